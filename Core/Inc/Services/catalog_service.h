@@ -0,0 +1,35 @@
+#ifndef CATALOG_SERVICE_H
+#define CATALOG_SERVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "product_catalog.h"
+#include "esp_protocol.h"
+
+// Catalogue produits en service (product_catalog.h), sauvegardé dans le
+// secteur 6 de la flash (flash_sector.h). Au démarrage: dernière version
+// valide sauvegardée, sinon le catalogue intégré.
+// Double tampon: l'ESP remplit la banque inactive (CATALOG_BEGIN / ITEM /
+// END); à la fin, le catalogue est validé, indexé, sauvegardé, puis la
+// banque active bascule d'une seule écriture. Un catalogue incomplet ou
+// refusé n'est jamais visible. La sauvegarde fige la flash: refusée (BUSY)
+// tant qu'un job moteur est en file ou en cours. Les lectures se font depuis l'orchestrateur,
+// plus prioritaire que la tâche ESP: une recherche n'est jamais interrompue
+// par une mise à jour.
+
+#define CATALOG_MAGIC  0x31544143UL    // "CAT1": format de ProductCatalogImage
+
+// Avant le démarrage des tâches
+void CatalogService_Init(void);
+
+// Chiffres saisis -> copie de l'entrée si FOUND (entry peut être NULL)
+ProductMatch CatalogService_Match(const char* digits, ProductEntry* entry);
+
+// Mise à jour, tâche ESP uniquement. Retournent ESP_CODE_NONE ou la raison
+// du refus (EspResponseCode); tout refus abandonne la mise à jour en cours.
+uint8_t CatalogService_Begin(uint16_t version);
+uint8_t CatalogService_AddItem(const ProductEntry* entry);
+uint8_t CatalogService_Commit(uint8_t count);
+void CatalogService_Abort(void);
+
+#endif // CATALOG_SERVICE_H
@@ -3,26 +3,68 @@
 
 #include "stm32f4xx_hal.h"
 #include "cmsis_os.h"
+#include <stdbool.h>
+#include "esp_protocol.h"
 
 // Handle UART1 défini dans usart.c
 extern UART_HandleTypeDef huart1;
 
+// Ligne la plus longue acceptée sur les canaux TELEMETRY et DIAG (CRLF exclu)
+#define ESP_TX_BULK_LINE_MAX 511
+
+
+// Transport du lien: lignes ASCII (défaut) ou trames binaires COBS + CRC16 (esp_frame.h)
+typedef enum {
+    ESP_LINK_MODE_TEXT = 0,
+    ESP_LINK_MODE_BINARY
+} EspLinkMode;
+
+// Canaux logiques d'émission, du plus prioritaire au moins prioritaire. Chaque
+// canal a sa file; l'ordonnanceur sert toujours le canal le plus prioritaire
+// entre deux transferts DMA. Avec la capacité ESP_CAP_CHANNELS, les lignes des
+// canaux autres que CONTROL sont étiquetées et découpées en morceaux:
+//   %<canal><+|.>:<morceau>     '+' suite à venir, '.' dernier morceau
+// de sorte qu'une ligne de contrôle attend au plus un morceau.
 typedef enum {
-    ESP_MSG_UNKNOWN = 0,
-    ESP_MSG_NFC_UID,
-    ESP_MSG_NFC_ERR,
-    ESP_MSG_NAK_PAYING_NO_NET,
-    ESP_MSG_NAK_PAYMENT_DENIED,
-    ESP_MSG_ORDER_START,
-    ESP_MSG_VEND_COMMAND,
-    ESP_MSG_ORDER_END,
-    ESP_MSG_QR_TOKEN_ERROR,
-    ESP_MSG_QR_TOKEN_INVALID,
-      ESP_MSG_QR_TOKEN_BUSY,
-  ESP_MSG_QR_TOKEN_NO_NETWORK,
-  ESP_MSG_ORDER_FAILED,
-  ESP_MSG_SUPERVISION_ERROR
-} EspMessageType;
+    ESP_CHANNEL_CONTROL = 0,   // Réponses de commande, négociation, acquits
+    ESP_CHANNEL_TELEMETRY,     // Supervision, remontées périodiques
+    ESP_CHANNEL_DIAG,          // Diagnostic à la demande
+    ESP_CHANNEL_COUNT
+} EspChannel;
+
+// Compteurs du lien UART1 (réception DMA circulaire + IDLE)
+typedef struct {
+    uint32_t rxBytes;         // Octets extraits du buffer DMA
+    uint32_t rxDropped;       // Octets perdus (ring de réception plein)
+    uint32_t rxEvents;        // Événements IDLE / demi-transfert / transfert complet
+    uint32_t overrunErrors;   // ORE
+    uint32_t framingErrors;   // FE
+    uint32_t noiseErrors;     // NE
+    uint32_t parityErrors;    // PE
+    uint32_t dmaErrors;       // Erreurs DMA
+    uint32_t rxRestarts;      // Redémarrages de la réception après erreur
+    uint32_t lineResets;      // Lignes abandonnées (timeout, débordement, caractères invalides)
+    uint32_t rxFrames;        // Trames binaires valides
+    uint32_t frameErrors;     // Trames binaires mal formées (COBS, longueur)
+    uint32_t crcErrors;       // Trames binaires corrompues (CRC)
+    uint32_t txLines;         // Lignes / trames mises en file d'émission
+    uint32_t txBytes;         // Octets transmis par DMA
+    uint32_t txDropped;       // Lignes / trames refusées (file d'émission pleine)
+    uint32_t txErrors;        // Transferts DMA TX interrompus
+    uint16_t txHighWater;     // Remplissage maximal des files d'émission (octets, tous canaux)
+    uint32_t txChunks;        // Morceaux émis pour les lignes découpées
+    uint32_t txPreemptions;   // Canal prioritaire servi avant un message en attente
+    uint8_t linkCaps;         // Capacités négociées (ESP_CAP_*)
+    uint32_t baudRate;        // Débit courant de USART1
+    uint32_t handshakes;      // Négociations terminées (y compris mode historique)
+    uint32_t baudFallbacks;   // Essais de débit rapide échoués (retour à 115200)
+    uint32_t linkLosses;      // Pertes du lien détectées (renégociation)
+    uint32_t seqGaps;         // Commandes numérotées reçues en avance (trou)
+    uint32_t seqDuplicates;   // Commandes numérotées déjà reçues
+    uint32_t seqRejected;     // Numéros hors fenêtre ou lignes numérotées invalides
+    uint32_t seqRetransmits;  // Réponses retransmises (NAK ou timeout)
+    uint32_t seqDropped;      // Réponses abandonnées sans acquit
+} EspLinkStats;
 
 // Détecte le type de message en fonction de la ligne reçue
 EspMessageType EspComm_ClassifyMessage(const char* line);
@@ -30,8 +72,33 @@ EspMessageType EspComm_ClassifyMessage(const char* line);
 // Démarre la tâche de communication avec l'ESP (UART1)
 void StartTaskEspCommunication(void *argument);
 
-// Envoie une ligne (CRLF ajouté) vers l'ESP via UART1
-void EspComm_SendLine(const char* line);
+// Envoie une ligne (CRLF ajouté) vers l'ESP via UART1, canal CONTROL
+// Met la ligne (+CRLF) en file d'émission DMA sans attendre la fin du transfert.
+// Retourne false si la ligne est invalide, si la file est pleine (contre-pression)
+// ou si le lien est en mode binaire.
+// Contexte tâche uniquement (section critique FreeRTOS).
+bool EspComm_SendLine(const char* line);
+
+// Idem sur un canal donné; hors CONTROL, la ligne peut atteindre ESP_TX_BULK_LINE_MAX
+bool EspComm_SendLineOn(EspChannel channel, const char* line);
+
+// Envoie une réponse typée, formatée selon le mode du lien (texte ou trame)
+bool EspComm_SendResponse(const EspResponse* rsp);
+
+// Envoie une trame binaire brute (type + payload), quel que soit le mode, canal CONTROL
+bool EspComm_SendFrame(uint8_t type, const uint8_t* payload, uint16_t len);
+bool EspComm_SendFrameOn(EspChannel channel, uint8_t type, const uint8_t* payload, uint16_t len);
+
+// Sélection du transport du lien ESP
+void EspComm_SetLinkMode(EspLinkMode mode);
+EspLinkMode EspComm_GetLinkMode(void);
+
+// Rend le descripteur d'une commande groupée (ORCH_EVT_ORDER_BATCH) une fois
+// la livraison terminée; la commande groupée suivante est refusée (ORDER_BUSY) avant
+void EspComm_ReleaseOrder(const EspOrder* order);
+
+// Copie des compteurs du lien ESP
+void EspComm_GetLinkStats(EspLinkStats* stats);
 
 #endif // ESP_COMMUNICATION_SERVICE_H
 
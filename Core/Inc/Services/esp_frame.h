@@ -0,0 +1,130 @@
+#ifndef ESP_FRAME_H
+#define ESP_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_protocol.h"
+
+// Transport binaire optionnel du lien NUCLEO <-> ESP32.
+// Trame brute : [type u8][payload ...][crc16 LE]
+// Sur le fil   : COBS(trame brute) suivi du délimiteur 0x00
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) calculé sur type + payload.
+// Les champs multi-octets du payload sont en little-endian.
+
+#define ESP_FRAME_DELIMITER    0x00
+#define ESP_FRAME_MAX_PAYLOAD  96
+#define ESP_FRAME_MAX_RAW      (1 + ESP_FRAME_MAX_PAYLOAD + 2)
+// COBS ajoute 1 octet par bloc de 254; + délimiteur
+#define ESP_FRAME_MAX_ENCODED  (ESP_FRAME_MAX_RAW + (ESP_FRAME_MAX_RAW / 254) + 1 + 1)
+
+// Réception: une trame ORDER complète (idLen, order_id, puis par article
+// slot, qty, idLen, product_id), enveloppe numérotée [seq][type] comprise.
+// Les trames émises restent bornées par ESP_FRAME_MAX_PAYLOAD.
+#define ESP_FRAME_ORDER_PAYLOAD_MAX  (1 + ESP_PROTO_ID_MAX_LEN + \
+                                      ESP_PROTO_ORDER_MAX_ITEMS * (3 + ESP_PROTO_ID_MAX_LEN))
+#define ESP_FRAME_MAX_RX_PAYLOAD     (2 + ESP_FRAME_ORDER_PAYLOAD_MAX)
+#define ESP_FRAME_MAX_RX_RAW         (1 + ESP_FRAME_MAX_RX_PAYLOAD + 2)
+#define ESP_FRAME_MAX_RX_ENCODED     (ESP_FRAME_MAX_RX_RAW + (ESP_FRAME_MAX_RX_RAW / 254) + 1 + 1)
+
+// Types de trames (octet 0 de la trame brute)
+typedef enum {
+    // ESP32 -> STM32 (mêmes messages que le protocole texte)
+    ESP_FRAME_NFC_UID            = 0x01,  // uid (octets bruts)
+    ESP_FRAME_NFC_ERR            = 0x02,
+    ESP_FRAME_NAK_PAYING_NO_NET  = 0x03,
+    ESP_FRAME_NAK_PAYMENT_DENIED = 0x04,
+    ESP_FRAME_ORDER_START        = 0x05,  // order_id (1..31 car.)
+    ESP_FRAME_VEND               = 0x06,  // slot u8, qty u8, product_id (1..31 car.)
+    ESP_FRAME_ORDER_END          = 0x07,
+    ESP_FRAME_QR_TOKEN_ERROR     = 0x08,
+    ESP_FRAME_QR_TOKEN_INVALID   = 0x09,
+    ESP_FRAME_QR_TOKEN_BUSY      = 0x0A,
+    ESP_FRAME_QR_TOKEN_NO_NETWORK = 0x0B,
+    ESP_FRAME_ORDER_FAILED       = 0x0C,
+    ESP_FRAME_ORDER              = 0x0D,  // idLen u8, order_id, puis par article: slot u8, qty u8, idLen u8, product_id
+    ESP_FRAME_CATALOG_BEGIN      = 0x0E,  // version u16
+    ESP_FRAME_CATALOG_ITEM       = 0x0F,  // code u16, digits u8, channel u8, sensor u8, price u16, label (1..11 car.)
+    ESP_FRAME_CATALOG_END        = 0x10,  // count u8
+    ESP_FRAME_DIAG_CALIB         = 0x11,
+
+    // Numérotation (esp_seq.h), dans les deux sens
+    ESP_FRAME_SEQ                = 0x40,  // seq u8, type u8, payload du type
+    ESP_FRAME_SEQ_ACK            = 0x41,  // seq u8 (acquit cumulatif)
+    ESP_FRAME_SEQ_NAK            = 0x42,  // seq u8 (retransmission demandée)
+
+    // STM32 -> ESP32
+    ESP_FRAME_ORDER_ACK          = 0x80,
+    ESP_FRAME_ORDER_NAK          = 0x81,  // code u8
+    ESP_FRAME_VEND_COMPLETED     = 0x82,  // slot u8
+    ESP_FRAME_VEND_FAILED        = 0x83,  // slot u8, code u8 [, delivered u8, quantity u8]
+    ESP_FRAME_DELIVERY_COMPLETED = 0x84,
+    ESP_FRAME_DELIVERY_FAILED    = 0x85,  // code u8
+    ESP_FRAME_STATE              = 0x86,  // code u8
+    ESP_FRAME_SUPERVISION_ERROR  = 0x87,  // error_type u8, timestamp u32, message
+    ESP_FRAME_CATALOG_ACK        = 0x88,
+    ESP_FRAME_CATALOG_NAK        = 0x89,  // code u8
+    ESP_FRAME_CAL                = 0x8A   // channel u8, onTime u16, settle u16, avgDispense u16, successes u16, attempts u16
+} EspFrameType;
+
+typedef enum {
+    ESP_FRAME_OK = 0,
+    ESP_FRAME_ERR_COBS,     // Encodage COBS invalide
+    ESP_FRAME_ERR_LENGTH,   // Trame trop courte ou trop longue
+    ESP_FRAME_ERR_CRC       // CRC incorrect (corruption)
+} EspFrameStatus;
+
+// CRC-16/CCITT-FALSE (table logicielle, identique sur cible et sur PC)
+uint16_t EspFrame_Crc16(const uint8_t* data, size_t len);
+
+// COBS: retournent la longueur produite, 0 si erreur ou place insuffisante
+size_t EspFrame_CobsEncode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize);
+size_t EspFrame_CobsDecode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize);
+
+// Construit une trame complète (COBS + délimiteur) ; retourne sa longueur, 0 si erreur
+size_t EspFrame_Encode(uint8_t type, const uint8_t* payload, size_t payloadLen,
+                       uint8_t* out, size_t outSize);
+
+// Décode une trame reçue (sans le délimiteur) ; payload pointe dans work
+EspFrameStatus EspFrame_Decode(const uint8_t* frame, size_t len, uint8_t* work, size_t workSize,
+                               uint8_t* type, const uint8_t** payload, size_t* payloadLen);
+
+// Commandes ESP32 -> STM32 <-> trame (décodage côté STM32, encodage côté ESP/tests)
+bool EspFrame_ToCommand(uint8_t type, const uint8_t* payload, size_t payloadLen, EspCommand* cmd);
+size_t EspFrame_EncodeCommand(const EspCommand* cmd, uint8_t* out, size_t outSize);
+
+// Réponses STM32 -> ESP32 <-> trame
+size_t EspFrame_EncodeResponse(const EspResponse* rsp, uint8_t* out, size_t outSize);
+bool EspFrame_ToResponse(uint8_t type, const uint8_t* payload, size_t payloadLen, EspResponse* rsp);
+
+// Commande groupée (ESP_FRAME_ORDER) <-> descripteur
+bool EspFrame_ToOrder(const uint8_t* payload, size_t payloadLen, EspOrder* order);
+size_t EspFrame_EncodeOrder(const EspOrder* order, uint8_t* out, size_t outSize);
+size_t EspFrame_EncodeOrderSeq(const EspOrder* order, uint8_t seq, uint8_t* out, size_t outSize);
+
+// Variantes numérotées (trame ESP_FRAME_SEQ)
+size_t EspFrame_EncodeCommandSeq(const EspCommand* cmd, uint8_t seq, uint8_t* out, size_t outSize);
+size_t EspFrame_EncodeResponseSeq(const EspResponse* rsp, uint8_t seq, uint8_t* out, size_t outSize);
+
+// Lecture / écriture little-endian des champs fixes
+static inline void EspFrame_PutU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline uint16_t EspFrame_GetU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline void EspFrame_PutU32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t EspFrame_GetU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+#endif // ESP_FRAME_H
@@ -0,0 +1,88 @@
+#ifndef ESP_LINK_HANDSHAKE_H
+#define ESP_LINK_HANDSHAKE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Négociation du lien ESP32 au démarrage et après perte du lien, sans dépendance HAL.
+// Toujours en texte à 115200 bauds, compatible avec un ESP qui ne la connaît pas:
+//
+//   STM -> ESP  HELLO:<version>:<caps>:<baud max>
+//   ESP -> STM  HELLO_ACK:<version>:<caps>:<baud max>
+//   STM -> ESP  BAUD:<baud>          puis les deux côtés changent de débit
+//   STM -> ESP  SYNC:<motif>         au nouveau débit
+//   ESP -> STM  SYNC_ACK:<motif>     sinon les deux côtés reviennent à 115200
+//
+// Sans HELLO_ACK après ESP_HS_HELLO_RETRIES essais, le lien reste en mode historique
+// (115200, aucune capacité). Les capacités retenues sont l'intersection des deux côtés;
+// elles s'appliquent après SYNC_ACK (ou dès HELLO_ACK si le débit ne change pas).
+
+#define ESP_HS_PROTOCOL_VERSION   1
+#define ESP_HS_DEFAULT_BAUD       115200U
+#define ESP_HS_MAX_BAUD           921600U   // PCLK2 84 MHz: erreur < 0,2 % à 460800 et 921600
+
+#define ESP_HS_HELLO_TIMEOUT_MS   500U
+#define ESP_HS_HELLO_RETRIES      3U
+#define ESP_HS_SYNC_TIMEOUT_MS    100U
+#define ESP_HS_REVERT_DELAY_MS    300U      // > timeout SYNC côté ESP: il est revenu à 115200
+#define ESP_HS_LINE_MAX           48U
+
+#define ESP_HS_SYNC_PATTERN       "UUUU5A5A"  // 0x55: transitions à chaque bit
+
+// Capacités optionnelles (bitmask)
+#define ESP_CAP_BINARY_FRAMES     0x01U     // Trames COBS + CRC16 (esp_frame.h)
+#define ESP_CAP_BAUD_UPGRADE      0x02U     // Changement de débit BAUD/SYNC
+#define ESP_CAP_SEQUENCED         0x04U     // Numéros de séquence + fenêtre d'acquit (esp_seq.h)
+#define ESP_CAP_CHANNELS          0x08U     // Canaux logiques étiquetés, lignes longues découpées
+#define ESP_HS_LOCAL_CAPS         (ESP_CAP_BINARY_FRAMES | ESP_CAP_BAUD_UPGRADE | \
+                                   ESP_CAP_SEQUENCED | ESP_CAP_CHANNELS)
+
+typedef enum {
+    ESP_HS_IDLE = 0,
+    ESP_HS_HELLO_SENT,      // Attente HELLO_ACK
+    ESP_HS_BAUD_SWITCHED,   // BAUD envoyé, nouveau débit appliqué: SYNC à envoyer
+    ESP_HS_SYNC_SENT,       // Attente SYNC_ACK au nouveau débit
+    ESP_HS_REVERTING,       // Retour à 115200, attente avant le débit suivant
+    ESP_HS_READY,           // Négociation terminée
+    ESP_HS_LEGACY           // ESP sans négociation: 115200, aucune capacité
+} EspHandshakeState;
+
+typedef struct {
+    EspHandshakeState state;
+    uint32_t deadline;      // Échéance de l'état courant (HAL_GetTick)
+    uint8_t retries;
+    uint8_t peerVersion;
+    uint8_t caps;           // Capacités retenues (valides en READY)
+    uint8_t peerCaps;
+    uint32_t peerMaxBaud;
+    uint32_t baud;          // Débit courant du lien
+    uint32_t trialBaud;     // Débit en cours d'essai
+    uint32_t fallbacks;     // Essais de débit échoués
+} EspHandshake;
+
+// Actions demandées au service, dans l'ordre: émettre line, puis appliquer baud
+// (une fois la ligne partie), puis, si linkUp, appliquer caps
+typedef struct {
+    char line[ESP_HS_LINE_MAX];   // Ligne à émettre ("" si aucune)
+    uint32_t baud;                // Nouveau débit (0 si inchangé)
+    bool linkUp;                  // Négociation terminée: appliquer les capacités
+    bool linkDown;                // Retour au mode de base (texte, aucune capacité)
+} EspHsAction;
+
+void EspHandshake_Init(EspHandshake* hs);
+
+// Démarre (ou redémarre après perte du lien) la négociation
+void EspHandshake_Start(EspHandshake* hs, uint32_t now, EspHsAction* act);
+
+// Ligne reçue de l'ESP: retourne true si elle appartient à la négociation
+bool EspHandshake_OnLine(EspHandshake* hs, const char* line, uint32_t now, EspHsAction* act);
+
+// Échéances (retransmission HELLO, timeout SYNC, retour à 115200)
+void EspHandshake_Poll(EspHandshake* hs, uint32_t now, EspHsAction* act);
+
+// Temps restant avant la prochaine échéance (UINT32_MAX si aucune)
+uint32_t EspHandshake_TimeToDeadline(const EspHandshake* hs, uint32_t now);
+
+bool EspHandshake_IsBusy(const EspHandshake* hs);
+
+#endif // ESP_LINK_HANDSHAKE_H
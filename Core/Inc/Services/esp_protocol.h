@@ -0,0 +1,133 @@
+#ifndef ESP_PROTOCOL_H
+#define ESP_PROTOCOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "product_catalog.h"
+
+// Décodage des lignes du protocole ESP32 -> STM32, sans dépendance HAL:
+// classification et extraction des arguments en un seul parcours de la ligne
+
+typedef enum {
+    ESP_MSG_UNKNOWN = 0,
+    ESP_MSG_NFC_UID,
+    ESP_MSG_NFC_ERR,
+    ESP_MSG_NAK_PAYING_NO_NET,
+    ESP_MSG_NAK_PAYMENT_DENIED,
+    ESP_MSG_ORDER_START,
+    ESP_MSG_VEND_COMMAND,
+    ESP_MSG_ORDER_END,
+    ESP_MSG_QR_TOKEN_ERROR,
+    ESP_MSG_QR_TOKEN_INVALID,
+    ESP_MSG_QR_TOKEN_BUSY,
+    ESP_MSG_QR_TOKEN_NO_NETWORK,
+    ESP_MSG_ORDER_FAILED,
+    ESP_MSG_SUPERVISION_ERROR,
+    ESP_MSG_ORDER_BATCH,        // "ORDER:<id>;<slot>,<qty>,<produit>;..." (commande groupée)
+    ESP_MSG_DIAG_CALIB,         // "DIAG:CAL": calibration des canaux moteur sur le canal DIAG
+    ESP_MSG_CATALOG_BEGIN,      // "CATALOG_BEGIN:<version>": nouveau catalogue, entrées à suivre
+    ESP_MSG_CATALOG_ITEM,       // "CATALOG_ITEM:<code>,<canal>,<capteur>,<prix>,<libellé>"
+    ESP_MSG_CATALOG_END         // "CATALOG_END:<nombre>": validation et bascule
+} EspMessageType;
+
+#define ESP_PROTO_ID_MAX_LEN 31   // Longueur max d'un identifiant (produit, commande)
+
+// Limites des arguments VEND
+#define ESP_PROTO_SLOT_MIN 1
+#define ESP_PROTO_SLOT_MAX 4
+#define ESP_PROTO_QTY_MIN  1
+#define ESP_PROTO_QTY_MAX  10
+
+// Mise à jour du catalogue produits
+#define ESP_PROTO_CATALOG_VERSION_MAX 65535
+#define ESP_PROTO_CATALOG_SENSOR_NONE 255   // Champ capteur: aucun capteur de stock
+
+// Commande groupée: tous les articles d'une commande en un seul message
+#define ESP_PROTO_ORDER_MAX_ITEMS 8
+// Taille texte au pire cas: "ORDER:" + order_id, puis par article ";<slot>,<qty>,<product_id>"
+#define ESP_PROTO_ORDER_ITEM_TEXT_MAX (6 + ESP_PROTO_ID_MAX_LEN)
+#define ESP_PROTO_ORDER_TEXT_MAX      (6 + ESP_PROTO_ID_MAX_LEN + \
+                                       ESP_PROTO_ORDER_MAX_ITEMS * ESP_PROTO_ORDER_ITEM_TEXT_MAX)
+
+typedef struct {
+    uint8_t slot_number;
+    uint8_t quantity;
+    char product_id[ESP_PROTO_ID_MAX_LEN + 1];
+} EspOrderItem;
+
+typedef struct {
+    char order_id[ESP_PROTO_ID_MAX_LEN + 1];
+    uint8_t item_count;
+    EspOrderItem items[ESP_PROTO_ORDER_MAX_ITEMS];
+} EspOrder;
+
+// Commande décodée
+typedef struct {
+    EspMessageType type;
+    bool valid;                                // Arguments présents et dans les bornes
+    uint8_t slot_number;                       // VEND
+    uint8_t quantity;                          // VEND
+    char product_id[ESP_PROTO_ID_MAX_LEN + 1]; // VEND
+    char order_id[ESP_PROTO_ID_MAX_LEN + 1];   // ORDER_START
+    uint16_t catalog_version;                  // CATALOG_BEGIN
+    uint8_t catalog_count;                     // CATALOG_END
+    ProductEntry product;                      // CATALOG_ITEM
+} EspCommand;
+
+// Réponses STM32 -> ESP32, indépendantes du mode de transport (texte ou binaire)
+typedef enum {
+    ESP_RSP_ORDER_ACK = 0,       // "ORDER_ACK"
+    ESP_RSP_ORDER_NAK,           // "ORDER_NAK:<raison>"
+    ESP_RSP_VEND_COMPLETED,      // "VEND_COMPLETED:<slot>"
+    ESP_RSP_VEND_FAILED,         // "VEND_FAILED:<slot>:<raison>"
+    ESP_RSP_DELIVERY_COMPLETED,  // "DELIVERY_COMPLETED"
+    ESP_RSP_DELIVERY_FAILED,     // "DELIVERY_FAILED:<raison>"
+    ESP_RSP_STATE,               // "STATE:<état>"
+    ESP_RSP_CATALOG_ACK,         // "CATALOG_ACK": nouveau catalogue en service
+    ESP_RSP_CATALOG_NAK          // "CATALOG_NAK:<raison>": mise à jour abandonnée
+} EspResponseType;
+
+// Codes transmis avec les réponses (raison d'échec ou état)
+typedef enum {
+    ESP_CODE_NONE = 0,
+    ESP_CODE_NO_ACTIVE_ORDER,
+    ESP_CODE_INVALID_VEND_FORMAT,
+    ESP_CODE_INVALID_CHANNEL,
+    ESP_CODE_ORDER_CANCELLED,
+    ESP_CODE_STATE_PAYING,
+    ESP_CODE_INVALID_ORDER_FORMAT,
+    ESP_CODE_ORDER_BUSY,
+    ESP_CODE_MOTOR_FAILED,
+    ESP_CODE_NO_DROP,            // Moteur arrêté sans chute détectée (bourrage)
+    ESP_CODE_CATALOG_FORMAT,     // Ligne mal formée ou hors séquence BEGIN/ITEM/END
+    ESP_CODE_CATALOG_INVALID,    // Nombre d'entrées, code, canal, doublon ou préfixe
+    ESP_CODE_CATALOG_STORAGE,    // Sauvegarde flash en échec: ancien catalogue conservé
+    ESP_CODE_CATALOG_BUSY        // Distribution en cours: mise à jour à renvoyer
+} EspResponseCode;
+
+typedef struct {
+    EspResponseType type;
+    uint8_t slot;   // VEND_COMPLETED / VEND_FAILED
+    uint8_t code;   // EspResponseCode
+    uint8_t delivered;  // VEND_FAILED après distribution: unités tombées...
+    uint8_t quantity;   // ...sur la quantité demandée (0: rien tenté)
+} EspResponse;
+
+// Classification seule (aucune extraction d'arguments)
+EspMessageType EspProtocol_Classify(const char* line);
+
+// Classification + extraction des arguments dans cmd; retourne cmd->type.
+// Pour VEND / ORDER_START / CATALOG_*, cmd->valid indique si les arguments sont exploitables;
+// pour ORDER (groupée), valid reste false: les articles se lisent avec
+// EspProtocol_DecodeOrder; pour les autres messages reconnus, valid vaut true.
+EspMessageType EspProtocol_Decode(const char* line, EspCommand* cmd);
+
+// "ORDER:<id>;<slot>,<qty>,<produit>[;...]" -> descripteur borné.
+// false si la ligne est mal formée, vide, ou dépasse ESP_PROTO_ORDER_MAX_ITEMS articles.
+bool EspProtocol_DecodeOrder(const char* line, EspOrder* order);
+
+// Formate une réponse en ligne texte (sans CRLF); retourne la longueur, 0 si erreur
+size_t EspProtocol_FormatResponse(const EspResponse* rsp, char* out, size_t outSize);
+
+#endif // ESP_PROTOCOL_H
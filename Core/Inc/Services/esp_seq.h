@@ -0,0 +1,80 @@
+#ifndef ESP_SEQ_H
+#define ESP_SEQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_protocol.h"
+
+// Numérotation des messages du lien ESP avec fenêtre glissante, sans dépendance HAL.
+// Activée par la capacité ESP_CAP_SEQUENCED négociée au HELLO.
+//
+//   Données   #<seq>:<ligne>     (trame: ESP_FRAME_SEQ [seq][type][payload])
+//   Acquit    #ACK:<seq>         cumulatif: tout jusqu'à seq inclus est reçu
+//   Demande   #NAK:<seq>         seq manquant: retransmission sélective
+//
+// seq sur 8 bits, modulo 256, recommence à 0 à chaque négociation. L'ESP peut
+// enchaîner jusqu'à ESP_SEQ_WINDOW commandes sans attendre d'acquit; les commandes
+// reçues hors ordre sont gardées et livrées dès que le trou est comblé.
+
+#define ESP_SEQ_WINDOW        8U
+#define ESP_SEQ_RTO_MS        300U    // Retransmission d'une réponse non acquittée
+#define ESP_SEQ_MAX_RETRIES   5U
+
+// Réception (commandes ESP -> STM)
+typedef enum {
+    ESP_SEQ_RX_DELIVER = 0,   // Dans l'ordre: livrer, puis vider EspSeq_RxNext
+    ESP_SEQ_RX_BUFFERED,      // En avance: gardée, le trou doit être signalé (NAK)
+    ESP_SEQ_RX_DUPLICATE,     // Déjà reçue (acquit perdu): ré-acquitter
+    ESP_SEQ_RX_REJECTED       // Hors fenêtre
+} EspSeqRxResult;
+
+typedef struct {
+    uint8_t expected;                       // Prochain seq attendu
+    uint8_t held;                           // Bit i: commande expected+i en attente
+    bool nakSent;                           // Trou courant déjà signalé
+    EspCommand pending[ESP_SEQ_WINDOW];
+} EspSeqRx;
+
+// Émission (réponses STM -> ESP)
+typedef struct {
+    uint8_t base;                           // Plus ancien seq non acquitté
+    uint8_t next;                           // Prochain seq à attribuer
+    uint32_t sentAt[ESP_SEQ_WINDOW];
+    uint8_t retries[ESP_SEQ_WINDOW];
+    EspResponse rsp[ESP_SEQ_WINDOW];
+} EspSeqTx;
+
+// Lignes texte préfixées par '#'
+typedef enum {
+    ESP_SEQ_LINE_NONE = 0,    // Ligne non numérotée
+    ESP_SEQ_LINE_DATA,        // #<seq>:<body>
+    ESP_SEQ_LINE_ACK,         // #ACK:<seq>
+    ESP_SEQ_LINE_NAK,         // #NAK:<seq>
+    ESP_SEQ_LINE_INVALID
+} EspSeqLineKind;
+
+EspSeqLineKind EspSeq_ParseLine(const char* line, uint8_t* seq, const char** body);
+
+void EspSeq_RxReset(EspSeqRx* rx);
+EspSeqRxResult EspSeq_RxAccept(EspSeqRx* rx, uint8_t seq, const EspCommand* cmd);
+// Sort qu'aurait seq, sans rien modifier (commande qu'on ne peut pas garder)
+EspSeqRxResult EspSeq_RxCheck(const EspSeqRx* rx, uint8_t seq);
+// Commande suivante devenue livrable après un DELIVER; false quand il n'y en a plus
+bool EspSeq_RxNext(EspSeqRx* rx, EspCommand* cmd);
+// Dernier seq reçu dans l'ordre (valeur de l'acquit cumulatif)
+uint8_t EspSeq_RxAckValue(const EspSeqRx* rx);
+
+void EspSeq_TxReset(EspSeqTx* tx);
+uint8_t EspSeq_TxInFlight(const EspSeqTx* tx);
+// Attribue un seq et garde la réponse jusqu'à l'acquit; false si la fenêtre est pleine
+bool EspSeq_TxPush(EspSeqTx* tx, const EspResponse* rsp, uint32_t now, uint8_t* seq);
+// Acquit cumulatif: retourne le nombre de réponses libérées
+uint8_t EspSeq_TxAck(EspSeqTx* tx, uint8_t seq);
+// Réponse encore en fenêtre pour un NAK (NULL si déjà acquittée ou inconnue)
+const EspResponse* EspSeq_TxGet(EspSeqTx* tx, uint8_t seq, uint32_t now);
+// Plus ancienne réponse dont le délai de retransmission est écoulé; false si aucune.
+// Après ESP_SEQ_MAX_RETRIES essais la réponse est abandonnée (*dropped = true).
+bool EspSeq_TxPollRetransmit(EspSeqTx* tx, uint32_t now, uint8_t* seq,
+                             EspResponse* rsp, bool* dropped);
+
+#endif // ESP_SEQ_H
@@ -0,0 +1,51 @@
+#ifndef I2C_BUS_SERVICE_H
+#define I2C_BUS_SERVICE_H
+
+#include "stm32f4xx_hal.h"
+#include "cmsis_os.h"
+#include "i2c.h"
+#include "i2c_txn_queue.h"
+
+// Gestionnaire des bus I2C: une tâche par bus possède son handle HAL et
+// exécute une à une les transactions de sa file (i2c_txn_queue.h), par
+// interruption (HAL_I2C_*_IT). Les demandeurs ne touchent jamais au
+// périphérique: ni mutex à oublier, ni tâche bloquée sur le fil.
+// Chaque transaction se termine, au plus tard à I2C_BUS_XFER_TIMEOUT_MS
+// (périphérique réinitialisé): une attente de fin est toujours bornée.
+// Transferts de quelques octets: l'interruption suffit, un flux DMA par
+// sens et par bus n'apporterait rien à cette taille.
+
+typedef enum {
+    I2C_BUS_1 = 0,          // hi2c1
+    I2C_BUS_2,              // hi2c2
+    I2C_BUS_COUNT
+} I2cBusId;
+
+#define I2C_BUS_XFER_TIMEOUT_MS  50U
+
+// Fin de transaction signalée au demandeur synchrone (osThreadFlags): ne pas
+// réutiliser ce drapeau dans une tâche cliente
+#define I2C_BUS_FLAG_DONE        0x40000000UL
+
+// Avant le démarrage de l'ordonnanceur
+void I2cBusService_Init(void);
+
+// Transaction quelconque, fin signalée par txn->done (tâche du bus)
+bool I2cBus_Submit(I2cBusId bus, const I2cTxn* txn, I2cPriority prio);
+
+// Écriture copiée et postée sans attente, dans l'ordre des envois
+bool I2cBus_Post(I2cBusId bus, I2cPriority prio, uint16_t addr8, const uint8_t* data, uint8_t len);
+
+// Synchrones: la tâche appelante dort jusqu'à la fin de sa transaction
+HAL_StatusTypeDef I2cBus_Write(I2cBusId bus, I2cPriority prio, uint16_t addr8,
+                               const uint8_t* data, uint8_t len);
+HAL_StatusTypeDef I2cBus_WriteRead(I2cBusId bus, I2cPriority prio, uint16_t addr8,
+                                   const uint8_t* tx, uint8_t txLen, uint8_t* rx, uint16_t rxLen);
+// Accès registre (memAddrSize: 1 ou 2 octets, poids fort d'abord): écriture
+// de len octets à partir de memAddr, ou lecture en rafale en redémarrage
+HAL_StatusTypeDef I2cBus_MemWrite(I2cBusId bus, I2cPriority prio, uint16_t addr8, uint16_t memAddr,
+                                  uint8_t memAddrSize, const uint8_t* data, uint8_t len);
+HAL_StatusTypeDef I2cBus_MemRead(I2cBusId bus, I2cPriority prio, uint16_t addr8, uint16_t memAddr,
+                                 uint8_t memAddrSize, uint8_t* rx, uint16_t rxLen);
+
+#endif // I2C_BUS_SERVICE_H
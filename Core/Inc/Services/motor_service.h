@@ -4,12 +4,84 @@
 #include "stm32f4xx_hal.h"
 #include "stdio.h"
 #include "cmsis_os.h"
+#include "motor_job_queue.h"
+#include "motor_drop.h"
+#include "motor_calib.h"
 
-// Plus de queue: notifications directes
+// File de jobs bornée (motor_job_queue.h), servie dans l'ordre par la tâche
+// moteur: une commande multi-articles est soumise d'un coup et enchaînée sans
+// attente côté demandeur. Un job porte toutes les unités d'un article. Chaque
+// job rappelle son callback en fin d'exécution (contexte de la tâche moteur)
+// ou à l'annulation (contexte de l'appelant).
+
+// L'impulsion elle-même est générée par TIM3_CH3 sur MUX_IN1_SIG (motor_pulse.h):
+// attente du multiplexeur et durée active à la microseconde, rampe optionnelle,
+// fin signalée par l'ISR de mise à jour.
+
+// Boucle fermée (MOTOR_DROP_SENSE): le moteur tourne en continu et la
+// barrière DROP_BEAM (PA0, EXTI front descendant) compte les unités; la
+// sortie est coupée à la dernière. La durée demandée est nominale par unité:
+// une unité lente prolonge la marche jusqu'à MOTOR_DROP_MAX_MS, au-delà le job
+// finit en MOTOR_JOB_NO_DROP avec le nombre d'unités déjà tombées. Barrière
+// coupée au départ: MOTOR_JOB_FAILED sans démarrer le moteur.
+
+// Durée MOTOR_ON_CALIBRATED: celle du canal (motor_calib.h), qui sert aussi
+// d'échéance par unité en boucle fermée et s'ajuste aux délais de chute
+// observés. Les enregistrements sont sauvegardés dans le dernier secteur de
+// la flash (flash_sector.h), réservé par le script de liens, au plus une fois par
+// MOTOR_CALIB_SAVE_MS et seulement file moteur vide.
+
+#define MOTOR_CHANNEL_COUNT   16U     // Sorties du multiplexeur (S0..S3)
+#define MOTOR_DEFAULT_ON_MS   700U
+#define MOTOR_JOB_GAP_MS      300U    // Repos entre deux jobs consécutifs
+#define MOTOR_MUX_SETTLE_US   20000U  // Sélection du canal -> signal actif
+#define MOTOR_SOFT_START_US   0U      // Rampe de démarrage (0: démarrage franc)
+#define MOTOR_PULSE_MARGIN_MS 50U     // Fin d'impulsion non signalée: job en échec
+#define MOTOR_DROP_SENSE      1       // 0: durée fixe, sans contrôle de chute
+#define MOTOR_DROP_MAX_MS     2000U   // Marche maximale en attente d'une unité
+#define MOTOR_DROP_MIN_GAP_MS 60U     // Fronts plus rapprochés: même produit
+
+#define MOTOR_ON_CALIBRATED   0U      // onTimeMs: durée apprise du canal
+#if MOTOR_DROP_SENSE
+#define MOTOR_CALIB_INITIAL_ON_MS MOTOR_DROP_MAX_MS   // Large tant que rien n'est appris
+#else
+#define MOTOR_CALIB_INITIAL_ON_MS MOTOR_DEFAULT_ON_MS
+#endif
+#define MOTOR_CALIB_SAVE_MS       60000U
+#define MOTOR_CALIB_MAGIC         0x314C434DUL        // "MCL1": format de MotorCalibRecord
 
 void StartTaskMotorService(void *argument);
+
+// Id du job, MOTOR_JOB_ID_NONE si le canal ou la quantité (1..MOTOR_JOB_MAX_UNITS)
+// est invalide, ou la file pleine. onTimeMs: durée par unité, ou MOTOR_ON_CALIBRATED
+MotorJobId MotorService_Submit(uint8_t channel, uint8_t quantity, uint16_t onTimeMs,
+                               MotorJobCallback done, void* ctx);
+
+// Jobs en attente (hors job en cours d'exécution)
+uint8_t MotorService_QueueDepth(void);
+
+// Aucun job en file ni en cours (pause entre deux jobs comprise): condition
+// d'une écriture en flash, qui fige aussi les interruptions moteur
+bool MotorService_IsIdle(void);
+
+// Retire les jobs en attente, rappelés avec MOTOR_JOB_CANCELLED; le job en
+// cours va à son terme. Retourne le nombre de jobs annulés.
+uint8_t MotorService_CancelAll(void);
+
+// Distribution simple sans retour (durée calibrée)
 void MotorService_StartDelivery(uint8_t channel);
-uint8_t MotorService_OrderToChannel(uint8_t orderCode);
 void MotorService_TestSweep(uint8_t firstChannel, uint8_t lastChannel, uint16_t onTimeMs);
 
+// Interruption de mise à jour de TIM3 (HAL_TIM_PeriodElapsedCallback)
+void MotorService_PulseElapsedFromISR(void);
+
+// Front de la barrière de chute (HAL_GPIO_EXTI_Callback)
+void MotorService_DropDetectedFromISR(void);
+
+// Bilan des chutes détectées / manquées depuis le démarrage
+void MotorService_GetDropStats(MotorDropStats* out);
+
+// Copie de la calibration d'un canal; false si le canal est invalide
+bool MotorService_GetCalibration(uint8_t channel, MotorCalibRecord* out);
+
 #endif
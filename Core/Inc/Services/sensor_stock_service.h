@@ -9,6 +9,16 @@
 // Adresse par défaut 0x29, mais support multi-capteurs: 8-bit HAL
 #define VL6180_DEFAULT_ADDR_8BIT   (0x29 << 1)
 
+// Balayage entrelacé (tof_scan.h): mesures lancées ensemble, relevées à
+// mesure qu'elles aboutissent. Fin de mesure signalée par la sortie GPIO1
+// de chaque capteur (TOFx_GPIO1, EXTI9_5): pas d'interrogation I2C. Accès
+// registre en transactions mémoire et rafales (vl6180.h)
+#define TOF_SENSOR_COUNT      5U
+#define TOF_I2C_BUS           I2C_BUS_1   // Bus des capteurs (i2c_bus_service.h)
+#define TOF_SCAN_PERIOD_MS    200U    // Début de cycle à début de cycle (multiple de 10 ms)
+#define TOF_RANGE_TIMEOUT_MS  80U     // Convergence maximale (~50 ms) + lecture
+#define TOF_CONTINUOUS        0       // 1: mesure continue à TOF_SCAN_PERIOD_MS, sans lancement par cycle
+
 typedef struct {
     uint8_t id;            // identifiant logique 0..N-1
     uint16_t i2cAddr8;     // adresse 8-bit HAL
@@ -35,6 +45,9 @@ typedef struct {
 #define TOF_SHUT_5_Pin         GPIO_PIN_13
 
 void StartTaskSensorStock(void *argument);
+// ISR EXTI: front descendant sur la GPIO1 d'un capteur (autres broches ignorées)
+void SensorStock_SampleReadyFromISR(uint16_t gpioPin);
+// hi2c ignoré: l'accès passe par la tâche du bus TOF_I2C_BUS
 HAL_StatusTypeDef VL6180_SetI2CAddress(I2C_HandleTypeDef* hi2c, uint16_t currentAddr8, uint8_t new7bit);
 
 #endif
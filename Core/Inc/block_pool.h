@@ -0,0 +1,42 @@
+#ifndef BLOCK_POOL_H
+#define BLOCK_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Allocateur de blocs de taille fixe sur un stockage statique (au plus 32 blocs).
+// Un bloc est désigné par un handle d'un octet, seul à transiter dans les files.
+// Allocation et libération en O(1) (masque des blocs libres). Sans verrou:
+// l'appelant sérialise les accès si plusieurs tâches allouent ou libèrent.
+
+#define BLOCK_POOL_MAX_BLOCKS  32U
+#define BLOCK_POOL_INVALID     0xFFU
+
+typedef struct {
+    uint8_t* storage;
+    uint16_t blockSize;
+    uint8_t count;
+    uint8_t inUse;
+    uint8_t highWater;        // Maximum de blocs alloués simultanément
+    uint32_t freeMask;        // Bit i à 1: bloc i libre
+    uint32_t allocFailures;   // Allocations refusées (pool vide)
+} BlockPool;
+
+// Initialisation statique (pool utilisable avant tout appel à BlockPool_Init)
+#define BLOCK_POOL_STATIC_INIT(storage_, blockSize_, count_) {                    \
+    .storage = (uint8_t*)(storage_), .blockSize = (blockSize_), .count = (count_),  \
+    .freeMask = ((count_) >= 32U) ? 0xFFFFFFFFU : ((1UL << (count_)) - 1U) }
+
+// false si count vaut 0 ou dépasse BLOCK_POOL_MAX_BLOCKS
+bool BlockPool_Init(BlockPool* pool, void* storage, uint16_t blockSize, uint8_t count);
+
+// Handle d'un bloc libre, BLOCK_POOL_INVALID si le pool est vide
+uint8_t BlockPool_Alloc(BlockPool* pool);
+
+// Adresse d'un bloc alloué, NULL si le handle est invalide ou libre
+void* BlockPool_Get(const BlockPool* pool, uint8_t handle);
+
+// false si le handle est invalide ou déjà libre (double libération)
+bool BlockPool_Free(BlockPool* pool, uint8_t handle);
+
+#endif // BLOCK_POOL_H
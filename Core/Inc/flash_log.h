@@ -0,0 +1,52 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Journal d'enregistrements de taille fixe dans une zone flash effacée d'un
+// bloc (un secteur). Chaque sauvegarde va dans l'emplacement vierge suivant,
+// la plus récente valide fait foi: la zone n'est effacée que lorsqu'elle est
+// pleine, soit une fois toutes les size / slotSize sauvegardes.
+// Emplacement: [magic u32][payload, complété à 4 octets][crc32 u32]. Une
+// écriture interrompue échoue au CRC, l'emplacement est ignoré et jamais
+// réécrit. Une coupure entre l'effacement et l'écriture perd la sauvegarde.
+// Module pur: lecture directe de la zone (mappée en mémoire), programmation
+// par mots et effacement par les fonctions fournies.
+
+// Programme count mots à offset (octets, aligné sur 4) dans la zone
+typedef bool (*FlashLogProgramFn)(uint32_t offset, const uint32_t* words, uint32_t count, void* ctx);
+typedef bool (*FlashLogEraseFn)(void* ctx);
+
+typedef struct {
+    const uint8_t* base;
+    uint32_t size;
+    uint32_t magic;             // Format du payload: changer de magic invalide l'existant
+    uint16_t payloadSize;
+    FlashLogProgramFn program;
+    FlashLogEraseFn erase;
+    void* ctx;
+} FlashLogConfig;
+
+#define FLASH_LOG_NONE  0xFFFFFFFFUL
+
+typedef struct {
+    FlashLogConfig cfg;
+    uint32_t slotSize;
+    uint32_t next;              // Premier emplacement vierge (size: zone pleine)
+    uint32_t latest;            // Dernier enregistrement valide, FLASH_LOG_NONE si aucun
+    uint32_t writes;
+    uint32_t erases;
+    uint32_t errors;            // Programmations ou effacements en échec
+} FlashLog;
+
+// Parcourt la zone: dernier enregistrement valide et prochain emplacement libre
+void FlashLog_Init(FlashLog* log, const FlashLogConfig* cfg);
+
+// Copie le dernier enregistrement valide; false si aucun
+bool FlashLog_Read(const FlashLog* log, void* payload);
+
+// Ajoute un enregistrement, efface d'abord la zone si elle est pleine
+bool FlashLog_Append(FlashLog* log, const void* payload);
+
+#endif // FLASH_LOG_H
@@ -0,0 +1,29 @@
+#ifndef FLASH_SECTOR_H
+#define FLASH_SECTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32f4xx_hal.h"
+
+// Secteurs réservés par le script de liens (région PERSIST), branchés sur
+// FlashLog (flash_log.h) via ctx. Plusieurs tâches y sauvegardent: chaque
+// programmation se fait ordonnanceur verrouillé, une autre tâche ne peut pas
+// reverrouiller la flash entre deux mots.
+// Programmation comme effacement bloquent la lecture de la flash, donc toute
+// exécution: à éviter moteur en marche (l'arrêt de l'impulsion est une ISR).
+
+// Secteurs 6 et 7 (128 Ko chacun)
+#define FLASH_SECTOR_CATALOG_ADDR  0x08040000UL
+#define FLASH_SECTOR_CALIB_ADDR    0x08060000UL
+#define FLASH_SECTOR_ZONE_SIZE     0x20000UL
+
+typedef struct {
+    uint32_t address;
+    uint32_t sector;            // FLASH_SECTOR_x
+} FlashSectorZone;
+
+// FlashLogProgramFn / FlashLogEraseFn, ctx: const FlashSectorZone*
+bool FlashSector_Program(uint32_t offset, const uint32_t* words, uint32_t count, void* ctx);
+bool FlashSector_Erase(void* ctx);
+
+#endif // FLASH_SECTOR_H
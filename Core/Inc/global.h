@@ -6,6 +6,7 @@
 #define GLOBAL_H
 
 #include <stdint.h>
+#include "product_catalog.h"
 
 typedef enum {
     IDLE,
@@ -16,8 +17,11 @@ typedef enum {
 } MachineState;
 
 extern volatile MachineState machine_interaction;
-extern volatile char keypad_choice[3];
-extern volatile uint8_t client_order;
+// Saisie clavier en cours: code produit de longueur variable (product_catalog.h)
+#define KEYPAD_CHOICE_SIZE (PRODUCT_CODE_MAX_DIGITS + 1U)
+
+extern volatile char keypad_choice[KEYPAD_CHOICE_SIZE];
+extern volatile uint16_t client_order;   // Code du produit en paiement
 
 extern volatile char* lcd_display;
 
@@ -56,7 +60,6 @@ static inline void log_mask_sensitive(char* dest, const char* src, size_t max_le
 
 #include "cmsis_os.h"
 // Mutex globaux pour protection des ressources partagées
-extern osMutexId_t i2c1Mutex;           // Protection bus I2C
 extern osMutexId_t globalStateMutex;    // Protection variables d'état globales
 extern osMutexId_t keypadChoiceMutex;   // Protection choix keypad
 
@@ -65,7 +68,7 @@ MachineState GlobalState_Get(void);
 void GlobalState_Set(MachineState newState);
 bool GlobalState_GetKeypadChoice(char* dest, size_t destSize);
 void GlobalState_SetKeypadChoice(const char* choice);
-uint8_t GlobalState_GetClientOrder(void);
-void GlobalState_SetClientOrder(uint8_t order);
+uint16_t GlobalState_GetClientOrder(void);
+void GlobalState_SetClientOrder(uint16_t order);
 
 #endif // GLOBAL_H
\ No newline at end of file
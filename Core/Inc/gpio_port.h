@@ -0,0 +1,46 @@
+#ifndef GPIO_PORT_H
+#define GPIO_PORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32f4xx_hal.h"
+
+// Écritures GPIO au niveau du port: les broches d'un même port changent
+// ensemble par une seule écriture BSRR (set en bits 0-15, reset en 16-31),
+// sans lecture-modification-écriture ni état intermédiaire visible.
+// Les primitives registre sont dans gpio.c (cible) et mock_hal.c (natif).
+
+#define GPIO_PORT_BATCH_MAX  4U     // Ports distincts par lot
+
+typedef struct {
+    GPIO_TypeDef* port;
+    uint16_t set;
+    uint16_t reset;
+} GpioPortOp;
+
+// Lot de mises à jour multi-ports: une écriture par port, dans l'ordre
+// d'apparition des ports dans le lot
+typedef struct {
+    GpioPortOp ops[GPIO_PORT_BATCH_MAX];
+    uint8_t count;
+} GpioPortBatch;
+
+// Mot BSRR: les broches de mask prennent les niveaux de value
+static inline uint32_t GpioPort_Bsrr(uint16_t mask, uint16_t value) {
+    return ((uint32_t)(uint16_t)(mask & ~value) << 16) | (uint32_t)(mask & value);
+}
+
+// Primitives registre
+void GpioPort_WriteBsrr(GPIO_TypeDef* port, uint32_t bsrr);
+uint16_t GpioPort_ReadIdr(GPIO_TypeDef* port);
+
+// Une seule écriture: broches de mask aux niveaux de value
+void GpioPort_Write(GPIO_TypeDef* port, uint16_t mask, uint16_t value);
+
+void GpioPortBatch_Init(GpioPortBatch* b);
+// Ajoute ou fusionne les broches d'un port (la dernière valeur l'emporte);
+// false si le lot a déjà GPIO_PORT_BATCH_MAX ports
+bool GpioPortBatch_Put(GpioPortBatch* b, GPIO_TypeDef* port, uint16_t mask, uint16_t value);
+void GpioPortBatch_Apply(const GpioPortBatch* b);
+
+#endif // GPIO_PORT_H
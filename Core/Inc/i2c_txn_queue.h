@@ -0,0 +1,70 @@
+#ifndef I2C_TXN_QUEUE_H
+#define I2C_TXN_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// File des transactions d'un bus I2C, exécutées une à une par la tâche du
+// bus (i2c_bus_service.h). Deux priorités, FIFO dans chacune: une
+// transaction haute passe devant les normales, mais après
+// I2C_TXN_HIGH_STREAK hautes d'affilée une normale en attente passe, le
+// LCD n'est jamais affamé par les capteurs.
+// Les octets à écrire sont copiés dans la transaction: l'émetteur peut la
+// poster sans attendre. Les octets lus vont dans le tampon du demandeur,
+// qui doit attendre la fin (callback). Sans verrou: l'appelant sérialise
+// les accès.
+
+#define I2C_TXN_QUEUE_DEPTH  8U      // Par priorité
+#define I2C_TXN_TX_MAX       8U
+#define I2C_TXN_HIGH_STREAK  4U
+
+typedef enum {
+    I2C_PRIO_HIGH = 0,
+    I2C_PRIO_NORMAL,
+    I2C_PRIO_COUNT
+} I2cPriority;
+
+typedef enum {
+    I2C_TXN_WRITE = 0,
+    I2C_TXN_READ,
+    I2C_TXN_WRITE_READ,     // Écriture puis lecture, arrêt entre les deux
+    I2C_TXN_MEM_WRITE,      // Adresse de registre (memAddr) puis tx, une transaction
+    I2C_TXN_MEM_READ        // Adresse de registre puis lecture en redémarrage (repeated start)
+} I2cTxnOp;
+
+// Fin de transaction, depuis la tâche du bus; status: HAL_StatusTypeDef
+typedef void (*I2cTxnCallback)(uint8_t status, void* ctx);
+
+typedef struct {
+    uint16_t addr8;         // Adresse 8 bits (HAL)
+    uint8_t op;             // I2cTxnOp
+    uint8_t memAddrSize;    // MEM_*: taille de memAddr en octets (1 ou 2)
+    uint16_t memAddr;
+    uint8_t txLen;
+    uint8_t tx[I2C_TXN_TX_MAX];
+    uint8_t* rx;
+    uint16_t rxLen;
+    I2cTxnCallback done;    // NULL: sans retour (écriture postée)
+    void* ctx;
+} I2cTxn;
+
+typedef struct {
+    I2cTxn slots[I2C_PRIO_COUNT][I2C_TXN_QUEUE_DEPTH];
+    uint8_t head[I2C_PRIO_COUNT];
+    uint8_t count[I2C_PRIO_COUNT];
+    uint8_t highStreak;     // Hautes servies d'affilée avec une normale en attente
+    uint8_t highWater;      // Profondeur totale maximale observée
+    uint32_t rejected;      // Transactions refusées (file pleine)
+} I2cTxnQueue;
+
+void I2cTxnQueue_Init(I2cTxnQueue* q);
+
+// false si la file de cette priorité est pleine ou la transaction invalide
+bool I2cTxnQueue_Push(I2cTxnQueue* q, const I2cTxn* txn, I2cPriority prio);
+
+// Prochaine transaction à exécuter
+bool I2cTxnQueue_Pop(I2cTxnQueue* q, I2cTxn* out);
+
+uint8_t I2cTxnQueue_Count(const I2cTxnQueue* q);
+
+#endif // I2C_TXN_QUEUE_H
@@ -67,6 +67,20 @@ void Error_Handler(void);
 #define MUX_S2_GPIO_Port GPIOC
 #define MUX_S3_Pin GPIO_PIN_3
 #define MUX_S3_GPIO_Port GPIOC
+#define TOF1_GPIO1_Pin GPIO_PIN_5
+#define TOF1_GPIO1_GPIO_Port GPIOC
+#define TOF2_GPIO1_Pin GPIO_PIN_6
+#define TOF2_GPIO1_GPIO_Port GPIOC
+#define TOF3_GPIO1_Pin GPIO_PIN_7
+#define TOF3_GPIO1_GPIO_Port GPIOA
+#define TOF4_GPIO1_Pin GPIO_PIN_8
+#define TOF4_GPIO1_GPIO_Port GPIOC
+#define TOF5_GPIO1_Pin GPIO_PIN_9
+#define TOF5_GPIO1_GPIO_Port GPIOC
+#define TOF_GPIO1_EXTI_IRQn EXTI9_5_IRQn
+#define DROP_BEAM_Pin GPIO_PIN_0
+#define DROP_BEAM_GPIO_Port GPIOA
+#define DROP_BEAM_EXTI_IRQn EXTI0_IRQn
 #define LD2_Pin GPIO_PIN_5
 #define LD2_GPIO_Port GPIOA
 #define MUX_IN1_SIG_Pin GPIO_PIN_0
@@ -0,0 +1,60 @@
+#ifndef MOTOR_CALIB_H
+#define MOTOR_CALIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Calibration d'un canal moteur, apprise des jobs en boucle fermée.
+// onTimeMs est la durée accordée à chaque unité: échéance de la chute en
+// boucle fermée, durée d'impulsion en boucle ouverte. Elle suit la moyenne
+// glissante du délai de chute observé, plus une marge:
+//   - unité manquée (échéance dépassée): hausse immédiate, le délai censuré
+//     entre dans la moyenne; un canal lent cesse de sous-distribuer
+//   - jobs complets: baisse progressive vers la cible; un canal rapide
+//     cesse de tourner pour rien sur un bourrage
+// Sans barrière de chute rien n'est appris: la durée reste celle du dernier
+// apprentissage ou la valeur par défaut.
+// Module pur: stockage et sérialisation à la charge de l'appelant.
+
+#define MOTOR_CALIB_MIN_ON_MS    150U
+#define MOTOR_CALIB_MAX_ON_MS    3000U
+#define MOTOR_CALIB_MARGIN_PCT   150U   // Cible: moyenne observée + 50 %
+#define MOTOR_CALIB_AVG_SHIFT    2U     // Nouvel échantillon pondéré à 1/4
+#define MOTOR_CALIB_RAISE_SHIFT  2U     // Unité manquée: au moins +1/4
+#define MOTOR_CALIB_LOWER_SHIFT  3U     // Baisse bornée à 1/8 par job
+#define MOTOR_CALIB_RATE_WINDOW  200U   // Compteurs divisés par deux au-delà: taux récent
+
+// Enregistrement persistant: 6 x u16, sans bourrage
+typedef struct {
+    uint16_t onTimeMs;          // Durée par unité en vigueur
+    uint16_t settleMs;          // Attente du multiplexeur avant la marche
+    uint16_t avgDispenseMs;     // Moyenne glissante du délai de chute (0: jamais observé)
+    uint16_t attempts;          // Unités demandées (fenêtre glissante)
+    uint16_t successes;         // Unités tombées
+    uint16_t adjustments;       // Changements de onTimeMs (saturé)
+} MotorCalibRecord;
+
+// Bilan d'un job en boucle fermée
+typedef struct {
+    uint8_t requested;
+    uint8_t delivered;
+    uint32_t sumMs;             // Somme des délais des unités tombées
+    uint32_t deadlineMs;        // Échéance appliquée (délai minimal d'une unité manquée)
+} MotorCalibSample;
+
+void MotorCalib_Default(MotorCalibRecord* rec, uint16_t onTimeMs, uint16_t settleMs);
+
+// Ramène un enregistrement relu dans ses bornes; false s'il était incohérent
+bool MotorCalib_Sanitize(MotorCalibRecord* rec);
+
+// Intègre un job; true si onTimeMs a changé
+bool MotorCalib_Observe(MotorCalibRecord* rec, const MotorCalibSample* sample);
+
+// Unités tombées / demandées, en pourcentage (100 sans historique)
+uint8_t MotorCalib_SuccessPct(const MotorCalibRecord* rec);
+
+// "CAL:<canal>:<on>:<attente>:<moyenne>:<tombées>/<demandées>"; longueur, 0 si erreur
+size_t MotorCalib_Format(uint8_t channel, const MotorCalibRecord* rec, char* out, size_t outSize);
+
+#endif // MOTOR_CALIB_H
@@ -0,0 +1,66 @@
+#ifndef MOTOR_DROP_H
+#define MOTOR_DROP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Comptage des chutes produit pendant un job moteur (boucle fermée).
+// Le moteur tourne en continu jusqu'à la dernière unité attendue; chaque
+// unité doit tomber au plus maxMs après l'armement ou la chute précédente.
+// Ignorées: les détections pendant le masquage (attente du multiplexeur),
+// après l'échéance, ou à moins de minGapMs de la précédente (même produit
+// vu deux fois). Detect peut être appelée depuis une ISR; l'appelant
+// sérialise Detect, DeadlineMs et Finish.
+// Module pur: horodatage en ms fourni par l'appelant.
+
+typedef enum {
+    MOTOR_DROP_IDLE = 0,
+    MOTOR_DROP_WAITING,     // Moteur en marche, unités encore attendues
+    MOTOR_DROP_DETECTED,    // Toutes les unités comptées
+    MOTOR_DROP_TIMEOUT      // Fenêtre close avant la dernière unité
+} MotorDropState;
+
+typedef struct {
+    uint32_t blankMs;
+    uint32_t nominalMs;     // Délai attendu par unité (statistiques)
+    uint32_t maxMs;         // Délai maximal par unité
+    uint32_t minGapMs;
+    uint8_t target;         // Unités à compter (au moins 1)
+} MotorDropSpec;
+
+typedef struct {
+    MotorDropSpec spec;
+    uint32_t armMs;         // Début de la fenêtre (départ + masquage)
+    uint32_t lastMs;        // Dernière chute comptée
+    uint32_t detectMs;      // Délai de la dernière unité
+    uint32_t sumMs;
+    uint32_t longestMs;
+    uint8_t count;
+    uint8_t extended;       // Unités tombées après le délai nominal
+    volatile MotorDropState state;
+} MotorDropWatch;
+
+// Bilan des jobs en boucle fermée
+typedef struct {
+    uint32_t detected;      // Unités
+    uint32_t timeouts;      // Jobs incomplets
+    uint32_t extended;
+    uint32_t totalDetectMs;
+    uint32_t maxDetectMs;
+} MotorDropStats;
+
+void MotorDrop_Start(MotorDropWatch* w, const MotorDropSpec* spec, uint32_t nowMs);
+
+// Chute signalée par le capteur: true si elle compte pour une unité
+bool MotorDrop_Detect(MotorDropWatch* w, uint32_t nowMs);
+
+// Échéance de l'unité attendue (ms absolues)
+uint32_t MotorDrop_DeadlineMs(const MotorDropWatch* w);
+
+// Clôt la fenêtre (moteur arrêté): DETECTED ou TIMEOUT, détections suivantes ignorées
+MotorDropState MotorDrop_Finish(MotorDropWatch* w);
+
+void MotorDrop_Record(MotorDropStats* s, const MotorDropWatch* w);
+uint32_t MotorDrop_AverageMs(const MotorDropStats* s);
+
+#endif // MOTOR_DROP_H
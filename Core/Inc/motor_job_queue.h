@@ -0,0 +1,62 @@
+#ifndef MOTOR_JOB_QUEUE_H
+#define MOTOR_JOB_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// File bornée des jobs moteur (canal, nombre d'unités, durée nominale par
+// unité, id). Chaque job porte le callback de son demandeur, appelé une fois
+// par job avec son issue et le nombre d'unités effectivement distribuées.
+// Ids attribués en séquence (0 réservé: refus), ce qui permet au demandeur
+// d'écarter les résultats d'une session précédente. Sans verrou: l'appelant
+// sérialise les accès. Une structure mise à zéro est une file vide valide.
+
+#define MOTOR_JOB_QUEUE_DEPTH  8U
+#define MOTOR_JOB_ID_NONE      0U
+#define MOTOR_JOB_MAX_UNITS    10U    // Unités par job (quantité VEND maximale)
+
+typedef uint16_t MotorJobId;
+
+typedef enum {
+    MOTOR_JOB_DONE = 0,
+    MOTOR_JOB_FAILED,       // Distribution non confirmée
+    MOTOR_JOB_CANCELLED,    // Retiré de la file avant exécution
+    MOTOR_JOB_NO_DROP       // Délai maximal sans chute avant la dernière unité (bourrage, colonne vide)
+} MotorJobStatus;
+
+typedef void (*MotorJobCallback)(MotorJobId id, uint8_t channel, MotorJobStatus status,
+                                 uint8_t delivered, void* ctx);
+
+typedef struct {
+    MotorJobId id;
+    uint8_t channel;
+    uint8_t quantity;
+    uint16_t onTimeMs;      // Par unité
+    MotorJobCallback done;  // NULL: aucun retour
+    void* ctx;
+} MotorJob;
+
+typedef struct {
+    MotorJob slots[MOTOR_JOB_QUEUE_DEPTH];
+    uint8_t head;
+    uint8_t count;
+    uint8_t highWater;      // Profondeur maximale observée
+    MotorJobId lastId;
+    uint32_t rejected;      // Jobs refusés (file pleine)
+} MotorJobQueue;
+
+void MotorJobQueue_Init(MotorJobQueue* q);
+
+// Id du job mis en file, MOTOR_JOB_ID_NONE si la file est pleine
+MotorJobId MotorJobQueue_Push(MotorJobQueue* q, uint8_t channel, uint8_t quantity,
+                              uint16_t onTimeMs, MotorJobCallback done, void* ctx);
+
+// Retire le job le plus ancien (FIFO)
+bool MotorJobQueue_Pop(MotorJobQueue* q, MotorJob* out);
+
+uint8_t MotorJobQueue_Count(const MotorJobQueue* q);
+
+// Vrai si a a été attribué avant b (comparaison tolérante au rebouclage)
+bool MotorJobQueue_IdBefore(MotorJobId a, MotorJobId b);
+
+#endif // MOTOR_JOB_QUEUE_H
@@ -0,0 +1,64 @@
+#ifndef MOTOR_PULSE_H
+#define MOTOR_PULSE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Séquenceur d'impulsion moteur sur un canal de timer en PWM mode 2
+// (sortie active quand CNT >= CCR), registres ARR/CCR préchargés.
+// Une impulsion est une suite de périodes:
+//   sans rampe  une seule période one-pulse: CCR = attente mux, ARR = fin
+//   avec rampe  attente (sortie basse), périodes de porteuse à rapport
+//               cyclique croissant, maintien (CCR = 0)
+// Les deux fronts sont matériels; l'ISR de mise à jour ne fait que précharger
+// la période suivante, puis arme l'arrêt one-pulse (OPM) pendant la dernière.
+// Module pur: aucun accès registre, la couche HAL applique les valeurs.
+
+#define MOTOR_PULSE_CARRIER_US  50U       // Porteuse de la rampe (20 kHz)
+#define MOTOR_PULSE_MAX_TICKS   0xFFFEU   // ARR maximal (CCR = ARR + 1 reste codable)
+
+typedef struct {
+    uint32_t settleUs;      // Stabilisation du multiplexeur, sortie basse
+    uint32_t onUs;          // Durée active, rampe comprise
+    uint32_t softStartUs;   // 0: démarrage franc (bornée à onUs / 2)
+} MotorPulseSpec;
+
+typedef struct {
+    uint16_t psc;
+    uint16_t arr;
+    uint16_t ccr;
+} MotorPulseRegs;
+
+typedef enum {
+    MOTOR_PULSE_PRELOAD = 0,    // Écrire regs: période suivante, prise à la prochaine mise à jour
+    MOTOR_PULSE_LAST,           // Écrire regs (niveau de repos) et armer OPM: la période en cours est la dernière
+    MOTOR_PULSE_DONE            // Compteur arrêté, sortie au repos
+} MotorPulseStep;
+
+typedef struct {
+    uint32_t ticksPerUs;
+    uint32_t settleUs;
+    uint32_t rampUs;
+    uint32_t holdUs;
+    uint32_t onUs;
+    uint16_t rampPeriods;
+    uint16_t periodCount;
+    uint16_t current;           // Période chargée dans le compteur
+    bool preloaded;             // Période current + 1 déjà préchargée
+    bool ended;                 // OPM armé
+    MotorPulseRegs currentRegs;
+    MotorPulseRegs pendingRegs;
+} MotorPulse;
+
+// Prépare l'impulsion et donne les registres de la première période, à
+// charger immédiatement (UG). false si la spécification ou l'horloge est invalide.
+bool MotorPulse_Start(MotorPulse* p, const MotorPulseSpec* spec, uint32_t timerHz, MotorPulseRegs* first);
+
+// Appelée une fois après le chargement de la première période, puis à chaque
+// interruption de mise à jour
+MotorPulseStep MotorPulse_Next(MotorPulse* p, MotorPulseRegs* regs);
+
+// Durée totale attendue (attente + impulsion)
+uint32_t MotorPulse_TotalUs(const MotorPulse* p);
+
+#endif // MOTOR_PULSE_H
@@ -0,0 +1,59 @@
+#ifndef ORCH_EVENT_QUEUE_H
+#define ORCH_EVENT_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "orchestrator.h"
+
+// File d'événements de l'orchestrateur, à deux niveaux de priorité:
+//   CONTROL    clavier, paiement, commandes, moteur, timers internes
+//   TELEMETRY  mesures périodiques (STOCK_LOW)
+// Chaque niveau a son propre stockage: la télémétrie ne peut jamais prendre
+// la place d'un événement de contrôle. Les événements idempotents (même type,
+// même clé) sont fusionnés sur place: la dernière valeur remplace l'ancienne.
+// Sans verrou: l'appelant sérialise Push/Pop (section critique côté service).
+// Une structure mise à zéro est une file vide valide.
+
+#define ORCH_QUEUE_CONTROL_DEPTH    8U
+#define ORCH_QUEUE_TELEMETRY_DEPTH  4U
+
+typedef enum {
+    ORCH_PRIO_CONTROL = 0,
+    ORCH_PRIO_TELEMETRY,
+    ORCH_PRIO_COUNT
+} OrchEventPriority;
+
+typedef enum {
+    ORCH_PUSH_QUEUED = 0,
+    ORCH_PUSH_COALESCED,    // Fusionné avec un événement déjà en file
+    ORCH_PUSH_DROPPED       // Niveau plein: événement perdu (compté)
+} OrchPushResult;
+
+typedef struct {
+    OrchestratorEvent* slots;
+    uint8_t depth;
+    uint8_t head;
+    uint8_t count;
+    uint8_t highWater;
+} OrchEventLevel;
+
+typedef struct {
+    OrchestratorEvent control[ORCH_QUEUE_CONTROL_DEPTH];
+    OrchestratorEvent telemetry[ORCH_QUEUE_TELEMETRY_DEPTH];
+    OrchEventLevel levels[ORCH_PRIO_COUNT];
+    OrchEventTypeStats stats[ORCH_EVT_COUNT];
+} OrchEventQueue;
+
+void OrchEventQueue_Init(OrchEventQueue* q);
+
+// Niveau de priorité d'un type d'événement
+OrchEventPriority OrchEventQueue_PriorityOf(OrchestratorEventType type);
+
+OrchPushResult OrchEventQueue_Push(OrchEventQueue* q, const OrchestratorEvent* evt);
+
+// Retire l'événement le plus prioritaire (FIFO dans un même niveau)
+bool OrchEventQueue_Pop(OrchEventQueue* q, OrchestratorEvent* out);
+
+uint8_t OrchEventQueue_Count(const OrchEventQueue* q);
+
+#endif // ORCH_EVENT_QUEUE_H
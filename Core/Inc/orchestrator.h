@@ -6,6 +6,7 @@
 #include "lcd_service.h"
 #include "motor_service.h"
 #include "cmsis_os.h"
+#include "esp_protocol.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -14,15 +15,20 @@ typedef enum {
     ORCH_EVT_PAYMENT_OK,
     ORCH_EVT_PAYMENT_CANCEL,
     ORCH_EVT_ERROR_MOTOR,
-    ORCH_EVT_DELIVERY_DONE,
+    ORCH_EVT_DELIVERY_DONE,   // Fin d'un job moteur (data.job)
     ORCH_EVT_STOCK_LOW,
     ORCH_EVT_NO_NET,
     ORCH_EVT_ORDER_START,
     ORCH_EVT_VEND_ITEM,
     ORCH_EVT_ORDER_COMPLETE,
-    ORCH_EVT_ORDER_FAILED
+    ORCH_EVT_ORDER_FAILED,
+    ORCH_EVT_ORDER_BATCH,
+    ORCH_EVT_TIMER,           // Échéance d'une étape temporisée (data.code = timer)
+    ORCH_EVT_COUNT
 } OrchestratorEventType;
 
+#define ORCH_STATE_COUNT ((uint8_t)SETTINGS + 1U)
+
 typedef struct {
     OrchestratorEventType type;
     union {
@@ -33,19 +39,55 @@ typedef struct {
             uint8_t mm;
         } stock;      // for ORCH_EVT_STOCK_LOW
         struct {
-            char order_id[32];
+            uint8_t id;           // bloc du pool d'identifiants, rendu par l'orchestrateur
         } order;      // for ORCH_EVT_ORDER_START
         struct {
             uint8_t slot_number;
             uint8_t quantity;
-            char product_id[32];
+            uint8_t product;      // identifiant produit interné (StrIntern)
         } vend;       // for ORCH_EVT_VEND_ITEM
+        struct {
+            const EspOrder* order; // descripteur du service ESP, rendu par EspComm_ReleaseOrder
+        } batch;      // for ORCH_EVT_ORDER_BATCH
+        struct {
+            uint16_t id;          // MotorJobId
+            uint8_t status;       // MotorJobStatus
+            uint8_t tag;          // Article de la file de distribution du job
+            uint8_t delivered;    // Unités tombées (compte partiel si échec)
+        } job;        // for ORCH_EVT_DELIVERY_DONE
     } data;
 } OrchestratorEvent;
 
-extern osMessageQueueId_t orchestratorEventQueueHandle;
+// Instrumentation de la machine à états (ticks RTOS = ms)
+typedef struct {
+    uint32_t transitions;                     // Changements d'état validés
+    uint32_t ignoredEvents;                   // Événements sans transition dans l'état courant
+    uint32_t stateSinceTick;                  // Entrée dans l'état courant
+    uint32_t lastDwellMs;                     // Durée passée dans l'état précédent
+    uint32_t dwellMs[ORCH_STATE_COUNT];       // Cumul par état (hors état courant)
+} OrchestratorStats;
+
+// Compteurs de la file d'événements, par type (orch_event_queue.h)
+typedef struct {
+    uint32_t posted;
+    uint32_t dropped;
+    uint32_t coalesced;
+    uint8_t queued;         // En file actuellement
+    uint8_t highWater;      // Maximum simultané observé
+} OrchEventTypeStats;
 
 void StartTaskOrchestrator(void *argument);
+void Orchestrator_GetStats(OrchestratorStats* out);
+
+// Dépose un événement pour l'orchestrateur (tâches uniquement, jamais depuis
+// une ISR). false si son niveau de priorité est plein: l'événement est perdu.
+bool Orchestrator_PostEvent(const OrchestratorEvent* evt);
+
+// Événements à charge utile: seuls un handle de bloc ou un id interné
+// transitent par la file. false si le pool ou la file est plein.
+bool Orchestrator_PostOrderStart(const char* order_id);
+bool Orchestrator_PostVendItem(uint8_t slot_number, uint8_t quantity, const char* product_id);
+void Orchestrator_GetEventStats(OrchestratorEventType type, OrchEventTypeStats* out);
 
 #endif // ORCHESTRATOR_H
 
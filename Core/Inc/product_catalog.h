@@ -0,0 +1,75 @@
+#ifndef PRODUCT_CATALOG_H
+#define PRODUCT_CATALOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Catalogue produits: code clavier -> canal moteur, capteur de stock, prix,
+// libellé. Un code est une suite de 1 à PRODUCT_CODE_MAX_DIGITS chiffres
+// ("7", "12", "305"; "05" et "5" sont distincts). L'ensemble des codes est
+// sans préfixe: aucun code n'est le début d'un autre, la saisie se conclut
+// donc au dernier chiffre, sans touche de validation.
+// Recherche en temps constant: table directe indexée par (longueur, valeur),
+// une case d'un octet par code possible, reconstruite au chargement quel que
+// soit le nombre de produits.
+// Module pur: persistance et publication à la charge de l'appelant.
+
+#define PRODUCT_CODE_MAX_DIGITS  3U
+#define PRODUCT_CATALOG_MAX      32U
+#define PRODUCT_LABEL_LEN        12U     // '\0' compris (11 caractères affichés)
+#define PRODUCT_SENSOR_NONE      0xFFU   // Produit sans capteur de stock
+#define PRODUCT_INDEX_SIZE       1110U   // 10 + 100 + 1000 codes possibles
+
+// Entrée persistante: 20 octets, sans bourrage
+typedef struct {
+    uint16_t code;              // Valeur décimale des chiffres
+    uint8_t digits;             // Nombre de chiffres saisis (1..PRODUCT_CODE_MAX_DIGITS)
+    uint8_t channel;            // Canal moteur
+    uint8_t sensorId;           // Capteur de stock, PRODUCT_SENSOR_NONE si aucun
+    uint8_t reserved;
+    uint16_t priceCents;
+    char label[PRODUCT_LABEL_LEN];
+} ProductEntry;
+
+// Image du catalogue telle que reçue de l'ESP et sauvegardée en flash
+typedef struct {
+    uint32_t version;           // Attribuée par l'ESP; 0: catalogue intégré
+    uint8_t count;
+    uint8_t reserved[3];
+    ProductEntry entries[PRODUCT_CATALOG_MAX];
+} ProductCatalogImage;
+
+// Catalogue prêt à consulter: image + index direct
+typedef struct {
+    ProductCatalogImage image;
+    uint8_t index[PRODUCT_INDEX_SIZE];
+} ProductCatalog;
+
+typedef enum {
+    PRODUCT_MATCH_NONE = 0,     // Aucun code ne commence par ces chiffres
+    PRODUCT_MATCH_PREFIX,       // Début d'un code plus long: saisie à poursuivre
+    PRODUCT_MATCH_FOUND
+} ProductMatch;
+
+typedef enum {
+    PRODUCT_CATALOG_OK = 0,
+    PRODUCT_CATALOG_ERR_COUNT,      // Vide ou plus de PRODUCT_CATALOG_MAX entrées
+    PRODUCT_CATALOG_ERR_CODE,       // Longueur ou valeur hors bornes
+    PRODUCT_CATALOG_ERR_CHANNEL,    // Canal moteur inexistant
+    PRODUCT_CATALOG_ERR_DUPLICATE,  // Même code deux fois
+    PRODUCT_CATALOG_ERR_PREFIX      // Un code commence un autre code
+} ProductCatalogError;
+
+// Catalogue intégré au firmware: codes historiques 11..13, 21..23
+void ProductCatalog_Default(ProductCatalogImage* image);
+
+// Valide cat->image (canaux 0..channelCount-1) et construit l'index;
+// libellés tronqués à PRODUCT_LABEL_LEN - 1. Index vide en cas d'erreur.
+ProductCatalogError ProductCatalog_Build(ProductCatalog* cat, uint8_t channelCount);
+
+// Chiffres saisis ("\0"-terminés) -> entrée; *entry renseigné si FOUND
+ProductMatch ProductCatalog_Match(const ProductCatalog* cat, const char* digits,
+                                  const ProductEntry** entry);
+
+#endif // PRODUCT_CATALOG_H
@@ -0,0 +1,42 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Buffer circulaire d'octets sans verrou, un seul producteur / un seul
+// consommateur (ex: ISR UART -> tâche). Le producteur ne modifie que head,
+// le consommateur que tail: aucune section critique n'est nécessaire.
+// La taille doit être une puissance de 2 (indices libres masqués).
+typedef struct {
+    uint8_t* buf;
+    uint16_t size;
+    uint16_t mask;
+    volatile uint16_t head;   // Position d'écriture (producteur)
+    volatile uint16_t tail;   // Position de lecture (consommateur)
+} RingBuffer;
+
+// Initialise le buffer sur un stockage fourni; false si size n'est pas une puissance de 2
+bool RingBuffer_Init(RingBuffer* rb, uint8_t* storage, uint16_t size);
+
+// Côté producteur: copie jusqu'à len octets, retourne le nombre réellement écrits
+uint16_t RingBuffer_Write(RingBuffer* rb, const uint8_t* data, uint16_t len);
+
+// Côté consommateur: copie jusqu'à maxLen octets, retourne le nombre lus
+uint16_t RingBuffer_Read(RingBuffer* rb, uint8_t* out, uint16_t maxLen);
+
+// Côté consommateur, sans copie: pointeur et longueur du bloc contigu lisible
+// (s'arrête à la fin du stockage), puis libération après usage (ex: DMA TX)
+uint16_t RingBuffer_PeekContiguous(const RingBuffer* rb, const uint8_t** data);
+void RingBuffer_Skip(RingBuffer* rb, uint16_t len);
+
+// Nombre d'octets disponibles en lecture
+uint16_t RingBuffer_Count(const RingBuffer* rb);
+
+// Place libre côté producteur
+uint16_t RingBuffer_Free(const RingBuffer* rb);
+
+// Position d'écriture courante (marqueur de resynchronisation)
+uint16_t RingBuffer_Head(const RingBuffer* rb);
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,37 @@
+#ifndef STR_INTERN_H
+#define STR_INTERN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Table d'internement de chaînes courtes (identifiants produit): chaque chaîne
+// distincte est copiée une seule fois et désignée ensuite par un id d'un octet.
+// Les entrées ne sont jamais retirées: adaptée à un vocabulaire borné qui se
+// répète (catalogue). Un seul écrivain à la fois (sérialisé par l'appelant);
+// StrIntern_Get est sûr sans verrou, une entrée publiée ne changeant plus.
+
+#define STR_INTERN_MAX_ENTRIES  32U
+#define STR_INTERN_NONE         0xFFU
+
+typedef struct {
+    char* storage;                          // capacity entrées de entryLen octets
+    uint8_t entryLen;                       // Terminateur compris
+    uint8_t capacity;
+    volatile uint8_t count;                 // Entrées publiées
+    uint8_t hash[STR_INTERN_MAX_ENTRIES];   // Empreinte: évite la plupart des strcmp
+    uint32_t rejected;                      // Table pleine ou chaîne trop longue
+} StrIntern;
+
+#define STR_INTERN_STATIC_INIT(storage_, entryLen_, capacity_) { \
+    .storage = (char*)(storage_), .entryLen = (entryLen_), .capacity = (capacity_) }
+
+// false si capacity vaut 0 ou dépasse STR_INTERN_MAX_ENTRIES
+bool StrIntern_Init(StrIntern* t, char* storage, uint8_t entryLen, uint8_t capacity);
+
+// Id de la chaîne (ajoutée si nouvelle), STR_INTERN_NONE si refusée
+uint8_t StrIntern_Intern(StrIntern* t, const char* s);
+
+// Chaîne d'un id ("" si inconnu)
+const char* StrIntern_Get(const StrIntern* t, uint8_t id);
+
+#endif // STR_INTERN_H
@@ -0,0 +1,52 @@
+#ifndef TOF_SCAN_H
+#define TOF_SCAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Cycle de mesure entrelacé des capteurs ToF: toutes les mesures sont
+// lancées d'abord, puis relevées dans l'ordre où elles aboutissent. Un cycle
+// dure alors à peu près la convergence d'un seul capteur, plus les échanges
+// I2C, au lieu de la somme des convergences.
+// Un capteur attendu sort du cycle par un résultat, une erreur signalée par
+// le pilote, ou l'échéance (timeoutMs après l'ouverture). Les capteurs hors
+// service (init échouée) ne sont jamais attendus.
+// Module pur: accès I2C au pilote, horodatage en ms fourni par l'appelant.
+
+#define TOF_SCAN_MAX  8U
+
+typedef struct {
+    uint32_t timeoutMs;
+    uint32_t startMs;           // Ouverture du cycle
+    uint32_t cycleMs;           // Durée du cycle jusqu'au dernier résultat
+    uint8_t count;
+    uint8_t enabled;            // Masques, bit i: capteur i
+    uint8_t pending;            // Résultat attendu
+    uint8_t done;               // Résultat relevé ce cycle
+    uint8_t failed;             // Erreur ou échéance ce cycle
+    uint8_t mm[TOF_SCAN_MAX];
+} TofScan;
+
+// Tous les capteurs en service
+void TofScan_Init(TofScan* s, uint8_t count, uint32_t timeoutMs);
+void TofScan_SetEnabled(TofScan* s, uint8_t id, bool enabled);
+
+// Ouvre un cycle: tous les capteurs en service deviennent attendus
+void TofScan_Begin(TofScan* s, uint32_t nowMs);
+
+// Résultat d'un capteur attendu; false s'il ne l'était pas (ignoré)
+bool TofScan_Ready(TofScan* s, uint8_t id, uint8_t mm, uint32_t nowMs);
+
+// Erreur du pilote (lancement ou lecture)
+void TofScan_Fail(TofScan* s, uint8_t id);
+
+// Attendus au-delà de l'échéance: en échec. Retourne leur masque
+uint8_t TofScan_Expire(TofScan* s, uint32_t nowMs);
+
+uint32_t TofScan_DeadlineMs(const TofScan* s);
+
+static inline bool TofScan_Complete(const TofScan* s) {
+    return s->pending == 0;
+}
+
+#endif // TOF_SCAN_H
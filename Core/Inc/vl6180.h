@@ -0,0 +1,66 @@
+#ifndef VL6180_H
+#define VL6180_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Pilote registre du VL6180X (adresses de registre sur 16 bits). Chaque
+// accès est une transaction « mémoire »: adresse de registre puis données
+// sans arrêt, la lecture repartant en redémarrage (repeated start), et les
+// registres voisins passent en rafale (auto-incrément du capteur):
+//   - lancement: acquittement + lancement en une écriture (0x015..0x018)
+//   - relevé: statut de mesure, statut d'interruption et distance en une
+//     lecture (0x04D..0x062)
+// Soit deux transactions par échantillon en mesure unique, au lieu de
+// quatre en écriture d'adresse puis lecture séparées.
+// Module pur: transport fourni par l'appelant (Vl6180Bus), adresses 8 bits.
+
+#define VL6180_SYSTEM_MODE_GPIO1                0x011
+#define VL6180_SYSTEM_INTERRUPT_CONFIG_GPIO     0x014
+#define VL6180_SYSTEM_INTERRUPT_CLEAR           0x015
+#define VL6180_SYSTEM_FRESH_OUT_OF_RESET        0x016
+#define VL6180_SYSTEM_GROUPED_PARAMETER_HOLD    0x017
+#define VL6180_SYSRANGE_START                   0x018
+#define VL6180_SYSRANGE_INTERMEASUREMENT_PERIOD 0x01b
+#define VL6180_RESULT_RANGE_STATUS              0x04d
+#define VL6180_RESULT_INTERRUPT_STATUS_GPIO     0x04f
+#define VL6180_RESULT_RANGE_VAL                 0x062
+#define VL6180_I2C_SLAVE_DEVICE_ADDRESS         0x212
+
+// Bloc résultat lu d'une traite, de RANGE_STATUS à RANGE_VAL inclus
+#define VL6180_RESULT_BLOCK_LEN  (VL6180_RESULT_RANGE_VAL - VL6180_RESULT_RANGE_STATUS + 1)
+
+#define VL6180_RANGE_MM_MAX      255U    // Aucune cible dans la portée
+
+// Écrit len octets à partir de reg / lit len octets à partir de reg, en une
+// transaction; false en cas d'erreur bus
+typedef bool (*Vl6180WriteFn)(uint16_t addr8, uint16_t reg, const uint8_t* data, uint8_t len, void* ctx);
+typedef bool (*Vl6180ReadFn)(uint16_t addr8, uint16_t reg, uint8_t* data, uint8_t len, void* ctx);
+
+typedef struct {
+    Vl6180WriteFn write;
+    Vl6180ReadFn read;
+    void* ctx;
+} Vl6180Bus;
+
+// Capteur à addr8 (adresse par défaut après sa sortie de SHUTDOWN) déplacé
+// à new7bit
+bool Vl6180_SetAddress(const Vl6180Bus* bus, uint16_t addr8, uint8_t new7bit);
+
+// Fin de mesure sur GPIO1 (sortie d'interruption active basse), interruptions
+// acquittées. periodMs: 0 pour des mesures uniques (Vl6180_Start), sinon
+// mesure continue à cette période (multiple de 10 ms, 2550 ms au plus)
+bool Vl6180_Init(const Vl6180Bus* bus, uint16_t addr8, uint16_t periodMs);
+
+// Mesure unique: acquitte le résultat précédent (relâche GPIO1) et lance
+bool Vl6180_Start(const Vl6180Bus* bus, uint16_t addr8);
+
+// Relevé d'un échantillon signalé. Distance en mm, VL6180_RANGE_MM_MAX sans
+// cible (hors portée, signal trop faible), 0 cible trop proche; false sur
+// erreur bus, erreur matérielle du capteur ou échantillon absent
+bool Vl6180_ReadSample(const Vl6180Bus* bus, uint16_t addr8, uint8_t* mm);
+
+// Relâche GPIO1 sans relancer (mesure continue, résultat non relevé)
+bool Vl6180_ClearInterrupt(const Vl6180Bus* bus, uint16_t addr8);
+
+#endif // VL6180_H
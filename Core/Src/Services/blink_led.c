@@ -1,6 +1,8 @@
 // blink_led_task.c
 #include "blink_led.h"
+#include "main.h"
 #include "motor_service.h"
+#include "sensor_stock_service.h"
 
 volatile uint8_t ledBlinkActive = 0;
 
@@ -26,5 +28,9 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
     if (GPIO_Pin == GPIO_PIN_13) {
         ledBlinkActive = !ledBlinkActive;
         printf("Bouton pressé ! ledBlinkActive = %d\r\n", ledBlinkActive);
+    } else if (GPIO_Pin == DROP_BEAM_Pin) {
+        MotorService_DropDetectedFromISR();
+    } else {
+        SensorStock_SampleReadyFromISR(GPIO_Pin);
     }
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "catalog_service.h"
+#include "flash_log.h"
+#include "flash_sector.h"
+#include "motor_service.h"
+#include "global.h"
+
+// Deux banques: active (lue par l'orchestrateur) et préparation (remplie par
+// la tâche ESP). Seul catalogActive change de main, en une écriture.
+static ProductCatalog catalogBanks[2];
+static volatile uint8_t catalogActive = 0;
+static bool catalogStaging = false;
+
+static FlashLog catalogLog;
+static FlashSectorZone catalogZone = { FLASH_SECTOR_CATALOG_ADDR, FLASH_SECTOR_6 };
+
+static ProductCatalog* catalog_staged(void) {
+    return &catalogBanks[catalogActive ^ 1U];
+}
+
+void CatalogService_Init(void) {
+    ProductCatalog* cat = &catalogBanks[0];
+    FlashLogConfig cfg = {
+        .base = (const uint8_t*)FLASH_SECTOR_CATALOG_ADDR,
+        .size = FLASH_SECTOR_ZONE_SIZE,
+        .magic = CATALOG_MAGIC,
+        .payloadSize = sizeof(ProductCatalogImage),
+        .program = FlashSector_Program,
+        .erase = FlashSector_Erase,
+        .ctx = &catalogZone,
+    };
+    FlashLog_Init(&catalogLog, &cfg);
+    catalogActive = 0;
+    catalogStaging = false;
+
+    if (FlashLog_Read(&catalogLog, &cat->image)) {
+        ProductCatalogError err = ProductCatalog_Build(cat, MOTOR_CHANNEL_COUNT);
+        if (err == PRODUCT_CATALOG_OK) {
+            printf("Catalog: version %lu restored (%u products)\r\n",
+                   (unsigned long)cat->image.version, cat->image.count);
+            return;
+        }
+        LOGW("Catalog: saved catalog rejected (%d), built-in used\r\n", err);
+    }
+    ProductCatalog_Default(&cat->image);
+    ProductCatalog_Build(cat, MOTOR_CHANNEL_COUNT);
+    printf("Catalog: built-in (%u products)\r\n", cat->image.count);
+}
+
+ProductMatch CatalogService_Match(const char* digits, ProductEntry* entry) {
+    const ProductEntry* found = NULL;
+    ProductMatch m = ProductCatalog_Match(&catalogBanks[catalogActive], digits, &found);
+    if (m == PRODUCT_MATCH_FOUND && entry != NULL) *entry = *found;
+    return m;
+}
+
+void CatalogService_Abort(void) {
+    catalogStaging = false;
+}
+
+uint8_t CatalogService_Begin(uint16_t version) {
+    ProductCatalog* cat = catalog_staged();
+    memset(&cat->image, 0, sizeof(cat->image));
+    cat->image.version = version;
+    catalogStaging = true;
+    return ESP_CODE_NONE;
+}
+
+uint8_t CatalogService_AddItem(const ProductEntry* entry) {
+    if (!catalogStaging) return ESP_CODE_CATALOG_FORMAT;
+    ProductCatalogImage* img = &catalog_staged()->image;
+    if (img->count >= PRODUCT_CATALOG_MAX) {
+        catalogStaging = false;
+        return ESP_CODE_CATALOG_INVALID;
+    }
+    img->entries[img->count++] = *entry;
+    return ESP_CODE_NONE;
+}
+
+uint8_t CatalogService_Commit(uint8_t count) {
+    if (!catalogStaging) return ESP_CODE_CATALOG_FORMAT;
+    catalogStaging = false;
+
+    ProductCatalog* cat = catalog_staged();
+    if (cat->image.count != count) return ESP_CODE_CATALOG_INVALID;
+
+    ProductCatalogError err = ProductCatalog_Build(cat, MOTOR_CHANNEL_COUNT);
+    if (err != PRODUCT_CATALOG_OK) {
+        LOGW("Catalog: version %u rejected (%d)\r\n", (unsigned)cat->image.version, err);
+        return ESP_CODE_CATALOG_INVALID;
+    }
+
+    // La sauvegarde fige la flash, interruptions comprises (effacement: jusqu'à
+    // 2 s): seulement moteur à l'arrêt et file vide. Ordonnanceur verrouillé du
+    // contrôle à la fin de l'écriture: aucun job ne peut démarrer entre les deux
+    int32_t lock = osKernelLock();
+    if (!MotorService_IsIdle()) {
+        osKernelRestoreLock(lock);
+        return ESP_CODE_CATALOG_BUSY;
+    }
+    bool saved = FlashLog_Append(&catalogLog, &cat->image);
+    osKernelRestoreLock(lock);
+    if (!saved) {
+        LOGE("Catalog: save failed\r\n");
+        return ESP_CODE_CATALOG_STORAGE;
+    }
+
+    // Index et image complets avant la bascule
+    __DMB();
+    catalogActive ^= 1U;
+    printf("Catalog: version %u active (%u products)\r\n", (unsigned)cat->image.version, cat->image.count);
+    return ESP_CODE_NONE;
+}
@@ -1,17 +1,129 @@
 #include "esp_communication_service.h"
 #include "orchestrator.h"
+#include "motor_service.h"
+#include "catalog_service.h"
 #include "watchdog_service.h"
+#include "ring_buffer.h"
+#include "esp_frame.h"
+#include "esp_link_handshake.h"
+#include "esp_seq.h"
 #include <string.h>
-#include <ctype.h>
 #include <stdio.h>
 
 #define UART_BUFFER_SIZE 128
 #define UART_MAX_LINE_LENGTH (UART_BUFFER_SIZE - 1)
+// Réception: la plus longue ligne attendue est une ORDER numérotée
+// ("#255:" + ESP_PROTO_ORDER_TEXT_MAX), ou une trame ORDER en mode binaire
+#define ESP_RX_SEQ_PREFIX_MAX 5
+#define ESP_RX_TEXT_LINE_MAX (ESP_RX_SEQ_PREFIX_MAX + ESP_PROTO_ORDER_TEXT_MAX)
+#define ESP_RX_LINE_MAX ((ESP_RX_TEXT_LINE_MAX > ESP_FRAME_MAX_RX_ENCODED - 1) ? \
+                         ESP_RX_TEXT_LINE_MAX : (ESP_FRAME_MAX_RX_ENCODED - 1))
 #define UART_MAX_INVALID_CHARS 10
 #define UART_TIMEOUT_MS 1000
+// Erreurs de ligne côté réception (bloquantes en mode DMA: le HAL arrête la réception)
+#define ESP_UART_RX_ERRORS (HAL_UART_ERROR_ORE | HAL_UART_ERROR_FE | HAL_UART_ERROR_NE | HAL_UART_ERROR_PE)
 
-static uint8_t rxByte1;
-static char lineBuf1[UART_BUFFER_SIZE];
+// Buffer DMA circulaire USART1: les événements IDLE, demi-transfert et
+// transfert complet livrent les octets par blocs au lieu d'une IT par octet
+#define ESP_RX_DMA_BUFFER_SIZE 256
+
+// Ring SPSC entre l'ISR (producteur) et la tâche ESP (consommateur):
+// l'ISR ne fait que copier, l'assemblage et le dispatch des lignes
+// s'exécutent en contexte tâche
+#define ESP_RX_RING_SIZE 512
+#define ESP_RX_CHUNK_SIZE 64
+#define ESP_TASK_WAIT_MS 500
+#define ESP_HEARTBEAT_PERIOD_MS 2000
+
+// Perte du lien: rafale d'erreurs de réception (débit désaccordé après un
+// redémarrage de l'ESP, trames illisibles) -> nouvelle négociation à 115200
+#define ESP_LINK_LOSS_ERRORS 8
+#define ESP_LINK_LOSS_WINDOW_MS 1000
+#define ESP_TX_DRAIN_TIMEOUT_MS 50
+
+static uint8_t rxDmaBuf1[ESP_RX_DMA_BUFFER_SIZE];
+static uint16_t rxDmaReadPos1 = 0;
+static volatile EspLinkStats linkStats1 = {0};
+
+static uint8_t rxRingStorage1[ESP_RX_RING_SIZE];
+static RingBuffer rxRing1;
+static TaskHandle_t espTaskHandleLocal = NULL;
+
+// Files d'émission, une par canal logique: rings multi-producteurs (section
+// critique courte) vidés par DMA2 Stream7. Chaque message y est écrit d'un bloc;
+// la longueur de chaque enregistrement est gardée à part pour que l'ordonnanceur
+// ne change de canal qu'entre deux enregistrements.
+#define ESP_TX_RING_SIZE 1024
+#define ESP_TX_BULK_RING_SIZE 1024
+#define ESP_TX_DIAG_RING_SIZE 512
+#define ESP_TX_RECORDS_MAX 32
+// Morceau d'une ligne longue: ~6 ms à 115200, < 1 ms à 921600
+#define ESP_TX_CHUNK_SIZE 64
+#define ESP_TX_CHUNK_HEADER 4      // "%<canal><+|.>:"
+// Un transfert DMA regroupe des enregistrements du même canal dans cette limite
+#define ESP_TX_BURST_MAX (ESP_TX_CHUNK_HEADER + ESP_TX_CHUNK_SIZE + 2)
+
+typedef struct {
+    RingBuffer ring;
+    uint16_t len[ESP_TX_RECORDS_MAX];   // Octets restant à émettre par enregistrement
+    volatile uint8_t head;
+    volatile uint8_t count;
+} EspTxChannel;
+
+static uint8_t txControlStorage1[ESP_TX_RING_SIZE];
+static uint8_t txBulkStorage1[ESP_TX_BULK_RING_SIZE];
+static uint8_t txDiagStorage1[ESP_TX_DIAG_RING_SIZE];
+// Initialisé statiquement: EspComm_SendLine peut précéder le démarrage de la tâche
+static EspTxChannel txChan1[ESP_CHANNEL_COUNT] = {
+    [ESP_CHANNEL_CONTROL]   = { .ring = { .buf = txControlStorage1, .size = ESP_TX_RING_SIZE,
+                                          .mask = ESP_TX_RING_SIZE - 1 } },
+    [ESP_CHANNEL_TELEMETRY] = { .ring = { .buf = txBulkStorage1, .size = ESP_TX_BULK_RING_SIZE,
+                                          .mask = ESP_TX_BULK_RING_SIZE - 1 } },
+    [ESP_CHANNEL_DIAG]      = { .ring = { .buf = txDiagStorage1, .size = ESP_TX_DIAG_RING_SIZE,
+                                          .mask = ESP_TX_DIAG_RING_SIZE - 1 } },
+};
+static volatile uint16_t txInFlight1 = 0;   // Octets du transfert DMA en cours
+static volatile uint8_t txInFlightCh1 = 0;  // Canal du transfert en cours
+static volatile int8_t txResumeCh1 = -1;    // Canal dont l'enregistrement de tête est entamé
+
+// Canaux étiquetés et découpage des lignes longues (capacité ESP_CAP_CHANNELS)
+static volatile bool channelsEnabled1 = false;
+
+// Mode de transport du lien (texte par défaut). Lu à chaque octet reçu et à
+// chaque envoi; l'assembleur repart de zéro quand il observe un changement.
+static volatile EspLinkMode linkMode1 = ESP_LINK_MODE_TEXT;
+static EspLinkMode rxAssemblyMode1 = ESP_LINK_MODE_TEXT;
+
+// Négociation HELLO / débit (contexte tâche uniquement)
+static EspHandshake linkHs1;
+static uint32_t linkLossWindowStart = 0;
+static uint32_t linkLossErrorBase = 0;
+
+static void EspComm_ApplyHandshake(const EspHsAction* act);
+static uint8_t EspComm_CommitCatalog(uint8_t count);
+
+// Numérotation des messages (capacité ESP_CAP_SEQUENCED). La fenêtre d'émission
+// est partagée avec les tâches qui envoient des réponses: section critique.
+static volatile bool seqEnabled1 = false;
+static EspSeqRx seqRx1;
+static EspSeqTx seqTx1;
+
+static bool EspComm_EmitResponse(const EspResponse* rsp, int seq);
+
+// Commande groupée: un seul descripteur, réservé à la réception et rendu par
+// l'orchestrateur; l'événement ne transporte qu'un pointeur
+static EspOrder stagedOrder1;
+static volatile bool stagedOrderBusy1 = false;
+static EspResponseCode stagedOrderError1 = ESP_CODE_NONE;
+
+// Resynchronisation demandée par l'ISR d'erreur: la ligne en cours est
+// abandonnée quand la tâche atteint la position d'écriture marquée
+static volatile bool rxResyncPending = false;
+static volatile uint16_t rxResyncMark = 0;
+
+static char lineBuf1[ESP_RX_LINE_MAX + 1];
+// Trame décodée: hors pile, la tâche ESP n'a que 1 Ko
+static uint8_t rxFrameWork1[ESP_FRAME_MAX_RX_RAW];
 static size_t lineLen1 = 0;
 static uint32_t invalidCharCount = 0;
 static uint32_t lastRxTimestamp = 0;
@@ -23,103 +135,114 @@ static uint8_t totalItems = 0;
 static uint8_t deliveredItems = 0;
 
 
-// Fonction helper pour parser une commande VEND
-static bool parse_vend_command(const char* line, uint8_t* slot_number, uint8_t* quantity, char* product_id) {
-    if (!line || !slot_number || !quantity || !product_id) return false;
-    
-    // Format attendu: "VEND <slot_number> <quantity> <product_id>"
-    int parsed_slot, parsed_qty;
-    char parsed_product[32];
-    
-    if (sscanf(line, "VEND %d %d %31s", &parsed_slot, &parsed_qty, parsed_product) == 3) {
-        if (parsed_slot >= 1 && parsed_slot <= 4 && parsed_qty >= 1 && parsed_qty <= 10) {
-            *slot_number = (uint8_t)parsed_slot;
-            *quantity = (uint8_t)parsed_qty;
-            strncpy(product_id, parsed_product, 31);
-            product_id[31] = '\0';
-            return true;
-        }
+// Réserve le descripteur et y décode les articles (texte: line, trame: payload).
+// L'échec est gardé dans stagedOrderError1 pour le NAK envoyé au dispatch.
+static bool EspComm_StageOrder(const char* line, const uint8_t* payload, size_t payloadLen) {
+    if (stagedOrderBusy1) {
+        stagedOrderError1 = ESP_CODE_ORDER_BUSY;
+        return false;
+    }
+    bool ok = line ? EspProtocol_DecodeOrder(line, &stagedOrder1)
+                   : EspFrame_ToOrder(payload, payloadLen, &stagedOrder1);
+    if (!ok) {
+        stagedOrderError1 = ESP_CODE_INVALID_ORDER_FORMAT;
+        return false;
     }
-    return false;
+    stagedOrderBusy1 = true;
+    stagedOrderError1 = ESP_CODE_NONE;
+    return true;
 }
 
-// Fonction helper pour extraire l'ID de commande
-static bool parse_order_start(const char* line, char* order_id) {
-    if (!line || !order_id) return false;
-    
-    // Format attendu: "ORDER_START:<order_id>"
-    if (sscanf(line, "ORDER_START:%31s", order_id) == 1) {
-        return true;
+void EspComm_ReleaseOrder(const EspOrder* order) {
+    if (order == &stagedOrder1) {
+        stagedOrderBusy1 = false;
     }
-    return false;
 }
 
-static void process_line_uart1(const char* line) {
-    if (!line) return;
-    EspMessageType type = EspComm_ClassifyMessage(line);
-    switch (type) {
+// Dispatch d'une commande décodée (ligne texte ou trame binaire);
+// line est NULL pour une trame binaire
+static void process_command(const EspCommand* cmd, const char* line) {
+    const char* desc = line ? line : "<frame>";
+    switch (cmd->type) {
         case ESP_MSG_NFC_UID: {
             OrchestratorEvent evt = { .type = ORCH_EVT_PAYMENT_OK };
-            osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
+            Orchestrator_PostEvent(&evt);
             break;
         }
         case ESP_MSG_NFC_ERR: {
             OrchestratorEvent evt = { .type = ORCH_EVT_PAYMENT_CANCEL };
-            osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
+            Orchestrator_PostEvent(&evt);
             break;
         }
         case ESP_MSG_NAK_PAYING_NO_NET: {
             OrchestratorEvent evt = { .type = ORCH_EVT_NO_NET };
-            osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
+            Orchestrator_PostEvent(&evt);
             break;
         }
         case ESP_MSG_NAK_PAYMENT_DENIED: {
             OrchestratorEvent evt = { .type = ORCH_EVT_PAYMENT_CANCEL };
-            osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
+            Orchestrator_PostEvent(&evt);
             break;
         }
         case ESP_MSG_ORDER_START: {
-            if (parse_order_start(line, currentOrderId)) {
+            if (cmd->valid) {
+                strncpy(currentOrderId, cmd->order_id, sizeof(currentOrderId) - 1);
+                currentOrderId[sizeof(currentOrderId) - 1] = '\0';
                 orderInProgress = true;
                 totalItems = 0;
                 deliveredItems = 0;
                 
-                OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_START };
-                strncpy(evt.data.order.order_id, currentOrderId, sizeof(evt.data.order.order_id) - 1);
-                evt.data.order.order_id[sizeof(evt.data.order.order_id) - 1] = '\0';
-                osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
+                Orchestrator_PostOrderStart(currentOrderId);
                 
                 // Confirmer la réception de la commande
-                EspComm_SendLine("ORDER_ACK");
+                EspResponse rsp = { .type = ESP_RSP_ORDER_ACK };
+                EspComm_SendResponse(&rsp);
                 printf("[ESP_UART] Order started: %s\r\n", currentOrderId);
             }
             break;
         }
+        case ESP_MSG_ORDER_BATCH: {
+            if (!cmd->valid) {
+                printf("[ESP_UART] Order batch refused: %s\r\n", desc);
+                EspResponse rsp = { .type = ESP_RSP_ORDER_NAK, .code = stagedOrderError1 };
+                EspComm_SendResponse(&rsp);
+                break;
+            }
+
+            // Une seule entrée dans la queue pour toute la commande
+            OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_BATCH };
+            evt.data.batch.order = &stagedOrder1;
+            if (!Orchestrator_PostEvent(&evt)) {
+                EspComm_ReleaseOrder(&stagedOrder1);
+                EspResponse rsp = { .type = ESP_RSP_ORDER_NAK, .code = ESP_CODE_ORDER_BUSY };
+                EspComm_SendResponse(&rsp);
+                break;
+            }
+            EspResponse rsp = { .type = ESP_RSP_ORDER_ACK };
+            EspComm_SendResponse(&rsp);
+            printf("[ESP_UART] Order batch: %s (%u items)\r\n",
+                   stagedOrder1.order_id, stagedOrder1.item_count);
+            break;
+        }
         case ESP_MSG_VEND_COMMAND: {
             if (!orderInProgress) {
                 printf("[ESP_UART] VEND command received without active order\r\n");
-                EspComm_SendLine("ORDER_NAK:NO_ACTIVE_ORDER");
+                EspResponse rsp = { .type = ESP_RSP_ORDER_NAK, .code = ESP_CODE_NO_ACTIVE_ORDER };
+                EspComm_SendResponse(&rsp);
                 break;
             }
             
-            uint8_t slot_number, quantity;
-            char product_id[32];
-            
-            if (parse_vend_command(line, &slot_number, &quantity, product_id)) {
+            if (cmd->valid) {
                 totalItems++;
                 
-                OrchestratorEvent evt = { .type = ORCH_EVT_VEND_ITEM };
-                evt.data.vend.slot_number = slot_number;
-                evt.data.vend.quantity = quantity;
-                strncpy(evt.data.vend.product_id, product_id, sizeof(evt.data.vend.product_id) - 1);
-                evt.data.vend.product_id[sizeof(evt.data.vend.product_id) - 1] = '\0';
-                osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
+                Orchestrator_PostVendItem(cmd->slot_number, cmd->quantity, cmd->product_id);
                 
                 printf("[ESP_UART] VEND command: slot=%d, qty=%d, product=%s\r\n", 
-                       slot_number, quantity, product_id);
+                       cmd->slot_number, cmd->quantity, cmd->product_id);
             } else {
-                printf("[ESP_UART] Invalid VEND command format: %s\r\n", line);
-                EspComm_SendLine("ORDER_NAK:INVALID_VEND_FORMAT");
+                printf("[ESP_UART] Invalid VEND command format: %s\r\n", desc);
+                EspResponse rsp = { .type = ESP_RSP_ORDER_NAK, .code = ESP_CODE_INVALID_VEND_FORMAT };
+                EspComm_SendResponse(&rsp);
             }
             break;
         }
@@ -128,7 +251,7 @@ static void process_line_uart1(const char* line) {
                 orderInProgress = false;
                 
                 OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_COMPLETE };
-                osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
+                Orchestrator_PostEvent(&evt);
                 
                 printf("[ESP_UART] Order completed: %s (total items: %d)\r\n", 
                        currentOrderId, totalItems);
@@ -144,34 +267,238 @@ static void process_line_uart1(const char* line) {
             if (orderInProgress) {
                 orderInProgress = false;
                 OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_FAILED };
-                osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
-                printf("[ESP_UART] Order failed/cancelled: %s\r\n", line);
+                Orchestrator_PostEvent(&evt);
+                printf("[ESP_UART] Order failed/cancelled: %s\r\n", desc);
+            }
+            break;
+        }
+        case ESP_MSG_DIAG_CALIB: {
+            // Une ligne (ou trame CAL) par canal moteur, derrière le trafic de contrôle
+            char diag[40];
+            uint8_t frame[11];
+            MotorCalibRecord rec;
+            bool binary = (EspComm_GetLinkMode() == ESP_LINK_MODE_BINARY);
+            for (uint8_t ch = 0; MotorService_GetCalibration(ch, &rec); ch++) {
+                bool sent;
+                if (binary) {
+                    frame[0] = ch;
+                    EspFrame_PutU16(&frame[1], rec.onTimeMs);
+                    EspFrame_PutU16(&frame[3], rec.settleMs);
+                    EspFrame_PutU16(&frame[5], rec.avgDispenseMs);
+                    EspFrame_PutU16(&frame[7], rec.successes);
+                    EspFrame_PutU16(&frame[9], rec.attempts);
+                    sent = EspComm_SendFrameOn(ESP_CHANNEL_DIAG, ESP_FRAME_CAL, frame, sizeof(frame));
+                } else {
+                    if (MotorCalib_Format(ch, &rec, diag, sizeof(diag)) == 0) continue;
+                    sent = EspComm_SendLineOn(ESP_CHANNEL_DIAG, diag);
+                }
+                if (!sent) break;
+            }
+            break;
+        }
+        case ESP_MSG_CATALOG_BEGIN:
+        case ESP_MSG_CATALOG_ITEM:
+        case ESP_MSG_CATALOG_END: {
+            // Entrées silencieuses, une seule réponse: à la fin ou au premier refus
+            uint8_t code = ESP_CODE_CATALOG_FORMAT;
+            if (!cmd->valid) {
+                CatalogService_Abort();
+            } else if (cmd->type == ESP_MSG_CATALOG_BEGIN) {
+                code = CatalogService_Begin(cmd->catalog_version);
+            } else if (cmd->type == ESP_MSG_CATALOG_ITEM) {
+                code = CatalogService_AddItem(&cmd->product);
+            } else {
+                code = EspComm_CommitCatalog(cmd->catalog_count);
+                if (code == ESP_CODE_NONE) {
+                    EspResponse rsp = { .type = ESP_RSP_CATALOG_ACK };
+                    EspComm_SendResponse(&rsp);
+                }
+            }
+            if (code != ESP_CODE_NONE) {
+                printf("[ESP_UART] Catalog update refused: %s\r\n", desc);
+                EspResponse rsp = { .type = ESP_RSP_CATALOG_NAK, .code = code };
+                EspComm_SendResponse(&rsp);
             }
             break;
         }
         case ESP_MSG_UNKNOWN:
         default:
-            printf("[ESP_UART] Unknown message: %s\r\n", line);
+            printf("[ESP_UART] Unknown message: %s\r\n", desc);
+            break;
+    }
+}
+
+// Acquit cumulatif ou demande de retransmission vers l'ESP (non numérotés)
+static void EspComm_SendSeqControl(bool nak, uint8_t seq) {
+    if (linkMode1 == ESP_LINK_MODE_BINARY) {
+        EspComm_SendFrame(nak ? ESP_FRAME_SEQ_NAK : ESP_FRAME_SEQ_ACK, &seq, 1);
+    } else {
+        char line[12];
+        snprintf(line, sizeof(line), "#%s:%u", nak ? "NAK" : "ACK", seq);
+        EspComm_SendLine(line);
+    }
+}
+
+// Commande numérotée: livrée dans l'ordre, gardée si en avance, ré-acquittée si doublon.
+// ORDER groupée (articles dans line ou payload): le descripteur n'est réservé
+// qu'à la livraison. Un doublon ou une commande hors fenêtre ne le touche pas;
+// en avance d'un trou elle n'est pas gardée (ses articles ne tiennent pas dans
+// EspCommand): sans acquit, l'ESP la renverra
+static void process_sequenced(uint8_t seq, EspCommand* cmd, const char* line,
+                              const uint8_t* payload, size_t payloadLen) {
+    EspCommand next;
+    EspSeqRxResult r;
+
+    if (cmd->type == ESP_MSG_ORDER_BATCH) {
+        r = EspSeq_RxCheck(&seqRx1, seq);
+        if (r == ESP_SEQ_RX_DELIVER) {
+            cmd->valid = EspComm_StageOrder(line, payload, payloadLen);
+            EspSeq_RxAccept(&seqRx1, seq, cmd);
+        }
+    } else {
+        r = EspSeq_RxAccept(&seqRx1, seq, cmd);
+    }
+
+    switch (r) {
+        case ESP_SEQ_RX_DELIVER:
+            process_command(cmd, line);
+            while (EspSeq_RxNext(&seqRx1, &next)) {
+                process_command(&next, NULL);
+            }
+            EspComm_SendSeqControl(false, EspSeq_RxAckValue(&seqRx1));
+            break;
+        case ESP_SEQ_RX_BUFFERED:
+            // Trou avant seq: une seule demande par trou, l'ESP ne renvoie que lui
+            linkStats1.seqGaps++;
+            if (!seqRx1.nakSent) {
+                seqRx1.nakSent = true;
+                EspComm_SendSeqControl(true, seqRx1.expected);
+            }
+            break;
+        case ESP_SEQ_RX_DUPLICATE:
+            linkStats1.seqDuplicates++;
+            EspComm_SendSeqControl(false, EspSeq_RxAckValue(&seqRx1));
+            break;
+        default:
+            linkStats1.seqRejected++;
+            LOGW("[ESP_UART] Sequence %u out of window (expected %u)\r\n", seq, seqRx1.expected);
+            EspComm_SendSeqControl(true, seqRx1.expected);
             break;
     }
 }
 
+// Acquit / demande de retransmission reçus de l'ESP pour nos réponses
+static void process_seq_control(bool nak, uint8_t seq) {
+    if (!nak) {
+        taskENTER_CRITICAL();
+        EspSeq_TxAck(&seqTx1, seq);
+        taskEXIT_CRITICAL();
+        return;
+    }
+
+    EspResponse rsp;
+    const EspResponse* held;
+    taskENTER_CRITICAL();
+    held = EspSeq_TxGet(&seqTx1, seq, HAL_GetTick());
+    if (held) rsp = *held;
+    taskEXIT_CRITICAL();
+
+    if (held) {
+        linkStats1.seqRetransmits++;
+        EspComm_EmitResponse(&rsp, seq);
+    }
+}
+
+static void process_line_uart1(const char* line) {
+    if (!line) return;
+
+    // Messages de négociation du lien, traités avant le protocole applicatif
+    EspHsAction act;
+    if (EspHandshake_OnLine(&linkHs1, line, HAL_GetTick(), &act)) {
+        EspComm_ApplyHandshake(&act);
+        return;
+    }
+
+    // Lignes numérotées "#<seq>:", "#ACK:", "#NAK:"
+    uint8_t seq;
+    const char* body = line;
+    EspSeqLineKind kind = EspSeq_ParseLine(line, &seq, &body);
+    if (kind == ESP_SEQ_LINE_ACK || kind == ESP_SEQ_LINE_NAK) {
+        process_seq_control(kind == ESP_SEQ_LINE_NAK, seq);
+        return;
+    }
+    if (kind == ESP_SEQ_LINE_INVALID) {
+        linkStats1.seqRejected++;
+        LOGW("[ESP_UART] Invalid sequenced line: %s\r\n", line);
+        return;
+    }
+
+    // Classification et extraction des arguments en un seul parcours
+    EspCommand cmd;
+    EspProtocol_Decode(body, &cmd);
+    if (kind == ESP_SEQ_LINE_DATA) {
+        process_sequenced(seq, &cmd, body, NULL, 0);
+        return;
+    }
+    if (cmd.type == ESP_MSG_ORDER_BATCH) {
+        cmd.valid = EspComm_StageOrder(body, NULL, 0);
+    }
+    process_command(&cmd, line);
+}
+
+// Trame binaire reçue (sans délimiteur): COBS, longueur et CRC vérifiés
+static void process_frame_uart1(const uint8_t* frame, size_t len) {
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+
+    EspFrameStatus st = EspFrame_Decode(frame, len, rxFrameWork1, sizeof(rxFrameWork1), &type,
+                                        &payload, &payloadLen);
+    if (st == ESP_FRAME_ERR_CRC) {
+        linkStats1.crcErrors++;
+        LOGW("[ESP_UART] Frame CRC error (len=%u)\r\n", (unsigned)len);
+        return;
+    }
+    if (st != ESP_FRAME_OK) {
+        linkStats1.frameErrors++;
+        LOGW("[ESP_UART] Invalid frame (status=%d)\r\n", (int)st);
+        return;
+    }
+    linkStats1.rxFrames++;
+
+    if ((type == ESP_FRAME_SEQ_ACK || type == ESP_FRAME_SEQ_NAK) && payloadLen == 1) {
+        process_seq_control(type == ESP_FRAME_SEQ_NAK, payload[0]);
+        return;
+    }
+
+    // Enveloppe numérotée: [seq][type][payload]
+    bool sequenced = false;
+    uint8_t seq = 0;
+    if (type == ESP_FRAME_SEQ && payloadLen >= 2) {
+        sequenced = true;
+        seq = payload[0];
+        type = payload[1];
+        payload += 2;
+        payloadLen -= 2;
+    }
+
+    EspCommand cmd;
+    if (!EspFrame_ToCommand(type, payload, payloadLen, &cmd)) {
+        printf("[ESP_UART] Unknown frame type: 0x%02X\r\n", type);
+        return;
+    }
+    if (sequenced) {
+        process_sequenced(seq, &cmd, NULL, payload, payloadLen);
+        return;
+    }
+    if (cmd.type == ESP_MSG_ORDER_BATCH) {
+        cmd.valid = EspComm_StageOrder(NULL, payload, payloadLen);
+    }
+    process_command(&cmd, NULL);
+}
+
 EspMessageType EspComm_ClassifyMessage(const char* line) {
-    if (!line) return ESP_MSG_UNKNOWN;
-    if (strncmp(line, "NFC_UID:", 8) == 0) return ESP_MSG_NFC_UID;
-    if (strncmp(line, "NFC_ERR:", 8) == 0) return ESP_MSG_NFC_ERR;
-    if (strncmp(line, "NAK:STATE:PAYING:NO_NET", 23) == 0) return ESP_MSG_NAK_PAYING_NO_NET;
-    if (strncmp(line, "NAK:PAYMENT:DENIED", 19) == 0) return ESP_MSG_NAK_PAYMENT_DENIED;
-    if (strncmp(line, "ORDER_START:", 12) == 0) return ESP_MSG_ORDER_START;
-    if (strncmp(line, "VEND ", 5) == 0) return ESP_MSG_VEND_COMMAND;
-    if (strcmp(line, "ORDER_END") == 0) return ESP_MSG_ORDER_END;
-    if (strcmp(line, "QR_TOKEN_ERROR") == 0) return ESP_MSG_QR_TOKEN_ERROR;
-    if (strcmp(line, "QR_TOKEN_INVALID") == 0) return ESP_MSG_QR_TOKEN_INVALID;
-    if (strcmp(line, "QR_TOKEN_BUSY") == 0) return ESP_MSG_QR_TOKEN_BUSY;
-    if (strcmp(line, "QR_TOKEN_NO_NETWORK") == 0) return ESP_MSG_QR_TOKEN_NO_NETWORK;
-    if (strcmp(line, "ORDER_FAILED") == 0) return ESP_MSG_ORDER_FAILED;
-
-    return ESP_MSG_UNKNOWN;
+    return EspProtocol_Classify(line);
 }
 
 // Validation sécurisée des caractères UART
@@ -189,86 +516,656 @@ static void EspComm_ResetBuffer(const char* reason) {
     memset(lineBuf1, 0, sizeof(lineBuf1));
 }
 
-void EspComm_SendLine(const char* line) {
-    if (!line) return;
-    
-    size_t len = strlen(line);
-    if (len == 0 || len > UART_MAX_LINE_LENGTH) {
-        LOGE("[ESP_UART] Invalid send length: %zu\r\n", len);
+// Traitement d'un octet reçu (contexte tâche): assemblage de ligne et dispatch sur CR/LF
+static void EspComm_RxByte(char c, uint32_t currentTime) {
+    // Vérification timeout entre caractères
+    if (lastRxTimestamp != 0 && (currentTime - lastRxTimestamp) > UART_TIMEOUT_MS) {
+        if (lineLen1 > 0) linkStats1.lineResets++;
+        EspComm_ResetBuffer("timeout");
+        invalidCharCount = 0;
+    }
+    lastRxTimestamp = currentTime;
+
+    // Changement de mode: ne pas mélanger une ligne et une trame
+    EspLinkMode mode = linkMode1;
+    if (mode != rxAssemblyMode1) {
+        rxAssemblyMode1 = mode;
+        EspComm_ResetBuffer("mode_change");
+        invalidCharCount = 0;
+    }
+
+    if (mode == ESP_LINK_MODE_BINARY) {
+        // Trames COBS: accumulation brute jusqu'au délimiteur 0x00
+        if ((uint8_t)c == ESP_FRAME_DELIMITER) {
+            if (lineLen1 > 0) {
+                process_frame_uart1((const uint8_t*)lineBuf1, lineLen1);
+                EspComm_ResetBuffer("processed");
+            }
+        } else if (lineLen1 < ESP_RX_LINE_MAX) {
+            lineBuf1[lineLen1++] = c;
+        } else {
+            linkStats1.frameErrors++;
+            linkStats1.lineResets++;
+            EspComm_ResetBuffer("frame_overflow");
+        }
         return;
     }
-    
-    // Validation des caractères avant envoi
-    for (size_t i = 0; i < len; i++) {
-        if (!EspComm_IsValidChar(line[i])) {
-            LOGE("[ESP_UART] Invalid char in send: 0x%02X\r\n", (uint8_t)line[i]);
-            return;
+
+    // Traitement fin de ligne
+    if (c == '\r' || c == '\n') {
+        if (lineLen1 > 0) {
+            lineBuf1[lineLen1] = '\0';
+            process_line_uart1(lineBuf1);
+            EspComm_ResetBuffer("processed");
+            invalidCharCount = 0;
+        }
+    } else {
+        // Validation caractère
+        if (!EspComm_IsValidChar(c)) {
+            invalidCharCount++;
+            if (invalidCharCount >= UART_MAX_INVALID_CHARS) {
+                LOGE("[ESP_UART] Too many invalid chars, resetting\r\n");
+                linkStats1.lineResets++;
+                EspComm_ResetBuffer("invalid_chars");
+                invalidCharCount = 0;
+            }
+        } else {
+            // Ajout caractère valide au buffer
+            if (lineLen1 < ESP_RX_LINE_MAX) {
+                lineBuf1[lineLen1++] = c;
+            } else {
+                LOGW("[ESP_UART] Line too long, truncating\r\n");
+                linkStats1.lineResets++;
+                EspComm_ResetBuffer("overflow");
+                invalidCharCount = 0;
+            }
+        }
+    }
+}
+
+// ISR: copie les octets écrits par le DMA entre la dernière position lue et
+// writePos dans le ring (au plus deux memcpy, rebouclage compris)
+static void EspComm_DrainRxDma(uint16_t writePos) {
+    if (writePos > ESP_RX_DMA_BUFFER_SIZE) return;
+    if (writePos == ESP_RX_DMA_BUFFER_SIZE) writePos = 0;
+    if (writePos == rxDmaReadPos1) return;
+
+    uint16_t len;
+    uint16_t written;
+    if (writePos > rxDmaReadPos1) {
+        len = (uint16_t)(writePos - rxDmaReadPos1);
+        written = RingBuffer_Write(&rxRing1, &rxDmaBuf1[rxDmaReadPos1], len);
+    } else {
+        uint16_t tailLen = (uint16_t)(ESP_RX_DMA_BUFFER_SIZE - rxDmaReadPos1);
+        len = (uint16_t)(tailLen + writePos);
+        written = RingBuffer_Write(&rxRing1, &rxDmaBuf1[rxDmaReadPos1], tailLen);
+        if (written == tailLen) {
+            written = (uint16_t)(written + RingBuffer_Write(&rxRing1, rxDmaBuf1, writePos));
+        }
+    }
+    linkStats1.rxBytes += len;
+    linkStats1.rxDropped += (uint32_t)(len - written);
+    rxDmaReadPos1 = writePos;
+}
+
+// ISR: réveille la tâche ESP (notification directe, pas de polling)
+static void EspComm_NotifyTaskFromISR(void) {
+    if (espTaskHandleLocal == NULL) return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(espTaskHandleLocal, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Tâche: consomme tout le ring et assemble les lignes
+static void EspComm_ProcessRx(void) {
+    uint8_t chunk[ESP_RX_CHUNK_SIZE];
+
+    for (;;) {
+        uint16_t maxLen = sizeof(chunk);
+        if (rxResyncPending) {
+            uint16_t toMark = (uint16_t)(rxResyncMark - rxRing1.tail);
+            if (toMark == 0) {
+                // Tous les octets antérieurs à l'erreur sont consommés
+                rxResyncPending = false;
+                EspComm_ResetBuffer("rx_error");
+                invalidCharCount = 0;
+                continue;
+            }
+            if (toMark < maxLen) maxLen = toMark;
+        }
+
+        uint16_t n = RingBuffer_Read(&rxRing1, chunk, maxLen);
+        if (n == 0) break;
+
+        uint32_t now = HAL_GetTick();
+        for (uint16_t i = 0; i < n; i++) {
+            EspComm_RxByte((char)chunk[i], now);
+        }
+    }
+}
+
+// (Ré)armement de la réception DMA circulaire avec détection IDLE
+static HAL_StatusTypeDef EspComm_StartRx(void) {
+    rxDmaReadPos1 = 0;
+    // HT/TC restent actifs en mode circulaire: ils garantissent un drain
+    // avant rebouclage même si la ligne n'est jamais silencieuse
+    return HAL_UARTEx_ReceiveToIdle_DMA(&huart1, rxDmaBuf1, ESP_RX_DMA_BUFFER_SIZE);
+}
+
+void EspComm_GetLinkStats(EspLinkStats* stats) {
+    if (!stats) return;
+    taskENTER_CRITICAL();
+    *stats = *(const EspLinkStats*)&linkStats1;
+    taskEXIT_CRITICAL();
+}
+
+// Démarre le transfert DMA suivant: canal le plus prioritaire ayant des données,
+// sauf si un enregistrement a été coupé par le rebouclage de son ring (il est
+// terminé d'abord). Appelée sous section critique (tâche) ou depuis TxCplt (ISR).
+static void EspComm_TxStartNext(void) {
+    if (txInFlight1 != 0) return;
+
+    uint8_t ch;
+    if (txResumeCh1 >= 0) {
+        ch = (uint8_t)txResumeCh1;
+    } else {
+        for (ch = 0; ch < ESP_CHANNEL_COUNT && txChan1[ch].count == 0; ch++) {
+        }
+        if (ch == ESP_CHANNEL_COUNT) return;
+        if (txInFlightCh1 > ch && txChan1[txInFlightCh1].count > 0) {
+            linkStats1.txPreemptions++;
+        }
+    }
+
+    EspTxChannel* c = &txChan1[ch];
+    const uint8_t* data;
+    uint16_t contig = RingBuffer_PeekContiguous(&c->ring, &data);
+
+    // Enregistrements entiers du même canal, dans la limite d'un morceau
+    uint16_t len = c->len[c->head];
+    for (uint8_t i = 1; i < c->count; i++) {
+        uint16_t next = c->len[(uint8_t)(c->head + i) % ESP_TX_RECORDS_MAX];
+        if ((uint32_t)len + next > ESP_TX_BURST_MAX) break;
+        len = (uint16_t)(len + next);
+    }
+    if (len > contig) len = contig;
+    if (len == 0) return;
+
+    if (HAL_UART_Transmit_DMA(&huart1, data, len) == HAL_OK) {
+        txInFlight1 = len;
+        txInFlightCh1 = ch;
+    }
+}
+
+// Libère les octets du transfert terminé et les enregistrements achevés
+static void EspComm_TxConsume(void) {
+    EspTxChannel* c = &txChan1[txInFlightCh1];
+    uint16_t n = txInFlight1;
+
+    RingBuffer_Skip(&c->ring, n);
+    txResumeCh1 = -1;
+    while (n > 0 && c->count > 0) {
+        uint16_t take = (n < c->len[c->head]) ? n : c->len[c->head];
+        c->len[c->head] = (uint16_t)(c->len[c->head] - take);
+        n = (uint16_t)(n - take);
+        if (c->len[c->head] != 0) {
+            txResumeCh1 = (int8_t)txInFlightCh1;
+            break;
         }
+        c->head = (uint8_t)((c->head + 1U) % ESP_TX_RECORDS_MAX);
+        c->count--;
     }
-    
-    HAL_UART_Transmit(&huart1, (uint8_t*)line, (uint16_t)len, 100);
-    const char crlf[2] = {'\r','\n'};
-    HAL_UART_Transmit(&huart1, (uint8_t*)crlf, 2, 50);
+    txInFlight1 = 0;
+}
+
+// Transfert interrompu (erreur DMA, changement de débit): le reste de
+// l'enregistrement entamé est abandonné, jamais émis tronqué au milieu d'un autre
+static void EspComm_TxAbortInFlight(void) {
+    EspComm_TxConsume();
+    if (txResumeCh1 >= 0) {
+        EspTxChannel* c = &txChan1[txResumeCh1];
+        RingBuffer_Skip(&c->ring, c->len[c->head]);
+        c->len[c->head] = 0;
+        c->head = (uint8_t)((c->head + 1U) % ESP_TX_RECORDS_MAX);
+        c->count--;
+        txResumeCh1 = -1;
+    }
+}
+
+static uint16_t EspComm_TxQueued(void) {
+    uint16_t used = 0;
+    for (uint8_t ch = 0; ch < ESP_CHANNEL_COUNT; ch++) {
+        used = (uint16_t)(used + RingBuffer_Count(&txChan1[ch].ring));
+    }
+    return used;
+}
+
+static bool EspComm_TxHasRoom(const EspTxChannel* c, uint16_t bytes, uint8_t records) {
+    return RingBuffer_Free(&c->ring) >= bytes &&
+           (uint8_t)(ESP_TX_RECORDS_MAX - c->count) >= records;
+}
+
+// Ajoute un enregistrement (préfixe + données + suffixe); place déjà vérifiée
+static void EspComm_TxPutRecord(EspTxChannel* c, const uint8_t* prefix, uint16_t prefixLen,
+                                const uint8_t* data, uint16_t len,
+                                const uint8_t* suffix, uint16_t suffixLen) {
+    if (prefixLen > 0) RingBuffer_Write(&c->ring, prefix, prefixLen);
+    RingBuffer_Write(&c->ring, data, len);
+    if (suffixLen > 0) RingBuffer_Write(&c->ring, suffix, suffixLen);
+    c->len[(uint8_t)(c->head + c->count) % ESP_TX_RECORDS_MAX] = (uint16_t)(prefixLen + len + suffixLen);
+    c->count++;
+}
+
+// Fin de mise en file (section critique): compteurs puis relance du DMA
+static void EspComm_TxQueuedMessage(void) {
+    uint16_t used = EspComm_TxQueued();
+    if (used > linkStats1.txHighWater) linkStats1.txHighWater = used;
+    linkStats1.txLines++;
+    EspComm_TxStartNext();
+}
+
+static void EspComm_TxRefused(void) {
+    linkStats1.txDropped++;
+    LOGW("[ESP_UART] TX queue full, message dropped\r\n");
+}
+
+// Copie un bloc (+ suffixe optionnel) dans la file d'un canal, d'un seul tenant
+static bool EspComm_TxEnqueue(EspChannel channel, const uint8_t* data, uint16_t len,
+                              const uint8_t* suffix, uint16_t suffixLen) {
+    EspTxChannel* c = &txChan1[channel];
+    bool queued = false;
+
+    taskENTER_CRITICAL();
+    if (EspComm_TxHasRoom(c, (uint16_t)(len + suffixLen), 1)) {
+        EspComm_TxPutRecord(c, NULL, 0, data, len, suffix, suffixLen);
+        EspComm_TxQueuedMessage();
+        queued = true;
+    }
+    taskEXIT_CRITICAL();
+
+    if (!queued) EspComm_TxRefused();
+    return queued;
+}
+
+// Ligne d'un canal secondaire découpée en morceaux étiquetés, tous mis en file
+// ou aucun: le contrôle peut s'intercaler entre deux morceaux
+static bool EspComm_TxEnqueueChunked(EspChannel channel, const char* line, uint16_t len) {
+    static const uint8_t crlf[2] = {'\r', '\n'};
+    EspTxChannel* c = &txChan1[channel];
+    uint8_t chunks = (uint8_t)((len + ESP_TX_CHUNK_SIZE - 1U) / ESP_TX_CHUNK_SIZE);
+    uint16_t bytes = (uint16_t)(len + chunks * (ESP_TX_CHUNK_HEADER + sizeof(crlf)));
+    bool queued = false;
+
+    taskENTER_CRITICAL();
+    if (EspComm_TxHasRoom(c, bytes, chunks)) {
+        for (uint16_t off = 0; off < len; off = (uint16_t)(off + ESP_TX_CHUNK_SIZE)) {
+            uint16_t part = (uint16_t)(len - off);
+            if (part > ESP_TX_CHUNK_SIZE) part = ESP_TX_CHUNK_SIZE;
+            uint8_t header[ESP_TX_CHUNK_HEADER] = {
+                '%', (uint8_t)('0' + channel), (off + part < len) ? '+' : '.', ':'
+            };
+            EspComm_TxPutRecord(c, header, sizeof(header), (const uint8_t*)line + off, part,
+                                crlf, sizeof(crlf));
+        }
+        linkStats1.txChunks += chunks;
+        EspComm_TxQueuedMessage();
+        queued = true;
+    }
+    taskEXIT_CRITICAL();
+
+    if (!queued) EspComm_TxRefused();
+    return queued;
+}
+
+bool EspComm_SendLineOn(EspChannel channel, const char* line) {
+    if (!line || channel >= ESP_CHANNEL_COUNT) return false;
+
+    // Longueur et validation des caractères en une seule passe bornée
+    size_t maxLen = (channel == ESP_CHANNEL_CONTROL) ? UART_MAX_LINE_LENGTH : ESP_TX_BULK_LINE_MAX;
+    size_t len = 0;
+    while (line[len] != '\0') {
+        if (len >= maxLen) {
+            LOGE("[ESP_UART] Invalid send length: > %u\r\n", (unsigned)maxLen);
+            return false;
+        }
+        if (!EspComm_IsValidChar(line[len])) {
+            LOGE("[ESP_UART] Invalid char in send: 0x%02X\r\n", (uint8_t)line[len]);
+            return false;
+        }
+        len++;
+    }
+    if (len == 0) {
+        LOGE("[ESP_UART] Invalid send length: 0\r\n");
+        return false;
+    }
+
+    if (linkMode1 != ESP_LINK_MODE_TEXT) {
+        LOGW("[ESP_UART] Text line refused in binary mode\r\n");
+        return false;
+    }
+
+    if (channel != ESP_CHANNEL_CONTROL && channelsEnabled1) {
+        return EspComm_TxEnqueueChunked(channel, line, (uint16_t)len);
+    }
+    static const uint8_t crlf[2] = {'\r', '\n'};
+    return EspComm_TxEnqueue(channel, (const uint8_t*)line, (uint16_t)len, crlf, sizeof(crlf));
+}
+
+bool EspComm_SendLine(const char* line) {
+    return EspComm_SendLineOn(ESP_CHANNEL_CONTROL, line);
+}
+
+// Trames bornées par ESP_FRAME_MAX_ENCODED (~ un morceau): jamais découpées
+bool EspComm_SendFrameOn(EspChannel channel, uint8_t type, const uint8_t* payload, uint16_t len) {
+    if (channel >= ESP_CHANNEL_COUNT) return false;
+
+    uint8_t frame[ESP_FRAME_MAX_ENCODED];
+    size_t n = EspFrame_Encode(type, payload, len, frame, sizeof(frame));
+    if (n == 0) {
+        LOGE("[ESP_UART] Frame encode failed (type=0x%02X, len=%u)\r\n", type, len);
+        return false;
+    }
+    return EspComm_TxEnqueue(channel, frame, (uint16_t)n, NULL, 0);
+}
+
+bool EspComm_SendFrame(uint8_t type, const uint8_t* payload, uint16_t len) {
+    return EspComm_SendFrameOn(ESP_CHANNEL_CONTROL, type, payload, len);
+}
+
+// Émission d'une réponse selon le mode du lien; seq < 0: non numérotée
+static bool EspComm_EmitResponse(const EspResponse* rsp, int seq) {
+    if (linkMode1 == ESP_LINK_MODE_BINARY) {
+        uint8_t frame[ESP_FRAME_MAX_ENCODED];
+        size_t n = (seq < 0)
+            ? EspFrame_EncodeResponse(rsp, frame, sizeof(frame))
+            : EspFrame_EncodeResponseSeq(rsp, (uint8_t)seq, frame, sizeof(frame));
+        if (n == 0) return false;
+        return EspComm_TxEnqueue(ESP_CHANNEL_CONTROL, frame, (uint16_t)n, NULL, 0);
+    }
+
+    char line[UART_BUFFER_SIZE];
+    size_t prefix = 0;
+    if (seq >= 0) {
+        prefix = (size_t)snprintf(line, sizeof(line), "#%d:", seq);
+    }
+    if (EspProtocol_FormatResponse(rsp, line + prefix, sizeof(line) - prefix) == 0) return false;
+    return EspComm_SendLine(line);
+}
+
+bool EspComm_SendResponse(const EspResponse* rsp) {
+    if (!rsp) return false;
+    if (!seqEnabled1) return EspComm_EmitResponse(rsp, -1);
+
+    // Gardée jusqu'à l'acquit de l'ESP, retransmise sur NAK ou timeout
+    uint8_t seq;
+    bool held;
+    taskENTER_CRITICAL();
+    held = EspSeq_TxPush(&seqTx1, rsp, HAL_GetTick(), &seq);
+    taskEXIT_CRITICAL();
+    if (!held) {
+        linkStats1.txDropped++;
+        LOGW("[ESP_UART] Sequence window full, response dropped\r\n");
+        return false;
+    }
+    return EspComm_EmitResponse(rsp, seq);
+}
+
+void EspComm_SetLinkMode(EspLinkMode mode) {
+    if (mode != ESP_LINK_MODE_TEXT && mode != ESP_LINK_MODE_BINARY) return;
+    linkMode1 = mode;
+    printf("[ESP_UART] Link mode: %s\r\n", mode == ESP_LINK_MODE_BINARY ? "binary" : "text");
+}
+
+EspLinkMode EspComm_GetLinkMode(void) {
+    return linkMode1;
+}
+
+// Change le débit de USART1 une fois la file d'émission vidée à l'ancien débit
+static void EspComm_SetBaud(uint32_t baud) {
+    for (uint32_t waited = 0; waited < ESP_TX_DRAIN_TIMEOUT_MS; waited++) {
+        if (txInFlight1 == 0 && EspComm_TxQueued() == 0) break;
+        osDelay(pdMS_TO_TICKS(1));
+    }
+
+    HAL_UART_Abort(&huart1);
+    taskENTER_CRITICAL();
+    if (txInFlight1 != 0) {
+        // Transfert interrompu par le changement de débit
+        EspComm_TxAbortInFlight();
+        linkStats1.txErrors++;
+    }
+    taskEXIT_CRITICAL();
+
+    huart1.Init.BaudRate = baud;
+    if (HAL_UART_Init(&huart1) != HAL_OK) {
+        LOGE("[ESP_UART] UART1 reinit failed at %lu baud\r\n", (unsigned long)baud);
+    }
+    EspComm_ResetBuffer("baud_change");
+    if (EspComm_StartRx() != HAL_OK) {
+        LOGE("[ESP_UART] RX DMA restart failed\r\n");
+    }
+    linkStats1.baudRate = baud;
+
+    // Reste de la file (lignes mises en file pendant l'attente): nouveau débit
+    taskENTER_CRITICAL();
+    EspComm_TxStartNext();
+    taskEXIT_CRITICAL();
+}
+
+// Applique dans l'ordre: mode de base, ligne à émettre, débit, capacités
+static void EspComm_ApplyHandshake(const EspHsAction* act) {
+    if (act->linkDown) {
+        EspComm_SetLinkMode(ESP_LINK_MODE_TEXT);
+        // Numérotation reprise à 0 après chaque négociation
+        taskENTER_CRITICAL();
+        seqEnabled1 = false;
+        channelsEnabled1 = false;
+        EspSeq_TxReset(&seqTx1);
+        taskEXIT_CRITICAL();
+        EspSeq_RxReset(&seqRx1);
+    }
+    if (act->line[0] != '\0') {
+        EspComm_SendLine(act->line);
+    }
+    if (act->baud != 0) {
+        EspComm_SetBaud(act->baud);
+    }
+    linkStats1.baudFallbacks = linkHs1.fallbacks;
+    if (act->linkUp) {
+        linkStats1.handshakes++;
+        linkStats1.linkCaps = linkHs1.caps;
+        printf("[ESP_UART] Link up: %s, %lu baud, caps=0x%02X\r\n",
+               linkHs1.state == ESP_HS_LEGACY ? "legacy" : "negotiated",
+               (unsigned long)linkHs1.baud, linkHs1.caps);
+        if (linkHs1.caps & ESP_CAP_BINARY_FRAMES) {
+            EspComm_SetLinkMode(ESP_LINK_MODE_BINARY);
+        }
+        seqEnabled1 = (linkHs1.caps & ESP_CAP_SEQUENCED) != 0;
+        channelsEnabled1 = (linkHs1.caps & ESP_CAP_CHANNELS) != 0;
+    }
+}
+
+// (Re)démarre la négociation: au boot et après perte du lien
+static void EspComm_StartHandshake(uint32_t now) {
+    EspHsAction act;
+    EspHandshake_Start(&linkHs1, now, &act);
+    EspComm_ApplyHandshake(&act);
+    linkLossWindowStart = now;
+    linkLossErrorBase = 0;
+}
+
+static uint32_t EspComm_RxErrorTotal(void) {
+    return linkStats1.framingErrors + linkStats1.noiseErrors +
+           linkStats1.frameErrors + linkStats1.crcErrors;
+}
+
+// Échéances de la négociation et détection de perte du lien (contexte tâche)
+static void EspComm_PollLink(uint32_t now) {
+    EspHsAction act;
+    EspHandshake_Poll(&linkHs1, now, &act);
+    EspComm_ApplyHandshake(&act);
+
+    // Retransmission de la plus ancienne réponse non acquittée
+    uint8_t seq;
+    EspResponse rsp;
+    bool dropped;
+    bool due;
+    do {
+        taskENTER_CRITICAL();
+        due = EspSeq_TxPollRetransmit(&seqTx1, now, &seq, &rsp, &dropped);
+        taskEXIT_CRITICAL();
+        if (!due) break;
+        if (dropped) {
+            linkStats1.seqDropped++;
+            LOGW("[ESP_UART] Response #%u never acknowledged, dropped\r\n", seq);
+        } else {
+            linkStats1.seqRetransmits++;
+            EspComm_EmitResponse(&rsp, seq);
+        }
+    } while (dropped);
+
+    uint32_t errors = EspComm_RxErrorTotal();
+    if (EspHandshake_IsBusy(&linkHs1)) {
+        // Erreurs attendues pendant les essais de débit
+        linkLossWindowStart = now;
+        linkLossErrorBase = errors;
+        return;
+    }
+    if ((errors - linkLossErrorBase) >= ESP_LINK_LOSS_ERRORS) {
+        LOGW("[ESP_UART] Link lost (%lu RX errors), renegotiating\r\n",
+             (unsigned long)(errors - linkLossErrorBase));
+        linkStats1.linkLosses++;
+        EspComm_StartHandshake(now);
+        linkLossErrorBase = EspComm_RxErrorTotal();
+        return;
+    }
+    if ((now - linkLossWindowStart) >= ESP_LINK_LOSS_WINDOW_MS) {
+        linkLossWindowStart = now;
+        linkLossErrorBase = errors;
+    }
+}
+
+// Sauvegarde du catalogue (CATALOG_END): l'effacement du secteur fige la
+// flash, interruptions comprises, jusqu'à 2 s; le buffer DMA circulaire serait
+// réécrit sans être relevé. Réception arrêtée le temps de la sauvegarde: les
+// octets reçus pendant sont perdus (l'ESP attend la réponse, le reste est
+// renvoyé s'il est numéroté), la ligne en cours est abandonnée, et ces pertes
+// ne comptent pas comme une perte du lien.
+static uint8_t EspComm_CommitCatalog(uint8_t count) {
+    HAL_UART_AbortReceive(&huart1);
+    taskENTER_CRITICAL();
+    if (huart1.hdmarx != NULL) {
+        EspComm_DrainRxDma((uint16_t)(ESP_RX_DMA_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart1.hdmarx)));
+    }
+    rxResyncMark = RingBuffer_Head(&rxRing1);
+    rxResyncPending = true;
+    taskEXIT_CRITICAL();
+
+    uint8_t code = CatalogService_Commit(count);
+
+    if (EspComm_StartRx() != HAL_OK) {
+        LOGE("[ESP_UART] RX DMA restart failed\r\n");
+    }
+    linkLossWindowStart = HAL_GetTick();
+    linkLossErrorBase = EspComm_RxErrorTotal();
+    return code;
 }
 
 void StartTaskEspCommunication(void *argument) {
+    (void)argument;
     printf("\r\nESP Communication Task started (UART1)\r\n");
-    HAL_UART_Receive_IT(&huart1, &rxByte1, 1);
-    
-    uint32_t heartbeatCounter = 0;
-    
+
+    espTaskHandleLocal = xTaskGetCurrentTaskHandle();
+    RingBuffer_Init(&rxRing1, rxRingStorage1, sizeof(rxRingStorage1));
+    if (EspComm_StartRx() != HAL_OK) {
+        LOGE("[ESP_UART] RX DMA start failed\r\n");
+    }
+    linkStats1.baudRate = huart1.Init.BaudRate;
+    EspHandshake_Init(&linkHs1);
+    EspComm_StartHandshake(HAL_GetTick());
+
+    uint32_t lastHeartbeat = HAL_GetTick();
+
     for (;;) {
-        // Heartbeat watchdog toutes les 200 itérations (10ms * 200 = 2s)
-        if (++heartbeatCounter >= 200) {
+        // Réveil par l'ISR dès qu'un bloc arrive, sinon à la prochaine échéance
+        // de négociation ou au timeout pour le heartbeat
+        uint32_t waitMs = EspHandshake_TimeToDeadline(&linkHs1, HAL_GetTick());
+        if (waitMs > ESP_TASK_WAIT_MS) waitMs = ESP_TASK_WAIT_MS;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+        EspComm_ProcessRx();
+        EspComm_PollLink(HAL_GetTick());
+
+        if ((HAL_GetTick() - lastHeartbeat) >= ESP_HEARTBEAT_PERIOD_MS) {
             Watchdog_TaskHeartbeat(TASK_ESP_COMM);
-            heartbeatCounter = 0;
+            lastHeartbeat = HAL_GetTick();
         }
-        
-        osDelay(10);
     }
 }
 
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
-    if (huart->Instance == USART1) {
-        uint32_t currentTime = HAL_GetTick();
-        char c = (char)rxByte1;
-        
-        // Vérification timeout entre caractères
-        if (lastRxTimestamp != 0 && (currentTime - lastRxTimestamp) > UART_TIMEOUT_MS) {
-            EspComm_ResetBuffer("timeout");
-            invalidCharCount = 0;
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+    if (huart->Instance != USART1) return;
+    linkStats1.rxEvents++;
+    // Size = position d'écriture du DMA dans le buffer circulaire
+    EspComm_DrainRxDma(Size);
+    EspComm_NotifyTaskFromISR();
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart->Instance != USART1) return;
+    linkStats1.txBytes += txInFlight1;
+    EspComm_TxConsume();
+    // Enchaîner le bloc suivant (suite après rebouclage, sinon canal prioritaire)
+    EspComm_TxStartNext();
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    if (huart->Instance != USART1) return;
+
+    uint32_t err = huart->ErrorCode;
+    if (err & HAL_UART_ERROR_ORE) linkStats1.overrunErrors++;
+    if (err & HAL_UART_ERROR_FE)  linkStats1.framingErrors++;
+    if (err & HAL_UART_ERROR_NE)  linkStats1.noiseErrors++;
+    if (err & HAL_UART_ERROR_PE)  linkStats1.parityErrors++;
+    if (err & HAL_UART_ERROR_DMA) linkStats1.dmaErrors++;
+
+    // Erreur DMA: le flux fautif porte son code d'erreur (HAL_DMA_IRQHandler)
+    bool txDmaError = (err & HAL_UART_ERROR_DMA) && huart->hdmatx != NULL &&
+                      huart->hdmatx->ErrorCode != HAL_DMA_ERROR_NONE;
+    bool rxError = (err & ESP_UART_RX_ERRORS) != 0 ||
+                   ((err & HAL_UART_ERROR_DMA) &&
+                    (!txDmaError || (huart->hdmarx != NULL && huart->hdmarx->ErrorCode != HAL_DMA_ERROR_NONE)));
+
+    if (rxError) {
+        // Récupérer ce que le DMA a déjà écrit avant l'arrêt, puis réarmer;
+        // des octets ont pu se perdre: la ligne en cours est abandonnée
+        if (huart->hdmarx != NULL) {
+            uint16_t pos = (uint16_t)(ESP_RX_DMA_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart->hdmarx));
+            EspComm_DrainRxDma(pos);
         }
-        lastRxTimestamp = currentTime;
-        
-        // Traitement fin de ligne
-        if (c == '\r' || c == '\n') {
-            if (lineLen1 > 0) {
-                lineBuf1[lineLen1] = '\0';
-                process_line_uart1(lineBuf1);
-                EspComm_ResetBuffer("processed");
-                invalidCharCount = 0;
-            }
-        } else {
-            // Validation caractère
-            if (!EspComm_IsValidChar(c)) {
-                invalidCharCount++;
-                if (invalidCharCount >= UART_MAX_INVALID_CHARS) {
-                    LOGE("[ESP_UART] Too many invalid chars, resetting\r\n");
-                    EspComm_ResetBuffer("invalid_chars");
-                    invalidCharCount = 0;
-                }
-            } else {
-                // Ajout caractère valide au buffer
-                if (lineLen1 < UART_MAX_LINE_LENGTH) {
-                    lineBuf1[lineLen1++] = c;
-                } else {
-                    LOGW("[ESP_UART] Line too long, truncating\r\n");
-                    EspComm_ResetBuffer("overflow");
-                    invalidCharCount = 0;
-                }
-            }
+        HAL_UART_AbortReceive(huart);
+        rxResyncMark = RingBuffer_Head(&rxRing1);
+        rxResyncPending = true;
+        linkStats1.rxRestarts++;
+        EspComm_StartRx();
+        EspComm_NotifyTaskFromISR();
+    } else if (huart->RxState != HAL_UART_STATE_BUSY_RX) {
+        // UART_DMAError (flux TX) clôt aussi la réception côté UART, le flux
+        // RX continuant d'écrire: arrêt, relevé jusqu'à la position finale,
+        // réarmement. Aucun octet perdu, la ligne en cours est conservée
+        HAL_UART_AbortReceive(huart);
+        if (huart->hdmarx != NULL) {
+            uint16_t pos = (uint16_t)(ESP_RX_DMA_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart->hdmarx));
+            EspComm_DrainRxDma(pos);
         }
-        
-        HAL_UART_Receive_IT(&huart1, &rxByte1, 1);
+        EspComm_StartRx();
+        EspComm_NotifyTaskFromISR();
+    }
+
+    // Une erreur DMA TX laisse l'UART prête sans TxCplt: abandonner le bloc
+    // en cours (les octets ont pu partir partiellement) et reprendre la file
+    if (txInFlight1 != 0 && huart->gState == HAL_UART_STATE_READY) {
+        linkStats1.txErrors++;
+        EspComm_TxAbortInFlight();
+        EspComm_TxStartNext();
     }
 }
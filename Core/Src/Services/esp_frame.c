@@ -0,0 +1,485 @@
+#include "esp_frame.h"
+#include <string.h>
+
+// Table CRC-16/CCITT-FALSE (poly 0x1021), en flash.
+// Le CRC matériel du F411 est figé en CRC-32 sur mots de 32 bits: il ne
+// peut pas produire ce CRC-16, d'où le calcul logiciel sur cible aussi.
+static const uint16_t kCrc16Table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+uint16_t EspFrame_Crc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 8) ^ kCrc16Table[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+size_t EspFrame_CobsEncode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize) {
+    if (!in || !out || outSize == 0) return 0;
+
+    size_t codeIdx = 0;   // Position de l'octet de code du bloc courant
+    size_t o = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[codeIdx] = code;
+            codeIdx = o++;
+            code = 1;
+        } else {
+            if (o >= outSize) return 0;
+            out[o++] = in[i];
+            code++;
+            if (code == 0xFF) {
+                out[codeIdx] = code;
+                codeIdx = o++;
+                code = 1;
+            }
+        }
+        if (codeIdx >= outSize) return 0;
+    }
+    out[codeIdx] = code;
+    return o;
+}
+
+size_t EspFrame_CobsDecode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize) {
+    if (!in || !out) return 0;
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0) return 0;                    // Délimiteur inattendu
+        if (i + (size_t)(code - 1) > len) return 0; // Bloc tronqué
+        for (uint8_t k = 1; k < code; k++) {
+            if (o >= outSize || in[i] == 0) return 0;
+            out[o++] = in[i++];
+        }
+        // Un zéro implicite suit chaque bloc non maximal, sauf le dernier
+        if (code != 0xFF && i < len) {
+            if (o >= outSize) return 0;
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+// raw contient type + payload et 2 octets libres pour le CRC
+static size_t seal_frame(uint8_t* raw, size_t payloadLen, uint8_t* out, size_t outSize) {
+    uint16_t crc = EspFrame_Crc16(raw, 1 + payloadLen);
+    raw[1 + payloadLen] = (uint8_t)crc;
+    raw[2 + payloadLen] = (uint8_t)(crc >> 8);
+
+    if (outSize < 2) return 0;
+    size_t n = EspFrame_CobsEncode(raw, payloadLen + 3, out, outSize - 1);
+    if (n == 0) return 0;
+    out[n++] = ESP_FRAME_DELIMITER;
+    return n;
+}
+
+size_t EspFrame_Encode(uint8_t type, const uint8_t* payload, size_t payloadLen,
+                       uint8_t* out, size_t outSize) {
+    if (payloadLen > ESP_FRAME_MAX_PAYLOAD || (payloadLen > 0 && !payload)) return 0;
+
+    uint8_t raw[ESP_FRAME_MAX_RAW];
+    raw[0] = type;
+    if (payloadLen > 0) memcpy(&raw[1], payload, payloadLen);
+    return seal_frame(raw, payloadLen, out, outSize);
+}
+
+EspFrameStatus EspFrame_Decode(const uint8_t* frame, size_t len, uint8_t* work, size_t workSize,
+                               uint8_t* type, const uint8_t** payload, size_t* payloadLen) {
+    if (!frame || !work || len == 0) return ESP_FRAME_ERR_LENGTH;
+
+    size_t n = EspFrame_CobsDecode(frame, len, work, workSize);
+    if (n == 0) return ESP_FRAME_ERR_COBS;
+    if (n < 3 || n > ESP_FRAME_MAX_RX_RAW) return ESP_FRAME_ERR_LENGTH;
+
+    uint16_t rxCrc = (uint16_t)(work[n - 2] | (work[n - 1] << 8));
+    if (EspFrame_Crc16(work, n - 2) != rxCrc) return ESP_FRAME_ERR_CRC;
+
+    if (type) *type = work[0];
+    if (payload) *payload = &work[1];
+    if (payloadLen) *payloadLen = n - 3;
+    return ESP_FRAME_OK;
+}
+
+// Correspondance type de trame <-> message pour les commandes sans argument
+typedef struct {
+    uint8_t frameType;
+    EspMessageType msgType;
+} EspFrameMap;
+
+static const EspFrameMap kCommandMap[] = {
+    { ESP_FRAME_NFC_UID,             ESP_MSG_NFC_UID },
+    { ESP_FRAME_NFC_ERR,             ESP_MSG_NFC_ERR },
+    { ESP_FRAME_NAK_PAYING_NO_NET,   ESP_MSG_NAK_PAYING_NO_NET },
+    { ESP_FRAME_NAK_PAYMENT_DENIED,  ESP_MSG_NAK_PAYMENT_DENIED },
+    { ESP_FRAME_ORDER_START,         ESP_MSG_ORDER_START },
+    { ESP_FRAME_VEND,                ESP_MSG_VEND_COMMAND },
+    { ESP_FRAME_ORDER_END,           ESP_MSG_ORDER_END },
+    { ESP_FRAME_QR_TOKEN_ERROR,      ESP_MSG_QR_TOKEN_ERROR },
+    { ESP_FRAME_QR_TOKEN_INVALID,    ESP_MSG_QR_TOKEN_INVALID },
+    { ESP_FRAME_QR_TOKEN_BUSY,       ESP_MSG_QR_TOKEN_BUSY },
+    { ESP_FRAME_QR_TOKEN_NO_NETWORK, ESP_MSG_QR_TOKEN_NO_NETWORK },
+    { ESP_FRAME_ORDER_FAILED,        ESP_MSG_ORDER_FAILED },
+    { ESP_FRAME_ORDER,               ESP_MSG_ORDER_BATCH },
+    { ESP_FRAME_CATALOG_BEGIN,       ESP_MSG_CATALOG_BEGIN },
+    { ESP_FRAME_CATALOG_ITEM,        ESP_MSG_CATALOG_ITEM },
+    { ESP_FRAME_CATALOG_END,         ESP_MSG_CATALOG_END },
+    { ESP_FRAME_DIAG_CALIB,          ESP_MSG_DIAG_CALIB },
+};
+
+#define MAP_COUNT (sizeof(kCommandMap) / sizeof(kCommandMap[0]))
+
+// Identifiant imprimable de 1 à ESP_PROTO_ID_MAX_LEN caractères
+static bool copy_id(const uint8_t* src, size_t len, char* dst) {
+    if (len == 0 || len > ESP_PROTO_ID_MAX_LEN) return false;
+    for (size_t i = 0; i < len; i++) {
+        if (src[i] <= 0x20 || src[i] > 0x7E) return false;
+        dst[i] = (char)src[i];
+    }
+    dst[len] = '\0';
+    return true;
+}
+
+static size_t id_len(const char* id) {
+    size_t n = 0;
+    while (n < ESP_PROTO_ID_MAX_LEN && id[n] != '\0') n++;
+    return n;
+}
+
+// Entrée CATALOG_ITEM: mêmes bornes que la ligne texte, libellé imprimable
+// blancs compris
+#define CATALOG_ITEM_FIXED  7U
+
+static bool decode_catalog_item(const uint8_t* payload, size_t payloadLen, ProductEntry* e) {
+    size_t labelLen = payloadLen - CATALOG_ITEM_FIXED;
+    if (payloadLen <= CATALOG_ITEM_FIXED || labelLen > PRODUCT_LABEL_LEN - 1U) return false;
+
+    e->code = EspFrame_GetU16(&payload[0]);
+    e->digits = payload[2];
+    e->channel = payload[3];
+    e->sensorId = payload[4];
+    e->priceCents = EspFrame_GetU16(&payload[5]);
+    if (e->digits == 0 || e->digits > PRODUCT_CODE_MAX_DIGITS) return false;
+    for (size_t i = 0; i < labelLen; i++) {
+        uint8_t c = payload[CATALOG_ITEM_FIXED + i];
+        if (c < 0x20 || c > 0x7E) return false;
+        e->label[i] = (char)c;
+    }
+    e->label[labelLen] = '\0';
+    if (e->sensorId == ESP_PROTO_CATALOG_SENSOR_NONE) e->sensorId = PRODUCT_SENSOR_NONE;
+    return true;
+}
+
+bool EspFrame_ToCommand(uint8_t type, const uint8_t* payload, size_t payloadLen, EspCommand* cmd) {
+    if (!cmd) return false;
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->type = ESP_MSG_UNKNOWN;
+
+    for (size_t i = 0; i < MAP_COUNT; i++) {
+        if (kCommandMap[i].frameType == type) {
+            cmd->type = kCommandMap[i].msgType;
+            break;
+        }
+    }
+
+    switch (cmd->type) {
+        case ESP_MSG_UNKNOWN:
+            return false;
+        case ESP_MSG_VEND_COMMAND:
+            if (payloadLen >= 3 &&
+                payload[0] >= ESP_PROTO_SLOT_MIN && payload[0] <= ESP_PROTO_SLOT_MAX &&
+                payload[1] >= ESP_PROTO_QTY_MIN && payload[1] <= ESP_PROTO_QTY_MAX &&
+                copy_id(&payload[2], payloadLen - 2, cmd->product_id)) {
+                cmd->slot_number = payload[0];
+                cmd->quantity = payload[1];
+                cmd->valid = true;
+            }
+            break;
+        case ESP_MSG_ORDER_START:
+            cmd->valid = copy_id(payload, payloadLen, cmd->order_id);
+            break;
+        case ESP_MSG_ORDER_BATCH:
+            // Articles lus par EspFrame_ToOrder dans un descripteur dédié
+            break;
+        case ESP_MSG_CATALOG_BEGIN:
+            if (payloadLen == 2) {
+                cmd->catalog_version = EspFrame_GetU16(payload);
+                cmd->valid = true;
+            }
+            break;
+        case ESP_MSG_CATALOG_ITEM:
+            cmd->valid = decode_catalog_item(payload, payloadLen, &cmd->product);
+            break;
+        case ESP_MSG_CATALOG_END:
+            if (payloadLen == 1 && payload[0] >= 1 && payload[0] <= PRODUCT_CATALOG_MAX) {
+                cmd->catalog_count = payload[0];
+                cmd->valid = true;
+            }
+            break;
+        default:
+            cmd->valid = true;
+            break;
+    }
+    return true;
+}
+
+// Type et payload d'une commande; false si elle n'a pas d'équivalent binaire
+static bool command_payload(const EspCommand* cmd, uint8_t* type, uint8_t* payload, size_t* len) {
+    *type = 0;
+    for (size_t i = 0; i < MAP_COUNT; i++) {
+        if (kCommandMap[i].msgType == cmd->type) {
+            *type = kCommandMap[i].frameType;
+            break;
+        }
+    }
+    if (*type == 0 || cmd->type == ESP_MSG_ORDER_BATCH) return false;
+
+    *len = 0;
+    if (cmd->type == ESP_MSG_VEND_COMMAND) {
+        size_t idLen = id_len(cmd->product_id);
+        payload[0] = cmd->slot_number;
+        payload[1] = cmd->quantity;
+        memcpy(&payload[2], cmd->product_id, idLen);
+        *len = 2 + idLen;
+    } else if (cmd->type == ESP_MSG_ORDER_START) {
+        *len = id_len(cmd->order_id);
+        memcpy(payload, cmd->order_id, *len);
+    } else if (cmd->type == ESP_MSG_CATALOG_BEGIN) {
+        EspFrame_PutU16(payload, cmd->catalog_version);
+        *len = 2;
+    } else if (cmd->type == ESP_MSG_CATALOG_ITEM) {
+        const ProductEntry* e = &cmd->product;
+        size_t labelLen = 0;
+        while (labelLen < PRODUCT_LABEL_LEN - 1U && e->label[labelLen] != '\0') labelLen++;
+        EspFrame_PutU16(&payload[0], e->code);
+        payload[2] = e->digits;
+        payload[3] = e->channel;
+        payload[4] = e->sensorId;
+        EspFrame_PutU16(&payload[5], e->priceCents);
+        memcpy(&payload[CATALOG_ITEM_FIXED], e->label, labelLen);
+        *len = CATALOG_ITEM_FIXED + labelLen;
+    } else if (cmd->type == ESP_MSG_CATALOG_END) {
+        payload[0] = cmd->catalog_count;
+        *len = 1;
+    }
+    return true;
+}
+
+static bool response_payload(const EspResponse* rsp, uint8_t* type, uint8_t* payload, size_t* len) {
+    *len = 0;
+    switch (rsp->type) {
+        case ESP_RSP_ORDER_ACK:          *type = ESP_FRAME_ORDER_ACK; break;
+        case ESP_RSP_ORDER_NAK:          *type = ESP_FRAME_ORDER_NAK;
+                                         payload[(*len)++] = rsp->code; break;
+        case ESP_RSP_VEND_COMPLETED:     *type = ESP_FRAME_VEND_COMPLETED;
+                                         payload[(*len)++] = rsp->slot; break;
+        case ESP_RSP_VEND_FAILED:        *type = ESP_FRAME_VEND_FAILED;
+                                         payload[(*len)++] = rsp->slot;
+                                         payload[(*len)++] = rsp->code;
+                                         if (rsp->quantity > 0) {
+                                             payload[(*len)++] = rsp->delivered;
+                                             payload[(*len)++] = rsp->quantity;
+                                         }
+                                         break;
+        case ESP_RSP_DELIVERY_COMPLETED: *type = ESP_FRAME_DELIVERY_COMPLETED; break;
+        case ESP_RSP_DELIVERY_FAILED:    *type = ESP_FRAME_DELIVERY_FAILED;
+                                         payload[(*len)++] = rsp->code; break;
+        case ESP_RSP_STATE:              *type = ESP_FRAME_STATE;
+                                         payload[(*len)++] = rsp->code; break;
+        case ESP_RSP_CATALOG_ACK:        *type = ESP_FRAME_CATALOG_ACK; break;
+        case ESP_RSP_CATALOG_NAK:        *type = ESP_FRAME_CATALOG_NAK;
+                                         payload[(*len)++] = rsp->code; break;
+        default:                         return false;
+    }
+    return true;
+}
+
+bool EspFrame_ToOrder(const uint8_t* payload, size_t payloadLen, EspOrder* order) {
+    if (!payload || !order || payloadLen < 1) return false;
+    order->item_count = 0;
+
+    size_t pos = 0;
+    size_t idLen = payload[pos++];
+    if (pos + idLen > payloadLen || !copy_id(&payload[pos], idLen, order->order_id)) return false;
+    pos += idLen;
+
+    while (pos < payloadLen) {
+        if (order->item_count >= ESP_PROTO_ORDER_MAX_ITEMS || pos + 3 > payloadLen) return false;
+        EspOrderItem* item = &order->items[order->item_count];
+        item->slot_number = payload[pos++];
+        item->quantity = payload[pos++];
+        idLen = payload[pos++];
+        if (item->slot_number < ESP_PROTO_SLOT_MIN || item->slot_number > ESP_PROTO_SLOT_MAX ||
+            item->quantity < ESP_PROTO_QTY_MIN || item->quantity > ESP_PROTO_QTY_MAX ||
+            pos + idLen > payloadLen || !copy_id(&payload[pos], idLen, item->product_id)) {
+            return false;
+        }
+        pos += idLen;
+        order->item_count++;
+    }
+    return order->item_count > 0;
+}
+
+// Trame ORDER, numérotée si withSeq; construite en place (au-delà de
+// ESP_FRAME_MAX_PAYLOAD, seule la réception est dimensionnée pour elle)
+static size_t encode_order(const EspOrder* order, bool withSeq, uint8_t seq,
+                           uint8_t* out, size_t outSize) {
+    if (!order || order->item_count == 0 || order->item_count > ESP_PROTO_ORDER_MAX_ITEMS) return 0;
+
+    uint8_t raw[ESP_FRAME_MAX_RX_RAW];
+    size_t len = 1;
+    if (withSeq) {
+        raw[0] = ESP_FRAME_SEQ;
+        raw[len++] = seq;
+        raw[len++] = ESP_FRAME_ORDER;
+    } else {
+        raw[0] = ESP_FRAME_ORDER;
+    }
+    size_t idLen = id_len(order->order_id);
+    raw[len++] = (uint8_t)idLen;
+    memcpy(&raw[len], order->order_id, idLen);
+    len += idLen;
+
+    for (uint8_t i = 0; i < order->item_count; i++) {
+        const EspOrderItem* item = &order->items[i];
+        idLen = id_len(item->product_id);
+        if (len + 3 + idLen + 2 > sizeof(raw)) return 0;
+        raw[len++] = item->slot_number;
+        raw[len++] = item->quantity;
+        raw[len++] = (uint8_t)idLen;
+        memcpy(&raw[len], item->product_id, idLen);
+        len += idLen;
+    }
+    return seal_frame(raw, len - 1, out, outSize);
+}
+
+size_t EspFrame_EncodeOrder(const EspOrder* order, uint8_t* out, size_t outSize) {
+    return encode_order(order, false, 0, out, outSize);
+}
+
+size_t EspFrame_EncodeOrderSeq(const EspOrder* order, uint8_t seq, uint8_t* out, size_t outSize) {
+    return encode_order(order, true, seq, out, outSize);
+}
+
+size_t EspFrame_EncodeCommand(const EspCommand* cmd, uint8_t* out, size_t outSize) {
+    uint8_t type;
+    uint8_t payload[2 + ESP_PROTO_ID_MAX_LEN];
+    size_t len;
+    if (!cmd || !command_payload(cmd, &type, payload, &len)) return 0;
+    return EspFrame_Encode(type, payload, len, out, outSize);
+}
+
+size_t EspFrame_EncodeResponse(const EspResponse* rsp, uint8_t* out, size_t outSize) {
+    uint8_t type;
+    uint8_t payload[2];
+    size_t len;
+    if (!rsp || !response_payload(rsp, &type, payload, &len)) return 0;
+    return EspFrame_Encode(type, payload, len, out, outSize);
+}
+
+// Enveloppe numérotée: [seq][type][payload]
+size_t EspFrame_EncodeCommandSeq(const EspCommand* cmd, uint8_t seq, uint8_t* out, size_t outSize) {
+    uint8_t inner[2 + 2 + ESP_PROTO_ID_MAX_LEN];
+    size_t len;
+    if (!cmd || !command_payload(cmd, &inner[1], &inner[2], &len)) return 0;
+    inner[0] = seq;
+    return EspFrame_Encode(ESP_FRAME_SEQ, inner, len + 2, out, outSize);
+}
+
+size_t EspFrame_EncodeResponseSeq(const EspResponse* rsp, uint8_t seq, uint8_t* out, size_t outSize) {
+    uint8_t inner[2 + 2];
+    size_t len;
+    if (!rsp || !response_payload(rsp, &inner[1], &inner[2], &len)) return 0;
+    inner[0] = seq;
+    return EspFrame_Encode(ESP_FRAME_SEQ, inner, len + 2, out, outSize);
+}
+
+bool EspFrame_ToResponse(uint8_t type, const uint8_t* payload, size_t payloadLen, EspResponse* rsp) {
+    if (!rsp) return false;
+    memset(rsp, 0, sizeof(*rsp));
+
+    switch (type) {
+        case ESP_FRAME_ORDER_ACK:
+            rsp->type = ESP_RSP_ORDER_ACK;
+            return payloadLen == 0;
+        case ESP_FRAME_ORDER_NAK:
+            rsp->type = ESP_RSP_ORDER_NAK;
+            if (payloadLen != 1) return false;
+            rsp->code = payload[0];
+            return true;
+        case ESP_FRAME_VEND_COMPLETED:
+            rsp->type = ESP_RSP_VEND_COMPLETED;
+            if (payloadLen != 1) return false;
+            rsp->slot = payload[0];
+            return true;
+        case ESP_FRAME_VEND_FAILED:
+            rsp->type = ESP_RSP_VEND_FAILED;
+            if (payloadLen != 2 && payloadLen != 4) return false;
+            rsp->slot = payload[0];
+            rsp->code = payload[1];
+            if (payloadLen == 4) {
+                rsp->delivered = payload[2];
+                rsp->quantity = payload[3];
+            }
+            return true;
+        case ESP_FRAME_DELIVERY_COMPLETED:
+            rsp->type = ESP_RSP_DELIVERY_COMPLETED;
+            return payloadLen == 0;
+        case ESP_FRAME_DELIVERY_FAILED:
+            rsp->type = ESP_RSP_DELIVERY_FAILED;
+            if (payloadLen != 1) return false;
+            rsp->code = payload[0];
+            return true;
+        case ESP_FRAME_STATE:
+            rsp->type = ESP_RSP_STATE;
+            if (payloadLen != 1) return false;
+            rsp->code = payload[0];
+            return true;
+        case ESP_FRAME_CATALOG_ACK:
+            rsp->type = ESP_RSP_CATALOG_ACK;
+            return payloadLen == 0;
+        case ESP_FRAME_CATALOG_NAK:
+            rsp->type = ESP_RSP_CATALOG_NAK;
+            if (payloadLen != 1) return false;
+            rsp->code = payload[0];
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,188 @@
+#include "esp_link_handshake.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Débits essayés, du plus rapide au plus lent (115200 = débit de base)
+static const uint32_t kBaudSteps[] = { 921600U, 460800U };
+
+static bool deadline_reached(const EspHandshake* hs, uint32_t now) {
+    return (int32_t)(now - hs->deadline) >= 0;
+}
+
+static void action_clear(EspHsAction* act) {
+    act->line[0] = '\0';
+    act->baud = 0;
+    act->linkUp = false;
+    act->linkDown = false;
+}
+
+static void set_baud(EspHandshake* hs, uint32_t baud, EspHsAction* act) {
+    if (hs->baud != baud) {
+        hs->baud = baud;
+        act->baud = baud;
+    }
+}
+
+static void send_hello(EspHandshake* hs, uint32_t now, EspHsAction* act) {
+    snprintf(act->line, sizeof(act->line), "HELLO:%d:%u:%lu",
+             ESP_HS_PROTOCOL_VERSION, (unsigned)ESP_HS_LOCAL_CAPS, (unsigned long)ESP_HS_MAX_BAUD);
+    hs->state = ESP_HS_HELLO_SENT;
+    hs->deadline = now + ESP_HS_HELLO_TIMEOUT_MS;
+}
+
+static void finish(EspHandshake* hs, EspHandshakeState state, EspHsAction* act) {
+    hs->state = state;
+    if (state == ESP_HS_LEGACY) hs->caps = 0;
+    act->linkUp = true;
+}
+
+// Prochain débit plus lent que l'essai précédent et accepté par les deux côtés
+static uint32_t next_trial_baud(const EspHandshake* hs) {
+    if ((hs->caps & ESP_CAP_BAUD_UPGRADE) == 0) return 0;
+    for (size_t i = 0; i < sizeof(kBaudSteps) / sizeof(kBaudSteps[0]); i++) {
+        uint32_t b = kBaudSteps[i];
+        if (hs->trialBaud != 0 && b >= hs->trialBaud) continue;
+        if (b <= hs->peerMaxBaud && b <= ESP_HS_MAX_BAUD) return b;
+    }
+    return 0;
+}
+
+static void begin_next_baud(EspHandshake* hs, uint32_t now, EspHsAction* act) {
+    uint32_t b = next_trial_baud(hs);
+    if (b == 0) {
+        // Aucun débit supérieur possible: le lien reste à 115200
+        hs->trialBaud = 0;
+        finish(hs, ESP_HS_READY, act);
+        return;
+    }
+    hs->trialBaud = b;
+    snprintf(act->line, sizeof(act->line), "BAUD:%lu", (unsigned long)b);
+    set_baud(hs, b, act);
+    hs->state = ESP_HS_BAUD_SWITCHED;
+    hs->deadline = now;
+}
+
+// Champ numérique "<n>" suivi de ':' ou de la fin de ligne
+static bool parse_field(const char** p, unsigned long* out) {
+    char* end;
+    if (**p < '0' || **p > '9') return false;
+    *out = strtoul(*p, &end, 10);
+    if (*end == ':') end++;
+    else if (*end != '\0') return false;
+    *p = end;
+    return true;
+}
+
+static bool parse_hello_ack(EspHandshake* hs, const char* args) {
+    unsigned long version, caps, baud;
+    const char* p = args;
+    if (!parse_field(&p, &version) || !parse_field(&p, &caps) || !parse_field(&p, &baud)) return false;
+    if (*p != '\0' || version == 0 || version > 255 || caps > 255) return false;
+    hs->peerVersion = (uint8_t)version;
+    hs->peerCaps = (uint8_t)caps;
+    hs->peerMaxBaud = (uint32_t)baud;
+    return true;
+}
+
+void EspHandshake_Init(EspHandshake* hs) {
+    memset(hs, 0, sizeof(*hs));
+    hs->state = ESP_HS_IDLE;
+    hs->baud = ESP_HS_DEFAULT_BAUD;
+}
+
+void EspHandshake_Start(EspHandshake* hs, uint32_t now, EspHsAction* act) {
+    action_clear(act);
+    hs->retries = 0;
+    hs->caps = 0;
+    hs->peerCaps = 0;
+    hs->peerVersion = 0;
+    hs->peerMaxBaud = 0;
+    hs->trialBaud = 0;
+    act->linkDown = true;
+    set_baud(hs, ESP_HS_DEFAULT_BAUD, act);
+    send_hello(hs, now, act);
+}
+
+bool EspHandshake_OnLine(EspHandshake* hs, const char* line, uint32_t now, EspHsAction* act) {
+    action_clear(act);
+    if (!line) return false;
+
+    if (strncmp(line, "HELLO_ACK:", 10) == 0) {
+        if (hs->state == ESP_HS_HELLO_SENT) {
+            if (parse_hello_ack(hs, line + 10)) {
+                hs->caps = (uint8_t)(ESP_HS_LOCAL_CAPS & hs->peerCaps);
+                begin_next_baud(hs, now, act);
+            } else {
+                printf("[ESP_HS] Malformed HELLO_ACK: %s\r\n", line);
+            }
+        }
+        return true;
+    }
+
+    if (strncmp(line, "SYNC_ACK:", 9) == 0) {
+        if (hs->state == ESP_HS_SYNC_SENT) {
+            if (strcmp(line + 9, ESP_HS_SYNC_PATTERN) == 0) {
+                finish(hs, ESP_HS_READY, act);
+            } else {
+                // Motif altéré: débit non fiable, même traitement qu'un timeout
+                hs->fallbacks++;
+                set_baud(hs, ESP_HS_DEFAULT_BAUD, act);
+                hs->state = ESP_HS_REVERTING;
+                hs->deadline = now + ESP_HS_REVERT_DELAY_MS;
+            }
+        }
+        return true;
+    }
+
+    // L'ESP (re)démarré demande une nouvelle négociation
+    if (strcmp(line, "HELLO") == 0) {
+        EspHandshake_Start(hs, now, act);
+        return true;
+    }
+
+    return false;
+}
+
+void EspHandshake_Poll(EspHandshake* hs, uint32_t now, EspHsAction* act) {
+    action_clear(act);
+    if (!EspHandshake_IsBusy(hs) || !deadline_reached(hs, now)) return;
+
+    switch (hs->state) {
+        case ESP_HS_HELLO_SENT:
+            if (++hs->retries >= ESP_HS_HELLO_RETRIES) {
+                finish(hs, ESP_HS_LEGACY, act);
+            } else {
+                send_hello(hs, now, act);
+            }
+            break;
+        case ESP_HS_BAUD_SWITCHED:
+            snprintf(act->line, sizeof(act->line), "SYNC:%s", ESP_HS_SYNC_PATTERN);
+            hs->state = ESP_HS_SYNC_SENT;
+            hs->deadline = now + ESP_HS_SYNC_TIMEOUT_MS;
+            break;
+        case ESP_HS_SYNC_SENT:
+            // Pas d'écho au nouveau débit: retour à 115200 des deux côtés
+            hs->fallbacks++;
+            set_baud(hs, ESP_HS_DEFAULT_BAUD, act);
+            hs->state = ESP_HS_REVERTING;
+            hs->deadline = now + ESP_HS_REVERT_DELAY_MS;
+            break;
+        case ESP_HS_REVERTING:
+            begin_next_baud(hs, now, act);
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t EspHandshake_TimeToDeadline(const EspHandshake* hs, uint32_t now) {
+    if (!EspHandshake_IsBusy(hs)) return UINT32_MAX;
+    int32_t left = (int32_t)(hs->deadline - now);
+    return (left > 0) ? (uint32_t)left : 0U;
+}
+
+bool EspHandshake_IsBusy(const EspHandshake* hs) {
+    return hs->state == ESP_HS_HELLO_SENT || hs->state == ESP_HS_BAUD_SWITCHED ||
+           hs->state == ESP_HS_SYNC_SENT || hs->state == ESP_HS_REVERTING;
+}
@@ -0,0 +1,341 @@
+#include "esp_protocol.h"
+#include <stdio.h>
+#include <string.h>
+
+// Entrée de la table des mots-clés: préfixe (suivi d'arguments) ou ligne exacte
+typedef struct {
+    const char* text;
+    uint8_t len;
+    bool exact;
+    EspMessageType type;
+} EspKeyword;
+
+#define KW(s, exact, type) { s, (uint8_t)(sizeof(s) - 1), exact, type }
+
+// Tables regroupées par premier caractère: le switch ne compare ensuite
+// qu'une poignée de candidats au lieu de toute la liste
+static const EspKeyword kKeywordsC[] = {
+    KW("CATALOG_BEGIN:", false, ESP_MSG_CATALOG_BEGIN),
+    KW("CATALOG_ITEM:",  false, ESP_MSG_CATALOG_ITEM),
+    KW("CATALOG_END:",   false, ESP_MSG_CATALOG_END),
+};
+
+static const EspKeyword kKeywordsD[] = {
+    KW("DIAG:CAL", true, ESP_MSG_DIAG_CALIB),
+};
+
+static const EspKeyword kKeywordsN[] = {
+    KW("NFC_UID:",                false, ESP_MSG_NFC_UID),
+    KW("NFC_ERR:",                false, ESP_MSG_NFC_ERR),
+    KW("NAK:STATE:PAYING:NO_NET", false, ESP_MSG_NAK_PAYING_NO_NET),
+    KW("NAK:PAYMENT:DENIED",      true,  ESP_MSG_NAK_PAYMENT_DENIED),
+};
+
+static const EspKeyword kKeywordsO[] = {
+    KW("ORDER_START:",  false, ESP_MSG_ORDER_START),
+    KW("ORDER:",        false, ESP_MSG_ORDER_BATCH),
+    KW("ORDER_END",     true,  ESP_MSG_ORDER_END),
+    KW("ORDER_FAILED",  true,  ESP_MSG_ORDER_FAILED),
+};
+
+static const EspKeyword kKeywordsQ[] = {
+    KW("QR_TOKEN_ERROR",      true, ESP_MSG_QR_TOKEN_ERROR),
+    KW("QR_TOKEN_INVALID",    true, ESP_MSG_QR_TOKEN_INVALID),
+    KW("QR_TOKEN_BUSY",       true, ESP_MSG_QR_TOKEN_BUSY),
+    KW("QR_TOKEN_NO_NETWORK", true, ESP_MSG_QR_TOKEN_NO_NETWORK),
+};
+
+static const EspKeyword kKeywordsV[] = {
+    KW("VEND ", false, ESP_MSG_VEND_COMMAND),
+};
+
+#define KW_COUNT(t) (sizeof(t) / sizeof((t)[0]))
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+static const char* skip_spaces(const char* p) {
+    while (is_space(*p)) p++;
+    return p;
+}
+
+// Trouve le mot-clé correspondant; *args pointe après le préfixe reconnu
+static EspMessageType match_keyword(const char* line, const char** args) {
+    const EspKeyword* table;
+    size_t count;
+
+    switch (line[0]) {
+        case 'C': table = kKeywordsC; count = KW_COUNT(kKeywordsC); break;
+        case 'D': table = kKeywordsD; count = KW_COUNT(kKeywordsD); break;
+        case 'N': table = kKeywordsN; count = KW_COUNT(kKeywordsN); break;
+        case 'O': table = kKeywordsO; count = KW_COUNT(kKeywordsO); break;
+        case 'Q': table = kKeywordsQ; count = KW_COUNT(kKeywordsQ); break;
+        case 'V': table = kKeywordsV; count = KW_COUNT(kKeywordsV); break;
+        default:  return ESP_MSG_UNKNOWN;
+    }
+
+    for (size_t k = 0; k < count; k++) {
+        const EspKeyword* kw = &table[k];
+        // Le premier caractère est déjà connu; le '\0' de la ligne stoppe la comparaison
+        uint8_t i = 1;
+        while (i < kw->len && line[i] == kw->text[i]) i++;
+        if (i != kw->len) continue;
+        if (kw->exact && line[i] != '\0') continue;
+        *args = &line[i];
+        return kw->type;
+    }
+    return ESP_MSG_UNKNOWN;
+}
+
+// Entier signé décimal (blancs initiaux ignorés); NULL si aucun chiffre
+static const char* parse_int(const char* p, int32_t* out) {
+    p = skip_spaces(p);
+    bool neg = false;
+    if (*p == '+' || *p == '-') {
+        neg = (*p == '-');
+        p++;
+    }
+    if (*p < '0' || *p > '9') return NULL;
+
+    int32_t v = 0;
+    while (*p >= '0' && *p <= '9') {
+        // Saturation: toute valeur aussi grande est hors bornes de toute façon
+        if (v < 100000) v = v * 10 + (*p - '0');
+        p++;
+    }
+    *out = neg ? -v : v;
+    return p;
+}
+
+// Mot sans blanc (blancs initiaux ignorés), tronqué à ESP_PROTO_ID_MAX_LEN; false si vide
+static bool parse_word(const char* p, char* out) {
+    p = skip_spaces(p);
+    size_t n = 0;
+    while (*p != '\0' && !is_space(*p) && n < ESP_PROTO_ID_MAX_LEN) {
+        out[n++] = *p++;
+    }
+    out[n] = '\0';
+    return n > 0;
+}
+
+// "VEND <slot> <qty> <product_id>"
+static bool decode_vend(const char* p, EspCommand* cmd) {
+    int32_t slot, qty;
+    p = parse_int(p, &slot);
+    if (!p) return false;
+    p = parse_int(p, &qty);
+    if (!p) return false;
+    if (!parse_word(p, cmd->product_id)) return false;
+
+    if (slot < ESP_PROTO_SLOT_MIN || slot > ESP_PROTO_SLOT_MAX ||
+        qty < ESP_PROTO_QTY_MIN || qty > ESP_PROTO_QTY_MAX) {
+        return false;
+    }
+    cmd->slot_number = (uint8_t)slot;
+    cmd->quantity = (uint8_t)qty;
+    return true;
+}
+
+// Identifiant de commande groupée: arrêté par le séparateur attendu, sans blanc
+static const char* parse_order_token(const char* p, char sep, char* out) {
+    size_t n = 0;
+    while (*p != sep && *p != '\0') {
+        if (*p == ';' || *p == ',' || is_space(*p) || n >= ESP_PROTO_ID_MAX_LEN) return NULL;
+        out[n++] = *p++;
+    }
+    out[n] = '\0';
+    return (n > 0) ? p : NULL;
+}
+
+// Entier borné suivi de ','
+static const char* parse_order_field(const char* p, int32_t min, int32_t max, uint8_t* out) {
+    int32_t v;
+    if (*p < '0' || *p > '9') return NULL;
+    p = parse_int(p, &v);
+    if (!p || *p != ',' || v < min || v > max) return NULL;
+    *out = (uint8_t)v;
+    return p + 1;
+}
+
+bool EspProtocol_DecodeOrder(const char* line, EspOrder* order) {
+    if (!line || !order) return false;
+    order->item_count = 0;
+    if (match_keyword(line, &line) != ESP_MSG_ORDER_BATCH) return false;
+
+    const char* p = parse_order_token(line, ';', order->order_id);
+    if (!p || *p != ';') return false;
+
+    // Articles "<slot>,<qty>,<produit>" séparés par ';'
+    while (*p == ';') {
+        if (order->item_count >= ESP_PROTO_ORDER_MAX_ITEMS) return false;
+        EspOrderItem* item = &order->items[order->item_count];
+        p = parse_order_field(p + 1, ESP_PROTO_SLOT_MIN, ESP_PROTO_SLOT_MAX, &item->slot_number);
+        if (!p) return false;
+        p = parse_order_field(p, ESP_PROTO_QTY_MIN, ESP_PROTO_QTY_MAX, &item->quantity);
+        if (!p) return false;
+        p = parse_order_token(p, ';', item->product_id);
+        if (!p) return false;
+        order->item_count++;
+    }
+    return *p == '\0';
+}
+
+// Entier borné, seul jusqu'à la fin de la ligne (blancs finaux tolérés)
+static bool parse_last_int(const char* p, int32_t min, int32_t max, int32_t* out) {
+    p = parse_int(p, out);
+    if (!p || *out < min || *out > max) return false;
+    return *skip_spaces(p) == '\0';
+}
+
+// "CATALOG_ITEM:<code>,<canal>,<capteur>,<prix>,<libellé>": code de 1 à
+// PRODUCT_CODE_MAX_DIGITS chiffres (zéros initiaux significatifs), libellé
+// imprimable jusqu'à la fin de la ligne, blancs compris
+static bool decode_catalog_item(const char* p, EspCommand* cmd) {
+    ProductEntry* e = &cmd->product;
+    while (*p >= '0' && *p <= '9') {
+        if (e->digits == PRODUCT_CODE_MAX_DIGITS) return false;
+        e->code = (uint16_t)(e->code * 10U + (uint16_t)(*p - '0'));
+        e->digits++;
+        p++;
+    }
+    if (e->digits == 0 || *p != ',') return false;
+
+    int32_t price;
+    p = parse_order_field(p + 1, 0, 255, &e->channel);
+    if (!p) return false;
+    p = parse_order_field(p, 0, ESP_PROTO_CATALOG_SENSOR_NONE, &e->sensorId);
+    if (!p || *p < '0' || *p > '9') return false;
+    p = parse_int(p, &price);
+    if (!p || *p != ',' || price > 0xFFFF) return false;
+    e->priceCents = (uint16_t)price;
+
+    size_t n = 0;
+    for (p++; *p != '\0' && *p != '\r' && *p != '\n'; p++) {
+        if (n >= PRODUCT_LABEL_LEN - 1U || *p < 0x20 || *p > 0x7E) return false;
+        e->label[n++] = *p;
+    }
+    e->label[n] = '\0';
+    if (e->sensorId == ESP_PROTO_CATALOG_SENSOR_NONE) e->sensorId = PRODUCT_SENSOR_NONE;
+    return n > 0;
+}
+
+EspMessageType EspProtocol_Classify(const char* line) {
+    if (!line) return ESP_MSG_UNKNOWN;
+    const char* args;
+    return match_keyword(line, &args);
+}
+
+EspMessageType EspProtocol_Decode(const char* line, EspCommand* cmd) {
+    if (!cmd) return EspProtocol_Classify(line);
+
+    cmd->type = ESP_MSG_UNKNOWN;
+    cmd->valid = false;
+    cmd->slot_number = 0;
+    cmd->quantity = 0;
+    cmd->product_id[0] = '\0';
+    cmd->order_id[0] = '\0';
+    cmd->catalog_version = 0;
+    cmd->catalog_count = 0;
+    memset(&cmd->product, 0, sizeof(cmd->product));
+    if (!line) return ESP_MSG_UNKNOWN;
+
+    const char* args = NULL;
+    cmd->type = match_keyword(line, &args);
+
+    switch (cmd->type) {
+        case ESP_MSG_UNKNOWN:
+            break;
+        case ESP_MSG_VEND_COMMAND:
+            cmd->valid = decode_vend(args, cmd);
+            break;
+        case ESP_MSG_ORDER_START:
+            cmd->valid = parse_word(args, cmd->order_id);
+            break;
+        case ESP_MSG_ORDER_BATCH:
+            // Articles lus par EspProtocol_DecodeOrder dans un descripteur dédié
+            break;
+        case ESP_MSG_CATALOG_BEGIN: {
+            int32_t version;
+            cmd->valid = parse_last_int(args, 0, ESP_PROTO_CATALOG_VERSION_MAX, &version);
+            if (cmd->valid) cmd->catalog_version = (uint16_t)version;
+            break;
+        }
+        case ESP_MSG_CATALOG_ITEM:
+            cmd->valid = decode_catalog_item(args, cmd);
+            break;
+        case ESP_MSG_CATALOG_END: {
+            int32_t count;
+            cmd->valid = parse_last_int(args, 1, PRODUCT_CATALOG_MAX, &count);
+            if (cmd->valid) cmd->catalog_count = (uint8_t)count;
+            break;
+        }
+        default:
+            cmd->valid = true;
+            break;
+    }
+    return cmd->type;
+}
+
+static const char* code_text(uint8_t code) {
+    switch (code) {
+        case ESP_CODE_NO_ACTIVE_ORDER:     return "NO_ACTIVE_ORDER";
+        case ESP_CODE_INVALID_VEND_FORMAT: return "INVALID_VEND_FORMAT";
+        case ESP_CODE_INVALID_CHANNEL:     return "INVALID_CHANNEL";
+        case ESP_CODE_ORDER_CANCELLED:     return "ORDER_CANCELLED";
+        case ESP_CODE_STATE_PAYING:        return "PAYING";
+        case ESP_CODE_INVALID_ORDER_FORMAT: return "INVALID_ORDER_FORMAT";
+        case ESP_CODE_ORDER_BUSY:          return "ORDER_BUSY";
+        case ESP_CODE_MOTOR_FAILED:        return "MOTOR_FAILED";
+        case ESP_CODE_NO_DROP:             return "NO_DROP";
+        case ESP_CODE_CATALOG_FORMAT:      return "FORMAT";
+        case ESP_CODE_CATALOG_INVALID:     return "INVALID";
+        case ESP_CODE_CATALOG_STORAGE:     return "STORAGE";
+        case ESP_CODE_CATALOG_BUSY:        return "BUSY";
+        default:                           return "UNKNOWN";
+    }
+}
+
+size_t EspProtocol_FormatResponse(const EspResponse* rsp, char* out, size_t outSize) {
+    if (!rsp || !out || outSize == 0) return 0;
+
+    int n;
+    switch (rsp->type) {
+        case ESP_RSP_ORDER_ACK:
+            n = snprintf(out, outSize, "ORDER_ACK");
+            break;
+        case ESP_RSP_ORDER_NAK:
+            n = snprintf(out, outSize, "ORDER_NAK:%s", code_text(rsp->code));
+            break;
+        case ESP_RSP_VEND_COMPLETED:
+            n = snprintf(out, outSize, "VEND_COMPLETED:%d", rsp->slot);
+            break;
+        case ESP_RSP_VEND_FAILED:
+            if (rsp->quantity == 0) {
+                n = snprintf(out, outSize, "VEND_FAILED:%d:%s", rsp->slot, code_text(rsp->code));
+            } else {
+                n = snprintf(out, outSize, "VEND_FAILED:%d:%s:%d/%d", rsp->slot, code_text(rsp->code),
+                             rsp->delivered, rsp->quantity);
+            }
+            break;
+        case ESP_RSP_DELIVERY_COMPLETED:
+            n = snprintf(out, outSize, "DELIVERY_COMPLETED");
+            break;
+        case ESP_RSP_DELIVERY_FAILED:
+            n = snprintf(out, outSize, "DELIVERY_FAILED:%s", code_text(rsp->code));
+            break;
+        case ESP_RSP_STATE:
+            n = snprintf(out, outSize, "STATE:%s", code_text(rsp->code));
+            break;
+        case ESP_RSP_CATALOG_ACK:
+            n = snprintf(out, outSize, "CATALOG_ACK");
+            break;
+        case ESP_RSP_CATALOG_NAK:
+            n = snprintf(out, outSize, "CATALOG_NAK:%s", code_text(rsp->code));
+            break;
+        default:
+            return 0;
+    }
+    if (n < 0 || (size_t)n >= outSize) return 0;
+    return (size_t)n;
+}
@@ -0,0 +1,147 @@
+#include "esp_seq.h"
+#include <string.h>
+
+// Nombre décimal 0..255 terminé par ':' ou par la fin de ligne
+static bool parse_seq(const char* p, uint8_t* seq, const char** end) {
+    unsigned value = 0;
+    size_t digits = 0;
+    while (p[digits] >= '0' && p[digits] <= '9') {
+        value = value * 10U + (unsigned)(p[digits] - '0');
+        if (++digits > 3 || value > 255U) return false;
+    }
+    if (digits == 0) return false;
+    *seq = (uint8_t)value;
+    *end = p + digits;
+    return true;
+}
+
+EspSeqLineKind EspSeq_ParseLine(const char* line, uint8_t* seq, const char** body) {
+    if (!line || line[0] != '#') return ESP_SEQ_LINE_NONE;
+
+    const char* end;
+    uint8_t value;
+    EspSeqLineKind kind;
+    if (strncmp(line + 1, "ACK:", 4) == 0) {
+        kind = ESP_SEQ_LINE_ACK;
+        if (!parse_seq(line + 5, &value, &end) || *end != '\0') return ESP_SEQ_LINE_INVALID;
+    } else if (strncmp(line + 1, "NAK:", 4) == 0) {
+        kind = ESP_SEQ_LINE_NAK;
+        if (!parse_seq(line + 5, &value, &end) || *end != '\0') return ESP_SEQ_LINE_INVALID;
+    } else {
+        kind = ESP_SEQ_LINE_DATA;
+        if (!parse_seq(line + 1, &value, &end) || *end != ':' || end[1] == '\0') {
+            return ESP_SEQ_LINE_INVALID;
+        }
+        if (body) *body = end + 1;
+    }
+    if (seq) *seq = value;
+    return kind;
+}
+
+// ============================================================================
+// RÉCEPTION
+// ============================================================================
+
+void EspSeq_RxReset(EspSeqRx* rx) {
+    memset(rx, 0, sizeof(*rx));
+}
+
+EspSeqRxResult EspSeq_RxCheck(const EspSeqRx* rx, uint8_t seq) {
+    uint8_t d = (uint8_t)(seq - rx->expected);
+
+    if (d == 0) return ESP_SEQ_RX_DELIVER;
+    if (d < ESP_SEQ_WINDOW) {
+        return (rx->held & (1U << d)) ? ESP_SEQ_RX_DUPLICATE : ESP_SEQ_RX_BUFFERED;
+    }
+    if (d >= (uint8_t)(256U - ESP_SEQ_WINDOW)) {
+        return ESP_SEQ_RX_DUPLICATE;
+    }
+    return ESP_SEQ_RX_REJECTED;
+}
+
+EspSeqRxResult EspSeq_RxAccept(EspSeqRx* rx, uint8_t seq, const EspCommand* cmd) {
+    EspSeqRxResult r = EspSeq_RxCheck(rx, seq);
+
+    if (r == ESP_SEQ_RX_DELIVER) {
+        // Bit i de held = seq expected + i: décalage d'un cran
+        rx->expected++;
+        rx->held >>= 1;
+        rx->nakSent = false;
+    } else if (r == ESP_SEQ_RX_BUFFERED) {
+        rx->held |= (uint8_t)(1U << (uint8_t)(seq - rx->expected));
+        rx->pending[seq % ESP_SEQ_WINDOW] = *cmd;
+    }
+    return r;
+}
+
+bool EspSeq_RxNext(EspSeqRx* rx, EspCommand* cmd) {
+    if ((rx->held & 1U) == 0) return false;
+    *cmd = rx->pending[rx->expected % ESP_SEQ_WINDOW];
+    rx->expected++;
+    rx->held >>= 1;
+    return true;
+}
+
+uint8_t EspSeq_RxAckValue(const EspSeqRx* rx) {
+    return (uint8_t)(rx->expected - 1U);
+}
+
+// ============================================================================
+// ÉMISSION
+// ============================================================================
+
+void EspSeq_TxReset(EspSeqTx* tx) {
+    memset(tx, 0, sizeof(*tx));
+}
+
+uint8_t EspSeq_TxInFlight(const EspSeqTx* tx) {
+    return (uint8_t)(tx->next - tx->base);
+}
+
+bool EspSeq_TxPush(EspSeqTx* tx, const EspResponse* rsp, uint32_t now, uint8_t* seq) {
+    if (EspSeq_TxInFlight(tx) >= ESP_SEQ_WINDOW) return false;
+
+    uint8_t idx = tx->next % ESP_SEQ_WINDOW;
+    tx->rsp[idx] = *rsp;
+    tx->sentAt[idx] = now;
+    tx->retries[idx] = 0;
+    *seq = tx->next++;
+    return true;
+}
+
+uint8_t EspSeq_TxAck(EspSeqTx* tx, uint8_t seq) {
+    uint8_t d = (uint8_t)(seq - tx->base);
+    if (d >= EspSeq_TxInFlight(tx)) return 0;   // Acquit ancien ou seq jamais émis
+    uint8_t freed = (uint8_t)(d + 1U);
+    tx->base = (uint8_t)(tx->base + freed);
+    return freed;
+}
+
+const EspResponse* EspSeq_TxGet(EspSeqTx* tx, uint8_t seq, uint32_t now) {
+    uint8_t d = (uint8_t)(seq - tx->base);
+    if (d >= EspSeq_TxInFlight(tx)) return NULL;
+    uint8_t idx = seq % ESP_SEQ_WINDOW;
+    tx->sentAt[idx] = now;
+    return &tx->rsp[idx];
+}
+
+bool EspSeq_TxPollRetransmit(EspSeqTx* tx, uint32_t now, uint8_t* seq,
+                             EspResponse* rsp, bool* dropped) {
+    if (EspSeq_TxInFlight(tx) == 0) return false;
+
+    uint8_t idx = tx->base % ESP_SEQ_WINDOW;
+    if ((now - tx->sentAt[idx]) < ESP_SEQ_RTO_MS) return false;
+
+    *seq = tx->base;
+    *rsp = tx->rsp[idx];
+    if (tx->retries[idx] >= ESP_SEQ_MAX_RETRIES) {
+        // ESP muet: la réponse est abandonnée pour ne pas bloquer la fenêtre
+        tx->base++;
+        *dropped = true;
+        return true;
+    }
+    tx->retries[idx]++;
+    tx->sentAt[idx] = now;
+    *dropped = false;
+    return true;
+}
@@ -0,0 +1,214 @@
+#include "i2c_bus_service.h"
+#include "global.h"
+#include <string.h>
+
+// Notifications de la tâche d'un bus
+#define I2C_BUS_NOTIFY_SUBMIT  0x01UL
+#define I2C_BUS_NOTIFY_XFER    0x02UL
+
+typedef struct {
+    I2C_HandleTypeDef* hi2c;
+    const char* name;
+    I2cTxnQueue queue;
+    TaskHandle_t task;
+    volatile uint8_t xferStatus;   // Posé par les callbacks HAL
+    uint32_t errors;
+    uint32_t timeouts;
+} I2cBus;
+
+static I2cBus i2cBuses[I2C_BUS_COUNT] = {
+    { .hi2c = &hi2c1, .name = "i2cBus1" },
+    { .hi2c = &hi2c2, .name = "i2cBus2" },
+};
+
+// Demandeur synchrone, sur sa pile le temps de l'attente
+typedef struct {
+    osThreadId_t waiter;
+    uint8_t status;
+} I2cBusWait;
+
+static void i2c_bus_notify_from_isr(I2C_HandleTypeDef* hi2c, HAL_StatusTypeDef status) {
+    for (uint8_t i = 0; i < I2C_BUS_COUNT; i++) {
+        I2cBus* b = &i2cBuses[i];
+        if (b->hi2c != hi2c || b->task == NULL) continue;
+        b->xferStatus = (uint8_t)status;
+        BaseType_t woken = pdFALSE;
+        xTaskNotifyFromISR(b->task, I2C_BUS_NOTIFY_XFER, eSetBits, &woken);
+        portYIELD_FROM_ISR(woken);
+        return;
+    }
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    i2c_bus_notify_from_isr(hi2c, HAL_OK);
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    i2c_bus_notify_from_isr(hi2c, HAL_OK);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    i2c_bus_notify_from_isr(hi2c, HAL_OK);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    i2c_bus_notify_from_isr(hi2c, HAL_OK);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) {
+    i2c_bus_notify_from_isr(hi2c, HAL_ERROR);
+}
+
+// Une phase du transfert: lancement IT puis attente de son callback
+static HAL_StatusTypeDef i2c_bus_phase(I2cBus* b, HAL_StatusTypeDef started) {
+    if (started != HAL_OK) return started;
+    TickType_t start = xTaskGetTickCount();
+    TickType_t limit = pdMS_TO_TICKS(I2C_BUS_XFER_TIMEOUT_MS);
+    for (;;) {
+        uint32_t bits = 0;
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        // Une soumission pendant le transfert réveille aussi: la file est
+        // relue après chaque transaction
+        if (elapsed < limit && xTaskNotifyWait(0, UINT32_MAX, &bits, limit - elapsed) == pdTRUE) {
+            if (bits & I2C_BUS_NOTIFY_XFER) return (HAL_StatusTypeDef)b->xferStatus;
+            continue;
+        }
+        // Fin jamais signalée: périphérique remis à zéro, le bus repart
+        b->timeouts++;
+        HAL_I2C_DeInit(b->hi2c);
+        HAL_I2C_Init(b->hi2c);
+        return HAL_TIMEOUT;
+    }
+}
+
+static HAL_StatusTypeDef i2c_bus_execute(I2cBus* b, I2cTxn* t) {
+    HAL_StatusTypeDef st = HAL_OK;
+    // Fin d'un transfert précédent arrivée après son échéance
+    xTaskNotifyWait(0, UINT32_MAX, NULL, 0);
+    // Accès registre: adresse et données dans une seule transaction, la
+    // lecture repart en redémarrage sans rendre le bus
+    uint16_t memSize = (t->memAddrSize == 2) ? I2C_MEMADD_SIZE_16BIT : I2C_MEMADD_SIZE_8BIT;
+    if (t->op == I2C_TXN_MEM_WRITE) {
+        return i2c_bus_phase(b, HAL_I2C_Mem_Write_IT(b->hi2c, t->addr8, t->memAddr, memSize, t->tx, t->txLen));
+    }
+    if (t->op == I2C_TXN_MEM_READ) {
+        return i2c_bus_phase(b, HAL_I2C_Mem_Read_IT(b->hi2c, t->addr8, t->memAddr, memSize, t->rx, t->rxLen));
+    }
+    if (t->op == I2C_TXN_WRITE || t->op == I2C_TXN_WRITE_READ) {
+        st = i2c_bus_phase(b, HAL_I2C_Master_Transmit_IT(b->hi2c, t->addr8, t->tx, t->txLen));
+    }
+    if (st == HAL_OK && (t->op == I2C_TXN_READ || t->op == I2C_TXN_WRITE_READ)) {
+        st = i2c_bus_phase(b, HAL_I2C_Master_Receive_IT(b->hi2c, t->addr8, t->rx, t->rxLen));
+    }
+    return st;
+}
+
+static void StartTaskI2cBus(void* argument) {
+    I2cBus* b = (I2cBus*)argument;
+    for (;;) {
+        I2cTxn txn;
+        taskENTER_CRITICAL();
+        bool pending = I2cTxnQueue_Pop(&b->queue, &txn);
+        taskEXIT_CRITICAL();
+        if (!pending) {
+            xTaskNotifyWait(0, UINT32_MAX, NULL, portMAX_DELAY);
+            continue;
+        }
+
+        HAL_StatusTypeDef st = i2c_bus_execute(b, &txn);
+        if (st != HAL_OK) {
+            b->errors++;
+            LOGW("%s: 0x%02X failed (%d)\r\n", b->name, txn.addr8 >> 1, st);
+        }
+        if (txn.done != NULL) {
+            txn.done((uint8_t)st, txn.ctx);
+        }
+    }
+}
+
+void I2cBusService_Init(void) {
+    for (uint8_t i = 0; i < I2C_BUS_COUNT; i++) {
+        I2cBus* b = &i2cBuses[i];
+        I2cTxnQueue_Init(&b->queue);
+        const osThreadAttr_t attr = {
+            .name = b->name,
+            .stack_size = 192 * 4,
+            // Au-dessus des demandeurs: l'enchaînement des transactions ne
+            // dépend pas de leur charge
+            .priority = (osPriority_t)osPriorityHigh,
+        };
+        b->task = (TaskHandle_t)osThreadNew(StartTaskI2cBus, b, &attr);
+        if (b->task == NULL) {
+            printf("ERREUR: Impossible de créer %s\r\n", b->name);
+        }
+    }
+}
+
+bool I2cBus_Submit(I2cBusId bus, const I2cTxn* txn, I2cPriority prio) {
+    if (bus >= I2C_BUS_COUNT || txn == NULL) return false;
+    I2cBus* b = &i2cBuses[bus];
+    taskENTER_CRITICAL();
+    bool ok = I2cTxnQueue_Push(&b->queue, txn, prio);
+    taskEXIT_CRITICAL();
+    if (ok && b->task != NULL) {
+        xTaskNotify(b->task, I2C_BUS_NOTIFY_SUBMIT, eSetBits);
+    }
+    return ok;
+}
+
+bool I2cBus_Post(I2cBusId bus, I2cPriority prio, uint16_t addr8, const uint8_t* data, uint8_t len) {
+    if (len > I2C_TXN_TX_MAX) return false;
+    I2cTxn txn = { .addr8 = addr8, .op = I2C_TXN_WRITE, .txLen = len };
+    memcpy(txn.tx, data, len);
+    return I2cBus_Submit(bus, &txn, prio);
+}
+
+static void i2c_bus_wake(uint8_t status, void* ctx) {
+    I2cBusWait* w = (I2cBusWait*)ctx;
+    osThreadId_t waiter = w->waiter;
+    w->status = status;
+    osThreadFlagsSet(waiter, I2C_BUS_FLAG_DONE);   // w n'est plus lu au-delà
+}
+
+static HAL_StatusTypeDef i2c_bus_transact(I2cBusId bus, I2cPriority prio, I2cTxn* txn) {
+    I2cBusWait w = { .waiter = osThreadGetId(), .status = HAL_ERROR };
+    txn->done = i2c_bus_wake;
+    txn->ctx = &w;
+    if (!I2cBus_Submit(bus, txn, prio)) return HAL_BUSY;
+    // Sans échéance: la tâche du bus termine toujours la transaction, et w
+    // doit rester valide jusque-là
+    osThreadFlagsWait(I2C_BUS_FLAG_DONE, osFlagsWaitAny, osWaitForever);
+    return (HAL_StatusTypeDef)w.status;
+}
+
+HAL_StatusTypeDef I2cBus_Write(I2cBusId bus, I2cPriority prio, uint16_t addr8,
+                               const uint8_t* data, uint8_t len) {
+    if (len > I2C_TXN_TX_MAX) return HAL_ERROR;
+    I2cTxn txn = { .addr8 = addr8, .op = I2C_TXN_WRITE, .txLen = len };
+    memcpy(txn.tx, data, len);
+    return i2c_bus_transact(bus, prio, &txn);
+}
+
+HAL_StatusTypeDef I2cBus_WriteRead(I2cBusId bus, I2cPriority prio, uint16_t addr8,
+                                   const uint8_t* tx, uint8_t txLen, uint8_t* rx, uint16_t rxLen) {
+    if (txLen > I2C_TXN_TX_MAX) return HAL_ERROR;
+    I2cTxn txn = { .addr8 = addr8, .op = I2C_TXN_WRITE_READ, .txLen = txLen, .rx = rx, .rxLen = rxLen };
+    memcpy(txn.tx, tx, txLen);
+    return i2c_bus_transact(bus, prio, &txn);
+}
+
+HAL_StatusTypeDef I2cBus_MemWrite(I2cBusId bus, I2cPriority prio, uint16_t addr8, uint16_t memAddr,
+                                  uint8_t memAddrSize, const uint8_t* data, uint8_t len) {
+    if (len > I2C_TXN_TX_MAX) return HAL_ERROR;
+    I2cTxn txn = { .addr8 = addr8, .op = I2C_TXN_MEM_WRITE, .memAddrSize = memAddrSize,
+                   .memAddr = memAddr, .txLen = len };
+    memcpy(txn.tx, data, len);
+    return i2c_bus_transact(bus, prio, &txn);
+}
+
+HAL_StatusTypeDef I2cBus_MemRead(I2cBusId bus, I2cPriority prio, uint16_t addr8, uint16_t memAddr,
+                                 uint8_t memAddrSize, uint8_t* rx, uint16_t rxLen) {
+    I2cTxn txn = { .addr8 = addr8, .op = I2C_TXN_MEM_READ, .memAddrSize = memAddrSize,
+                   .memAddr = memAddr, .rx = rx, .rxLen = rxLen };
+    return i2c_bus_transact(bus, prio, &txn);
+}
@@ -2,6 +2,7 @@
 #include "global.h"
 #include "orchestrator.h"
 #include "watchdog_service.h"
+#include "gpio_port.h"
 #include "string.h"
 
 #define KEYPAD_MAX_INVALID_ATTEMPTS 10
@@ -12,12 +13,18 @@ static uint32_t invalidAttempts = 0;
 static uint32_t lastKeyPressTime = 0;
 static uint32_t lockoutStartTime = 0;
 
-// Ports et broches pour les lignes et colonnes
-static GPIO_TypeDef* rowPorts[KEYPAD_ROWS] = {GPIOA, GPIOA, GPIOB, GPIOC};
-static uint16_t rowPins[KEYPAD_ROWS] = {GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10, GPIO_PIN_7};
+// Ports et broches pour les lignes et colonnes (lignes: PAD_OUTPUT*, colonnes
+// groupées par port pour une lecture IDR par port)
+static GPIO_TypeDef* rowPorts[KEYPAD_ROWS] = {PAD_OUTPUTA8_GPIO_Port, PAD_OUTPUTA9_GPIO_Port, PAD_OUTPUTB6_GPIO_Port, PAD_OUTPUT_GPIO_Port};
+static uint16_t rowPins[KEYPAD_ROWS] = {PAD_OUTPUTA8_Pin, PAD_OUTPUTA9_Pin, PAD_OUTPUTB6_Pin, PAD_OUTPUT_Pin};
 
-static GPIO_TypeDef* colPorts[KEYPAD_COLS] = {GPIOA, GPIOB, GPIOB};
-static uint16_t colPins[KEYPAD_COLS] = {GPIO_PIN_10, GPIO_PIN_4, GPIO_PIN_5};
+static GPIO_TypeDef* colPorts[KEYPAD_COLS] = {PAD_INPUT_GPIO_Port, PAD_INPUTB4_GPIO_Port, PAD_INPUTB5_GPIO_Port};
+static uint16_t colPins[KEYPAD_COLS] = {PAD_INPUT_Pin, PAD_INPUTB4_Pin, PAD_INPUTB5_Pin};
+
+// Écritures précalculées, pour chaque ligne "elle seule basse": une écriture
+// par port, celui de la ligne sélectionnée en dernier pour que deux lignes ne
+// soient jamais basses en même temps
+static GpioPortBatch rowSelect[KEYPAD_ROWS];
 
 static char keymap[KEYPAD_ROWS][KEYPAD_COLS] = {
     {'1', '2', '3'},
@@ -26,28 +33,40 @@ static char keymap[KEYPAD_ROWS][KEYPAD_COLS] = {
     {'*', '0', '#'}
 };
 
-// ---------- Queue d'event unifiée ----------
-extern osMessageQueueId_t orchestratorEventQueueHandle;
-
-void Keypad_Init(void) {
+static void keypad_build_row_select(GpioPortBatch* b, int row) {
+    GpioPortBatch_Init(b);
     for (int i = 0; i < KEYPAD_ROWS; i++) {
-        HAL_GPIO_WritePin(rowPorts[i], rowPins[i], GPIO_PIN_SET);
+        if (rowPorts[i] != rowPorts[row]) {
+            GpioPortBatch_Put(b, rowPorts[i], rowPins[i], rowPins[i]);
+        }
+    }
+    for (int i = 0; i < KEYPAD_ROWS; i++) {
+        if (rowPorts[i] == rowPorts[row]) {
+            GpioPortBatch_Put(b, rowPorts[i], rowPins[i], (i == row) ? 0 : rowPins[i]);
+        }
     }
 }
 
-static void setAllRowsHigh(void) {
+void Keypad_Init(void) {
+    GpioPortBatch idle;
+    GpioPortBatch_Init(&idle);
     for (int i = 0; i < KEYPAD_ROWS; i++) {
-        HAL_GPIO_WritePin(rowPorts[i], rowPins[i], GPIO_PIN_SET);
+        GpioPortBatch_Put(&idle, rowPorts[i], rowPins[i], rowPins[i]);
+        keypad_build_row_select(&rowSelect[i], i);
     }
+    GpioPortBatch_Apply(&idle);
 }
 
 char Keypad_Scan(void) {
     for (int row = 0; row < KEYPAD_ROWS; row++) {
-        setAllRowsHigh();
-        HAL_GPIO_WritePin(rowPorts[row], rowPins[row], GPIO_PIN_RESET);
+        GpioPortBatch_Apply(&rowSelect[row]);
         HAL_Delay(1);
+        uint16_t idr = 0;
         for (int col = 0; col < KEYPAD_COLS; col++) {
-            if (HAL_GPIO_ReadPin(colPorts[col], colPins[col]) == GPIO_PIN_RESET) {
+            if (col == 0 || colPorts[col] != colPorts[col - 1]) {
+                idr = GpioPort_ReadIdr(colPorts[col]);
+            }
+            if ((idr & colPins[col]) == 0) {
                 char detected = keymap[row][col];
                 // Anti-rebond simple non bloquant
                 osDelay(20);
@@ -123,7 +142,7 @@ void StartTaskKeypad(void *argument) {
             // Envoi vers l'orchestrateur (voie unifiée)
             OrchestratorEvent oevt = { .type = ORCH_EVT_KEYPAD };
             oevt.data.key = key;
-            osMessageQueuePut(orchestratorEventQueueHandle, &oevt, 0, 0);
+            Orchestrator_PostEvent(&oevt);
             LOGD("[Keypad] Touche valide envoyée\r\n");
             osDelay(80); // évite répétitions rapides
         } else {
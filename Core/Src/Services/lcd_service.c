@@ -1,6 +1,7 @@
 #include "lcd_service.h"
 #include "global.h"
 #include "watchdog_service.h"
+#include "i2c_bus_service.h"
 #include <string.h>
 
 #define LCD_ADDR         (0x27 << 1) // Adresse I2C du module (0x27 est classique)
@@ -9,35 +10,44 @@
 #define LCD_RW           0x02
 #define LCD_RS           0x01
 
+#define LCD_I2C_BUS      I2C_BUS_1
 //extern I2C_HandleTypeDef hi2c1;
 // lcd_display est défini dans global.c
 extern osMessageQueueId_t lcdMessageQueueHandle;
-extern osMutexId_t i2c1Mutex;
 
-static void lcd_send_nibble(uint8_t nibble, uint8_t control) {
+// Un quartet = 3 octets d'une même transaction (données, front haut de E,
+// front bas): le PCF8574 recopie chaque octet sur ses sorties, E reste haut
+// la durée d'un octet (> 20 us à 400 kHz, 450 ns requis)
+static uint8_t lcd_put_nibble(uint8_t* out, uint8_t nibble, uint8_t control) {
     uint8_t data = nibble | control | LCD_BACKLIGHT;
+    out[0] = data;
+    out[1] = data | LCD_ENABLE;
+    out[2] = data;
+    return 3;
+}
 
-    osMutexAcquire(i2c1Mutex, osWaitForever);
-    HAL_I2C_Master_Transmit(&hi2c1, LCD_ADDR, &data, 1, 50);
-    data |= LCD_ENABLE;
-    HAL_I2C_Master_Transmit(&hi2c1, LCD_ADDR, &data, 1, 50);
-    osDelay(1);
-    data &= ~LCD_ENABLE;
-    HAL_I2C_Master_Transmit(&hi2c1, LCD_ADDR, &data, 1, 50);
-    osMutexRelease(i2c1Mutex);
-    osDelay(1);
+static void lcd_send_nibble(uint8_t nibble, uint8_t control) {
+    uint8_t burst[3];
+    lcd_put_nibble(burst, nibble, control);
+    I2cBus_Write(LCD_I2C_BUS, I2C_PRIO_NORMAL, LCD_ADDR, burst, sizeof(burst));
+}
+
+// Octet complet en une transaction. Entre deux octets, l'entête de la
+// transaction suivante couvre déjà les 37 us d'exécution du contrôleur
+static void lcd_send_byte(uint8_t value, uint8_t control) {
+    uint8_t burst[6];
+    uint8_t n = lcd_put_nibble(burst, value & 0xF0, control);
+    lcd_put_nibble(&burst[n], (uint8_t)((value << 4) & 0xF0), control);
+    I2cBus_Write(LCD_I2C_BUS, I2C_PRIO_NORMAL, LCD_ADDR, burst, sizeof(burst));
 }
 
 void lcd_send_command(uint8_t cmd) {
-    lcd_send_nibble(cmd & 0xF0, 0);
-    lcd_send_nibble((cmd << 4) & 0xF0, 0);
+    lcd_send_byte(cmd, 0);
     osDelay(2);
 }
 
 void lcd_send_data(uint8_t data) {
-    lcd_send_nibble(data & 0xF0, LCD_RS);
-    lcd_send_nibble((data << 4) & 0xF0, LCD_RS);
-    osDelay(2);
+    lcd_send_byte(data, LCD_RS);
 }
 
 void lcd_clear(void) {
@@ -96,7 +106,7 @@ void lcd_scroll_string(char *str, uint8_t row, uint16_t delay_ms) {
 
 void lcd_backlight(uint8_t state) {
     uint8_t data = state ? LCD_BACKLIGHT : 0x00;
-    HAL_I2C_Master_Transmit(&hi2c1, LCD_ADDR, &data, 1, HAL_MAX_DELAY);
+    I2cBus_Post(LCD_I2C_BUS, I2C_PRIO_NORMAL, LCD_ADDR, &data, 1);
 }
 
 void StartTaskLCD(void *argument) {
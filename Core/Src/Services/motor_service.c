@@ -1,38 +1,266 @@
 #include "motor_service.h"
 #include "main.h"
-#include "queue.h"
-#include "orchestrator.h"
-
-// Notification directe + structure de job
-typedef struct {
-    uint8_t channel;
-} MotorJob;
+#include "tim.h"
+#include "motor_pulse.h"
+#include "gpio_port.h"
+#include "flash_log.h"
+#include "flash_sector.h"
+#include "global.h"
 
+// Jobs en attente: accès en section critique, la tâche est réveillée par notification
+static MotorJobQueue motorJobs;
 static TaskHandle_t motorTaskHandleLocal = NULL;
-static MotorJob currentJob = {0};
+static volatile bool motorJobActive = false;    // Job retiré de la file, pas encore terminé
+
+// Impulsion en cours sur TIM3_CH3: séquencée par l'ISR de mise à jour, la
+// tâche ne fait qu'attendre la notification de fin
+static MotorPulse motorPulse;
+static volatile bool motorPulseDone = false;
+
+// Chute attendue pendant le job en cours: détection sous ISR EXTI
+static MotorDropWatch motorDrop;
+static MotorDropStats motorDropStats;
+
+// Calibration par canal: lue et apprise par la tâche moteur, copiée sous
+// section critique pour les diagnostics, sauvegardée moteur à l'arrêt
+static MotorCalibRecord motorCalib[MOTOR_CHANNEL_COUNT];
+static FlashLog motorCalibLog;
+static FlashSectorZone motorCalibZone = { FLASH_SECTOR_CALIB_ADDR, FLASH_SECTOR_7 };
+static bool motorCalibDirty = false;
+static uint32_t motorCalibSavedTick = 0;
 
+// S0..S3 sur GPIOC: une seule écriture BSRR, l'adresse du multiplexeur passe
+// directement de l'ancien canal au nouveau sans adresse intermédiaire
 void MotorService_SelectMotor(uint8_t index) {
-    HAL_GPIO_WritePin(MUX_S0_GPIO_Port, MUX_S0_Pin, (index >> 0) & 0x01 ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(MUX_S1_GPIO_Port, MUX_S1_Pin, (index >> 1) & 0x01 ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(MUX_S2_GPIO_Port, MUX_S2_Pin, (index >> 2) & 0x01 ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(MUX_S3_GPIO_Port, MUX_S3_Pin, (index >> 3) & 0x01 ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    printf("MUX select -> S3:%d S2:%d S1:%d S0:%d (idx=%d)\r\n",
-           (index >> 3) & 1, (index >> 2) & 1, (index >> 1) & 1, (index >> 0) & 1, index);
+    static const uint16_t muxPins[4] = { MUX_S0_Pin, MUX_S1_Pin, MUX_S2_Pin, MUX_S3_Pin };
+    uint16_t mask = 0;
+    uint16_t value = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        mask |= muxPins[i];
+        if ((index >> i) & 0x01) value |= muxPins[i];
+    }
+    GpioPort_Write(MUX_S0_GPIO_Port, mask, value);
 }
 
-static void MotorService_Run(uint8_t channel) {
-    printf("MotorService_Run: channel = %d\r\n", channel);
-    MotorService_SelectMotor(channel);
-    // Temps de stabilisation du mux
-    osDelay(20);
-    HAL_GPIO_WritePin(MUX_IN1_SIG_GPIO_Port, MUX_IN1_SIG_Pin, GPIO_PIN_SET);
+static void motor_pulse_write(const MotorPulseRegs* regs) {
+    __HAL_TIM_SET_PRESCALER(&htim3, regs->psc);
+    __HAL_TIM_SET_AUTORELOAD(&htim3, regs->arr);
+    __HAL_TIM_SET_COMPARE(&htim3, MOTOR_PULSE_TIM_CHANNEL, regs->ccr);
 }
 
-static void MotorService_Stop(uint8_t channel) {
-    printf("MotorService_Stop: channel = %d\r\n", channel);
+// Prépare la période suivante (ISR ou armement); true quand l'impulsion est finie
+static bool motor_pulse_step(void) {
+    MotorPulseRegs regs;
+    switch (MotorPulse_Next(&motorPulse, &regs)) {
+        case MOTOR_PULSE_PRELOAD:
+            motor_pulse_write(&regs);
+            return false;
+        case MOTOR_PULSE_LAST:
+            motor_pulse_write(&regs);
+            htim3.Instance->CR1 |= TIM_CR1_OPM;     // Arrêt matériel en fin de période
+            return false;
+        default:
+            return true;
+    }
+}
+
+static void MotorService_Stop(void) {
+    __HAL_TIM_DISABLE_IT(&htim3, TIM_IT_UPDATE);
+    HAL_TIM_PWM_Stop(&htim3, MOTOR_PULSE_TIM_CHANNEL);
+    htim3.Instance->CR1 &= ~TIM_CR1_OPM;
+    // Sortie éventuellement forcée par une chute: retour en PWM mode 2 (OC3M, CCMR2)
+    MODIFY_REG(htim3.Instance->CCMR2, TIM_CCMR2_OC3M, TIM_OCMODE_PWM2);
+}
+
+static void motor_notify_from_isr(void) {
+    if (motorTaskHandleLocal != NULL) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(motorTaskHandleLocal, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+// Sélection du canal puis impulsion matérielle: attente mux, rampe éventuelle
+// et durée active au tick timer près
+static bool motor_pulse_begin(uint8_t channel, uint32_t settleMs, uint32_t onMs) {
+    MotorPulseSpec spec = {
+        .settleUs = settleMs * 1000U,
+        .onUs = onMs * 1000U,
+        .softStartUs = MOTOR_SOFT_START_US,
+    };
+    MotorPulseRegs first;
+
     MotorService_SelectMotor(channel);
-    // Couper le signal
-    HAL_GPIO_WritePin(MUX_IN1_SIG_GPIO_Port, MUX_IN1_SIG_Pin, GPIO_PIN_RESET);
+    if (!MotorPulse_Start(&motorPulse, &spec, MOTOR_PULSE_TIMER_HZ, &first)) {
+        return false;
+    }
+    motorPulseDone = false;
+    htim3.Instance->CR1 &= ~TIM_CR1_OPM;
+    motor_pulse_write(&first);
+    htim3.Instance->EGR = TIM_EGR_UG;               // Chargement immédiat (URS: sans IT)
+    motor_pulse_step();                             // Période suivante ou arrêt armé
+    __HAL_TIM_CLEAR_IT(&htim3, TIM_IT_UPDATE);
+    __HAL_TIM_ENABLE_IT(&htim3, TIM_IT_UPDATE);
+    HAL_TIM_PWM_Start(&htim3, MOTOR_PULSE_TIM_CHANNEL);
+    return true;
+}
+
+// Valeurs par défaut, remplacées par la dernière sauvegarde valide
+static void motor_calib_load(void) {
+    for (uint8_t ch = 0; ch < MOTOR_CHANNEL_COUNT; ch++) {
+        MotorCalib_Default(&motorCalib[ch], MOTOR_CALIB_INITIAL_ON_MS, MOTOR_MUX_SETTLE_US / 1000U);
+    }
+    FlashLogConfig cfg = {
+        .base = (const uint8_t*)FLASH_SECTOR_CALIB_ADDR,
+        .size = FLASH_SECTOR_ZONE_SIZE,
+        .magic = MOTOR_CALIB_MAGIC,
+        .payloadSize = sizeof(motorCalib),
+        .program = FlashSector_Program,
+        .erase = FlashSector_Erase,
+        .ctx = &motorCalibZone,
+    };
+    FlashLog_Init(&motorCalibLog, &cfg);
+    if (!FlashLog_Read(&motorCalibLog, motorCalib)) {
+        printf("MotorService: default calibration\r\n");
+        return;
+    }
+    for (uint8_t ch = 0; ch < MOTOR_CHANNEL_COUNT; ch++) {
+        if (!MotorCalib_Sanitize(&motorCalib[ch])) {
+            LOGW("MotorService: calibration ch=%d out of range, clamped\r\n", ch);
+        }
+    }
+    printf("MotorService: calibration restored\r\n");
+}
+
+// Moteur à l'arrêt uniquement: la flash est inaccessible pendant l'écriture
+static void motor_calib_save(void) {
+    if (FlashLog_Append(&motorCalibLog, motorCalib)) {
+        motorCalibDirty = false;
+    } else {
+        LOGE("MotorService: calibration save failed\r\n");
+    }
+    motorCalibSavedTick = osKernelGetTickCount();
+}
+
+#if MOTOR_DROP_SENSE
+// Marche continue jusqu'à la dernière unité: l'impulsion est bornée à une
+// échéance par unité, la tâche coupe dès qu'une unité manque son échéance
+// et l'ISR EXTI à la dernière chute. Les jobs à durée calibrée alimentent
+// l'apprentissage du canal.
+static MotorJobStatus MotorService_Run(const MotorJob* job, uint8_t* delivered) {
+    *delivered = 0;
+    if (HAL_GPIO_ReadPin(DROP_BEAM_GPIO_Port, DROP_BEAM_Pin) == GPIO_PIN_RESET) {
+        return MOTOR_JOB_FAILED;                    // Produit coincé ou barrière en défaut
+    }
+    MotorCalibRecord* cal = &motorCalib[job->channel];
+    bool calibrated = (job->onTimeMs == MOTOR_ON_CALIBRATED);
+    uint32_t unitMs = cal->onTimeMs;
+    if (!calibrated) {
+        unitMs = (job->onTimeMs < MOTOR_DROP_MAX_MS) ? MOTOR_DROP_MAX_MS : job->onTimeMs;
+    }
+    MotorDropSpec drop = {
+        .blankMs = cal->settleMs,
+        .nominalMs = calibrated ? MOTOR_DEFAULT_ON_MS : job->onTimeMs,
+        .maxMs = unitMs,
+        .minGapMs = MOTOR_DROP_MIN_GAP_MS,
+        .target = job->quantity,
+    };
+    taskENTER_CRITICAL();
+    MotorDrop_Start(&motorDrop, &drop, HAL_GetTick());
+    taskEXIT_CRITICAL();
+    if (!motor_pulse_begin(job->channel, cal->settleMs, unitMs * job->quantity)) {
+        MotorDrop_Finish(&motorDrop);
+        return MOTOR_JOB_FAILED;
+    }
+
+    // Notifications de Submit consommées ici sans perte: la file est relue ensuite
+    for (;;) {
+        taskENTER_CRITICAL();
+        MotorDropState state = motorDrop.state;
+        int32_t leftMs = (int32_t)(MotorDrop_DeadlineMs(&motorDrop) - HAL_GetTick());
+        taskEXIT_CRITICAL();
+        if (state != MOTOR_DROP_WAITING || motorPulseDone || leftMs <= 0) break;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS((uint32_t)leftMs));
+    }
+    MotorService_Stop();
+
+    taskENTER_CRITICAL();
+    MotorDropState state = MotorDrop_Finish(&motorDrop);
+    MotorDrop_Record(&motorDropStats, &motorDrop);
+    *delivered = motorDrop.count;
+    bool retuned = false;
+    if (calibrated) {
+        MotorCalibSample sample = {
+            .requested = job->quantity,
+            .delivered = motorDrop.count,
+            .sumMs = motorDrop.sumMs,
+            .deadlineMs = unitMs,
+        };
+        retuned = MotorCalib_Observe(cal, &sample);
+        motorCalibDirty = true;
+    }
+    taskEXIT_CRITICAL();
+    if (retuned) {
+        LOGD("Motor ch=%d: on-time %lu -> %u ms\r\n", job->channel, unitMs, cal->onTimeMs);
+    }
+    LOGD("Motor ch=%d: %u/%u units, last after %lu ms\r\n",
+         job->channel, *delivered, job->quantity, motorDrop.detectMs);
+    return (state == MOTOR_DROP_DETECTED) ? MOTOR_JOB_DONE : MOTOR_JOB_NO_DROP;
+}
+#else
+// Boucle ouverte: une impulsion par unité, enchaînées sans pause; durée
+// calibrée figée (rien à observer sans barrière)
+static MotorJobStatus MotorService_Run(const MotorJob* job, uint8_t* delivered) {
+    const MotorCalibRecord* cal = &motorCalib[job->channel];
+    uint32_t onMs = (job->onTimeMs == MOTOR_ON_CALIBRATED) ? cal->onTimeMs : job->onTimeMs;
+    *delivered = 0;
+    for (uint8_t unit = 0; unit < job->quantity; unit++) {
+        if (!motor_pulse_begin(job->channel, cal->settleMs, onMs)) return MOTOR_JOB_FAILED;
+        uint32_t timeoutMs = MotorPulse_TotalUs(&motorPulse) / 1000U + MOTOR_PULSE_MARGIN_MS;
+        uint32_t start = osKernelGetTickCount();
+        while (!motorPulseDone) {
+            uint32_t elapsed = osKernelGetTickCount() - start;
+            if (elapsed >= timeoutMs) break;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs - elapsed));
+        }
+        bool done = motorPulseDone;
+        MotorService_Stop();
+        if (!done) return MOTOR_JOB_FAILED;
+        (*delivered)++;
+    }
+    return MOTOR_JOB_DONE;
+}
+#endif
+
+void MotorService_PulseElapsedFromISR(void) {
+    if (!motor_pulse_step()) return;
+    __HAL_TIM_DISABLE_IT(&htim3, TIM_IT_UPDATE);
+    motorPulseDone = true;
+    motor_notify_from_isr();
+}
+
+void MotorService_DropDetectedFromISR(void) {
+    if (!MotorDrop_Detect(&motorDrop, HAL_GetTick())) return;
+    if (motorDrop.state != MOTOR_DROP_DETECTED) return;    // Unités encore attendues
+    // Dernière unité: coupure immédiate, sortie forcée inactive, compteur arrêté
+    MODIFY_REG(htim3.Instance->CCMR2, TIM_CCMR2_OC3M, TIM_OCMODE_FORCED_INACTIVE);
+    __HAL_TIM_DISABLE_IT(&htim3, TIM_IT_UPDATE);
+    __HAL_TIM_DISABLE(&htim3);
+    motor_notify_from_isr();
+}
+
+void MotorService_GetDropStats(MotorDropStats* out) {
+    taskENTER_CRITICAL();
+    *out = motorDropStats;
+    taskEXIT_CRITICAL();
+}
+
+bool MotorService_GetCalibration(uint8_t channel, MotorCalibRecord* out) {
+    if (channel >= MOTOR_CHANNEL_COUNT || out == NULL) return false;
+    taskENTER_CRITICAL();
+    *out = motorCalib[channel];
+    taskEXIT_CRITICAL();
+    return true;
 }
 
 // Tâche principale FreeRTOS
@@ -42,50 +270,106 @@ void StartTaskMotorService(void *argument) {
     motorTaskHandleLocal = xTaskGetCurrentTaskHandle();
 
     // S'assurer que le signal est au repos (LOW)
-    HAL_GPIO_WritePin(MUX_IN1_SIG_GPIO_Port, MUX_IN1_SIG_Pin, GPIO_PIN_RESET);
+    MotorService_Stop();
+    motor_calib_load();
 
     for (;;) {
-        printf("MotorService task en attente...\r\n");
-        // Attendre une notification (job disponible)
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        printf("Motor job: ch=%d\r\n", currentJob.channel);
-        MotorService_Run(currentJob.channel);
-        osDelay(700);
-        MotorService_Stop(currentJob.channel);
-        // Notifier orchestrateur fin de livraison
-        extern osMessageQueueId_t orchestratorEventQueueHandle;
-        OrchestratorEvent evt = { .type = ORCH_EVT_DELIVERY_DONE };
-        osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
+        MotorJob job;
+        taskENTER_CRITICAL();
+        bool pending = MotorJobQueue_Pop(&motorJobs, &job);
+        motorJobActive = pending;
+        taskEXIT_CRITICAL();
+
+        if (!pending) {
+            // File vide: sauvegarde de la calibration, au plus une par
+            // MOTOR_CALIB_SAVE_MS, sinon réveil à l'échéance
+            TickType_t wait = portMAX_DELAY;
+            if (motorCalibDirty) {
+                uint32_t since = osKernelGetTickCount() - motorCalibSavedTick;
+                if (since >= MOTOR_CALIB_SAVE_MS) {
+                    motor_calib_save();
+                    continue;
+                }
+                wait = pdMS_TO_TICKS(MOTOR_CALIB_SAVE_MS - since);
+            }
+            // Jobs soumis avant l'enregistrement du handle servis au premier tour
+            ulTaskNotifyTake(pdTRUE, wait);
+            continue;
+        }
+
+        LOGD("Motor job %u: ch=%d, %u x %u ms\r\n", job.id, job.channel, job.quantity, job.onTimeMs);
+        uint8_t delivered = 0;
+        MotorJobStatus status = MotorService_Run(&job, &delivered);
+        if (status == MOTOR_JOB_NO_DROP) {
+            LOGE("Motor job %u: %u/%u units dropped on ch=%d\r\n", job.id, delivered, job.quantity, job.channel);
+        } else if (status != MOTOR_JOB_DONE) {
+            LOGE("Motor job %u: failed on ch=%d\r\n", job.id, job.channel);
+        }
+        if (job.done != NULL) {
+            job.done(job.id, job.channel, status, delivered, job.ctx);
+        }
+        osDelay(MOTOR_JOB_GAP_MS);
     }
 }
 
-// API: démarrer une distribution (canal + durée)
-void MotorService_StartDelivery(uint8_t channel) {
-    if (motorTaskHandleLocal == NULL) return;
-    currentJob.channel = channel;
-    xTaskNotifyGive(motorTaskHandleLocal);
+MotorJobId MotorService_Submit(uint8_t channel, uint8_t quantity, uint16_t onTimeMs,
+                               MotorJobCallback done, void* ctx) {
+    if (channel >= MOTOR_CHANNEL_COUNT) return MOTOR_JOB_ID_NONE;
+    if (quantity == 0 || quantity > MOTOR_JOB_MAX_UNITS) return MOTOR_JOB_ID_NONE;
+    taskENTER_CRITICAL();
+    MotorJobId id = MotorJobQueue_Push(&motorJobs, channel, quantity, onTimeMs, done, ctx);
+    taskEXIT_CRITICAL();
+    if (id != MOTOR_JOB_ID_NONE && motorTaskHandleLocal != NULL) {
+        xTaskNotifyGive(motorTaskHandleLocal);
+    }
+    return id;
+}
+
+uint8_t MotorService_QueueDepth(void) {
+    taskENTER_CRITICAL();
+    uint8_t depth = MotorJobQueue_Count(&motorJobs);
+    taskEXIT_CRITICAL();
+    return depth;
 }
 
-// Mappe un code commande (11,12,13,21,22,23) vers un canal 1..4 (multiplexeur 4 channels)
-uint8_t MotorService_OrderToChannel(uint8_t orderCode) {
-    switch (orderCode) {
-        case 11: return 1;  // Channel 1 du multiplexeur
-        case 12: return 2;  // Channel 2 du multiplexeur
-        case 13: return 3;  // Channel 3 du multiplexeur
-        case 21: return 4;  // Channel 4 du multiplexeur
-        case 22: return 1;  // Retour au channel 1 (rotation)
-        case 23: return 2;  // Retour au channel 2 (rotation)
-        default: return 0xFF; // invalide
+bool MotorService_IsIdle(void) {
+    taskENTER_CRITICAL();
+    bool idle = !motorJobActive && MotorJobQueue_Count(&motorJobs) == 0;
+    taskEXIT_CRITICAL();
+    return idle;
+}
+
+uint8_t MotorService_CancelAll(void) {
+    MotorJob job;
+    uint8_t cancelled = 0;
+    for (;;) {
+        taskENTER_CRITICAL();
+        bool pending = MotorJobQueue_Pop(&motorJobs, &job);
+        taskEXIT_CRITICAL();
+        if (!pending) break;
+        // Callback hors section critique
+        if (job.done != NULL) {
+            job.done(job.id, job.channel, MOTOR_JOB_CANCELLED, 0, job.ctx);
+        }
+        cancelled++;
+    }
+    return cancelled;
+}
+
+// API: démarrer une distribution sans suivi (durée calibrée du canal)
+void MotorService_StartDelivery(uint8_t channel) {
+    if (MotorService_Submit(channel, 1, MOTOR_ON_CALIBRATED, NULL, NULL) == MOTOR_JOB_ID_NONE) {
+        printf("Motor queue full or invalid channel %d\r\n", channel);
     }
 }
 
+// Balayage de test: un job par canal, enchaînés par la tâche moteur
 void MotorService_TestSweep(uint8_t firstChannel, uint8_t lastChannel, uint16_t onTimeMs) {
     if (firstChannel > lastChannel) return;
     for (uint8_t ch = firstChannel; ch <= lastChannel; ++ch) {
-        printf("TestSweep: ch=%d\r\n", ch);
-        MotorService_Run(ch);
-        osDelay(onTimeMs);
-        MotorService_Stop(ch);
-        osDelay(200);
+        if (MotorService_Submit(ch, 1, onTimeMs, NULL, NULL) == MOTOR_JOB_ID_NONE) {
+            printf("TestSweep: queue full at ch=%d\r\n", ch);
+            return;
+        }
     }
 }
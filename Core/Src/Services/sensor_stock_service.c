@@ -2,130 +2,193 @@
 #include "orchestrator.h"
 #include <stdio.h>
 #include "global.h"
+#include "gpio_port.h"
+#include "tof_scan.h"
+#include "i2c_bus_service.h"
+#include "vl6180.h"
 
-// Registres clés du VL6180X (voir AN ST)
-#define VL6180_SYSRANGE_START          0x018
-#define VL6180_RESULT_RANGE_STATUS     0x04d
-#define VL6180_RESULT_RANGE_VAL        0x062
-#define VL6180_SYSTEM_FRESH_OUT_OF_RESET 0x016
-#define VL6180_I2C_SLAVE_DEVICE_ADDRESS 0x212
-
-static HAL_StatusTypeDef vl6180_write_reg_addr(uint16_t devAddr8, uint16_t reg, uint8_t value) {
-    uint8_t tx[3] = { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF), value };
-    osMutexAcquire(i2c1Mutex, osWaitForever);
-    HAL_StatusTypeDef st = HAL_I2C_Master_Transmit(&hi2c1, devAddr8, tx, 3, 50);
-    osMutexRelease(i2c1Mutex);
-    return st;
+// Accès registre via la tâche du bus (i2c_bus_service.h), priorité haute:
+// un échantillon prêt passe devant l'affichage
+static bool tof_bus_write(uint16_t addr8, uint16_t reg, const uint8_t* data, uint8_t len, void* ctx) {
+    (void)ctx;
+    return I2cBus_MemWrite(TOF_I2C_BUS, I2C_PRIO_HIGH, addr8, reg, 2, data, len) == HAL_OK;
 }
 
-static HAL_StatusTypeDef vl6180_read_reg_addr(uint16_t devAddr8, uint16_t reg, uint8_t *value) {
-    uint8_t addr[2] = { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF) };
-    osMutexAcquire(i2c1Mutex, osWaitForever);
-    HAL_StatusTypeDef st = HAL_I2C_Master_Transmit(&hi2c1, devAddr8, addr, 2, 50);
-    if (st != HAL_OK) return st;
-    st = HAL_I2C_Master_Receive(&hi2c1, devAddr8, value, 1, 50);
-    osMutexRelease(i2c1Mutex);
-    return st;
+static bool tof_bus_read(uint16_t addr8, uint16_t reg, uint8_t* data, uint8_t len, void* ctx) {
+    (void)ctx;
+    return I2cBus_MemRead(TOF_I2C_BUS, I2C_PRIO_HIGH, addr8, reg, 2, data, len) == HAL_OK;
 }
 
-static void sensor_set_shutdown(const TofSensorCfg* s, uint8_t state) {
-    HAL_GPIO_WritePin(s->shutPort, s->shutPin, state ? GPIO_PIN_SET : GPIO_PIN_RESET);
-}
+static const Vl6180Bus kTofBus = { .write = tof_bus_write, .read = tof_bus_read, .ctx = NULL };
 
-static HAL_StatusTypeDef vl6180_init(uint16_t devAddr8) {
-    // Vérifier le flag Fresh out of reset (optionnel)
-    uint8_t fresh = 0;
-    if (vl6180_read_reg_addr(devAddr8, VL6180_SYSTEM_FRESH_OUT_OF_RESET, &fresh) != HAL_OK) return HAL_ERROR;
-    // Quelques writes de tuning peuvent être nécessaires selon AN (omises ici pour simplicité)
-    return HAL_OK;
-}
+// Réveil de la tâche par capteur: drapeau i (osThreadFlags) = GPIO1 du
+// capteur i. Drapeaux plutôt que valeur de notification brute: la fin des
+// transactions I2C (I2C_BUS_FLAG_DONE) partage la même notification
+#define TOF_FLAGS_ALL  ((1UL << TOF_SENSOR_COUNT) - 1UL)
+static osThreadId_t sensorTaskHandleLocal = NULL;
+static const uint16_t kTofGpio1Pins[TOF_SENSOR_COUNT] = {
+    TOF1_GPIO1_Pin, TOF2_GPIO1_Pin, TOF3_GPIO1_Pin, TOF4_GPIO1_Pin, TOF5_GPIO1_Pin
+};
 
-static HAL_StatusTypeDef vl6180_single_shot(uint16_t devAddr8, uint8_t *mm) {
-    // Lancer une mesure single-shot
-    if (vl6180_write_reg_addr(devAddr8, VL6180_SYSRANGE_START, 0x01) != HAL_OK) return HAL_ERROR;
-    // Polling simple sur RESULT_RANGE_STATUS bit 0 (ready)
-    for (int i = 0; i < 20; ++i) {
-        uint8_t status;
-        if (vl6180_read_reg_addr(devAddr8, VL6180_RESULT_RANGE_STATUS, &status) != HAL_OK) return HAL_ERROR;
-        if ((status & 0x01) == 0) {
-            osDelay(5);
-        } else {
-            break;
-        }
-    }
-    // Lire la distance
-    uint8_t range = 0;
-    if (vl6180_read_reg_addr(devAddr8, VL6180_RESULT_RANGE_VAL, &range) != HAL_OK) return HAL_ERROR;
-    *mm = range;
-    return HAL_OK;
+static void sensor_set_shutdown(const TofSensorCfg* s, uint8_t state) {
+    GpioPort_Write(s->shutPort, s->shutPin, state ? s->shutPin : 0);
 }
 
 HAL_StatusTypeDef VL6180_SetI2CAddress(I2C_HandleTypeDef* hi2c, uint16_t currentAddr8, uint8_t new7bit) {
-    // Ecriture du nouveau 7-bit dans le registre 0x021
-    return vl6180_write_reg_addr(currentAddr8, VL6180_I2C_SLAVE_DEVICE_ADDRESS, new7bit);
+    (void)hi2c;
+    return Vl6180_SetAddress(&kTofBus, currentAddr8, new7bit) ? HAL_OK : HAL_ERROR;
 }
 
-static HAL_StatusTypeDef sensors_init(TofSensorCfg* sensors, uint8_t count) {
-    // Mettre tous les capteurs en SHUTDOWN
+// Un capteur en échec est retiré du balayage, les autres restent en service
+static HAL_StatusTypeDef sensors_init(TofSensorCfg* sensors, uint8_t count, TofScan* scan) {
+    // Mettre tous les capteurs en SHUTDOWN: une écriture par port
+    GpioPortBatch shut;
+    GpioPortBatch_Init(&shut);
     for (uint8_t i = 0; i < count; ++i) {
-        sensor_set_shutdown(&sensors[i], 0);
+        if (!GpioPortBatch_Put(&shut, sensors[i].shutPort, sensors[i].shutPin, 0)) return HAL_ERROR;
     }
+    GpioPortBatch_Apply(&shut);
     osDelay(2);
+    HAL_StatusTypeDef st = HAL_OK;
     // Remonter un par un, changer l'adresse si nécessaire, puis initialiser
     for (uint8_t i = 0; i < count; ++i) {
         sensor_set_shutdown(&sensors[i], 1);
         osDelay(10);
         // Si l'adresse désirée est différente de la valeur par défaut, la changer
         if (sensors[i].i2cAddr8 != VL6180_DEFAULT_ADDR_8BIT) {
-            if (VL6180_SetI2CAddress(&hi2c1, VL6180_DEFAULT_ADDR_8BIT, (uint8_t)(sensors[i].i2cAddr8 >> 1)) != HAL_OK) {
+            if (VL6180_SetI2CAddress(NULL, VL6180_DEFAULT_ADDR_8BIT, (uint8_t)(sensors[i].i2cAddr8 >> 1)) != HAL_OK) {
                 printf("TOF[%d] set addr failed\r\n", sensors[i].id);
-                return HAL_ERROR;
+                // Resté à l'adresse par défaut: bloquerait les suivants
+                sensor_set_shutdown(&sensors[i], 0);
+                TofScan_SetEnabled(scan, i, false);
+                st = HAL_ERROR;
+                continue;
             }
             osDelay(2);
         }
-        if (vl6180_init(sensors[i].i2cAddr8) != HAL_OK) {
+        if (!Vl6180_Init(&kTofBus, sensors[i].i2cAddr8, TOF_CONTINUOUS ? TOF_SCAN_PERIOD_MS : 0)) {
             printf("TOF[%d] init failed\r\n", sensors[i].id);
-            return HAL_ERROR;
+            TofScan_SetEnabled(scan, i, false);
+            st = HAL_ERROR;
+        }
+    }
+    return st;
+}
+
+static void sensors_report(const TofSensorCfg* sensors, const TofScan* scan) {
+    for (uint8_t i = 0; i < scan->count; ++i) {
+        uint8_t bit = (uint8_t)(1U << i);
+        if (scan->failed & bit) {
+            printf("TOF[%d] read error\r\n", sensors[i].id);
+            continue;
+        }
+        if ((scan->done & bit) == 0) continue;
+        uint8_t mm = scan->mm[i];
+        printf("TOF[%d] distance: %u mm\r\n", sensors[i].id, mm);
+        if (mm >= sensors[i].thresholdMm) {
+            OrchestratorEvent evt = { .type = ORCH_EVT_STOCK_LOW };
+            evt.data.stock.sensorId = sensors[i].id;
+            evt.data.stock.mm = mm;
+            Orchestrator_PostEvent(&evt);   // Fusionné par capteur s'il est encore en file
+        }
+    }
+}
+
+void SensorStock_SampleReadyFromISR(uint16_t gpioPin) {
+    if (sensorTaskHandleLocal == NULL) return;
+    for (uint8_t i = 0; i < TOF_SENSOR_COUNT; ++i) {
+        if (kTofGpio1Pins[i] == gpioPin) {
+            osThreadFlagsSet(sensorTaskHandleLocal, 1UL << i);
+            return;
         }
     }
-    return HAL_OK;
 }
 
 void StartTaskSensorStock(void *argument) {
     printf("\r\nSensorStock Task started\r\n");
+    sensorTaskHandleLocal = osThreadGetId();
     // Configuration des 5 capteurs ToF avec leurs broches SHUT respectives
-    TofSensorCfg sensors[5] = {
+    TofSensorCfg sensors[TOF_SENSOR_COUNT] = {
         { .id = 0, .i2cAddr8 = (0x29 << 1), .shutPort = TOF_SHUT_1_GPIO_Port, .shutPin = TOF_SHUT_1_Pin, .thresholdMm = 170 },
         { .id = 1, .i2cAddr8 = (0x2A << 1), .shutPort = TOF_SHUT_2_GPIO_Port, .shutPin = TOF_SHUT_2_Pin, .thresholdMm = 170 },
         { .id = 2, .i2cAddr8 = (0x2B << 1), .shutPort = TOF_SHUT_3_GPIO_Port, .shutPin = TOF_SHUT_3_Pin, .thresholdMm = 170 },
         { .id = 3, .i2cAddr8 = (0x2C << 1), .shutPort = TOF_SHUT_4_GPIO_Port, .shutPin = TOF_SHUT_4_Pin, .thresholdMm = 170 },
         { .id = 4, .i2cAddr8 = (0x2D << 1), .shutPort = TOF_SHUT_5_GPIO_Port, .shutPin = TOF_SHUT_5_Pin, .thresholdMm = 170 }
     };
+    TofScan scan;
+    // En continu, un résultat peut arriver jusqu'à une période après l'ouverture
+    TofScan_Init(&scan, TOF_SENSOR_COUNT, TOF_CONTINUOUS ? TOF_SCAN_PERIOD_MS + TOF_RANGE_TIMEOUT_MS
+                                                         : TOF_RANGE_TIMEOUT_MS);
 
-    if (sensors_init(sensors, 5) != HAL_OK) {
+    if (sensors_init(sensors, TOF_SENSOR_COUNT, &scan) != HAL_OK) {
         printf("VL6180 init error\r\n");
     } else {
-        printf("VL6180 ready (5 sensors)\r\n");
+        printf("VL6180 ready (%u sensors)\r\n", TOF_SENSOR_COUNT);
     }
 
+    uint32_t cycleTick = osKernelGetTickCount();
+    uint32_t signalled = 0;     // Signaux GPIO1 reçus, pas encore relevés
     for (;;) {
-        for (uint8_t i = 0; i < 5; ++i) {
-            uint8_t mm = 0;
-            if (vl6180_single_shot(sensors[i].i2cAddr8, &mm) == HAL_OK) {
-                printf("TOF[%d] distance: %u mm\r\n", sensors[i].id, mm);
-                if (mm >= sensors[i].thresholdMm) {
-                    extern osMessageQueueId_t orchestratorEventQueueHandle;
-                    OrchestratorEvent evt = { .type = ORCH_EVT_STOCK_LOW };
-                    evt.data.stock.sensorId = sensors[i].id;
-                    evt.data.stock.mm = mm;
-                    osMessageQueuePut(orchestratorEventQueueHandle, &evt, 0, 0);
+#if TOF_CONTINUOUS
+        // Capteur en échec au cycle précédent: résultat tardif éventuel non
+        // acquitté, GPIO1 resterait bas sans nouveau front
+        uint8_t stale = scan.failed;
+        TofScan_Begin(&scan, osKernelGetTickCount());
+        for (uint8_t i = 0; i < TOF_SENSOR_COUNT; ++i) {
+            if ((stale & scan.pending & (1U << i)) && !Vl6180_ClearInterrupt(&kTofBus, sensors[i].i2cAddr8)) {
+                TofScan_Fail(&scan, i);
+            }
+        }
+#else
+        TofScan_Begin(&scan, osKernelGetTickCount());
+        // Signaux d'un cycle précédent: sans objet, les mesures sont relancées
+        osThreadFlagsClear(TOF_FLAGS_ALL);
+        signalled = 0;
+        // Toutes les mesures lancées d'abord: les convergences se recouvrent.
+        // Le lancement acquitte aussi le résultat précédent, relevé ou non
+        for (uint8_t i = 0; i < TOF_SENSOR_COUNT; ++i) {
+            if ((scan.pending & (1U << i)) && !Vl6180_Start(&kTofBus, sensors[i].i2cAddr8)) {
+                TofScan_Fail(&scan, i);
+            }
+        }
+#endif
+        // Relevé des seuls capteurs ayant signalé, dans l'ordre d'arrivée
+        while (!TofScan_Complete(&scan)) {
+            // Signaux reçus pendant une transaction I2C: déjà dans les
+            // drapeaux, sans réveil en attente
+            uint32_t bits = osThreadFlagsClear(TOF_FLAGS_ALL);
+            if ((bits & osFlagsError) == 0) signalled |= bits & TOF_FLAGS_ALL;
+            int32_t leftMs = (int32_t)(TofScan_DeadlineMs(&scan) - osKernelGetTickCount());
+            if ((signalled & scan.pending) == 0 && leftMs > 0) {
+                bits = osThreadFlagsWait(TOF_FLAGS_ALL, osFlagsWaitAny, (uint32_t)leftMs);
+                if ((bits & osFlagsError) == 0) signalled |= bits & TOF_FLAGS_ALL;
+            }
+            uint32_t ready = signalled & scan.pending;
+            signalled &= ~ready;
+            for (uint8_t i = 0; i < TOF_SENSOR_COUNT; ++i) {
+                if ((ready & (1U << i)) == 0) continue;
+                uint8_t mm = 0;
+                bool ok = Vl6180_ReadSample(&kTofBus, sensors[i].i2cAddr8, &mm);
+#if TOF_CONTINUOUS
+                // Relâche GPIO1 pour l'échantillon suivant; en mesure unique,
+                // c'est le prochain lancement qui acquitte
+                ok = Vl6180_ClearInterrupt(&kTofBus, sensors[i].i2cAddr8) && ok;
+#endif
+                if (!ok) {
+                    TofScan_Fail(&scan, i);
+                } else {
+                    TofScan_Ready(&scan, i, mm, osKernelGetTickCount());
                 }
-            } else {
-                printf("TOF[%d] read error\r\n", sensors[i].id);
             }
+            TofScan_Expire(&scan, osKernelGetTickCount());
+        }
+        sensors_report(sensors, &scan);
+
+        cycleTick += TOF_SCAN_PERIOD_MS;
+        if ((int32_t)(osKernelGetTickCount() - cycleTick) >= 0) {
+            cycleTick = osKernelGetTickCount();     // Cycle en retard: pas de rattrapage
+        } else {
+            osDelayUntil(cycleTick);
         }
-        osDelay(200);
     }
 }
-
-
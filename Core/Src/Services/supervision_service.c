@@ -1,6 +1,7 @@
 #include "supervision_service.h"
 #include "global.h"
 #include "Services/esp_communication_service.h"
+#include "Services/esp_frame.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -75,6 +76,22 @@ void SupervisionService_SendErrorNotificationEvent(const SupervisionEvent* event
   printf("  Message: %s\n", event->message);
   printf("  Payload: %s\n", json_payload);
   
+  // Lien en mode binaire: trame SUPERVISION_ERROR (type u8, timestamp u32 LE, message)
+  if (EspComm_GetLinkMode() == ESP_LINK_MODE_BINARY) {
+    uint8_t payload[ESP_FRAME_MAX_PAYLOAD];
+    size_t msg_len = strlen(event->message);
+    if (msg_len > sizeof(payload) - 5) {
+      msg_len = sizeof(payload) - 5;
+    }
+    payload[0] = (uint8_t)event->error_type;
+    EspFrame_PutU32(&payload[1], event->timestamp);
+    memcpy(&payload[5], event->message, msg_len);
+    EspComm_SendFrameOn(ESP_CHANNEL_TELEMETRY, ESP_FRAME_SUPERVISION_ERROR, payload, (uint16_t)(5 + msg_len));
+    last_notification_time = HAL_GetTick();
+    printf("[SUPERVISION] Error notification sent as frame\n");
+    return;
+  }
+
   // Envoyer la notification via UART à l'ESP32
   // Format: SUPERVISION_ERROR:<json_payload>
   char uart_message[512];
@@ -89,8 +106,8 @@ void SupervisionService_SendErrorNotificationEvent(const SupervisionEvent* event
              (int)max_json_len, json_payload);
   }
   
-  // Utiliser le service de communication ESP pour envoyer le message
-  EspComm_SendLine(uart_message);
+  // Canal télémétrie: ne retarde pas les réponses de commande (découpé si négocié)
+  EspComm_SendLineOn(ESP_CHANNEL_TELEMETRY, uart_message);
   
   // Mettre à jour le timestamp de la dernière notification
   last_notification_time = HAL_GetTick();
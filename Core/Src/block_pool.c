@@ -0,0 +1,44 @@
+#include "block_pool.h"
+#include <stddef.h>
+
+bool BlockPool_Init(BlockPool* pool, void* storage, uint16_t blockSize, uint8_t count) {
+    if (!pool || !storage || blockSize == 0 || count == 0 || count > BLOCK_POOL_MAX_BLOCKS) {
+        return false;
+    }
+    pool->storage = (uint8_t*)storage;
+    pool->blockSize = blockSize;
+    pool->count = count;
+    pool->inUse = 0;
+    pool->highWater = 0;
+    pool->freeMask = (count >= 32U) ? 0xFFFFFFFFU : ((1UL << count) - 1U);
+    pool->allocFailures = 0;
+    return true;
+}
+
+uint8_t BlockPool_Alloc(BlockPool* pool) {
+    if (pool->freeMask == 0) {
+        pool->allocFailures++;
+        return BLOCK_POOL_INVALID;
+    }
+    uint8_t handle = (uint8_t)__builtin_ctz(pool->freeMask);   // CTZ = RBIT + CLZ sur Cortex-M4
+    pool->freeMask &= ~(1UL << handle);
+    pool->inUse++;
+    if (pool->inUse > pool->highWater) pool->highWater = pool->inUse;
+    return handle;
+}
+
+void* BlockPool_Get(const BlockPool* pool, uint8_t handle) {
+    if (handle >= pool->count || (pool->freeMask & (1UL << handle)) != 0) {
+        return NULL;
+    }
+    return pool->storage + (uint32_t)handle * pool->blockSize;
+}
+
+bool BlockPool_Free(BlockPool* pool, uint8_t handle) {
+    if (handle >= pool->count || (pool->freeMask & (1UL << handle)) != 0) {
+        return false;
+    }
+    pool->freeMask |= (1UL << handle);
+    pool->inUse--;
+    return true;
+}
@@ -0,0 +1,104 @@
+#include "flash_log.h"
+#include <string.h>
+
+#define FLASH_LOG_CHUNK_WORDS  8U      // Mots programmés par appel
+
+// CRC-32 (polynôme réfléchi 0xEDB88320), bit à bit: quelques centaines
+// d'octets par sauvegarde, pas de table en flash
+static uint32_t flash_log_crc(uint32_t crc, const uint8_t* data, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t flash_log_padded(const FlashLog* log) {
+    return ((uint32_t)log->cfg.payloadSize + 3U) & ~3U;
+}
+
+static uint32_t flash_log_word(const FlashLog* log, uint32_t offset) {
+    uint32_t w;
+    memcpy(&w, log->cfg.base + offset, sizeof(w));
+    return w;
+}
+
+static bool flash_log_blank(const FlashLog* log, uint32_t offset) {
+    for (uint32_t i = 0; i < log->slotSize; i += 4U) {
+        if (flash_log_word(log, offset + i) != 0xFFFFFFFFUL) return false;
+    }
+    return true;
+}
+
+static bool flash_log_valid(const FlashLog* log, uint32_t offset) {
+    if (flash_log_word(log, offset) != log->cfg.magic) return false;
+    uint32_t body = 4U + flash_log_padded(log);
+    return flash_log_crc(0, log->cfg.base + offset, body) == flash_log_word(log, offset + body);
+}
+
+void FlashLog_Init(FlashLog* log, const FlashLogConfig* cfg) {
+    memset(log, 0, sizeof(*log));
+    log->cfg = *cfg;
+    log->slotSize = 4U + flash_log_padded(log) + 4U;
+    log->latest = FLASH_LOG_NONE;
+    log->next = cfg->size;
+
+    // Écriture séquentielle: le premier emplacement vierge clôt le journal
+    for (uint32_t off = 0; off + log->slotSize <= cfg->size; off += log->slotSize) {
+        if (flash_log_blank(log, off)) {
+            log->next = off;
+            break;
+        }
+        if (flash_log_valid(log, off)) log->latest = off;
+    }
+}
+
+bool FlashLog_Read(const FlashLog* log, void* payload) {
+    if (log->latest == FLASH_LOG_NONE) return false;
+    memcpy(payload, log->cfg.base + log->latest + 4U, log->cfg.payloadSize);
+    return true;
+}
+
+bool FlashLog_Append(FlashLog* log, const void* payload) {
+    if (log->next + log->slotSize > log->cfg.size) {
+        if (!log->cfg.erase(log->cfg.ctx)) {
+            log->errors++;
+            return false;
+        }
+        log->erases++;
+        log->next = 0;
+        log->latest = FLASH_LOG_NONE;
+    }
+
+    // Le CRC couvre magic + payload complété: calculé au fil des morceaux
+    uint32_t offset = log->next;
+    uint32_t padded = flash_log_padded(log);
+    uint32_t words[FLASH_LOG_CHUNK_WORDS];
+    uint32_t crc = flash_log_crc(0, (const uint8_t*)&log->cfg.magic, 4U);
+    bool ok = log->cfg.program(offset, &log->cfg.magic, 1, log->cfg.ctx);
+
+    for (uint32_t done = 0; ok && done < padded; ) {
+        uint32_t chunk = padded - done;
+        if (chunk > sizeof(words)) chunk = sizeof(words);
+        memset(words, 0, sizeof(words));
+        uint32_t copy = (done + chunk > log->cfg.payloadSize) ? log->cfg.payloadSize - done : chunk;
+        memcpy(words, (const uint8_t*)payload + done, copy);
+        crc = flash_log_crc(crc, (const uint8_t*)words, chunk);
+        ok = log->cfg.program(offset + 4U + done, words, chunk / 4U, log->cfg.ctx);
+        done += chunk;
+    }
+    if (ok) ok = log->cfg.program(offset + 4U + padded, &crc, 1, log->cfg.ctx);
+
+    // Emplacement consommé même en cas d'échec: jamais reprogrammé
+    log->next += log->slotSize;
+    if (!ok || !flash_log_valid(log, offset)) {
+        log->errors++;
+        return false;
+    }
+    log->latest = offset;
+    log->writes++;
+    return true;
+}
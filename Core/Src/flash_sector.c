@@ -0,0 +1,36 @@
+#include "flash_sector.h"
+#include "cmsis_os.h"
+#include "watchdog_service.h"
+
+bool FlashSector_Program(uint32_t offset, const uint32_t* words, uint32_t count, void* ctx) {
+    const FlashSectorZone* zone = (const FlashSectorZone*)ctx;
+    bool ok = true;
+    int32_t lock = osKernelLock();
+    HAL_FLASH_Unlock();
+    for (uint32_t i = 0; ok && i < count; i++) {
+        ok = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, zone->address + offset + 4U * i, words[i]) == HAL_OK;
+    }
+    HAL_FLASH_Lock();
+    osKernelRestoreLock(lock);
+    return ok;
+}
+
+// Effacement d'un secteur de 128 Ko: jusqu'à 2 s sans lecture flash, donc sans
+// tâche ni interruption; le watchdog est rafraîchi juste avant
+bool FlashSector_Erase(void* ctx) {
+    const FlashSectorZone* zone = (const FlashSectorZone*)ctx;
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_SECTORS,
+        .Sector = zone->sector,
+        .NbSectors = 1,
+        .VoltageRange = FLASH_VOLTAGE_RANGE_3,
+    };
+    uint32_t badSector = 0;
+    Watchdog_Refresh();
+    int32_t lock = osKernelLock();
+    HAL_FLASH_Unlock();
+    HAL_StatusTypeDef st = HAL_FLASHEx_Erase(&erase, &badSector);
+    HAL_FLASH_Lock();
+    osKernelRestoreLock(lock);
+    return st == HAL_OK;
+}
@@ -35,6 +35,8 @@
 #include "sensor_stock_service.h"
 #include "esp_communication_service.h"
 #include "watchdog_service.h"
+#include "catalog_service.h"
+#include "i2c_bus_service.h"
 
 /* USER CODE END Includes */
 
@@ -66,9 +68,7 @@ osThreadId_t espCommTaskHandle;
 osThreadId_t watchdogTaskHandle;
 
 osMessageQueueId_t keypadEventQueueHandle;
-osMessageQueueId_t orchestratorEventQueueHandle;
 osMessageQueueId_t lcdMessageQueueHandle;
-osMutexId_t i2c1Mutex;
 
 const osThreadAttr_t blinkLED_attributes = {
   .name = "blinkLED",
@@ -126,9 +126,6 @@ const osThreadAttr_t watchdogTask_attributes = {
 const osMessageQueueAttr_t keypadEventQueue_attributes = {
   .name = "keypadEventQueue"
 };
-const osMessageQueueAttr_t orchestratorEventQueue_attributes = {
-  .name = "orchestratorEventQueue"
-};
 const osMessageQueueAttr_t lcdMessageQueue_attributes = {
   .name = "lcdMessageQueue"
 };
@@ -164,13 +161,11 @@ void MX_FREERTOS_Init(void); /* (MISRA C 2004 rule 8.1) */
 void MX_FREERTOS_Init(void) {
   /* USER CODE BEGIN Init */
 	printf("\r\nCreating tasks...\r\n");
+  // Catalogue produits chargé avant l'orchestrateur (lecture flash seule)
+  CatalogService_Init();
   /* USER CODE END Init */
 
   /* USER CODE BEGIN RTOS_MUTEX */
-  // Mutex I2C1 pour LCD + capteurs (évite collisions)
-  const osMutexAttr_t i2c1MutexAttr = { .name = "i2c1Mutex" };
-  i2c1Mutex = osMutexNew(&i2c1MutexAttr);
-  
   // Mutex pour variables globales d'état (sécurité thread-safe)
   extern osMutexId_t globalStateMutex;
   extern osMutexId_t keypadChoiceMutex;
@@ -198,7 +193,6 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE BEGIN RTOS_QUEUES */
   keypadEventQueueHandle = osMessageQueueNew(8, sizeof(KeypadEvent), &keypadEventQueue_attributes);
-  orchestratorEventQueueHandle = osMessageQueueNew(8, sizeof(OrchestratorEvent), &orchestratorEventQueue_attributes);
   lcdMessageQueueHandle = osMessageQueueNew(4, sizeof(LcdMessage), &lcdMessageQueue_attributes);
   /* USER CODE END RTOS_QUEUES */
 
@@ -207,6 +201,8 @@ void MX_FREERTOS_Init(void) {
   defaultTaskHandle = osThreadNew(StartDefaultTask, NULL, &defaultTask_attributes);
 
   /* USER CODE BEGIN RTOS_THREADS */
+  // Tâches des bus I2C (LCD + capteurs): avant leurs clients
+  I2cBusService_Init();
   blinkLEDHandle    = osThreadNew(StartTaskBlinkLED, NULL, &blinkLED_attributes);
   //sendUARTHandle    = osThreadNew(StartTaskSendUART, NULL, &sendUART_attributes);
   lcdTaskHandle     = osThreadNew(StartTaskLCD, NULL, &lcdTask_attributes);
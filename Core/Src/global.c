@@ -2,8 +2,8 @@
 #include <string.h>
 
 volatile MachineState machine_interaction = IDLE;
-volatile char keypad_choice[3] = "";
-volatile uint8_t client_order = 0;
+volatile char keypad_choice[KEYPAD_CHOICE_SIZE] = "";
+volatile uint16_t client_order = 0;
 
 volatile char* lcd_display = "Pret";
 
@@ -51,16 +51,16 @@ void GlobalState_SetKeypadChoice(const char* choice) {
     osMutexRelease(keypadChoiceMutex);
 }
 
-uint8_t GlobalState_GetClientOrder(void) {
+uint16_t GlobalState_GetClientOrder(void) {
     if (globalStateMutex == NULL) return client_order;
     
     osMutexAcquire(globalStateMutex, osWaitForever);
-    uint8_t order = client_order;
+    uint16_t order = client_order;
     osMutexRelease(globalStateMutex);
     return order;
 }
 
-void GlobalState_SetClientOrder(uint8_t order) {
+void GlobalState_SetClientOrder(uint16_t order) {
     if (globalStateMutex == NULL) {
         client_order = order;
         return;
@@ -22,6 +22,7 @@
 #include "gpio.h"
 
 /* USER CODE BEGIN 0 */
+#include "gpio_port.h"
 
 /* USER CODE END 0 */
 
@@ -58,8 +59,8 @@ void MX_GPIO_Init(void)
   HAL_GPIO_WritePin(GPIOA, LD2_Pin|PAD_OUTPUTA8_Pin|PAD_OUTPUTA9_Pin, GPIO_PIN_RESET);
 
   /*Configure GPIO pin Output Level */
-  HAL_GPIO_WritePin(GPIOB, MUX_IN1_SIG_Pin|TOF2_SHUT_Pin|TOF1_SHUT_Pin|TOF5_SHUT_Pin
-                          |TOF4_SHUT_Pin|TOF3_SHUT_Pin|PAD_OUTPUTB6_Pin, GPIO_PIN_RESET);
+  HAL_GPIO_WritePin(GPIOB, TOF2_SHUT_Pin|TOF1_SHUT_Pin|TOF5_SHUT_Pin|TOF4_SHUT_Pin
+                          |TOF3_SHUT_Pin|PAD_OUTPUTB6_Pin, GPIO_PIN_RESET);
 
   /*Configure GPIO pin : B1_Pin */
   GPIO_InitStruct.Pin = B1_Pin;
@@ -67,6 +68,24 @@ void MX_GPIO_Init(void)
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(B1_GPIO_Port, &GPIO_InitStruct);
 
+  /*Configure GPIO pin : DROP_BEAM_Pin */
+  GPIO_InitStruct.Pin = DROP_BEAM_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(DROP_BEAM_GPIO_Port, &GPIO_InitStruct);
+
+  /*Configure GPIO pins : TOF1_GPIO1_Pin TOF2_GPIO1_Pin TOF4_GPIO1_Pin TOF5_GPIO1_Pin */
+  GPIO_InitStruct.Pin = TOF1_GPIO1_Pin|TOF2_GPIO1_Pin|TOF4_GPIO1_Pin|TOF5_GPIO1_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+
+  /*Configure GPIO pin : TOF3_GPIO1_Pin */
+  GPIO_InitStruct.Pin = TOF3_GPIO1_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(TOF3_GPIO1_GPIO_Port, &GPIO_InitStruct);
+
   /*Configure GPIO pins : MUX_S0_Pin MUX_S1_Pin MUX_S2_Pin MUX_S3_Pin
                            PAD_OUTPUT_Pin */
   GPIO_InitStruct.Pin = MUX_S0_Pin|MUX_S1_Pin|MUX_S2_Pin|MUX_S3_Pin
@@ -83,10 +102,10 @@ void MX_GPIO_Init(void)
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
   HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
-  /*Configure GPIO pins : MUX_IN1_SIG_Pin TOF2_SHUT_Pin TOF1_SHUT_Pin TOF5_SHUT_Pin
-                           TOF4_SHUT_Pin TOF3_SHUT_Pin PAD_OUTPUTB6_Pin */
-  GPIO_InitStruct.Pin = MUX_IN1_SIG_Pin|TOF2_SHUT_Pin|TOF1_SHUT_Pin|TOF5_SHUT_Pin
-                          |TOF4_SHUT_Pin|TOF3_SHUT_Pin|PAD_OUTPUTB6_Pin;
+  /*Configure GPIO pins : TOF2_SHUT_Pin TOF1_SHUT_Pin TOF5_SHUT_Pin TOF4_SHUT_Pin
+                           TOF3_SHUT_Pin PAD_OUTPUTB6_Pin */
+  GPIO_InitStruct.Pin = TOF2_SHUT_Pin|TOF1_SHUT_Pin|TOF5_SHUT_Pin|TOF4_SHUT_Pin
+                          |TOF3_SHUT_Pin|PAD_OUTPUTB6_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
@@ -104,6 +123,13 @@ void MX_GPIO_Init(void)
   GPIO_InitStruct.Pull = GPIO_PULLUP;
   HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(DROP_BEAM_EXTI_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DROP_BEAM_EXTI_IRQn);
+
+  HAL_NVIC_SetPriority(TOF_GPIO1_EXTI_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(TOF_GPIO1_EXTI_IRQn);
+
 }
 
 /* USER CODE BEGIN 2 */
@@ -120,4 +146,16 @@ void MX_GPIO_Init(void)
     	HAL_NVIC_SetPriority(EXTI15_10_IRQn, 2, 0);
     	HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
     	*/
+
+/* Primitives de gpio_port.h: accès registre directs, une écriture BSRR
+   est atomique vis-à-vis des interruptions et des autres broches du port */
+void GpioPort_WriteBsrr(GPIO_TypeDef* port, uint32_t bsrr)
+{
+  port->BSRR = bsrr;
+}
+
+uint16_t GpioPort_ReadIdr(GPIO_TypeDef* port)
+{
+  return (uint16_t)port->IDR;
+}
 /* USER CODE END 2 */
@@ -0,0 +1,38 @@
+#include "gpio_port.h"
+#include <string.h>
+
+void GpioPort_Write(GPIO_TypeDef* port, uint16_t mask, uint16_t value) {
+    if (mask == 0) return;
+    GpioPort_WriteBsrr(port, GpioPort_Bsrr(mask, value));
+}
+
+void GpioPortBatch_Init(GpioPortBatch* b) {
+    memset(b, 0, sizeof(*b));
+}
+
+bool GpioPortBatch_Put(GpioPortBatch* b, GPIO_TypeDef* port, uint16_t mask, uint16_t value) {
+    GpioPortOp* op = NULL;
+    for (uint8_t i = 0; i < b->count; i++) {
+        if (b->ops[i].port == port) {
+            op = &b->ops[i];
+            break;
+        }
+    }
+    if (op == NULL) {
+        if (b->count >= GPIO_PORT_BATCH_MAX) return false;
+        op = &b->ops[b->count++];
+        op->port = port;
+        op->set = 0;
+        op->reset = 0;
+    }
+    op->set = (uint16_t)((op->set & ~mask) | (mask & value));
+    op->reset = (uint16_t)((op->reset & ~mask) | (mask & ~value));
+    return true;
+}
+
+void GpioPortBatch_Apply(const GpioPortBatch* b) {
+    for (uint8_t i = 0; i < b->count; i++) {
+        const GpioPortOp* op = &b->ops[i];
+        GpioPort_Write(op->port, (uint16_t)(op->set | op->reset), op->set);
+    }
+}
@@ -0,0 +1,63 @@
+#include "i2c_txn_queue.h"
+#include <string.h>
+
+void I2cTxnQueue_Init(I2cTxnQueue* q) {
+    memset(q, 0, sizeof(*q));
+}
+
+static bool i2c_txn_valid(const I2cTxn* txn) {
+    if (txn->txLen > I2C_TXN_TX_MAX) return false;
+    switch ((I2cTxnOp)txn->op) {
+        case I2C_TXN_WRITE:
+            return txn->txLen > 0;
+        case I2C_TXN_READ:
+            return txn->rx != NULL && txn->rxLen > 0;
+        case I2C_TXN_WRITE_READ:
+            return txn->txLen > 0 && txn->rx != NULL && txn->rxLen > 0;
+        case I2C_TXN_MEM_WRITE:
+            return (txn->memAddrSize == 1 || txn->memAddrSize == 2) && txn->txLen > 0;
+        case I2C_TXN_MEM_READ:
+            return (txn->memAddrSize == 1 || txn->memAddrSize == 2) && txn->rx != NULL && txn->rxLen > 0;
+        default:
+            return false;
+    }
+}
+
+bool I2cTxnQueue_Push(I2cTxnQueue* q, const I2cTxn* txn, I2cPriority prio) {
+    if (prio >= I2C_PRIO_COUNT || !i2c_txn_valid(txn) || q->count[prio] >= I2C_TXN_QUEUE_DEPTH) {
+        q->rejected++;
+        return false;
+    }
+    q->slots[prio][(uint8_t)(q->head[prio] + q->count[prio]) % I2C_TXN_QUEUE_DEPTH] = *txn;
+    q->count[prio]++;
+    uint8_t total = I2cTxnQueue_Count(q);
+    if (total > q->highWater) q->highWater = total;
+    return true;
+}
+
+bool I2cTxnQueue_Pop(I2cTxnQueue* q, I2cTxn* out) {
+    uint8_t prio;
+    if (q->count[I2C_PRIO_HIGH] == 0) {
+        prio = I2C_PRIO_NORMAL;
+    } else if (q->count[I2C_PRIO_NORMAL] > 0 && q->highStreak >= I2C_TXN_HIGH_STREAK) {
+        prio = I2C_PRIO_NORMAL;
+    } else {
+        prio = I2C_PRIO_HIGH;
+    }
+    if (q->count[prio] == 0) return false;
+
+    // Le compteur ne mesure que l'attente effective d'une normale
+    if (prio == I2C_PRIO_HIGH && q->count[I2C_PRIO_NORMAL] > 0) {
+        q->highStreak++;
+    } else {
+        q->highStreak = 0;
+    }
+    *out = q->slots[prio][q->head[prio]];
+    q->head[prio] = (uint8_t)((q->head[prio] + 1U) % I2C_TXN_QUEUE_DEPTH);
+    q->count[prio]--;
+    return true;
+}
+
+uint8_t I2cTxnQueue_Count(const I2cTxnQueue* q) {
+    return (uint8_t)(q->count[I2C_PRIO_HIGH] + q->count[I2C_PRIO_NORMAL]);
+}
@@ -20,6 +20,7 @@
 #include "main.h"
 #include "cmsis_os.h"
 #include "i2c.h"
+#include "tim.h"
 #include "usart.h"
 #include "gpio.h"
 
@@ -27,6 +28,7 @@
 /* USER CODE BEGIN Includes */
 #include "watchdog_service.h"
 #include "supervision_service.h"
+#include "motor_service.h"
 #include <stdio.h>
 /* USER CODE END Includes */
 
@@ -99,6 +101,7 @@ int main(void)
   MX_I2C1_Init();
   MX_USART1_UART_Init();
   MX_I2C2_Init();
+  MX_TIM3_Init();
   /* USER CODE BEGIN 2 */
   // Vérifier si le reset précédent était dû au watchdog
   if (Watchdog_WasResetCause()) {
@@ -198,6 +201,10 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
+  if (htim->Instance == TIM3)
+  {
+    MotorService_PulseElapsedFromISR();
+  }
 
   /* USER CODE END Callback 1 */
 }
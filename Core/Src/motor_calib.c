@@ -0,0 +1,103 @@
+#include "motor_calib.h"
+#include <stdio.h>
+
+#define MOTOR_CALIB_MAX_SETTLE_MS  500U
+
+static uint16_t motor_calib_clamp(uint32_t ms) {
+    if (ms < MOTOR_CALIB_MIN_ON_MS) return MOTOR_CALIB_MIN_ON_MS;
+    if (ms > MOTOR_CALIB_MAX_ON_MS) return MOTOR_CALIB_MAX_ON_MS;
+    return (uint16_t)ms;
+}
+
+void MotorCalib_Default(MotorCalibRecord* rec, uint16_t onTimeMs, uint16_t settleMs) {
+    rec->onTimeMs = motor_calib_clamp(onTimeMs);
+    rec->settleMs = settleMs;
+    rec->avgDispenseMs = 0;
+    rec->attempts = 0;
+    rec->successes = 0;
+    rec->adjustments = 0;
+}
+
+bool MotorCalib_Sanitize(MotorCalibRecord* rec) {
+    bool ok = true;
+    uint16_t on = motor_calib_clamp(rec->onTimeMs);
+    if (on != rec->onTimeMs) {
+        rec->onTimeMs = on;
+        ok = false;
+    }
+    if (rec->settleMs > MOTOR_CALIB_MAX_SETTLE_MS) {
+        rec->settleMs = MOTOR_CALIB_MAX_SETTLE_MS;
+        ok = false;
+    }
+    if (rec->successes > rec->attempts) {
+        rec->successes = rec->attempts;
+        ok = false;
+    }
+    return ok;
+}
+
+bool MotorCalib_Observe(MotorCalibRecord* rec, const MotorCalibSample* sample) {
+    if (sample->requested == 0) return false;
+    uint8_t delivered = (sample->delivered > sample->requested) ? sample->requested : sample->delivered;
+    bool missed = delivered < sample->requested;
+
+    rec->attempts = (uint16_t)(rec->attempts + sample->requested);
+    rec->successes = (uint16_t)(rec->successes + delivered);
+    while (rec->attempts > MOTOR_CALIB_RATE_WINDOW) {
+        rec->attempts = (uint16_t)(rec->attempts / 2U);
+        rec->successes = (uint16_t)(rec->successes / 2U);
+    }
+
+    // Délai moyen par unité; l'unité manquée compte pour l'échéance, minorant
+    // de son délai réel
+    uint32_t units = delivered;
+    uint32_t sum = sample->sumMs;
+    if (missed) {
+        units++;
+        sum += sample->deadlineMs;
+    }
+    uint32_t unitMs = sum / units;
+    if (unitMs > 0xFFFFU) unitMs = 0xFFFFU;
+    if (rec->avgDispenseMs == 0) {
+        rec->avgDispenseMs = (unitMs == 0) ? 1U : (uint16_t)unitMs;
+    } else {
+        int32_t diff = (int32_t)unitMs - (int32_t)rec->avgDispenseMs;
+        int32_t avg = (int32_t)rec->avgDispenseMs + diff / (int32_t)(1U << MOTOR_CALIB_AVG_SHIFT);
+        rec->avgDispenseMs = (uint16_t)((avg < 1) ? 1 : avg);
+    }
+
+    // Hausse immédiate sur unité manquée, baisse lissée sinon
+    uint32_t target = (uint32_t)rec->avgDispenseMs * MOTOR_CALIB_MARGIN_PCT / 100U;
+    uint32_t on = rec->onTimeMs;
+    if (missed) {
+        uint32_t raised = on + (on >> MOTOR_CALIB_RAISE_SHIFT);
+        on = (target > raised) ? target : raised;
+    } else if (target > on) {
+        on = target;
+    } else {
+        uint32_t lowered = on - (on >> MOTOR_CALIB_LOWER_SHIFT);
+        on = (target > lowered) ? target : lowered;
+    }
+
+    uint16_t next = motor_calib_clamp(on);
+    if (next == rec->onTimeMs) return false;
+    rec->onTimeMs = next;
+    if (rec->adjustments < 0xFFFFU) rec->adjustments++;
+    return true;
+}
+
+uint8_t MotorCalib_SuccessPct(const MotorCalibRecord* rec) {
+    if (rec->attempts == 0) return 100;
+    return (uint8_t)((uint32_t)rec->successes * 100U / rec->attempts);
+}
+
+size_t MotorCalib_Format(uint8_t channel, const MotorCalibRecord* rec, char* out, size_t outSize) {
+    if (!rec || !out || outSize == 0) return 0;
+    int n = snprintf(out, outSize, "CAL:%u:%u:%u:%u:%u/%u", channel, rec->onTimeMs, rec->settleMs,
+                     rec->avgDispenseMs, rec->successes, rec->attempts);
+    if (n < 0 || (size_t)n >= outSize) {
+        out[0] = '\0';
+        return 0;
+    }
+    return (size_t)n;
+}
@@ -0,0 +1,57 @@
+#include "motor_drop.h"
+
+void MotorDrop_Start(MotorDropWatch* w, const MotorDropSpec* spec, uint32_t nowMs) {
+    w->spec = *spec;
+    if (w->spec.target == 0) w->spec.target = 1;
+    w->armMs = nowMs + spec->blankMs;
+    w->lastMs = w->armMs;
+    w->detectMs = 0;
+    w->sumMs = 0;
+    w->longestMs = 0;
+    w->count = 0;
+    w->extended = 0;
+    w->state = MOTOR_DROP_WAITING;
+}
+
+bool MotorDrop_Detect(MotorDropWatch* w, uint32_t nowMs) {
+    if (w->state != MOTOR_DROP_WAITING) return false;
+    // Différence signée: robuste au rebouclage du tick
+    int32_t elapsed = (int32_t)(nowMs - w->lastMs);
+    if (elapsed < 0 || (uint32_t)elapsed > w->spec.maxMs) return false;
+    if (w->count > 0 && (uint32_t)elapsed < w->spec.minGapMs) return false;
+
+    w->count++;
+    w->lastMs = nowMs;
+    w->detectMs = (uint32_t)elapsed;
+    w->sumMs += (uint32_t)elapsed;
+    if ((uint32_t)elapsed > w->longestMs) w->longestMs = (uint32_t)elapsed;
+    if ((uint32_t)elapsed > w->spec.nominalMs) w->extended++;
+    if (w->count >= w->spec.target) {
+        w->state = MOTOR_DROP_DETECTED;
+    }
+    return true;
+}
+
+uint32_t MotorDrop_DeadlineMs(const MotorDropWatch* w) {
+    return w->lastMs + w->spec.maxMs;
+}
+
+MotorDropState MotorDrop_Finish(MotorDropWatch* w) {
+    if (w->state == MOTOR_DROP_WAITING) {
+        w->state = MOTOR_DROP_TIMEOUT;
+    }
+    return w->state;
+}
+
+void MotorDrop_Record(MotorDropStats* s, const MotorDropWatch* w) {
+    if (w->state == MOTOR_DROP_TIMEOUT) s->timeouts++;
+    if (w->count == 0) return;
+    s->detected += w->count;
+    s->totalDetectMs += w->sumMs;
+    s->extended += w->extended;
+    if (w->longestMs > s->maxDetectMs) s->maxDetectMs = w->longestMs;
+}
+
+uint32_t MotorDrop_AverageMs(const MotorDropStats* s) {
+    return (s->detected == 0) ? 0 : s->totalDetectMs / s->detected;
+}
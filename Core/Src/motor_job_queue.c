@@ -0,0 +1,45 @@
+#include "motor_job_queue.h"
+#include <string.h>
+
+void MotorJobQueue_Init(MotorJobQueue* q) {
+    memset(q, 0, sizeof(*q));
+}
+
+MotorJobId MotorJobQueue_Push(MotorJobQueue* q, uint8_t channel, uint8_t quantity,
+                              uint16_t onTimeMs, MotorJobCallback done, void* ctx) {
+    if (q->count >= MOTOR_JOB_QUEUE_DEPTH) {
+        q->rejected++;
+        return MOTOR_JOB_ID_NONE;
+    }
+    q->lastId++;
+    if (q->lastId == MOTOR_JOB_ID_NONE) {
+        q->lastId++;
+    }
+
+    MotorJob* job = &q->slots[(uint8_t)(q->head + q->count) % MOTOR_JOB_QUEUE_DEPTH];
+    job->id = q->lastId;
+    job->channel = channel;
+    job->quantity = quantity;
+    job->onTimeMs = onTimeMs;
+    job->done = done;
+    job->ctx = ctx;
+    q->count++;
+    if (q->count > q->highWater) q->highWater = q->count;
+    return job->id;
+}
+
+bool MotorJobQueue_Pop(MotorJobQueue* q, MotorJob* out) {
+    if (q->count == 0) return false;
+    *out = q->slots[q->head];
+    q->head = (uint8_t)((q->head + 1U) % MOTOR_JOB_QUEUE_DEPTH);
+    q->count--;
+    return true;
+}
+
+uint8_t MotorJobQueue_Count(const MotorJobQueue* q) {
+    return q->count;
+}
+
+bool MotorJobQueue_IdBefore(MotorJobId a, MotorJobId b) {
+    return (int16_t)(uint16_t)(a - b) < 0;
+}
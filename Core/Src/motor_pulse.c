@@ -0,0 +1,100 @@
+#include "motor_pulse.h"
+#include <string.h>
+
+#define MOTOR_PULSE_MAX_PSC  0xFFFFU
+
+// Prescaler minimal pour que la durée tienne dans ARR; retourne le nombre de
+// ticks (arrondi, au moins 1) à ce prescaler
+static uint32_t motor_pulse_span(const MotorPulse* p, uint32_t us, uint16_t* psc) {
+    uint64_t raw = (uint64_t)us * p->ticksPerUs;
+    uint64_t div = (raw + MOTOR_PULSE_MAX_TICKS - 1U) / MOTOR_PULSE_MAX_TICKS;
+    if (div == 0) div = 1;
+    *psc = (uint16_t)(div - 1U);
+    uint32_t ticks = (uint32_t)((raw + div / 2U) / div);
+    return (ticks == 0) ? 1U : ticks;
+}
+
+static void motor_pulse_period(const MotorPulse* p, uint16_t index, MotorPulseRegs* r) {
+    if (p->rampPeriods == 0) {
+        // Une seule période one-pulse: bas pendant l'attente, haut jusqu'à ARR
+        uint32_t total = motor_pulse_span(p, p->settleUs + p->onUs, &r->psc);
+        uint32_t scale = (uint32_t)r->psc + 1U;
+        uint32_t settle = (uint32_t)(((uint64_t)p->settleUs * p->ticksPerUs + scale / 2U) / scale);
+        if (settle == 0) settle = 1;
+        if (settle >= total) total = settle + 1U;
+        r->arr = (uint16_t)(total - 1U);
+        r->ccr = (uint16_t)settle;
+        return;
+    }
+    if (index == 0) {
+        uint32_t ticks = motor_pulse_span(p, p->settleUs, &r->psc);
+        r->arr = (uint16_t)(ticks - 1U);
+        r->ccr = (uint16_t)ticks;           // CCR > ARR: sortie jamais active
+    } else if (index <= p->rampPeriods) {
+        uint32_t carrier = MOTOR_PULSE_CARRIER_US * p->ticksPerUs;
+        uint32_t duty = carrier * index / ((uint32_t)p->rampPeriods + 1U);
+        r->psc = 0;
+        r->arr = (uint16_t)(carrier - 1U);
+        r->ccr = (uint16_t)(carrier - duty); // Active en fin de période
+    } else {
+        uint32_t ticks = motor_pulse_span(p, p->holdUs, &r->psc);
+        r->arr = (uint16_t)(ticks - 1U);
+        r->ccr = 0;                         // Active sur toute la période
+    }
+}
+
+bool MotorPulse_Start(MotorPulse* p, const MotorPulseSpec* spec, uint32_t timerHz, MotorPulseRegs* first) {
+    if (p == NULL || spec == NULL || first == NULL || spec->onUs == 0) return false;
+    if (timerHz < 1000000U || (timerHz % 1000000U) != 0) return false;
+
+    memset(p, 0, sizeof(*p));
+    p->ticksPerUs = timerHz / 1000000U;
+    if (MOTOR_PULSE_CARRIER_US * p->ticksPerUs > MOTOR_PULSE_MAX_TICKS) return false;
+
+    uint64_t totalTicks = ((uint64_t)spec->settleUs + spec->onUs) * p->ticksPerUs;
+    if (totalTicks > (uint64_t)MOTOR_PULSE_MAX_TICKS * (MOTOR_PULSE_MAX_PSC + 1U)) return false;
+
+    p->settleUs = spec->settleUs;
+    p->onUs = spec->onUs;
+
+    uint32_t ramp = spec->softStartUs;
+    if (ramp > spec->onUs / 2U) ramp = spec->onUs / 2U;
+    uint32_t periods = ramp / MOTOR_PULSE_CARRIER_US;
+    if (periods > 0xFFFDU) periods = 0xFFFDU;
+    p->rampPeriods = (uint16_t)periods;
+    p->rampUs = periods * MOTOR_PULSE_CARRIER_US;
+    p->holdUs = spec->onUs - p->rampUs;
+    p->periodCount = (p->rampPeriods == 0) ? 1U : (uint16_t)(p->rampPeriods + 2U);
+
+    motor_pulse_period(p, 0, &p->currentRegs);
+    *first = p->currentRegs;
+    return true;
+}
+
+MotorPulseStep MotorPulse_Next(MotorPulse* p, MotorPulseRegs* regs) {
+    if (p->ended) return MOTOR_PULSE_DONE;
+
+    // La mise à jour vient de charger la période préchargée
+    if (p->preloaded) {
+        p->current++;
+        p->currentRegs = p->pendingRegs;
+        p->preloaded = false;
+    }
+    if ((uint32_t)p->current + 1U < p->periodCount) {
+        motor_pulse_period(p, (uint16_t)(p->current + 1U), &p->pendingRegs);
+        p->preloaded = true;
+        *regs = p->pendingRegs;
+        return MOTOR_PULSE_PRELOAD;
+    }
+
+    // Dernière période en cours: à l'arrêt (CNT = 0) le CCR préchargé doit
+    // laisser la sortie basse, soit CCR >= 1
+    *regs = p->currentRegs;
+    if (regs->ccr == 0) regs->ccr = 1;
+    p->ended = true;
+    return MOTOR_PULSE_LAST;
+}
+
+uint32_t MotorPulse_TotalUs(const MotorPulse* p) {
+    return p->settleUs + p->onUs;
+}
@@ -0,0 +1,81 @@
+#include "orch_event_queue.h"
+#include <string.h>
+
+// Les niveaux pointent sur le stockage de la file: rattachés au premier usage
+// pour qu'une file statique mise à zéro fonctionne sans Init explicite
+static void orch_queue_bind(OrchEventQueue* q) {
+    if (q->levels[ORCH_PRIO_CONTROL].slots != NULL) return;
+    q->levels[ORCH_PRIO_CONTROL].slots = q->control;
+    q->levels[ORCH_PRIO_CONTROL].depth = ORCH_QUEUE_CONTROL_DEPTH;
+    q->levels[ORCH_PRIO_TELEMETRY].slots = q->telemetry;
+    q->levels[ORCH_PRIO_TELEMETRY].depth = ORCH_QUEUE_TELEMETRY_DEPTH;
+}
+
+void OrchEventQueue_Init(OrchEventQueue* q) {
+    memset(q, 0, sizeof(*q));
+    orch_queue_bind(q);
+}
+
+OrchEventPriority OrchEventQueue_PriorityOf(OrchestratorEventType type) {
+    return (type == ORCH_EVT_STOCK_LOW) ? ORCH_PRIO_TELEMETRY : ORCH_PRIO_CONTROL;
+}
+
+// Événements idempotents: un seul en file par clé (capteur, timer)
+static bool orch_same_key(const OrchestratorEvent* a, const OrchestratorEvent* b) {
+    if (a->type != b->type) return false;
+    switch (a->type) {
+        case ORCH_EVT_STOCK_LOW:
+            return a->data.stock.sensorId == b->data.stock.sensorId;
+        case ORCH_EVT_TIMER:
+            return a->data.code == b->data.code;
+        default:
+            return false;
+    }
+}
+
+OrchPushResult OrchEventQueue_Push(OrchEventQueue* q, const OrchestratorEvent* evt) {
+    if ((unsigned)evt->type >= ORCH_EVT_COUNT) return ORCH_PUSH_DROPPED;
+    orch_queue_bind(q);
+
+    OrchEventTypeStats* st = &q->stats[evt->type];
+    OrchEventLevel* lv = &q->levels[OrchEventQueue_PriorityOf(evt->type)];
+    st->posted++;
+
+    for (uint8_t i = 0; i < lv->count; i++) {
+        OrchestratorEvent* slot = &lv->slots[(uint8_t)(lv->head + i) % lv->depth];
+        if (orch_same_key(slot, evt)) {
+            *slot = *evt;
+            st->coalesced++;
+            return ORCH_PUSH_COALESCED;
+        }
+    }
+    if (lv->count >= lv->depth) {
+        st->dropped++;
+        return ORCH_PUSH_DROPPED;
+    }
+
+    lv->slots[(uint8_t)(lv->head + lv->count) % lv->depth] = *evt;
+    lv->count++;
+    if (lv->count > lv->highWater) lv->highWater = lv->count;
+    st->queued++;
+    if (st->queued > st->highWater) st->highWater = st->queued;
+    return ORCH_PUSH_QUEUED;
+}
+
+bool OrchEventQueue_Pop(OrchEventQueue* q, OrchestratorEvent* out) {
+    orch_queue_bind(q);
+    for (uint8_t p = 0; p < ORCH_PRIO_COUNT; p++) {
+        OrchEventLevel* lv = &q->levels[p];
+        if (lv->count == 0) continue;
+        *out = lv->slots[lv->head];
+        lv->head = (uint8_t)((lv->head + 1U) % lv->depth);
+        lv->count--;
+        q->stats[out->type].queued--;
+        return true;
+    }
+    return false;
+}
+
+uint8_t OrchEventQueue_Count(const OrchEventQueue* q) {
+    return (uint8_t)(q->levels[ORCH_PRIO_CONTROL].count + q->levels[ORCH_PRIO_TELEMETRY].count);
+}
@@ -1,15 +1,39 @@
 #include "orchestrator.h"
 #include "esp_communication_service.h"
 #include "watchdog_service.h"
+#include "orch_event_queue.h"
+#include "block_pool.h"
+#include "str_intern.h"
+#include "catalog_service.h"
 
 // ---------- Queues ----------
 extern osMessageQueueId_t keypadEventQueueHandle; // legacy
-extern osMessageQueueId_t orchestratorEventQueueHandle; // nouvelle queue unifiée
+
+// File d'événements à priorités (remplace la queue CMSIS FIFO): accès en
+// section critique, la tâche est réveillée par notification
+static OrchEventQueue orchQueue;
+static TaskHandle_t orchTaskHandleLocal = NULL;
+
+// Charges utiles hors file: identifiants de commande dans un pool de blocs
+// (un par ORDER_START en vol), identifiants produit internés une fois pour toutes
+#define ORCH_ORDER_ID_BLOCKS   4U
+#define ORCH_PRODUCT_IDS       16U
+#define ORCH_ID_LEN            (ESP_PROTO_ID_MAX_LEN + 1U)
+
+static char orderIdStorage[ORCH_ORDER_ID_BLOCKS][ORCH_ID_LEN];
+static BlockPool orderIdPool = BLOCK_POOL_STATIC_INIT(orderIdStorage, ORCH_ID_LEN, ORCH_ORDER_ID_BLOCKS);
+static char productIdStorage[ORCH_PRODUCT_IDS][ORCH_ID_LEN];
+static StrIntern productIds = STR_INTERN_STATIC_INIT(productIdStorage, ORCH_ID_LEN, ORCH_PRODUCT_IDS);
 
 // Variables d'état globales (définies dans global.c)
 extern volatile MachineState machine_interaction;
-extern volatile char keypad_choice[3];
-extern volatile uint8_t client_order;
+extern volatile char keypad_choice[KEYPAD_CHOICE_SIZE];
+extern volatile uint16_t client_order;
+
+// Produit choisi au clavier, figé pendant le paiement: son code est relu dans
+// le catalogue au moment de distribuer (mise à jour pendant le paiement)
+static ProductEntry clientProduct;
+static char clientCode[KEYPAD_CHOICE_SIZE];
 
 // Variables pour la gestion des commandes de livraison
 static bool deliveryOrderInProgress = false;
@@ -17,6 +41,66 @@ static char currentDeliveryOrderId[32] = {0};
 static uint8_t pendingDeliveryItems = 0;
 static uint8_t completedDeliveryItems = 0;
 
+// Étapes temporisées: timers logiciels à un coup. Leur callback (tâche Timer
+// Service) ne fait que poster ORCH_EVT_TIMER; la suite s'exécute dans la boucle
+// d'événements, qui ne bloque jamais.
+typedef enum {
+    ORCH_TIMER_MESSAGE = 0,     // Fin d'affichage d'un message temporaire
+    ORCH_TIMER_COUNT
+} OrchTimerId;
+
+#define ORCH_MESSAGE_MS      3000U
+#define ORCH_TIMER_RETRY_MS  10U    // Queue pleine: nouvel essai de l'échéance
+
+static osTimerId_t orchTimers[ORCH_TIMER_COUNT];
+
+// Articles en cours de distribution. Un article = un job moteur de toute sa
+// quantité: les articles sont soumis d'avance tant que la file moteur a de la
+// place, chaque fin de job (ORCH_EVT_DELIVERY_DONE) est imputée à son article
+// par le tag du job, avec le nombre d'unités effectivement tombées.
+#define ORCH_VEND_QUEUE_SIZE ESP_PROTO_ORDER_MAX_ITEMS
+#define ORCH_JOB_TAG_LOCAL   0xFFU  // Achat au clavier, hors file d'articles
+
+typedef struct {
+    uint8_t slot_number;
+    uint8_t quantity;
+    uint8_t submitted;      // Unités confiées au moteur
+    uint8_t done;
+    uint8_t failed;
+    uint8_t failCode;       // EspResponseCode du dernier échec
+} OrchVendJob;
+
+static OrchVendJob vendQueue[ORCH_VEND_QUEUE_SIZE];
+static uint8_t vendHead = 0;
+static uint8_t vendCount = 0;
+static uint8_t vendSubmitIdx = 0;       // Article (relatif à la tête) en cours de soumission
+static bool orderCompletePending = false;
+
+// Fins de job moteur refusées par la file pleine: une place réservée par tag
+// (un job en vol par article, un seul achat local), reprise par la boucle
+// après la file. La tâche moteur n'attend jamais et aucun résultat n'est perdu.
+#define ORCH_PARKED_SLOTS (ORCH_VEND_QUEUE_SIZE + 1U)
+static OrchestratorEvent parkedResults[ORCH_PARKED_SLOTS];
+static uint16_t parkedMask = 0;
+
+// Premier job moteur de la distribution en cours: les fins de jobs antérieurs
+// (commande annulée, job déjà lancé) sont ignorées
+static MotorJobId sessionFirstJob = MOTOR_JOB_ID_NONE;
+
+// Message temporaire à afficher à l'entrée dans IDLE (à la place de l'accueil)
+static LcdMessage pendingFlash;
+static bool pendingFlashSet = false;
+
+// ---------- Machine à états ----------
+// Une action traite l'événement et retourne l'état suivant. ORCH_STATE_KEEP:
+// pas de transition; retourner l'état courant revient au même (ni sortie ni entrée).
+#define ORCH_STATE_KEEP ((MachineState)0xFF)
+
+typedef MachineState (*OrchAction)(const OrchestratorEvent* evt);
+typedef void (*OrchStateHook)(void);
+
+static OrchestratorStats orchStats;
+
 // Helper pour reset le choix
 static void reset_choice(void) {
     keypad_choice[0] = '\0';
@@ -43,8 +127,8 @@ static void orchestrator_show(MachineState state) {
             orchestrator_send_lcd("Choix de boisson", (const char*)keypad_choice);
             break;
         case PAYING: {
-            char buf[8];
-            snprintf(buf, sizeof(buf), "%d", client_order);
+            char buf[sizeof(clientCode) + sizeof(clientProduct.label)];
+            snprintf(buf, sizeof(buf), "%s %s", clientCode, clientProduct.label);
             orchestrator_send_lcd("Paiement en cours", buf);
             break;
         }
@@ -59,226 +143,632 @@ static void orchestrator_show(MachineState state) {
     }
 }
 
-// ---------- Gestion des événements ----------
-static void orchestrator_on_delivery_done(void) {
-    ((volatile uint8_t)client_order);
+static void orchestrator_show_flash(void) {
+    pendingFlashSet = false;
+    LCD_SendMessage(&pendingFlash);
+    osTimerStart(orchTimers[ORCH_TIMER_MESSAGE], ORCH_MESSAGE_MS);
+}
+
+// Message affiché ORCH_MESSAGE_MS à l'entrée dans IDLE (tout de suite si on
+// y est déjà), puis l'accueil
+static void orchestrator_flash(const char* line1, const char* line2) {
+    memset(&pendingFlash, 0, sizeof(pendingFlash));
+    snprintf(pendingFlash.line1, sizeof(pendingFlash.line1), "%s", line1);
+    snprintf(pendingFlash.line2, sizeof(pendingFlash.line2), "%s", line2);
+    pendingFlashSet = true;
+    if (machine_interaction == IDLE) {
+        orchestrator_show_flash();
+    }
+}
+
+// ---------- Étapes temporisées ----------
+static void orchestrator_timer_cb(void* argument) {
+    uint8_t id = (uint8_t)(uintptr_t)argument;
+    OrchestratorEvent evt = { .type = ORCH_EVT_TIMER, .data.code = id };
+    if (!Orchestrator_PostEvent(&evt)) {
+        osTimerStart(orchTimers[id], ORCH_TIMER_RETRY_MS);
+    }
+}
+
+static void orchestrator_timers_init(void) {
+    for (uint8_t i = 0; i < ORCH_TIMER_COUNT; i++) {
+        orchTimers[i] = osTimerNew(orchestrator_timer_cb, osTimerOnce, (void*)(uintptr_t)i, NULL);
+        if (orchTimers[i] == NULL) {
+            LOGE("[ORCH] Timer %u creation failed\r\n", i);
+        }
+    }
+}
+
+// ---------- Actions d'entrée / sortie ----------
+static void orchestrator_enter_idle(void) {
+    reset_choice();
     client_order = 0;
-    machine_interaction = IDLE;
-    orchestrator_show(IDLE);
+    clientCode[0] = '\0';
+    if (pendingFlashSet) {
+        orchestrator_show_flash();
+    } else {
+        orchestrator_show(IDLE);
+    }
+}
+
+static void orchestrator_enter_paying(void) {
+    EspResponse rsp = { .type = ESP_RSP_STATE, .code = ESP_CODE_STATE_PAYING };
+    EspComm_SendResponse(&rsp);
+    orchestrator_show(PAYING);
 }
 
-// Fonction pour gérer le début d'une commande de livraison
-static void orchestrator_on_order_start(const char* order_id) {
+static void orchestrator_enter_delivering(void) {
     if (deliveryOrderInProgress) {
-        printf("[ORCH] Order already in progress, ignoring new order\r\n");
+        orchestrator_send_lcd("Commande QR recue", currentDeliveryOrderId);
+    } else {
+        orchestrator_show(DELIVERING);
+    }
+}
+
+static void orchestrator_enter_settings(void) {
+    orchestrator_show(SETTINGS);
+}
+
+static void orchestrator_exit_ordering(void) {
+    reset_choice();
+}
+
+// Quitter DELIVERING abandonne toute unité restante (commande annulée ou terminée)
+static void orchestrator_exit_delivering(void) {
+    MotorService_CancelAll();
+    vendHead = 0;
+    vendCount = 0;
+    vendSubmitIdx = 0;
+    orderCompletePending = false;
+    sessionFirstJob = MOTOR_JOB_ID_NONE;
+}
+
+static const OrchStateHook orchEntry[ORCH_STATE_COUNT] = {
+    [IDLE]       = orchestrator_enter_idle,
+    [PAYING]     = orchestrator_enter_paying,
+    [DELIVERING] = orchestrator_enter_delivering,
+    [SETTINGS]   = orchestrator_enter_settings,
+};
+
+static const OrchStateHook orchExit[ORCH_STATE_COUNT] = {
+    [ORDERING]   = orchestrator_exit_ordering,
+    [DELIVERING] = orchestrator_exit_delivering,
+};
+
+// Seul point d'écriture de machine_interaction: sortie, horodatage, entrée.
+// Rester dans le même état ne déclenche rien.
+static void orchestrator_commit_state(MachineState next) {
+    MachineState prev = machine_interaction;
+    if (next == prev) {
         return;
     }
+    uint32_t now = osKernelGetTickCount();
+
+    if (orchExit[prev] != NULL) {
+        orchExit[prev]();
+    }
+    orchStats.lastDwellMs = now - orchStats.stateSinceTick;
+    orchStats.dwellMs[prev] += orchStats.lastDwellMs;
+    orchStats.stateSinceTick = now;
+    orchStats.transitions++;
+    LOGD("[ORCH] State %d -> %d after %lu ms\r\n", (int)prev, (int)next,
+         (unsigned long)orchStats.lastDwellMs);
+    machine_interaction = next;
+    if (orchEntry[next] != NULL) {
+        orchEntry[next]();
+    }
+}
+
+void Orchestrator_GetStats(OrchestratorStats* out) {
+    if (out == NULL) return;
+    *out = orchStats;
+}
+
+bool Orchestrator_PostEvent(const OrchestratorEvent* evt) {
+    if (evt == NULL) return false;
+    taskENTER_CRITICAL();
+    OrchPushResult res = OrchEventQueue_Push(&orchQueue, evt);
+    taskEXIT_CRITICAL();
+    if (res == ORCH_PUSH_DROPPED) {
+        return false;
+    }
+    if (orchTaskHandleLocal != NULL) {
+        xTaskNotifyGive(orchTaskHandleLocal);
+    }
+    return true;
+}
+
+bool Orchestrator_PostOrderStart(const char* order_id) {
+    if (order_id == NULL) return false;
+    taskENTER_CRITICAL();
+    uint8_t id = BlockPool_Alloc(&orderIdPool);
+    taskEXIT_CRITICAL();
+    if (id == BLOCK_POOL_INVALID) {
+        return false;
+    }
+    char* block = (char*)BlockPool_Get(&orderIdPool, id);
+    strncpy(block, order_id, ORCH_ID_LEN - 1U);
+    block[ORCH_ID_LEN - 1U] = '\0';
+
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_START, .data.order.id = id };
+    if (!Orchestrator_PostEvent(&evt)) {
+        taskENTER_CRITICAL();
+        BlockPool_Free(&orderIdPool, id);
+        taskEXIT_CRITICAL();
+        return false;
+    }
+    return true;
+}
+
+bool Orchestrator_PostVendItem(uint8_t slot_number, uint8_t quantity, const char* product_id) {
+    OrchestratorEvent evt = { .type = ORCH_EVT_VEND_ITEM };
+    evt.data.vend.slot_number = slot_number;
+    evt.data.vend.quantity = quantity;
+    // Id inconnu si la table est pleine: l'identifiant ne sert qu'aux traces
+    taskENTER_CRITICAL();
+    evt.data.vend.product = StrIntern_Intern(&productIds, product_id ? product_id : "");
+    taskEXIT_CRITICAL();
+    return Orchestrator_PostEvent(&evt);
+}
+
+// Rend le bloc d'un ORDER_START une fois l'événement traité (ou ignoré)
+static void orchestrator_release_payload(const OrchestratorEvent* evt) {
+    if (evt->type == ORCH_EVT_ORDER_START) {
+        taskENTER_CRITICAL();
+        BlockPool_Free(&orderIdPool, evt->data.order.id);
+        taskEXIT_CRITICAL();
+    }
+}
+
+void Orchestrator_GetEventStats(OrchestratorEventType type, OrchEventTypeStats* out) {
+    if (out == NULL || (unsigned)type >= ORCH_EVT_COUNT) return;
+    taskENTER_CRITICAL();
+    *out = orchQueue.stats[type];
+    taskEXIT_CRITICAL();
+}
+
+static bool orchestrator_next_event(OrchestratorEvent* out) {
+    taskENTER_CRITICAL();
+    bool ok = OrchEventQueue_Pop(&orchQueue, out);
+    if (!ok && parkedMask != 0) {
+        uint8_t slot = 0;
+        while ((parkedMask & (1U << slot)) == 0) slot++;
+        *out = parkedResults[slot];
+        parkedMask &= (uint16_t)~(1U << slot);
+        ok = true;
+    }
+    taskEXIT_CRITICAL();
+    return ok;
+}
+
+// ---------- Commandes de livraison (QR) ----------
+static MachineState orchestrator_finish_order(void) {
+    printf("[ORCH] Order completed: %s (%d items delivered)\r\n", 
+           currentDeliveryOrderId, completedDeliveryItems);
+    
+    // Confirmer la livraison complète à l'ESP
+    EspResponse rsp = { .type = ESP_RSP_DELIVERY_COMPLETED };
+    EspComm_SendResponse(&rsp);
     
+    deliveryOrderInProgress = false;
+    orderCompletePending = false;
+    return IDLE;
+}
+
+// Fin d'un job moteur (tâche moteur): seul un événement repart vers la boucle,
+// par la file ou, si elle est pleine, par la place réservée du tag.
+// Les jobs annulés l'ont été par l'orchestrateur lui-même, rien à signaler.
+static void orchestrator_motor_done(MotorJobId id, uint8_t channel, MotorJobStatus status,
+                                    uint8_t delivered, void* ctx) {
+    (void)channel;
+    if (status == MOTOR_JOB_CANCELLED) return;
+    OrchestratorEvent evt = { .type = ORCH_EVT_DELIVERY_DONE };
+    evt.data.job.id = id;
+    evt.data.job.status = (uint8_t)status;
+    evt.data.job.tag = (uint8_t)(uintptr_t)ctx;
+    evt.data.job.delivered = delivered;
+    if (Orchestrator_PostEvent(&evt)) return;
+
+    // Même tag déjà en place: l'ancien résultat est celui d'une distribution
+    // annulée (le moteur est séquentiel), le plus récent l'emporte
+    uint8_t slot = (evt.data.job.tag < ORCH_VEND_QUEUE_SIZE) ? evt.data.job.tag : ORCH_VEND_QUEUE_SIZE;
+    taskENTER_CRITICAL();
+    parkedResults[slot] = evt;
+    parkedMask |= (uint16_t)(1U << slot);
+    taskEXIT_CRITICAL();
+    LOGW("[ORCH] Queue full, motor job %u result parked\r\n", id);
+    if (orchTaskHandleLocal != NULL) {
+        xTaskNotifyGive(orchTaskHandleLocal);
+    }
+}
+
+static MotorJobId orchestrator_submit(uint8_t channel, uint8_t quantity, uint8_t tag) {
+    MotorJobId id = MotorService_Submit(channel, quantity, MOTOR_ON_CALIBRATED,
+                                        orchestrator_motor_done, (void*)(uintptr_t)tag);
+    if (id != MOTOR_JOB_ID_NONE && sessionFirstJob == MOTOR_JOB_ID_NONE) {
+        sessionFirstJob = id;
+    }
+    return id;
+}
+
+// Confie au moteur les articles restants, un job par article, dans l'ordre,
+// tant que sa file a de la place; reprise à chaque fin de job
+static void orchestrator_vend_feed(void) {
+    while (vendSubmitIdx < vendCount) {
+        uint8_t idx = (uint8_t)(vendHead + vendSubmitIdx) % ORCH_VEND_QUEUE_SIZE;
+        OrchVendJob* job = &vendQueue[idx];
+        if (job->submitted >= job->quantity) {
+            vendSubmitIdx++;
+            continue;
+        }
+        // Le slot_number correspond directement au channel du multiplexeur
+        if (orchestrator_submit(job->slot_number, (uint8_t)(job->quantity - job->submitted), idx)
+                == MOTOR_JOB_ID_NONE) {
+            return;
+        }
+        job->submitted = job->quantity;
+    }
+}
+
+// Confirme les articles de tête dont toutes les unités sont revenues, relance
+// la soumission, et clôt la commande si ORDER_COMPLETE attendait la fin
+static MachineState orchestrator_vend_settle(void) {
+    while (vendCount > 0) {
+        const OrchVendJob* job = &vendQueue[vendHead];
+        if ((uint8_t)(job->done + job->failed) < job->quantity) {
+            break;
+        }
+        if (job->failed == 0) {
+            EspResponse rsp = { .type = ESP_RSP_VEND_COMPLETED, .slot = job->slot_number };
+            EspComm_SendResponse(&rsp);
+            completedDeliveryItems++;
+            printf("[ORCH] Item delivered: %d/%d\r\n", completedDeliveryItems, pendingDeliveryItems);
+        } else {
+            printf("[ORCH] Item failed: slot %d, %d/%d units\r\n", job->slot_number, job->done, job->quantity);
+            EspResponse rsp = { .type = ESP_RSP_VEND_FAILED, .slot = job->slot_number, .code = job->failCode,
+                                .delivered = job->done, .quantity = job->quantity };
+            EspComm_SendResponse(&rsp);
+        }
+        vendHead = (uint8_t)((vendHead + 1U) % ORCH_VEND_QUEUE_SIZE);
+        vendCount--;
+        if (vendSubmitIdx > 0) vendSubmitIdx--;
+    }
+
+    orchestrator_vend_feed();
+    return (vendCount == 0 && orderCompletePending) ? orchestrator_finish_order() : ORCH_STATE_KEEP;
+}
+
+static void orchestrator_start_order(const char* order_id) {
     deliveryOrderInProgress = true;
+    sessionFirstJob = MOTOR_JOB_ID_NONE;
     pendingDeliveryItems = 0;
     completedDeliveryItems = 0;
     strncpy(currentDeliveryOrderId, order_id, sizeof(currentDeliveryOrderId) - 1);
     currentDeliveryOrderId[sizeof(currentDeliveryOrderId) - 1] = '\0';
-    
-    machine_interaction = DELIVERING;
-    orchestrator_send_lcd("Commande QR recue", currentDeliveryOrderId);
     printf("[ORCH] Order started: %s\r\n", currentDeliveryOrderId);
 }
 
-// Fonction pour gérer un item de livraison
-static void orchestrator_on_vend_item(uint8_t slot_number, uint8_t quantity, const char* product_id) {
+// Item de livraison: mis en file, ses unités soumises au moteur sans bloquer
+static MachineState orchestrator_queue_item(uint8_t slot_number, uint8_t quantity, const char* product_id) {
     if (!deliveryOrderInProgress) {
         printf("[ORCH] VEND item received without active order\r\n");
-        return;
+        return ORCH_STATE_KEEP;
+    }
+    if (vendCount >= ORCH_VEND_QUEUE_SIZE) {
+        printf("[ORCH] Vend queue full, refusing slot %d\r\n", slot_number);
+        EspResponse rsp = { .type = ESP_RSP_VEND_FAILED, .slot = slot_number, .code = ESP_CODE_ORDER_BUSY };
+        EspComm_SendResponse(&rsp);
+        return ORCH_STATE_KEEP;
     }
     
     pendingDeliveryItems++;
     printf("[ORCH] VEND item: slot=%d, qty=%d, product=%s\r\n", slot_number, quantity, product_id);
-    
-    // Démarrer la livraison pour cet item
-    uint8_t channel = slot_number; // Le slot_number correspond directement au channel du multiplexeur
-    if (channel >= 1 && channel <= 4) {
-        // Livrer la quantité demandée
-        for (uint8_t i = 0; i < quantity; i++) {
-            MotorService_StartDelivery(channel);
-            // Attendre un peu entre chaque livraison
-            osDelay(1000);
-        }
-        
-        // Confirmer la livraison de cet item
-        char response[64];
-        snprintf(response, sizeof(response), "VEND_COMPLETED:%d", slot_number);
-        EspComm_SendLine(response);
-        
-        completedDeliveryItems++;
-        printf("[ORCH] Item delivered: %d/%d\r\n", completedDeliveryItems, pendingDeliveryItems);
-    } else {
-        printf("[ORCH] Invalid channel: %d\r\n", channel);
-        char response[64];
-        snprintf(response, sizeof(response), "VEND_FAILED:%d:INVALID_CHANNEL", slot_number);
-        EspComm_SendLine(response);
+    if (slot_number < 1 || slot_number > 4) {
+        printf("[ORCH] Invalid channel: %d\r\n", slot_number);
+        EspResponse rsp = { .type = ESP_RSP_VEND_FAILED, .slot = slot_number, .code = ESP_CODE_INVALID_CHANNEL };
+        EspComm_SendResponse(&rsp);
+        return ORCH_STATE_KEEP;
     }
+    
+    OrchVendJob* job = &vendQueue[(uint8_t)(vendHead + vendCount) % ORCH_VEND_QUEUE_SIZE];
+    memset(job, 0, sizeof(*job));
+    job->slot_number = slot_number;
+    job->quantity = quantity;
+    vendCount++;
+    return orchestrator_vend_settle();
 }
 
-// Fonction pour finaliser une commande de livraison
-static void orchestrator_on_order_complete(void) {
+// Fin de commande: différée tant que des unités restent à distribuer
+static MachineState orchestrator_complete_order(void) {
     if (!deliveryOrderInProgress) {
         printf("[ORCH] Order complete received without active order\r\n");
-        return;
+        return ORCH_STATE_KEEP;
     }
-    
-    printf("[ORCH] Order completed: %s (%d items delivered)\r\n", 
-           currentDeliveryOrderId, completedDeliveryItems);
-    
-    // Confirmer la livraison complète à l'ESP
-    EspComm_SendLine("DELIVERY_COMPLETED");
-    
-    // Réinitialiser l'état
-    deliveryOrderInProgress = false;
-    machine_interaction = IDLE;
-    orchestrator_show(IDLE);
+    if (vendCount > 0) {
+        orderCompletePending = true;
+        return ORCH_STATE_KEEP;
+    }
+    return orchestrator_finish_order();
 }
 
-// Fonction pour gérer l'échec d'une commande
-static void orchestrator_on_order_failed(void) {
-    if (deliveryOrderInProgress) {
-        printf("[ORCH] Order failed: %s\r\n", currentDeliveryOrderId);
-        EspComm_SendLine("DELIVERY_FAILED:ORDER_CANCELLED");
-        deliveryOrderInProgress = false;
-        machine_interaction = IDLE;
-        orchestrator_show(IDLE);
+// Chiffre ajouté à la saisie, consulté aussitôt dans le catalogue: code
+// complet -> paiement, début d'un code -> saisie poursuivie, sinon refus
+static MachineState orchestrator_key_digit(char key) {
+    size_t len = strlen((const char*)keypad_choice);
+    ProductMatch match = PRODUCT_MATCH_NONE;
+    if (len + 1U < sizeof(keypad_choice)) {
+        keypad_choice[len] = key;
+        keypad_choice[len + 1U] = '\0';
+        match = CatalogService_Match((const char*)keypad_choice, &clientProduct);
+    }
+
+    switch (match) {
+        case PRODUCT_MATCH_FOUND:
+            printf("Commande à valider: %s\r\n", keypad_choice);
+            memcpy(clientCode, (const char*)keypad_choice, sizeof(clientCode));
+            client_order = clientProduct.code;
+            return PAYING;
+        case PRODUCT_MATCH_PREFIX:
+            orchestrator_show(ORDERING);
+            return ORDERING;
+        default:
+            reset_choice();
+            orchestrator_flash("Produit non ", "valable");
+            return IDLE;
     }
 }
 
-static void orchestrator_on_key_idle_ordering(char key) {
-    if (key == '*' && machine_interaction == ORDERING) {
-        printf("Annuler\r\n");
-        reset_choice();
-        machine_interaction = IDLE;
-        orchestrator_send_lcd("Commande annulee !", "");
-        return;
+// ---------- Actions (une par case utile de la table) ----------
+static MachineState orch_act_key_idle(const OrchestratorEvent* evt) {
+    char key = evt->data.key;
+    if (key < '0' || key > '9') {
+        return ORCH_STATE_KEEP;
     }
-    if (key == '*' || key == '#') {
-        return;
+    return orchestrator_key_digit(key);
+}
+
+static MachineState orch_act_cancel_ordering(const OrchestratorEvent* evt) {
+    (void)evt;
+    printf("Annuler\r\n");
+    orchestrator_flash("Commande annulee !", "");
+    return IDLE;
+}
+
+static MachineState orch_act_key_ordering(const OrchestratorEvent* evt) {
+    char key = evt->data.key;
+    if (key == '*') {
+        return orch_act_cancel_ordering(evt);
     }
-    size_t len = strlen((const char *)keypad_choice);
-    if (len < 2) {
-        keypad_choice[len] = key;
-        keypad_choice[len + 1] = '\0';
-        machine_interaction = ORDERING;
-        orchestrator_show(ORDERING);
-    }
-    if (strlen((const char *)keypad_choice) == 2) {
-        printf("Commande à valider: %s\r\n", keypad_choice);
-        uint8_t orderCode = (keypad_choice[0] - '0') * 10 + (keypad_choice[1] - '0');
-        reset_choice();
-        uint8_t ch = MotorService_OrderToChannel(orderCode);
-        if (ch == 0xFF) {
-            client_order = 0;
-            machine_interaction = IDLE;
-            orchestrator_send_lcd("Produit non ", "valable");
-            osDelay(3000);
-            orchestrator_show(IDLE);
-            return;
-        }
-        client_order = orderCode;
-        machine_interaction = PAYING;
-        EspComm_SendLine("STATE:PAYING");
-        orchestrator_show(PAYING);
+    if (key < '0' || key > '9') {
+        return ORCH_STATE_KEEP;
     }
+    return orchestrator_key_digit(key);
 }
 
-static void orchestrator_on_key_paying(char key) {
-    if (key == '*') {
-        printf("Paiement annulé\r\n");
-        client_order = 0;
-        machine_interaction = IDLE;
-        orchestrator_show(IDLE);
-        return;
+static MachineState orch_act_pay_confirm(const OrchestratorEvent* evt) {
+    (void)evt;
+    printf("Paiement validé pour commande %s\r\n", clientCode);
+    ProductEntry product;
+    if (CatalogService_Match(clientCode, &product) != PRODUCT_MATCH_FOUND) {
+        printf("Commande invalide: %s\r\n", clientCode);
+        orchestrator_flash("Produit retire", "du catalogue");
+        return IDLE;
     }
-    if (key == '#') {
-        printf("Paiement validé pour commande %d\r\n", client_order);
-        machine_interaction = DELIVERING;
-        uint8_t channel = MotorService_OrderToChannel(client_order);
-        if (channel == 0xFF) {
-            printf("Commande invalide: %d\r\n", client_order);
-            machine_interaction = IDLE;
-            orchestrator_send_lcd("Commande invalide", "");
-            return;
+    sessionFirstJob = MOTOR_JOB_ID_NONE;
+    if (orchestrator_submit(product.channel, 1, ORCH_JOB_TAG_LOCAL) == MOTOR_JOB_ID_NONE) {
+        orchestrator_flash("Distributeur", "occupe");
+        return IDLE;
+    }
+    return DELIVERING;
+}
+
+static MachineState orch_act_pay_cancel(const OrchestratorEvent* evt) {
+    (void)evt;
+    printf("Paiement annulé\r\n");
+    return IDLE;
+}
+
+static MachineState orch_act_key_paying(const OrchestratorEvent* evt) {
+    switch (evt->data.key) {
+        case '#': return orch_act_pay_confirm(evt);
+        case '*': return orch_act_pay_cancel(evt);
+        default:  return ORCH_STATE_KEEP;
+    }
+}
+
+static MachineState orch_act_no_net(const OrchestratorEvent* evt) {
+    (void)evt;
+    // Paiement impossible: retour immédiat à l'accueil, message gardé 3 s
+    orchestrator_flash("Aucune connexion", "internet");
+    return IDLE;
+}
+
+// Fin d'un job moteur: achat local terminé, ou article de commande QR
+static MachineState orch_act_delivery_done(const OrchestratorEvent* evt) {
+    MotorJobId id = evt->data.job.id;
+    if (sessionFirstJob == MOTOR_JOB_ID_NONE || MotorJobQueue_IdBefore(id, sessionFirstJob)) {
+        return ORCH_STATE_KEEP;     // Job d'une distribution précédente
+    }
+    if (evt->data.job.tag == ORCH_JOB_TAG_LOCAL) {
+        if (deliveryOrderInProgress) return ORCH_STATE_KEEP;
+        if (evt->data.job.status == MOTOR_JOB_NO_DROP) {
+            orchestrator_flash("Produit non", "distribue");
+        } else if (evt->data.job.status != MOTOR_JOB_DONE) {
+            orchestrator_flash("Erreur de", "distribution");
         }
-        orchestrator_show(DELIVERING);
-        MotorService_StartDelivery(channel);
+        return IDLE;
+    }
+    if (!deliveryOrderInProgress || evt->data.job.tag >= ORCH_VEND_QUEUE_SIZE) {
+        return ORCH_STATE_KEEP;
+    }
+    OrchVendJob* job = &vendQueue[evt->data.job.tag];
+    if (evt->data.job.status == MOTOR_JOB_DONE) {
+        job->done = job->quantity;
+    } else {
+        // Compte partiel: les unités tombées avant l'échec restent livrées
+        uint8_t delivered = evt->data.job.delivered;
+        if (delivered > job->quantity) delivered = job->quantity;
+        job->done = delivered;
+        job->failed = (uint8_t)(job->quantity - delivered);
+        job->failCode = (evt->data.job.status == MOTOR_JOB_NO_DROP) ? ESP_CODE_NO_DROP : ESP_CODE_MOTOR_FAILED;
     }
+    return orchestrator_vend_settle();
 }
 
-static void orchestrator_on_key_event(char key) {
-    // Logging sécurisé sans exposition des détails internes
-    LOGD("[Orchestrator] Key event processed (state=%d)\r\n", (int)machine_interaction);
-    switch (machine_interaction) {
-        case IDLE:
-        case ORDERING:
-            orchestrator_on_key_idle_ordering(key);
-            break;
-        case PAYING:
-            orchestrator_on_key_paying(key);
-            break;
-        default:
-            break;
+static MachineState orch_act_stock_low(const OrchestratorEvent* evt) {
+    printf("Stock LOW: sensor=%d, %dmm\r\n", evt->data.stock.sensorId, evt->data.stock.mm);
+    return ORCH_STATE_KEEP;
+}
+
+static MachineState orch_act_order_start(const OrchestratorEvent* evt) {
+    const char* order_id = (const char*)BlockPool_Get(&orderIdPool, evt->data.order.id);
+    orchestrator_start_order(order_id ? order_id : "");
+    return DELIVERING;
+}
+
+static MachineState orch_act_order_busy(const OrchestratorEvent* evt) {
+    (void)evt;
+    printf("[ORCH] Order already in progress, ignoring new order\r\n");
+    return ORCH_STATE_KEEP;
+}
+
+static MachineState orch_act_vend_item(const OrchestratorEvent* evt) {
+    return orchestrator_queue_item(evt->data.vend.slot_number,
+                                   evt->data.vend.quantity,
+                                   StrIntern_Get(&productIds, evt->data.vend.product));
+}
+
+static MachineState orch_act_order_complete(const OrchestratorEvent* evt) {
+    (void)evt;
+    return orchestrator_complete_order();
+}
+
+static MachineState orch_act_order_failed(const OrchestratorEvent* evt) {
+    (void)evt;
+    if (!deliveryOrderInProgress) {
+        return ORCH_STATE_KEEP;
+    }
+    printf("[ORCH] Order failed: %s\r\n", currentDeliveryOrderId);
+    EspResponse rsp = { .type = ESP_RSP_DELIVERY_FAILED, .code = ESP_CODE_ORDER_CANCELLED };
+    EspComm_SendResponse(&rsp);
+    deliveryOrderInProgress = false;
+    return IDLE;
+}
+
+// Commande groupée: début, articles et fin traités d'un seul événement. Les
+// articles sont copiés dans la file de distribution: le descripteur est rendu aussitôt.
+static MachineState orch_act_order_batch(const OrchestratorEvent* evt) {
+    const EspOrder* order = evt->data.batch.order;
+    MachineState next = DELIVERING;
+
+    orchestrator_start_order(order->order_id);
+    for (uint8_t i = 0; i < order->item_count; i++) {
+        const EspOrderItem* item = &order->items[i];
+        orchestrator_queue_item(item->slot_number, item->quantity, item->product_id);
+    }
+    EspComm_ReleaseOrder(order);
+    MachineState done = orchestrator_complete_order();
+    if (done != ORCH_STATE_KEEP) {
+        next = done;   // Aucun article distribuable: commande déjà close
+    }
+    return next;
+}
+
+// Refus propre à la nouvelle commande (ORDER_NAK): DELIVERY_FAILED désignerait
+// la commande en cours de distribution
+static MachineState orch_act_batch_busy(const OrchestratorEvent* evt) {
+    const EspOrder* order = evt->data.batch.order;
+    printf("[ORCH] Order already in progress, refusing batch %s\r\n", order->order_id);
+    EspResponse rsp = { .type = ESP_RSP_ORDER_NAK, .code = ESP_CODE_ORDER_BUSY };
+    EspComm_SendResponse(&rsp);
+    EspComm_ReleaseOrder(order);
+    return ORCH_STATE_KEEP;
+}
+
+static MachineState orch_act_timer_idle(const OrchestratorEvent* evt) {
+    if (evt->data.code == ORCH_TIMER_MESSAGE) {
+        orchestrator_show(IDLE);
+    }
+    return ORCH_STATE_KEEP;
+}
+
+// ---------- Table des transitions (const: en flash) ----------
+// Case NULL: événement ignoré dans cet état (compté dans ignoredEvents)
+#define ORCH_ROW_ORDERS_ACCEPTED \
+    [ORCH_EVT_STOCK_LOW]   = orch_act_stock_low,   \
+    [ORCH_EVT_ORDER_START] = orch_act_order_start, \
+    [ORCH_EVT_ORDER_BATCH] = orch_act_order_batch
+
+static const OrchAction orchTransitions[ORCH_STATE_COUNT][ORCH_EVT_COUNT] = {
+    [IDLE] = {
+        ORCH_ROW_ORDERS_ACCEPTED,
+        [ORCH_EVT_KEYPAD]         = orch_act_key_idle,
+        [ORCH_EVT_NO_NET]         = orch_act_no_net,
+        [ORCH_EVT_TIMER]          = orch_act_timer_idle,
+    },
+    [ORDERING] = {
+        ORCH_ROW_ORDERS_ACCEPTED,
+        [ORCH_EVT_KEYPAD]         = orch_act_key_ordering,
+        [ORCH_EVT_PAYMENT_CANCEL] = orch_act_cancel_ordering,
+        [ORCH_EVT_NO_NET]         = orch_act_no_net,
+    },
+    [PAYING] = {
+        ORCH_ROW_ORDERS_ACCEPTED,
+        [ORCH_EVT_KEYPAD]         = orch_act_key_paying,
+        [ORCH_EVT_PAYMENT_OK]     = orch_act_pay_confirm,
+        [ORCH_EVT_PAYMENT_CANCEL] = orch_act_pay_cancel,
+        [ORCH_EVT_NO_NET]         = orch_act_no_net,
+    },
+    [DELIVERING] = {
+        [ORCH_EVT_STOCK_LOW]      = orch_act_stock_low,
+        [ORCH_EVT_DELIVERY_DONE]  = orch_act_delivery_done,
+        [ORCH_EVT_ORDER_START]    = orch_act_order_busy,
+        [ORCH_EVT_ORDER_BATCH]    = orch_act_batch_busy,
+        [ORCH_EVT_VEND_ITEM]      = orch_act_vend_item,
+        [ORCH_EVT_ORDER_COMPLETE] = orch_act_order_complete,
+        [ORCH_EVT_ORDER_FAILED]   = orch_act_order_failed,
+    },
+    [SETTINGS] = {
+        ORCH_ROW_ORDERS_ACCEPTED,
+    },
+};
+
+// Traite un événement en O(1); ne bloque jamais (attentes sur orchTimers ou jobs moteur)
+static void orchestrator_dispatch(const OrchestratorEvent* oevt) {
+    MachineState state = machine_interaction;
+    if ((unsigned)state >= ORCH_STATE_COUNT || (unsigned)oevt->type >= ORCH_EVT_COUNT) {
+        orchStats.ignoredEvents++;
+        return;
+    }
+    OrchAction action = orchTransitions[state][oevt->type];
+    if (action == NULL) {
+        orchStats.ignoredEvents++;
+        return;
+    }
+    LOGD("[Orchestrator] Event %d processed (state=%d)\r\n", (int)oevt->type, (int)state);
+    MachineState next = action(oevt);
+    if (next != ORCH_STATE_KEEP) {
+        orchestrator_commit_state(next);
     }
 }
 
 void StartTaskOrchestrator(void *argument) {
+    (void)argument;
     printf("\r\nOrchestrator Task started\r\n");
     OrchestratorEvent oevt;
+    orchestrator_timers_init();
+    orchStats.stateSinceTick = osKernelGetTickCount();
+    orchTaskHandleLocal = xTaskGetCurrentTaskHandle();
 
     for (;;) {
         // Heartbeat watchdog pour signaler que la tâche est vivante
         Watchdog_TaskHeartbeat(TASK_ORCHESTRATOR);
-        
-        if (osMessageQueueGet(orchestratorEventQueueHandle, &oevt, NULL, 1000) != osOK) {
-            continue; // Timeout pour permettre le heartbeat régulier
-        }
-        switch (oevt.type) {
-            case ORCH_EVT_KEYPAD:
-                orchestrator_on_key_event(oevt.data.key);
-                break;
-            case ORCH_EVT_PAYMENT_OK:
-                orchestrator_on_key_event('#');
-                break;
-            case ORCH_EVT_PAYMENT_CANCEL:
-                orchestrator_on_key_event('*');
-                break;
-            case ORCH_EVT_NO_NET:
-                orchestrator_send_lcd("Aucune connexion", "internet");
-                osDelay(3000);
-                machine_interaction = IDLE;
-                orchestrator_show(IDLE);
-                break;
-            case ORCH_EVT_DELIVERY_DONE:
-                orchestrator_on_delivery_done();
-                break;
-            case ORCH_EVT_STOCK_LOW:
-                printf("Stock LOW: sensor=%d, %dmm\r\n", oevt.data.stock.sensorId, oevt.data.stock.mm);
-                break;
-            case ORCH_EVT_ORDER_START:
-                orchestrator_on_order_start(oevt.data.order.order_id);
-                break;
-            case ORCH_EVT_VEND_ITEM:
-                orchestrator_on_vend_item(oevt.data.vend.slot_number, 
-                                        oevt.data.vend.quantity, 
-                                        oevt.data.vend.product_id);
-                break;
-            case ORCH_EVT_ORDER_COMPLETE:
-                orchestrator_on_order_complete();
-                break;
-            case ORCH_EVT_ORDER_FAILED:
-                orchestrator_on_order_failed();
-                break;
-            case ORCH_EVT_ERROR_MOTOR:
-            default:
-                break;
+
+        // Événements déposés avant l'enregistrement du handle compris
+        while (orchestrator_next_event(&oevt)) {
+            orchestrator_dispatch(&oevt);
+            orchestrator_release_payload(&oevt);
         }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000)); // Timeout pour le heartbeat régulier
     }
 }
-
-
@@ -0,0 +1,96 @@
+#include "product_catalog.h"
+#include <string.h>
+
+// Case de l'index: numéro d'entrée sur 7 bits (PRODUCT_SLOT_EMPTY: aucune),
+// bit 7 levé si un code plus long commence par ces chiffres
+#define PRODUCT_SLOT_ENTRY   0x7FU
+#define PRODUCT_SLOT_EMPTY   0x7FU
+#define PRODUCT_SLOT_PREFIX  0x80U
+
+// Première case et nombre de codes possibles par longueur
+static const uint16_t kSlotBase[PRODUCT_CODE_MAX_DIGITS + 1] = { 0, 0, 10, 110 };
+static const uint16_t kCodeSpan[PRODUCT_CODE_MAX_DIGITS + 1] = { 0, 10, 100, 1000 };
+
+static void product_set(ProductEntry* e, uint16_t code, uint8_t channel, const char* label) {
+    memset(e, 0, sizeof(*e));
+    e->code = code;
+    e->digits = 2;
+    e->channel = channel;
+    e->sensorId = PRODUCT_SENSOR_NONE;
+    strncpy(e->label, label, PRODUCT_LABEL_LEN - 1);
+}
+
+void ProductCatalog_Default(ProductCatalogImage* image) {
+    memset(image, 0, sizeof(*image));
+    // Deux rangées sur les quatre premiers canaux du multiplexeur, prix
+    // fixés côté paiement
+    product_set(&image->entries[0], 11, 1, "Produit 11");
+    product_set(&image->entries[1], 12, 2, "Produit 12");
+    product_set(&image->entries[2], 13, 3, "Produit 13");
+    product_set(&image->entries[3], 21, 4, "Produit 21");
+    product_set(&image->entries[4], 22, 1, "Produit 22");
+    product_set(&image->entries[5], 23, 2, "Produit 23");
+    image->count = 6;
+}
+
+ProductCatalogError ProductCatalog_Build(ProductCatalog* cat, uint8_t channelCount) {
+    ProductCatalogImage* img = &cat->image;
+    memset(cat->index, PRODUCT_SLOT_EMPTY, sizeof(cat->index));
+    if (img->count == 0 || img->count > PRODUCT_CATALOG_MAX) return PRODUCT_CATALOG_ERR_COUNT;
+
+    ProductCatalogError err = PRODUCT_CATALOG_OK;
+    // Codes exacts d'abord, puis leurs préfixes: le contrôle ne dépend pas
+    // de l'ordre des entrées
+    for (uint8_t i = 0; err == PRODUCT_CATALOG_OK && i < img->count; i++) {
+        ProductEntry* e = &img->entries[i];
+        e->label[PRODUCT_LABEL_LEN - 1] = '\0';
+        if (e->digits == 0 || e->digits > PRODUCT_CODE_MAX_DIGITS || e->code >= kCodeSpan[e->digits]) {
+            err = PRODUCT_CATALOG_ERR_CODE;
+        } else if (e->channel >= channelCount) {
+            err = PRODUCT_CATALOG_ERR_CHANNEL;
+        } else {
+            uint8_t* slot = &cat->index[kSlotBase[e->digits] + e->code];
+            if (*slot != PRODUCT_SLOT_EMPTY) err = PRODUCT_CATALOG_ERR_DUPLICATE;
+            *slot = i;
+        }
+    }
+    for (uint8_t i = 0; err == PRODUCT_CATALOG_OK && i < img->count; i++) {
+        const ProductEntry* e = &img->entries[i];
+        uint16_t prefix = e->code;
+        for (uint8_t d = e->digits - 1U; d > 0; d--) {
+            prefix /= 10U;
+            uint8_t* slot = &cat->index[kSlotBase[d] + prefix];
+            if ((*slot & PRODUCT_SLOT_ENTRY) != PRODUCT_SLOT_EMPTY) {
+                err = PRODUCT_CATALOG_ERR_PREFIX;
+                break;
+            }
+            *slot |= PRODUCT_SLOT_PREFIX;
+        }
+    }
+
+    if (err != PRODUCT_CATALOG_OK) memset(cat->index, PRODUCT_SLOT_EMPTY, sizeof(cat->index));
+    return err;
+}
+
+ProductMatch ProductCatalog_Match(const ProductCatalog* cat, const char* digits,
+                                  const ProductEntry** entry) {
+    if (!cat || !digits) return PRODUCT_MATCH_NONE;
+
+    uint8_t len = 0;
+    uint16_t value = 0;
+    while (digits[len] != '\0') {
+        if (len == PRODUCT_CODE_MAX_DIGITS || digits[len] < '0' || digits[len] > '9') {
+            return PRODUCT_MATCH_NONE;
+        }
+        value = (uint16_t)(value * 10U + (uint16_t)(digits[len] - '0'));
+        len++;
+    }
+    if (len == 0) return PRODUCT_MATCH_NONE;
+
+    uint8_t slot = cat->index[kSlotBase[len] + value];
+    if ((slot & PRODUCT_SLOT_ENTRY) != PRODUCT_SLOT_EMPTY) {
+        if (entry) *entry = &cat->image.entries[slot & PRODUCT_SLOT_ENTRY];
+        return PRODUCT_MATCH_FOUND;
+    }
+    return (slot & PRODUCT_SLOT_PREFIX) ? PRODUCT_MATCH_PREFIX : PRODUCT_MATCH_NONE;
+}
@@ -0,0 +1,86 @@
+#include "ring_buffer.h"
+#include <string.h>
+
+// Empêche le compilateur de réordonner la copie des données et la
+// publication de l'indice (Cortex-M4 mono-cœur: pas de barrière matérielle)
+#define RING_BUFFER_BARRIER() __asm__ volatile ("" ::: "memory")
+
+bool RingBuffer_Init(RingBuffer* rb, uint8_t* storage, uint16_t size) {
+    if (!rb || !storage || size == 0 || (size & (size - 1)) != 0 || size > 0x8000) {
+        return false;
+    }
+    rb->buf = storage;
+    rb->size = size;
+    rb->mask = (uint16_t)(size - 1);
+    rb->head = 0;
+    rb->tail = 0;
+    return true;
+}
+
+uint16_t RingBuffer_Count(const RingBuffer* rb) {
+    return (uint16_t)(rb->head - rb->tail);
+}
+
+uint16_t RingBuffer_Free(const RingBuffer* rb) {
+    return (uint16_t)(rb->size - RingBuffer_Count(rb));
+}
+
+uint16_t RingBuffer_Head(const RingBuffer* rb) {
+    return rb->head;
+}
+
+uint16_t RingBuffer_Write(RingBuffer* rb, const uint8_t* data, uint16_t len) {
+    uint16_t head = rb->head;
+    uint16_t space = (uint16_t)(rb->size - (uint16_t)(head - rb->tail));
+    if (len > space) len = space;
+    if (len == 0) return 0;
+
+    // Copie en deux morceaux au plus (rebouclage)
+    uint16_t idx = head & rb->mask;
+    uint16_t first = (uint16_t)(rb->size - idx);
+    if (first > len) first = len;
+    memcpy(&rb->buf[idx], data, first);
+    if (len > first) {
+        memcpy(&rb->buf[0], data + first, (size_t)(len - first));
+    }
+
+    RING_BUFFER_BARRIER();
+    rb->head = (uint16_t)(head + len);
+    return len;
+}
+
+uint16_t RingBuffer_Read(RingBuffer* rb, uint8_t* out, uint16_t maxLen) {
+    uint16_t tail = rb->tail;
+    uint16_t avail = (uint16_t)(rb->head - tail);
+    if (maxLen > avail) maxLen = avail;
+    if (maxLen == 0) return 0;
+
+    RING_BUFFER_BARRIER();
+    uint16_t idx = tail & rb->mask;
+    uint16_t first = (uint16_t)(rb->size - idx);
+    if (first > maxLen) first = maxLen;
+    memcpy(out, &rb->buf[idx], first);
+    if (maxLen > first) {
+        memcpy(out + first, &rb->buf[0], (size_t)(maxLen - first));
+    }
+
+    RING_BUFFER_BARRIER();
+    rb->tail = (uint16_t)(tail + maxLen);
+    return maxLen;
+}
+
+uint16_t RingBuffer_PeekContiguous(const RingBuffer* rb, const uint8_t** data) {
+    uint16_t tail = rb->tail;
+    uint16_t avail = (uint16_t)(rb->head - tail);
+    uint16_t idx = tail & rb->mask;
+    uint16_t first = (uint16_t)(rb->size - idx);
+    if (data) *data = &rb->buf[idx];
+    return (avail < first) ? avail : first;
+}
+
+void RingBuffer_Skip(RingBuffer* rb, uint16_t len) {
+    uint16_t avail = (uint16_t)(rb->head - rb->tail);
+    if (len > avail) len = avail;
+    RING_BUFFER_BARRIER();
+    rb->tail = (uint16_t)(rb->tail + len);
+}
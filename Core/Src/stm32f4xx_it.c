@@ -69,6 +69,11 @@ extern TIM_HandleTypeDef htim1;
 extern volatile uint8_t ledBlinkActive;
 extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart2;
+extern DMA_HandleTypeDef hdma_usart1_rx;
+extern DMA_HandleTypeDef hdma_usart1_tx;
+extern TIM_HandleTypeDef htim3;
+extern I2C_HandleTypeDef hi2c1;
+extern I2C_HandleTypeDef hi2c2;
 /* USER CODE END EV */
 
 /******************************************************************************/
@@ -212,6 +217,58 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
 // Amélioration HardFault avec diagnostic
 // Note: HardFault_Handler est déjà défini plus haut dans le fichier
 // Cette fonction est remplacée par la logique dans la section USER CODE
+/**
+  * @brief This function handles EXTI line0 interrupt (barrière de chute DROP_BEAM).
+  */
+void EXTI0_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(DROP_BEAM_Pin);
+}
+
+/**
+  * @brief This function handles EXTI line[9:5] interrupts (GPIO1 des capteurs ToF).
+  */
+void EXTI9_5_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(TOF1_GPIO1_Pin);
+  HAL_GPIO_EXTI_IRQHandler(TOF2_GPIO1_Pin);
+  HAL_GPIO_EXTI_IRQHandler(TOF3_GPIO1_Pin);
+  HAL_GPIO_EXTI_IRQHandler(TOF4_GPIO1_Pin);
+  HAL_GPIO_EXTI_IRQHandler(TOF5_GPIO1_Pin);
+}
+
+/**
+  * @brief This function handles I2C1 event interrupt.
+  */
+void I2C1_EV_IRQHandler(void)
+{
+  HAL_I2C_EV_IRQHandler(&hi2c1);
+}
+
+/**
+  * @brief This function handles I2C1 error interrupt.
+  */
+void I2C1_ER_IRQHandler(void)
+{
+  HAL_I2C_ER_IRQHandler(&hi2c1);
+}
+
+/**
+  * @brief This function handles I2C2 event interrupt.
+  */
+void I2C2_EV_IRQHandler(void)
+{
+  HAL_I2C_EV_IRQHandler(&hi2c2);
+}
+
+/**
+  * @brief This function handles I2C2 error interrupt.
+  */
+void I2C2_ER_IRQHandler(void)
+{
+  HAL_I2C_ER_IRQHandler(&hi2c2);
+}
+
 /**
   * @brief This function handles EXTI line[15:10] interrupts.
   */
@@ -228,6 +285,14 @@ void USART2_IRQHandler(void)
   HAL_UART_IRQHandler(&huart2);
 }
 
+/**
+  * @brief This function handles TIM3 global interrupt (impulsion moteur).
+  */
+void TIM3_IRQHandler(void)
+{
+  HAL_TIM_IRQHandler(&htim3);
+}
+
 /**
   * @brief This function handles USART1 global interrupt.
   */
@@ -235,4 +300,20 @@ void USART1_IRQHandler(void)
 {
   HAL_UART_IRQHandler(&huart1);
 }
+
+/**
+  * @brief This function handles DMA2 stream2 global interrupt (USART1_RX).
+  */
+void DMA2_Stream2_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_rx);
+}
+
+/**
+  * @brief This function handles DMA2 stream7 global interrupt (USART1_TX).
+  */
+void DMA2_Stream7_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_tx);
+}
 /* USER CODE END 1 */
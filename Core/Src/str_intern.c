@@ -0,0 +1,54 @@
+#include "str_intern.h"
+#include <string.h>
+
+// Publication d'une entrée après sa copie (Cortex-M4 mono-cœur: barrière compilateur)
+#define STR_INTERN_BARRIER() __asm__ volatile ("" ::: "memory")
+
+static uint8_t str_intern_hash(const char* s, size_t* len) {
+    uint8_t h = 0;
+    size_t n = 0;
+    while (s[n] != '\0') {
+        h = (uint8_t)((h << 1) ^ (h >> 7) ^ (uint8_t)s[n]);
+        n++;
+    }
+    *len = n;
+    return h;
+}
+
+bool StrIntern_Init(StrIntern* t, char* storage, uint8_t entryLen, uint8_t capacity) {
+    if (!t || !storage || entryLen < 2 || capacity == 0 || capacity > STR_INTERN_MAX_ENTRIES) {
+        return false;
+    }
+    memset(t, 0, sizeof(*t));
+    t->storage = storage;
+    t->entryLen = entryLen;
+    t->capacity = capacity;
+    return true;
+}
+
+uint8_t StrIntern_Intern(StrIntern* t, const char* s) {
+    size_t len;
+    uint8_t h = str_intern_hash(s, &len);
+    uint8_t count = t->count;
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (t->hash[i] == h && strcmp(&t->storage[(uint16_t)i * t->entryLen], s) == 0) {
+            return i;
+        }
+    }
+    if (count >= t->capacity || len >= t->entryLen) {
+        t->rejected++;
+        return STR_INTERN_NONE;
+    }
+
+    memcpy(&t->storage[(uint16_t)count * t->entryLen], s, len + 1U);
+    t->hash[count] = h;
+    STR_INTERN_BARRIER();
+    t->count = (uint8_t)(count + 1U);
+    return count;
+}
+
+const char* StrIntern_Get(const StrIntern* t, uint8_t id) {
+    if (id >= t->count) return "";
+    return &t->storage[(uint16_t)id * t->entryLen];
+}
@@ -0,0 +1,62 @@
+#include "tof_scan.h"
+#include <string.h>
+
+void TofScan_Init(TofScan* s, uint8_t count, uint32_t timeoutMs) {
+    memset(s, 0, sizeof(*s));
+    if (count > TOF_SCAN_MAX) count = TOF_SCAN_MAX;
+    s->count = count;
+    s->timeoutMs = timeoutMs;
+    s->enabled = (uint8_t)((1U << count) - 1U);
+}
+
+void TofScan_SetEnabled(TofScan* s, uint8_t id, bool enabled) {
+    if (id >= s->count) return;
+    uint8_t bit = (uint8_t)(1U << id);
+    if (enabled) {
+        s->enabled |= bit;
+    } else {
+        s->enabled &= (uint8_t)~bit;
+        s->pending &= (uint8_t)~bit;
+    }
+}
+
+void TofScan_Begin(TofScan* s, uint32_t nowMs) {
+    s->startMs = nowMs;
+    s->cycleMs = 0;
+    s->pending = s->enabled;
+    s->done = 0;
+    s->failed = 0;
+}
+
+bool TofScan_Ready(TofScan* s, uint8_t id, uint8_t mm, uint32_t nowMs) {
+    if (id >= s->count) return false;
+    uint8_t bit = (uint8_t)(1U << id);
+    if ((s->pending & bit) == 0) return false;
+    s->pending &= (uint8_t)~bit;
+    s->done |= bit;
+    s->mm[id] = mm;
+    s->cycleMs = nowMs - s->startMs;
+    return true;
+}
+
+void TofScan_Fail(TofScan* s, uint8_t id) {
+    if (id >= s->count) return;
+    uint8_t bit = (uint8_t)(1U << id);
+    if ((s->pending & bit) == 0) return;
+    s->pending &= (uint8_t)~bit;
+    s->failed |= bit;
+}
+
+uint8_t TofScan_Expire(TofScan* s, uint32_t nowMs) {
+    // Différence signée: robuste au rebouclage du tick
+    if (s->pending == 0 || (int32_t)(nowMs - TofScan_DeadlineMs(s)) < 0) return 0;
+    uint8_t expired = s->pending;
+    s->failed |= expired;
+    s->pending = 0;
+    s->cycleMs = nowMs - s->startMs;
+    return expired;
+}
+
+uint32_t TofScan_DeadlineMs(const TofScan* s) {
+    return s->startMs + s->timeoutMs;
+}
@@ -0,0 +1,68 @@
+#include "vl6180.h"
+
+#define VL6180_GPIO1_INTERRUPT_OUT     0x10    // MODE_GPIO1: sortie d'interruption, active basse
+#define VL6180_INT_RANGE_NEW_SAMPLE    0x04    // INTERRUPT_CONFIG / INTERRUPT_STATUS, bits 2:0
+#define VL6180_INT_RANGE_MASK          0x07
+#define VL6180_INT_CLEAR_ALL           0x07
+#define VL6180_RANGE_SINGLE_SHOT       0x01
+#define VL6180_RANGE_CONTINUOUS        0x03    // Démarrage + mode continu
+
+// RANGE_STATUS, bits 7:4: 1..5 défaut du capteur (VCSEL, PLL), 12 et 14
+// dépassement par le bas (cible collée), les autres codes: pas de cible
+#define VL6180_RANGE_ERR_SHIFT         4
+#define VL6180_RANGE_ERR_HW_LAST       5U
+#define VL6180_RANGE_ERR_RAW_UNDERFLOW 12U
+#define VL6180_RANGE_ERR_UNDERFLOW     14U
+
+static bool vl6180_write_reg(const Vl6180Bus* bus, uint16_t addr8, uint16_t reg, uint8_t value) {
+    return bus->write(addr8, reg, &value, 1, bus->ctx);
+}
+
+bool Vl6180_SetAddress(const Vl6180Bus* bus, uint16_t addr8, uint8_t new7bit) {
+    return vl6180_write_reg(bus, addr8, VL6180_I2C_SLAVE_DEVICE_ADDRESS, new7bit);
+}
+
+bool Vl6180_Init(const Vl6180Bus* bus, uint16_t addr8, uint16_t periodMs) {
+    uint8_t fresh = 0;
+    if (!bus->read(addr8, VL6180_SYSTEM_FRESH_OUT_OF_RESET, &fresh, 1, bus->ctx)) return false;
+    // Quelques writes de tuning peuvent être nécessaires selon AN (omises ici pour simplicité)
+    if (!vl6180_write_reg(bus, addr8, VL6180_SYSTEM_MODE_GPIO1, VL6180_GPIO1_INTERRUPT_OUT)) return false;
+    // INTERRUPT_CONFIG, INTERRUPT_CLEAR, FRESH_OUT_OF_RESET remis à 0
+    const uint8_t irq[] = { VL6180_INT_RANGE_NEW_SAMPLE, VL6180_INT_CLEAR_ALL, 0x00 };
+    if (!bus->write(addr8, VL6180_SYSTEM_INTERRUPT_CONFIG_GPIO, irq, sizeof(irq), bus->ctx)) return false;
+    if (periodMs == 0) return true;
+    // Période = (valeur + 1) x 10 ms
+    if (!vl6180_write_reg(bus, addr8, VL6180_SYSRANGE_INTERMEASUREMENT_PERIOD,
+                          (uint8_t)(periodMs / 10U - 1U))) return false;
+    return vl6180_write_reg(bus, addr8, VL6180_SYSRANGE_START, VL6180_RANGE_CONTINUOUS);
+}
+
+bool Vl6180_Start(const Vl6180Bus* bus, uint16_t addr8) {
+    // INTERRUPT_CLEAR, FRESH_OUT_OF_RESET, GROUPED_PARAMETER_HOLD, SYSRANGE_START
+    const uint8_t seq[] = { VL6180_INT_CLEAR_ALL, 0x00, 0x00, VL6180_RANGE_SINGLE_SHOT };
+    return bus->write(addr8, VL6180_SYSTEM_INTERRUPT_CLEAR, seq, sizeof(seq), bus->ctx);
+}
+
+bool Vl6180_ReadSample(const Vl6180Bus* bus, uint16_t addr8, uint8_t* mm) {
+    uint8_t block[VL6180_RESULT_BLOCK_LEN];
+    if (!bus->read(addr8, VL6180_RESULT_RANGE_STATUS, block, sizeof(block), bus->ctx)) return false;
+
+    uint8_t irq = block[VL6180_RESULT_INTERRUPT_STATUS_GPIO - VL6180_RESULT_RANGE_STATUS];
+    if ((irq & VL6180_INT_RANGE_MASK) != VL6180_INT_RANGE_NEW_SAMPLE) return false;
+
+    uint8_t err = (uint8_t)(block[0] >> VL6180_RANGE_ERR_SHIFT);
+    if (err == 0) {
+        *mm = block[VL6180_RESULT_RANGE_VAL - VL6180_RESULT_RANGE_STATUS];
+    } else if (err <= VL6180_RANGE_ERR_HW_LAST) {
+        return false;
+    } else if (err == VL6180_RANGE_ERR_RAW_UNDERFLOW || err == VL6180_RANGE_ERR_UNDERFLOW) {
+        *mm = 0;
+    } else {
+        *mm = VL6180_RANGE_MM_MAX;
+    }
+    return true;
+}
+
+bool Vl6180_ClearInterrupt(const Vl6180Bus* bus, uint16_t addr8) {
+    return vl6180_write_reg(bus, addr8, VL6180_SYSTEM_INTERRUPT_CLEAR, VL6180_INT_CLEAR_ALL);
+}
@@ -0,0 +1,7 @@
+#ifndef MOCK_CMSIS_OS_H
+#define MOCK_CMSIS_OS_H
+
+// Redirection de l'en-tête CMSIS-RTOS v2 vers les mocks FreeRTOS
+#include "mock_freertos.h"
+
+#endif // MOCK_CMSIS_OS_H
@@ -13,6 +13,8 @@ static struct {
     uint32_t queue_count;
     uint32_t mutex_count;
     uint32_t delay_call_count;
+    uint32_t notify_value;
+    uint32_t notify_give_count;
     
     // Simulation des objets FreeRTOS
     struct {
@@ -35,6 +37,17 @@ static struct {
         bool locked;
         osThreadId_t owner;
     } mutexes[8];
+
+    struct timer_state {
+        bool in_use;
+        bool running;
+        osTimerFunc_t func;
+        osTimerType_t type;
+        void* argument;
+        uint32_t period;
+        uint32_t expiry;
+    } timers[8];
+    uint32_t timer_count;
     
 } mock_freertos = {
     .kernel_state = osKernelInactive,
@@ -211,6 +224,114 @@ osStatus_t osMutexRelease(osMutexId_t mutex_id) {
     return osErrorParameter;
 }
 
+// ============================================================================
+// FONCTIONS NOTIFICATIONS DE TÂCHE
+// ============================================================================
+
+// Une seule tâche simulée: toutes les notifications visent le même compteur
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return (TaskHandle_t)1;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify) {
+    if (xTaskToNotify == NULL) return pdFALSE;
+    mock_freertos.notify_value++;
+    mock_freertos.notify_give_count++;
+    return pdTRUE;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t* pxHigherPriorityTaskWoken) {
+    if (xTaskToNotify == NULL) return;
+    mock_freertos.notify_value++;
+    mock_freertos.notify_give_count++;
+    if (pxHigherPriorityTaskWoken) *pxHigherPriorityTaskWoken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait) {
+    uint32_t value = mock_freertos.notify_value;
+    if (value == 0) {
+        // Pas de blocage en natif: le temps d'attente est simplement écoulé
+        if (xTicksToWait != portMAX_DELAY) mock_freertos.current_tick += xTicksToWait;
+        return 0;
+    }
+    mock_freertos.notify_value = xClearCountOnExit ? 0 : value - 1;
+    return value;
+}
+
+// ============================================================================
+// FONCTIONS TIMERS LOGICIELS
+// ============================================================================
+
+static struct timer_state* mock_timer(osTimerId_t timer_id) {
+    int index = (int)(uintptr_t)timer_id - 1;
+    if (index < 0 || index >= 8 || !mock_freertos.timers[index].in_use) return NULL;
+    return &mock_freertos.timers[index];
+}
+
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void* argument, const osTimerAttr_t* attr) {
+    (void)attr;
+    if (!func) return NULL;
+    for (int i = 0; i < 8; i++) {
+        if (!mock_freertos.timers[i].in_use) {
+            struct timer_state* t = &mock_freertos.timers[i];
+            memset(t, 0, sizeof(*t));
+            t->in_use = true;
+            t->func = func;
+            t->type = type;
+            t->argument = argument;
+            mock_freertos.timer_count++;
+            return (osTimerId_t)(uintptr_t)(i + 1);
+        }
+    }
+    return NULL;
+}
+
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
+    struct timer_state* t = mock_timer(timer_id);
+    if (!t || ticks == 0) return osErrorParameter;
+    t->period = ticks;
+    t->expiry = mock_freertos.current_tick + ticks;
+    t->running = true;
+    return osOK;
+}
+
+osStatus_t osTimerStop(osTimerId_t timer_id) {
+    struct timer_state* t = mock_timer(timer_id);
+    if (!t) return osErrorParameter;
+    if (!t->running) return osErrorResource;
+    t->running = false;
+    return osOK;
+}
+
+uint32_t osTimerIsRunning(osTimerId_t timer_id) {
+    struct timer_state* t = mock_timer(timer_id);
+    return (t && t->running) ? 1U : 0U;
+}
+
+void Mock_FreeRTOS_AdvanceTimers(uint32_t ticks) {
+    uint32_t target = mock_freertos.current_tick + ticks;
+
+    for (;;) {
+        struct timer_state* next = NULL;
+        for (int i = 0; i < 8; i++) {
+            struct timer_state* t = &mock_freertos.timers[i];
+            if (!t->in_use || !t->running) continue;
+            if ((int32_t)(t->expiry - target) > 0) continue;
+            if (!next || (int32_t)(t->expiry - next->expiry) < 0) next = t;
+        }
+        if (!next) break;
+
+        mock_freertos.current_tick = next->expiry;
+        if (next->type == osTimerPeriodic) {
+            next->expiry += next->period;
+        } else {
+            next->running = false;
+        }
+        next->func(next->argument);
+    }
+    mock_freertos.current_tick = target;
+}
+
 // ============================================================================
 // FONCTIONS DE CONTRÔLE DES MOCKS
 // ============================================================================
@@ -259,8 +380,20 @@ uint32_t Mock_FreeRTOS_GetMutexCount(void) {
     return mock_freertos.mutex_count;
 }
 
+uint32_t Mock_FreeRTOS_GetTimerCount(void) {
+    return mock_freertos.timer_count;
+}
+
 uint32_t Mock_FreeRTOS_GetDelayCallCount(void) {
     return mock_freertos.delay_call_count;
 }
 
+uint32_t Mock_FreeRTOS_GetNotifyGiveCount(void) {
+    return mock_freertos.notify_give_count;
+}
+
+uint32_t Mock_FreeRTOS_GetPendingNotifications(void) {
+    return mock_freertos.notify_value;
+}
+
 #endif // UNITY_NATIVE_TESTS
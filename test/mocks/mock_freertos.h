@@ -39,6 +39,14 @@ typedef enum {
 typedef void* osThreadId_t;
 typedef void* osMessageQueueId_t;
 typedef void* osMutexId_t;
+typedef void* osTimerId_t;
+
+typedef void (*osTimerFunc_t)(void* argument);
+
+typedef enum {
+    osTimerOnce = 0,
+    osTimerPeriodic = 1
+} osTimerType_t;
 
 // Structures mockées
 typedef struct {
@@ -55,9 +63,29 @@ typedef struct {
     const char* name;
 } osMutexAttr_t;
 
+typedef struct {
+    const char* name;
+} osTimerAttr_t;
+
 // Constantes
 #define osWaitForever 0xFFFFFFFFU
 
+// API tâches FreeRTOS natives (notifications directes)
+typedef void* TaskHandle_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE  ((BaseType_t)1)
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFU)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(xTimeInMs))
+#define portYIELD_FROM_ISR(x) ((void)(x))
+
+// Sections critiques: sans effet en natif (exécution mono-thread)
+#define taskENTER_CRITICAL() ((void)0)
+#define taskEXIT_CRITICAL()  ((void)0)
+
 // Fonctions FreeRTOS mockées
 osStatus_t osKernelInitialize(void);
 osKernelState_t osKernelGetState(void);
@@ -76,17 +104,33 @@ osMutexId_t osMutexNew(const osMutexAttr_t* attr);
 osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout);
 osStatus_t osMutexRelease(osMutexId_t mutex_id);
 
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void* argument, const osTimerAttr_t* attr);
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks);
+osStatus_t osTimerStop(osTimerId_t timer_id);
+uint32_t osTimerIsRunning(osTimerId_t timer_id);
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify);
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t* pxHigherPriorityTaskWoken);
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+
 // Fonctions de contrôle des mocks
 void Mock_FreeRTOS_Reset(void);
 void Mock_FreeRTOS_SetTick(uint32_t tick);
 void Mock_FreeRTOS_SetKernelState(osKernelState_t state);
 void Mock_FreeRTOS_SimulateDelay(uint32_t ticks);
+// Avance le temps et exécute les callbacks des timers échus, dans l'ordre
+// d'échéance (comme la tâche Timer Service)
+void Mock_FreeRTOS_AdvanceTimers(uint32_t ticks);
 
 // Vérifications des mocks
 uint32_t Mock_FreeRTOS_GetThreadCount(void);
 uint32_t Mock_FreeRTOS_GetQueueCount(void);
 uint32_t Mock_FreeRTOS_GetMutexCount(void);
+uint32_t Mock_FreeRTOS_GetTimerCount(void);
 uint32_t Mock_FreeRTOS_GetDelayCallCount(void);
+uint32_t Mock_FreeRTOS_GetNotifyGiveCount(void);
+uint32_t Mock_FreeRTOS_GetPendingNotifications(void);
 
 #endif // UNITY_NATIVE_TESTS
 
@@ -4,8 +4,8 @@
 
 // Définition des variables globales mockées
 volatile MachineState machine_interaction = IDLE;
-volatile char keypad_choice[3] = "";
-volatile uint8_t client_order = 0;
+volatile char keypad_choice[KEYPAD_CHOICE_SIZE] = "";
+volatile uint16_t client_order = 0;
 
 // Mutex globaux
 osMutexId_t globalStateMutex = NULL;
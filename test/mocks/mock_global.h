@@ -8,6 +8,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
+#include "product_catalog.h"
 
 // Mock des types FreeRTOS (éviter duplication avec mock_freertos.h)
 #ifndef MOCK_FREERTOS_H
@@ -60,9 +61,11 @@ typedef struct {
 #define LOGD(fmt, ...) printf("[DEBUG] " fmt "\n", ##__VA_ARGS__)
 
 // Variables globales
+#define KEYPAD_CHOICE_SIZE (PRODUCT_CODE_MAX_DIGITS + 1U)
+
 extern volatile MachineState machine_interaction;
-extern volatile char keypad_choice[3];
-extern volatile uint8_t client_order;
+extern volatile char keypad_choice[KEYPAD_CHOICE_SIZE];
+extern volatile uint16_t client_order;
 
 // Mutex globaux
 extern osMutexId_t globalStateMutex;
@@ -91,16 +94,16 @@ static inline bool GlobalState_GetKeypadChoice(char* buffer, size_t buffer_size)
 
 static inline void GlobalState_SetKeypadChoice(const char* choice) {
     if (choice) {
-        strncpy((char*)keypad_choice, choice, 2);
-        keypad_choice[2] = '\0';
+        strncpy((char*)keypad_choice, choice, KEYPAD_CHOICE_SIZE - 1);
+        keypad_choice[KEYPAD_CHOICE_SIZE - 1] = '\0';
     }
 }
 
-static inline uint8_t GlobalState_GetClientOrder(void) {
+static inline uint16_t GlobalState_GetClientOrder(void) {
     return client_order;
 }
 
-static inline void GlobalState_SetClientOrder(uint8_t order) {
+static inline void GlobalState_SetClientOrder(uint16_t order) {
     client_order = order;
 }
 
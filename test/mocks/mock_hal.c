@@ -1,4 +1,5 @@
 #include "mock_hal.h"
+#include "gpio_port.h"
 
 #ifdef UNITY_NATIVE_TESTS
 
@@ -6,6 +7,9 @@
 #include <string.h>
 #include <time.h>
 
+#define MOCK_GPIO_PORTS      3
+#define MOCK_GPIO_TRACE_MAX  256
+
 // Variables globales mockées
 static GPIO_TypeDef gpio_a = {0};
 static GPIO_TypeDef gpio_b = {0};
@@ -15,9 +19,17 @@ GPIO_TypeDef* GPIOA = &gpio_a;
 GPIO_TypeDef* GPIOB = &gpio_b;
 GPIO_TypeDef* GPIOC = &gpio_c;
 
+USART_TypeDef mock_usart1_instance = {0};
+USART_TypeDef mock_usart2_instance = {0};
+
+static DMA_Stream_TypeDef dma_usart1_rx_stream = {0};
+static DMA_HandleTypeDef hdma_usart1_rx = { .Instance = &dma_usart1_rx_stream };
+static DMA_Stream_TypeDef dma_usart1_tx_stream = {0};
+static DMA_HandleTypeDef hdma_usart1_tx = { .Instance = &dma_usart1_tx_stream };
+
 I2C_HandleTypeDef hi2c1 = {0};
-UART_HandleTypeDef huart1 = {0};
-UART_HandleTypeDef huart2 = {0};
+UART_HandleTypeDef huart1 = { .Instance = USART1, .Init = { .BaudRate = 115200 }, .hdmarx = &hdma_usart1_rx, .hdmatx = &hdma_usart1_tx, .gState = HAL_UART_STATE_READY };
+UART_HandleTypeDef huart2 = { .Instance = USART2, .Init = { .BaudRate = 115200 }, .gState = HAL_UART_STATE_READY };
 
 // État des mocks
 static struct {
@@ -26,18 +38,68 @@ static struct {
     HAL_StatusTypeDef i2c_response;
     uint8_t i2c_data[256];
     uint16_t i2c_data_size;
+    uint16_t i2c_mem_address;
+    uint16_t i2c_mem_add_size;
+    uint16_t i2c_last_size;
+    uint8_t i2c_last_tx[MOCK_I2C_TX_MAX];
     HAL_StatusTypeDef uart_response;
     
     // Compteurs d'appels
     uint32_t i2c_call_count;
     uint32_t uart_call_count;
     uint32_t gpio_write_count;
+
+    // Sorties par port (A, B, C) et trace de chaque écriture, pour vérifier
+    // qu'une transition ne passe par aucun état intermédiaire
+    uint16_t gpio_odr[MOCK_GPIO_PORTS];
+    uint16_t gpio_trace_start[MOCK_GPIO_PORTS];
+    struct {
+        uint8_t port;
+        uint16_t odr;
+    } gpio_trace[MOCK_GPIO_TRACE_MAX];
+    uint16_t gpio_trace_len;
+    uint32_t gpio_port_write_count;
+    uint32_t gpio_port_read_count;
+
+    // Réception UART DMA simulée
+    bool uart_rx_active;
+    uint32_t uart_rx_event_count;
+    uint32_t uart_rx_start_count;
+    uint32_t uart_rx_lost_count;
+
+    // Émission UART DMA simulée
+    uint8_t uart_tx_data[2048];
+    uint32_t uart_tx_len;
+    uint32_t uart_tx_start_count;
+    uint32_t uart_init_count;
 } mock_state = {0};
 
 // ============================================================================
 // FONCTIONS HAL MOCKÉES
 // ============================================================================
 
+static int mock_gpio_port_index(const GPIO_TypeDef* port) {
+    if (port == GPIOA) return 0;
+    if (port == GPIOB) return 1;
+    if (port == GPIOC) return 2;
+    return -1;
+}
+
+// Applique un mot BSRR au modèle de sortie du port et trace l'état obtenu
+static void mock_gpio_apply(const GPIO_TypeDef* port, uint32_t bsrr) {
+    int idx = mock_gpio_port_index(port);
+    if (idx < 0) return;
+    uint16_t set = (uint16_t)(bsrr & 0xFFFFU);
+    uint16_t reset = (uint16_t)(bsrr >> 16);
+    // Comme le matériel: set prioritaire sur reset pour une même broche
+    mock_state.gpio_odr[idx] = (uint16_t)((mock_state.gpio_odr[idx] & ~reset) | set);
+    if (mock_state.gpio_trace_len < MOCK_GPIO_TRACE_MAX) {
+        mock_state.gpio_trace[mock_state.gpio_trace_len].port = (uint8_t)idx;
+        mock_state.gpio_trace[mock_state.gpio_trace_len].odr = mock_state.gpio_odr[idx];
+        mock_state.gpio_trace_len++;
+    }
+}
+
 HAL_StatusTypeDef HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
     // Convertir le pin en index (position du bit)
     int pin_index = 0;
@@ -67,6 +129,28 @@ void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState Pin
     if (pin_index < 16) {
         mock_state.gpio_states[pin_index] = PinState;
     }
+    mock_gpio_apply(GPIOx, (PinState != GPIO_PIN_RESET) ? GPIO_Pin : ((uint32_t)GPIO_Pin << 16));
+}
+
+// Primitives de gpio_port.h (gpio.c sur cible)
+void GpioPort_WriteBsrr(GPIO_TypeDef* port, uint32_t bsrr) {
+    mock_state.gpio_port_write_count++;
+    for (int i = 0; i < 16; i++) {
+        if (bsrr & (1UL << (i + 16))) mock_state.gpio_states[i] = GPIO_PIN_RESET;
+        if (bsrr & (1UL << i)) mock_state.gpio_states[i] = GPIO_PIN_SET;
+    }
+    mock_gpio_apply(port, bsrr);
+}
+
+// Entrées: mêmes niveaux que HAL_GPIO_ReadPin (indexés par broche)
+uint16_t GpioPort_ReadIdr(GPIO_TypeDef* port) {
+    (void)port;
+    uint16_t idr = 0;
+    mock_state.gpio_port_read_count++;
+    for (int i = 0; i < 16; i++) {
+        if (mock_state.gpio_states[i] != GPIO_PIN_RESET) idr |= (uint16_t)(1U << i);
+    }
+    return idr;
 }
 
 HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, 
@@ -87,6 +171,31 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
     return mock_state.i2c_response;
 }
 
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    mock_state.i2c_call_count++;
+    mock_state.i2c_mem_address = MemAddress;
+    mock_state.i2c_mem_add_size = MemAddSize;
+    mock_state.i2c_last_size = Size;
+    if (pData && Size > 0) {
+        memcpy(mock_state.i2c_last_tx, pData, (Size < MOCK_I2C_TX_MAX) ? Size : MOCK_I2C_TX_MAX);
+    }
+    return mock_state.i2c_response;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    mock_state.i2c_call_count++;
+    mock_state.i2c_mem_address = MemAddress;
+    mock_state.i2c_mem_add_size = MemAddSize;
+    mock_state.i2c_last_size = Size;
+    if (mock_state.i2c_response == HAL_OK && pData && Size > 0) {
+        uint16_t copy_size = (Size < mock_state.i2c_data_size) ? Size : mock_state.i2c_data_size;
+        memcpy(pData, mock_state.i2c_data, copy_size);
+    }
+    return mock_state.i2c_response;
+}
+
 HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, 
                                     uint16_t Size, uint32_t Timeout) {
     mock_state.uart_call_count++;
@@ -98,6 +207,93 @@ HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData,
     return mock_state.uart_response;
 }
 
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size) {
+    mock_state.uart_call_count++;
+    if (mock_state.uart_response != HAL_OK) {
+        return mock_state.uart_response;
+    }
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    if (huart->hdmarx) {
+        huart->hdmarx->Instance->NDTR = Size;
+        huart->hdmarx->ErrorCode = HAL_DMA_ERROR_NONE;
+    }
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    mock_state.uart_rx_active = true;
+    mock_state.uart_rx_start_count++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart) {
+    huart->RxState = HAL_UART_STATE_READY;
+    mock_state.uart_rx_active = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size) {
+    mock_state.uart_call_count++;
+    if (mock_state.uart_response != HAL_OK) {
+        return mock_state.uart_response;
+    }
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pData == NULL || Size == 0U) {
+        return HAL_ERROR;
+    }
+    // Capture des octets émis (les données sont lues au démarrage du transfert)
+    uint32_t room = (uint32_t)sizeof(mock_state.uart_tx_data) - mock_state.uart_tx_len;
+    uint32_t copy = (Size < room) ? Size : room;
+    memcpy(&mock_state.uart_tx_data[mock_state.uart_tx_len], pData, copy);
+    mock_state.uart_tx_len += copy;
+    mock_state.uart_tx_start_count++;
+    if (huart->hdmatx) {
+        huart->hdmatx->ErrorCode = HAL_DMA_ERROR_NONE;
+    }
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart) {
+    // Arrêt bloquant TX + RX, sans callback (comme le HAL)
+    mock_state.uart_rx_active = false;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart) {
+    mock_state.uart_init_count++;
+    if (mock_state.uart_response != HAL_OK) {
+        return mock_state.uart_response;
+    }
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+// Callbacks faibles, comme dans le HAL (__weak)
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+    (void)huart;
+    (void)Size;
+}
+
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+static void mock_uart_rx_event(UART_HandleTypeDef *huart, uint16_t pos) {
+    // Réception close côté UART: le DMA écrit encore, sans événement
+    if (huart->RxState != HAL_UART_STATE_BUSY_RX) return;
+    mock_state.uart_rx_event_count++;
+    HAL_UARTEx_RxEventCallback(huart, pos);
+}
+
 uint32_t HAL_GetTick(void) {
     return mock_state.current_tick;
 }
@@ -112,6 +308,14 @@ void HAL_Delay(uint32_t Delay) {
 
 void Mock_HAL_Reset(void) {
     memset(&mock_state, 0, sizeof(mock_state));
+    huart1.gState = HAL_UART_STATE_READY;
+    huart2.gState = HAL_UART_STATE_READY;
+    huart1.RxState = HAL_UART_STATE_READY;
+    huart2.RxState = HAL_UART_STATE_READY;
+    hdma_usart1_rx.ErrorCode = HAL_DMA_ERROR_NONE;
+    hdma_usart1_tx.ErrorCode = HAL_DMA_ERROR_NONE;
+    huart1.Init.BaudRate = 115200;
+    huart2.Init.BaudRate = 115200;
     mock_state.i2c_response = HAL_OK;
     mock_state.uart_response = HAL_OK;
 }
@@ -145,6 +349,74 @@ void Mock_HAL_SetUARTResponse(HAL_StatusTypeDef status) {
     mock_state.uart_response = status;
 }
 
+void Mock_HAL_UART_FeedRx(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len) {
+    if (!huart || !huart->hdmarx || !data) return;
+    bool pending_idle = false;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (!mock_state.uart_rx_active || huart->RxXferSize == 0) {
+            mock_state.uart_rx_lost_count++;
+            continue;
+        }
+        uint16_t size = huart->RxXferSize;
+        uint16_t pos = (uint16_t)(size - huart->hdmarx->Instance->NDTR);
+        huart->pRxBuffPtr[pos] = data[i];
+        huart->hdmarx->Instance->NDTR--;
+        pending_idle = true;
+
+        if (huart->hdmarx->Instance->NDTR == size / 2U) {
+            // Half transfer
+            mock_uart_rx_event(huart, (uint16_t)(size / 2U));
+            pending_idle = false;
+        } else if (huart->hdmarx->Instance->NDTR == 0U) {
+            // Transfer complete: le DMA circulaire recharge NDTR
+            huart->hdmarx->Instance->NDTR = size;
+            mock_uart_rx_event(huart, size);
+            pending_idle = false;
+        }
+    }
+
+    // Ligne au repos après la rafale: événement IDLE
+    if (pending_idle && mock_state.uart_rx_active) {
+        uint16_t pos = (uint16_t)(huart->RxXferSize - huart->hdmarx->Instance->NDTR);
+        mock_uart_rx_event(huart, pos);
+    }
+}
+
+void Mock_HAL_UART_InjectError(UART_HandleTypeDef *huart, uint32_t errorCode) {
+    if (!huart) return;
+    // Comme HAL_UART_IRQHandler: une erreur bloquante stoppe la réception DMA
+    huart->ErrorCode |= errorCode;
+    if ((errorCode & HAL_UART_ERROR_DMA) && huart->hdmarx) {
+        huart->hdmarx->ErrorCode |= HAL_DMA_ERROR_TE;
+    }
+    huart->RxState = HAL_UART_STATE_READY;
+    mock_state.uart_rx_active = false;
+    HAL_UART_ErrorCallback(huart);
+}
+
+void Mock_HAL_UART_InjectTxDmaError(UART_HandleTypeDef *huart) {
+    if (!huart) return;
+    if (huart->hdmatx) {
+        huart->hdmatx->ErrorCode |= HAL_DMA_ERROR_TE;
+    }
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    huart->ErrorCode |= HAL_UART_ERROR_DMA;
+    HAL_UART_ErrorCallback(huart);
+}
+
+void Mock_HAL_UART_CompleteTx(UART_HandleTypeDef *huart) {
+    if (!huart || huart->gState != HAL_UART_STATE_BUSY_TX) return;
+    huart->gState = HAL_UART_STATE_READY;
+    HAL_UART_TxCpltCallback(huart);
+}
+
+const uint8_t* Mock_HAL_GetUARTTxData(uint32_t* len) {
+    if (len) *len = mock_state.uart_tx_len;
+    return mock_state.uart_tx_data;
+}
+
 // ============================================================================
 // VÉRIFICATIONS DES MOCKS
 // ============================================================================
@@ -153,6 +425,22 @@ uint32_t Mock_HAL_GetI2CCallCount(void) {
     return mock_state.i2c_call_count;
 }
 
+uint16_t Mock_HAL_GetI2CLastMemAddress(void) {
+    return mock_state.i2c_mem_address;
+}
+
+uint16_t Mock_HAL_GetI2CLastMemAddSize(void) {
+    return mock_state.i2c_mem_add_size;
+}
+
+uint16_t Mock_HAL_GetI2CLastSize(void) {
+    return mock_state.i2c_last_size;
+}
+
+const uint8_t* Mock_HAL_GetI2CLastTx(void) {
+    return mock_state.i2c_last_tx;
+}
+
 uint32_t Mock_HAL_GetUARTCallCount(void) {
     return mock_state.uart_call_count;
 }
@@ -165,4 +453,65 @@ uint32_t Mock_HAL_GetGPIOWriteCallCount(void) {
     return mock_state.gpio_write_count;
 }
 
+uint16_t Mock_HAL_GetGpioOutput(GPIO_TypeDef* port) {
+    int idx = mock_gpio_port_index(port);
+    return (idx < 0) ? 0 : mock_state.gpio_odr[idx];
+}
+
+void Mock_HAL_ClearGpioTrace(void) {
+    memcpy(mock_state.gpio_trace_start, mock_state.gpio_odr, sizeof(mock_state.gpio_trace_start));
+    mock_state.gpio_trace_len = 0;
+    mock_state.gpio_port_write_count = 0;
+    mock_state.gpio_port_read_count = 0;
+}
+
+uint8_t Mock_HAL_GetGpioTransitions(GPIO_TypeDef* port, uint16_t mask, uint16_t* values, uint8_t max) {
+    int idx = mock_gpio_port_index(port);
+    if (idx < 0 || values == NULL || max == 0) return 0;
+    uint8_t n = 0;
+    uint16_t last = (uint16_t)(mock_state.gpio_trace_start[idx] & mask);
+    values[n++] = last;
+    for (uint16_t i = 0; i < mock_state.gpio_trace_len && n < max; i++) {
+        if (mock_state.gpio_trace[i].port != idx) continue;
+        uint16_t v = (uint16_t)(mock_state.gpio_trace[i].odr & mask);
+        if (v != last) {
+            values[n++] = v;
+            last = v;
+        }
+    }
+    return n;
+}
+
+uint32_t Mock_HAL_GetGpioPortWriteCount(void) {
+    return mock_state.gpio_port_write_count;
+}
+
+uint32_t Mock_HAL_GetGpioPortReadCount(void) {
+    return mock_state.gpio_port_read_count;
+}
+
+uint32_t Mock_HAL_GetUARTRxEventCount(void) {
+    return mock_state.uart_rx_event_count;
+}
+
+uint32_t Mock_HAL_GetUARTRxStartCount(void) {
+    return mock_state.uart_rx_start_count;
+}
+
+uint32_t Mock_HAL_GetUARTRxLostCount(void) {
+    return mock_state.uart_rx_lost_count;
+}
+
+bool Mock_HAL_IsUARTRxActive(void) {
+    return mock_state.uart_rx_active;
+}
+
+uint32_t Mock_HAL_GetUARTTxStartCount(void) {
+    return mock_state.uart_tx_start_count;
+}
+
+uint32_t Mock_HAL_GetUARTInitCount(void) {
+    return mock_state.uart_init_count;
+}
+
 #endif // UNITY_NATIVE_TESTS
@@ -29,11 +29,64 @@ typedef struct {
     uint32_t dummy;
 } I2C_HandleTypeDef;
 
+// Instance USART mockée (identifie le lien, comme huart->Instance sur cible)
 typedef struct {
     uint32_t dummy;
+} USART_TypeDef;
+
+// Stream DMA mocké: NDTR = nombre d'octets restants avant wrap
+typedef struct {
+    volatile uint32_t NDTR;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+    DMA_Stream_TypeDef *Instance;
+    volatile uint32_t ErrorCode;    // Posé par HAL_DMA_IRQHandler avant XferErrorCallback
+} DMA_HandleTypeDef;
+
+#define HAL_DMA_ERROR_NONE  0x00000000U
+#define HAL_DMA_ERROR_TE    0x00000001U
+
+// États UART (valeurs identiques au HAL)
+typedef enum {
+    HAL_UART_STATE_RESET   = 0x00U,
+    HAL_UART_STATE_READY   = 0x20U,
+    HAL_UART_STATE_BUSY_TX = 0x21U,
+    HAL_UART_STATE_BUSY_RX = 0x22U
+} HAL_UART_StateTypeDef;
+
+typedef struct {
+    uint32_t BaudRate;
+} UART_InitTypeDef;
+
+typedef struct {
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmarx;
+    DMA_HandleTypeDef *hdmatx;
+    uint8_t *pRxBuffPtr;
+    uint16_t RxXferSize;
+    volatile uint32_t ErrorCode;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
 } UART_HandleTypeDef;
 
+// Codes d'erreur UART (valeurs identiques au HAL)
+#define HAL_UART_ERROR_NONE  0x00000000U
+#define HAL_UART_ERROR_PE    0x00000001U
+#define HAL_UART_ERROR_NE    0x00000002U
+#define HAL_UART_ERROR_FE    0x00000004U
+#define HAL_UART_ERROR_ORE   0x00000008U
+#define HAL_UART_ERROR_DMA   0x00000010U
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Instance->NDTR)
+
 // Variables mockées
+extern USART_TypeDef mock_usart1_instance;
+extern USART_TypeDef mock_usart2_instance;
+#define USART1 (&mock_usart1_instance)
+#define USART2 (&mock_usart2_instance)
+
 extern GPIO_TypeDef* GPIOA;
 extern GPIO_TypeDef* GPIOB;
 extern GPIO_TypeDef* GPIOC;
@@ -44,20 +97,43 @@ extern UART_HandleTypeDef huart2;
 // Pins mockées
 #define GPIO_PIN_0   (1 << 0)
 #define GPIO_PIN_1   (1 << 1)
+#define GPIO_PIN_2   (1 << 2)
+#define GPIO_PIN_3   (1 << 3)
+#define GPIO_PIN_4   (1 << 4)
 #define GPIO_PIN_5   (1 << 5)
+#define GPIO_PIN_6   (1 << 6)
+#define GPIO_PIN_7   (1 << 7)
 #define GPIO_PIN_8   (1 << 8)
 #define GPIO_PIN_9   (1 << 9)
 #define GPIO_PIN_10  (1 << 10)
+#define GPIO_PIN_11  (1 << 11)
+#define GPIO_PIN_12  (1 << 12)
 #define GPIO_PIN_13  (1 << 13)
+#define GPIO_PIN_14  (1 << 14)
 #define GPIO_PIN_15  (1 << 15)
 
+#define I2C_MEMADD_SIZE_8BIT   0x00000001U
+#define I2C_MEMADD_SIZE_16BIT  0x00000010U
+
 // Fonctions HAL mockées
 HAL_StatusTypeDef HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
 void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
 HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
 HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
 HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
 HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+
+// Callbacks HAL (définitions faibles dans mock_hal.c, surchargées par le code testé)
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
 
 // Fonction de temps mockée
 uint32_t HAL_GetTick(void);
@@ -70,11 +146,47 @@ void Mock_HAL_SetGpioPin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state);
 void Mock_HAL_SetI2CResponse(HAL_StatusTypeDef status, uint8_t* data, uint16_t size);
 void Mock_HAL_SetUARTResponse(HAL_StatusTypeDef status);
 
+// Simulation réception DMA circulaire + IDLE: écrit les octets dans le buffer
+// armé par HAL_UARTEx_ReceiveToIdle_DMA et déclenche les événements HT/TC/IDLE
+void Mock_HAL_UART_FeedRx(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len);
+// Simule une erreur matérielle (ORE, FE, ...) : arrête la réception et appelle HAL_UART_ErrorCallback
+void Mock_HAL_UART_InjectError(UART_HandleTypeDef *huart, uint32_t errorCode);
+// Erreur du flux DMA TX, comme UART_DMAError: fin du transfert TX, et fin de
+// la réception côté UART (RxState prêt, plus d'événements) alors que le flux
+// DMA RX continue d'écrire
+void Mock_HAL_UART_InjectTxDmaError(UART_HandleTypeDef *huart);
+// Termine le transfert DMA TX en cours et appelle HAL_UART_TxCpltCallback
+void Mock_HAL_UART_CompleteTx(UART_HandleTypeDef *huart);
+// Octets émis par HAL_UART_Transmit_DMA depuis le dernier reset (concaténés)
+const uint8_t* Mock_HAL_GetUARTTxData(uint32_t* len);
+
 // Vérifications des mocks
 uint32_t Mock_HAL_GetI2CCallCount(void);
+// Dernier accès registre (HAL_I2C_Mem_*): adresse de registre, taille
+// d'adresse, longueur, et octets écrits (Mem_Write, MOCK_I2C_TX_MAX au plus)
+#define MOCK_I2C_TX_MAX  32U
+uint16_t Mock_HAL_GetI2CLastMemAddress(void);
+uint16_t Mock_HAL_GetI2CLastMemAddSize(void);
+uint16_t Mock_HAL_GetI2CLastSize(void);
+const uint8_t* Mock_HAL_GetI2CLastTx(void);
 uint32_t Mock_HAL_GetUARTCallCount(void);
 uint32_t Mock_HAL_GetGpioWriteCount(void);
 uint32_t Mock_HAL_GetGPIOWriteCallCount(void);
+// Sorties GPIO par port (toutes écritures confondues) et transitions vues
+// sur les broches de mask depuis Mock_HAL_ClearGpioTrace: la valeur de départ
+// puis chaque changement; une commutation sans glitch en donne exactement deux
+uint16_t Mock_HAL_GetGpioOutput(GPIO_TypeDef* port);
+void Mock_HAL_ClearGpioTrace(void);
+uint8_t Mock_HAL_GetGpioTransitions(GPIO_TypeDef* port, uint16_t mask, uint16_t* values, uint8_t max);
+// Accès registre de gpio_port.h depuis Mock_HAL_ClearGpioTrace
+uint32_t Mock_HAL_GetGpioPortWriteCount(void);
+uint32_t Mock_HAL_GetGpioPortReadCount(void);
+uint32_t Mock_HAL_GetUARTRxEventCount(void);
+uint32_t Mock_HAL_GetUARTRxStartCount(void);
+uint32_t Mock_HAL_GetUARTRxLostCount(void);
+bool Mock_HAL_IsUARTRxActive(void);
+uint32_t Mock_HAL_GetUARTTxStartCount(void);
+uint32_t Mock_HAL_GetUARTInitCount(void);
 
 #endif // UNITY_NATIVE_TESTS
 
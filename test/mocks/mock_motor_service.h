@@ -10,7 +10,6 @@
 // Déclarations des fonctions du motor service
 void StartTaskMotorService(void *argument);
 void MotorService_StartDelivery(uint8_t channel);
-uint8_t MotorService_OrderToChannel(uint8_t orderCode);
 void MotorService_TestSweep(uint8_t firstChannel, uint8_t lastChannel, uint16_t onTimeMs);
 
 // Variables de test pour capturer l'état
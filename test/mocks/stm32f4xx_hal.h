@@ -0,0 +1,8 @@
+#ifndef MOCK_STM32F4XX_HAL_H
+#define MOCK_STM32F4XX_HAL_H
+
+// Redirection de l'en-tête HAL vers les mocks: permet de compiler les
+// sources réelles de Core/Src sur PC (tests natifs)
+#include "mock_hal.h"
+
+#endif // MOCK_STM32F4XX_HAL_H
@@ -0,0 +1,78 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "block_pool.h"
+
+#define TEST_BLOCK_SIZE  32
+#define TEST_BLOCKS      4
+
+static uint8_t storage[TEST_BLOCKS][TEST_BLOCK_SIZE];
+static BlockPool pool;
+
+void setUp(void) {
+    TEST_ASSERT_TRUE(BlockPool_Init(&pool, storage, TEST_BLOCK_SIZE, TEST_BLOCKS));
+}
+
+void tearDown(void) {
+}
+
+void test_block_pool_init_rejects_bad_sizes(void) {
+    BlockPool p;
+    TEST_ASSERT_FALSE(BlockPool_Init(&p, storage, TEST_BLOCK_SIZE, 0));
+    TEST_ASSERT_FALSE(BlockPool_Init(&p, storage, TEST_BLOCK_SIZE, BLOCK_POOL_MAX_BLOCKS + 1));
+    TEST_ASSERT_FALSE(BlockPool_Init(&p, storage, 0, 1));
+    TEST_ASSERT_TRUE(BlockPool_Init(&p, storage, 1, BLOCK_POOL_MAX_BLOCKS));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFFU, p.freeMask);
+}
+
+// Blocs distincts jusqu'à épuisement, puis refus compté
+void test_block_pool_alloc_until_empty(void) {
+    uint8_t h[TEST_BLOCKS];
+    for (uint8_t i = 0; i < TEST_BLOCKS; i++) {
+        h[i] = BlockPool_Alloc(&pool);
+        TEST_ASSERT_NOT_EQUAL(BLOCK_POOL_INVALID, h[i]);
+        TEST_ASSERT_EQUAL_PTR(storage[h[i]], BlockPool_Get(&pool, h[i]));
+    }
+    TEST_ASSERT_EQUAL_UINT8(BLOCK_POOL_INVALID, BlockPool_Alloc(&pool));
+    TEST_ASSERT_EQUAL_UINT32(1, pool.allocFailures);
+    TEST_ASSERT_EQUAL_UINT8(TEST_BLOCKS, pool.highWater);
+
+    TEST_ASSERT_TRUE(BlockPool_Free(&pool, h[2]));
+    TEST_ASSERT_EQUAL_UINT8(h[2], BlockPool_Alloc(&pool));
+}
+
+// Handle libre ou hors pool: ni accès ni double libération
+void test_block_pool_rejects_stale_handles(void) {
+    uint8_t h = BlockPool_Alloc(&pool);
+    strcpy((char*)BlockPool_Get(&pool, h), "ORD-1");
+
+    TEST_ASSERT_TRUE(BlockPool_Free(&pool, h));
+    TEST_ASSERT_FALSE(BlockPool_Free(&pool, h));
+    TEST_ASSERT_NULL(BlockPool_Get(&pool, h));
+    TEST_ASSERT_NULL(BlockPool_Get(&pool, TEST_BLOCKS));
+    TEST_ASSERT_FALSE(BlockPool_Free(&pool, BLOCK_POOL_INVALID));
+    TEST_ASSERT_EQUAL_UINT8(0, pool.inUse);
+}
+
+void test_block_pool_static_init(void) {
+    static uint8_t s[3][8];
+    static BlockPool sp = BLOCK_POOL_STATIC_INIT(s, 8, 3);
+
+    TEST_ASSERT_EQUAL_UINT8(0, BlockPool_Alloc(&sp));
+    TEST_ASSERT_EQUAL_UINT8(1, BlockPool_Alloc(&sp));
+    TEST_ASSERT_EQUAL_UINT8(2, BlockPool_Alloc(&sp));
+    TEST_ASSERT_EQUAL_UINT8(BLOCK_POOL_INVALID, BlockPool_Alloc(&sp));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_block_pool_init_rejects_bad_sizes);
+    RUN_TEST(test_block_pool_alloc_until_empty);
+    RUN_TEST(test_block_pool_rejects_stale_handles);
+    RUN_TEST(test_block_pool_static_init);
+
+    return UNITY_END();
+}
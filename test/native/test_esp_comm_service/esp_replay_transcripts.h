@@ -0,0 +1,85 @@
+#ifndef ESP_REPLAY_TRANSCRIPTS_H
+#define ESP_REPLAY_TRANSCRIPTS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Transcriptions octet par octet du lien ESP32 -> STM32 (USART1, 115200 bauds),
+// relevées à l'analyseur logique et ramenées à des enregistrements:
+//   gap_us  silence sur la ligne avant le premier octet de l'enregistrement
+//   data    octets émis dos à dos (un temps caractère chacun)
+// Un silence d'au moins un temps caractère déclenche l'IDLE côté STM32.
+
+typedef struct {
+    uint32_t gap_us;
+    const char* data;
+    uint16_t len;
+} EspReplayRecord;
+
+#define ESP_REPLAY_REC(gap, s) { (gap), (s), (uint16_t)(sizeof(s) - 1U) }
+
+typedef struct {
+    const char* name;
+    const EspReplayRecord* records;
+    size_t count;
+    uint32_t expectedEvents;      // Événements orchestrateur attendus par passage
+} EspReplayTranscript;
+
+// Session de vente complète. Serial.print côté ESP découpe les lignes en
+// plusieurs écritures (mot-clé, arguments, CRLF) séparées de quelques µs.
+static const EspReplayRecord esp_replay_session[] = {
+    ESP_REPLAY_REC(250000, "NFC_UID:"),
+    ESP_REPLAY_REC(    12, "04A1B2C3D4E5F6"),
+    ESP_REPLAY_REC(     9, "\r\n"),
+    ESP_REPLAY_REC(180000, "ORDER_START:"),
+    ESP_REPLAY_REC(    15, "ORD-2024-000123\r\n"),
+    ESP_REPLAY_REC(  2400, "VEND 1 2 PROD_COCA_33CL\r\n"),
+    ESP_REPLAY_REC(   350, "VEND 3 1 "),
+    ESP_REPLAY_REC(    20, "PROD_EAU_50CL\r\n"),
+    ESP_REPLAY_REC(   410, "VEND 4 1 PROD_CHIPS\r\n"),
+    ESP_REPLAY_REC(  1900, "ORDER_END\r\n"),
+    ESP_REPLAY_REC(900000, "NFC_UID:1A2B3C4D\r\n"),
+    ESP_REPLAY_REC( 60000, "NAK:PAYMENT:DENIED\r\n"),
+    ESP_REPLAY_REC(300000, "NFC_UID:1A2B3C4D\r\n"),
+    ESP_REPLAY_REC(150000, "ORDER_START:ORD-2024-000124\r\n"),
+    ESP_REPLAY_REC(  2100, "VEND 2 1 PROD_MARS\r\n"),
+    ESP_REPLAY_REC(  5000, "QR_TOKEN_NO_NETWORK\r\n"),
+};
+
+// Console de debug: un octet à la fois, 2 ms entre chaque (pire cas en nombre d'IDLE)
+static const EspReplayRecord esp_replay_slow[] = {
+    ESP_REPLAY_REC(2000, "N"), ESP_REPLAY_REC(2000, "F"), ESP_REPLAY_REC(2000, "C"),
+    ESP_REPLAY_REC(2000, "_"), ESP_REPLAY_REC(2000, "U"), ESP_REPLAY_REC(2000, "I"),
+    ESP_REPLAY_REC(2000, "D"), ESP_REPLAY_REC(2000, ":"), ESP_REPLAY_REC(2000, "9"),
+    ESP_REPLAY_REC(2000, "9"), ESP_REPLAY_REC(2000, "\r"), ESP_REPLAY_REC(2000, "\n"),
+    ESP_REPLAY_REC(2000, "N"), ESP_REPLAY_REC(2000, "F"), ESP_REPLAY_REC(2000, "C"),
+    ESP_REPLAY_REC(2000, "_"), ESP_REPLAY_REC(2000, "E"), ESP_REPLAY_REC(2000, "R"),
+    ESP_REPLAY_REC(2000, "R"), ESP_REPLAY_REC(2000, ":"), ESP_REPLAY_REC(2000, "T"),
+    ESP_REPLAY_REC(2000, "O"), ESP_REPLAY_REC(2000, "\n"),
+};
+
+// Redémarrage de l'ESP: bannière ROM à 74880 bauds vue à 115200 (octets
+// invalides), ligne de log, puis reprise du protocole
+static const EspReplayRecord esp_replay_reboot[] = {
+    ESP_REPLAY_REC(     0, "\xe0\x80\xf8\x1c\x8e\x00\x9c\xe3\x03\x8c\x7c\x80\xe0\x1c\x0c\xfc"),
+    ESP_REPLAY_REC(    40, "\x80\x83\x9c\xe0\xe3\x00\x0c\x8c\xf0\x1e\x80\x8c\x00\xfc\xe0\x03"),
+    ESP_REPLAY_REC(  3000, "\r\n"),
+    ESP_REPLAY_REC(120000, "[  1203][I][esp32-hal-misc.c:1427] loopTask(): "
+                           "Setup done, WiFi STA connecting to vending-ap, "
+                           "heap free 214532 bytes, psram 0, flash 4MB QIO 80MHz\r\n"),
+    ESP_REPLAY_REC(400000, "NFC_UID:CAFEBABE\r\n"),
+    ESP_REPLAY_REC(200000, "ORDER_START:ORD-2024-000125\r\n"),
+    ESP_REPLAY_REC(  2000, "VEND 1 1 PROD_COCA_33CL\r\n"),
+    ESP_REPLAY_REC(  2000, "ORDER_END\r\n"),
+};
+
+#define ESP_REPLAY_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static const EspReplayTranscript esp_replay_transcripts[] = {
+    // NFC, ORDER_START, 3 VEND, ORDER_END, NFC, DENIED, NFC, ORDER_START, VEND, ORDER_FAILED
+    { "session", esp_replay_session, ESP_REPLAY_COUNT(esp_replay_session), 12 },
+    { "slow",    esp_replay_slow,    ESP_REPLAY_COUNT(esp_replay_slow),    2 },
+    { "reboot",  esp_replay_reboot,  ESP_REPLAY_COUNT(esp_replay_reboot),  4 },
+};
+
+#endif // ESP_REPLAY_TRANSCRIPTS_H
@@ -0,0 +1,1164 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Le service réel est compilé directement contre les mocks HAL/FreeRTOS:
+// on teste la réception DMA circulaire + IDLE telle qu'elle tourne sur cible
+#include "../../../Core/Src/Services/esp_communication_service.c"
+#include "block_pool.h"
+#include "str_intern.h"
+
+// L'orchestrateur n'est pas lié: ses événements sont capturés dans une queue mock
+extern osMessageQueueId_t orchestratorEventQueueHandle;
+
+bool Orchestrator_PostEvent(const OrchestratorEvent* evt) {
+    return osMessageQueuePut(orchestratorEventQueueHandle, evt, 0, 0) == osOK;
+}
+
+// Charges utiles: mêmes pool et table d'internement que l'orchestrateur
+static char testOrderIds[4][ESP_PROTO_ID_MAX_LEN + 1];
+static BlockPool testOrderPool;
+static char testProductStorage[8][ESP_PROTO_ID_MAX_LEN + 1];
+static StrIntern testProducts;
+
+bool Orchestrator_PostOrderStart(const char* order_id) {
+    uint8_t id = BlockPool_Alloc(&testOrderPool);
+    if (id == BLOCK_POOL_INVALID) return false;
+    strcpy((char*)BlockPool_Get(&testOrderPool, id), order_id);
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_START, .data.order.id = id };
+    return Orchestrator_PostEvent(&evt);
+}
+
+bool Orchestrator_PostVendItem(uint8_t slot_number, uint8_t quantity, const char* product_id) {
+    OrchestratorEvent evt = { .type = ORCH_EVT_VEND_ITEM };
+    evt.data.vend.slot_number = slot_number;
+    evt.data.vend.quantity = quantity;
+    evt.data.vend.product = StrIntern_Intern(&testProducts, product_id);
+    return Orchestrator_PostEvent(&evt);
+}
+
+// Calibration moteur servie par DIAG:CAL: deux canaux suffisent
+bool MotorService_GetCalibration(uint8_t channel, MotorCalibRecord* out) {
+    if (channel >= 2) return false;
+    MotorCalib_Default(out, (uint16_t)(600 + 100 * channel), 20);
+    return true;
+}
+
+// Catalogue: seule la séquence BEGIN / ITEM / END est suivie ici, la
+// validation est couverte par test_product_catalog
+static bool catalogOpen;
+static uint8_t catalogItems;
+static uint8_t catalogCommits;
+static ProductEntry catalogLastItem;
+static const char* catalogSaveArrivals;     // Octets reçus pendant la sauvegarde
+
+uint8_t CatalogService_Begin(uint16_t version) {
+    (void)version;
+    catalogOpen = true;
+    catalogItems = 0;
+    return ESP_CODE_NONE;
+}
+
+uint8_t CatalogService_AddItem(const ProductEntry* entry) {
+    if (!catalogOpen) return ESP_CODE_CATALOG_FORMAT;
+    catalogLastItem = *entry;
+    catalogItems++;
+    return ESP_CODE_NONE;
+}
+
+uint8_t CatalogService_Commit(uint8_t count) {
+    bool open = catalogOpen;
+    catalogOpen = false;
+    if (!open) return ESP_CODE_CATALOG_FORMAT;
+    if (count != catalogItems) return ESP_CODE_CATALOG_INVALID;
+    if (catalogSaveArrivals != NULL) {
+        Mock_HAL_UART_FeedRx(&huart1, (const uint8_t*)catalogSaveArrivals,
+                             (uint16_t)strlen(catalogSaveArrivals));
+    }
+    catalogCommits++;
+    return ESP_CODE_NONE;
+}
+
+void CatalogService_Abort(void) {
+    catalogOpen = false;
+}
+
+static const char* event_order_id(const OrchestratorEvent* evt) {
+    return (const char*)BlockPool_Get(&testOrderPool, evt->data.order.id);
+}
+
+static void reset_esp_link_state(void) {
+    BlockPool_Init(&testOrderPool, testOrderIds, sizeof(testOrderIds[0]), 4);
+    StrIntern_Init(&testProducts, &testProductStorage[0][0], sizeof(testProductStorage[0]), 8);
+    rxDmaReadPos1 = 0;
+    lineLen1 = 0;
+    invalidCharCount = 0;
+    lastRxTimestamp = 0;
+    orderInProgress = false;
+    memset(lineBuf1, 0, sizeof(lineBuf1));
+    memset((void*)&linkStats1, 0, sizeof(linkStats1));
+    rxResyncPending = false;
+    RingBuffer_Init(&rxRing1, rxRingStorage1, sizeof(rxRingStorage1));
+    espTaskHandleLocal = xTaskGetCurrentTaskHandle();
+    for (uint8_t ch = 0; ch < ESP_CHANNEL_COUNT; ch++) {
+        txChan1[ch].ring.head = txChan1[ch].ring.tail = 0;
+        txChan1[ch].head = txChan1[ch].count = 0;
+    }
+    txInFlight1 = 0;
+    txInFlightCh1 = 0;
+    txResumeCh1 = -1;
+    channelsEnabled1 = false;
+    linkMode1 = ESP_LINK_MODE_TEXT;
+    rxAssemblyMode1 = ESP_LINK_MODE_TEXT;
+    EspHandshake_Init(&linkHs1);
+    linkLossWindowStart = 0;
+    linkLossErrorBase = 0;
+    seqEnabled1 = false;
+    EspSeq_RxReset(&seqRx1);
+    EspSeq_TxReset(&seqTx1);
+    stagedOrderBusy1 = false;
+}
+
+// Côté ISR uniquement: le DMA écrit, les callbacks remplissent le ring
+static void isr_feed_str(const char* s) {
+    Mock_HAL_UART_FeedRx(&huart1, (const uint8_t*)s, (uint16_t)strlen(s));
+}
+
+// Réception complète: ISR puis passage de la tâche ESP
+static void feed_str(const char* s) {
+    isr_feed_str(s);
+    if (ulTaskNotifyTake(pdTRUE, 0) > 0) {
+        EspComm_ProcessRx();
+    }
+}
+
+static bool pop_event(OrchestratorEvent* evt) {
+    return osMessageQueueGet(orchestratorEventQueueHandle, evt, NULL, 0) == osOK;
+}
+
+void setUp(void) {
+    Mock_HAL_Reset();
+    Mock_FreeRTOS_Reset();
+    reset_esp_link_state();
+    orchestratorEventQueueHandle = osMessageQueueNew(8, sizeof(OrchestratorEvent), NULL);
+    TEST_ASSERT_EQUAL(HAL_OK, EspComm_StartRx());
+}
+
+void tearDown(void) {
+}
+
+// Une ligne complète suivie d'un silence est livrée par l'événement IDLE
+void test_esp_link_line_delivered_on_idle(void) {
+    OrchestratorEvent evt;
+
+    feed_str("NFC_UID:12345678\r\n");
+
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, evt.type);
+    TEST_ASSERT_FALSE(pop_event(&evt));
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(18, stats.rxBytes);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxEvents);
+}
+
+// Une ligne coupée en plusieurs rafales est réassemblée
+void test_esp_link_line_split_across_bursts(void) {
+    OrchestratorEvent evt;
+
+    feed_str("ORDER_START:42\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_START, evt.type);
+
+    feed_str("VEND 2 ");
+    TEST_ASSERT_FALSE(pop_event(&evt));
+    feed_str("3 PROD_A");
+    TEST_ASSERT_FALSE(pop_event(&evt));
+    feed_str("\n");
+
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_VEND_ITEM, evt.type);
+    TEST_ASSERT_EQUAL_UINT8(2, evt.data.vend.slot_number);
+    TEST_ASSERT_EQUAL_UINT8(3, evt.data.vend.quantity);
+    TEST_ASSERT_EQUAL_STRING("PROD_A", StrIntern_Get(&testProducts, evt.data.vend.product));
+}
+
+// Le flux traverse le rebouclage du buffer circulaire sans perte
+void test_esp_link_wraps_around_dma_buffer(void) {
+    OrchestratorEvent evt;
+    char line[64];
+    uint32_t delivered = 0;
+
+    // 40 lignes de 18 octets = 720 octets, soit près de 3 tours de buffer
+    for (int i = 0; i < 40; i++) {
+        snprintf(line, sizeof(line), "NFC_UID:%08d\r\n", i);
+        feed_str(line);
+        while (pop_event(&evt)) {
+            TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, evt.type);
+            delivered++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(40, delivered);
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(40 * 18, stats.rxBytes);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.lineResets);
+}
+
+// Une rafale sans silence plus longue que le buffer est drainée par HT/TC
+void test_esp_link_long_burst_drained_by_half_and_full_transfer(void) {
+    OrchestratorEvent evt;
+    uint8_t burst[ESP_RX_DMA_BUFFER_SIZE + 54];
+    size_t n = 0;
+
+    while (n + 18 <= sizeof(burst)) {
+        memcpy(&burst[n], "NFC_UID:AABBCCDD\r\n", 18);
+        n += 18;
+    }
+    Mock_HAL_UART_FeedRx(&huart1, burst, (uint16_t)n);
+    EspComm_ProcessRx();
+
+    uint32_t delivered = 0;
+    while (pop_event(&evt)) delivered++;
+    // La queue de test contient 8 entrées: le reste est rejeté côté queue, pas côté UART
+    TEST_ASSERT_EQUAL_UINT32(8, delivered);
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(n, stats.rxBytes);
+    TEST_ASSERT_TRUE(stats.rxEvents >= 2);
+    TEST_ASSERT_EQUAL_UINT32(0, Mock_HAL_GetUARTRxLostCount());
+}
+
+// Un overrun est compté, la ligne partielle est jetée et la réception réarmée
+void test_esp_link_overrun_restarts_reception(void) {
+    OrchestratorEvent evt;
+
+    feed_str("NFC_UID:DEAD");
+    Mock_HAL_UART_InjectError(&huart1, HAL_UART_ERROR_ORE);
+    EspComm_ProcessRx();
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.overrunErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxRestarts);
+    TEST_ASSERT_TRUE(Mock_HAL_IsUARTRxActive());
+    TEST_ASSERT_EQUAL_UINT32(2, Mock_HAL_GetUARTRxStartCount());
+
+    // La suite du flux est de nouveau exploitable
+    feed_str("BEEF\r\nNFC_ERR:TIMEOUT\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_CANCEL, evt.type);
+    TEST_ASSERT_FALSE(pop_event(&evt));
+}
+
+// Chaque type d'erreur UART a son compteur
+void test_esp_link_error_counters(void) {
+    Mock_HAL_UART_InjectError(&huart1, HAL_UART_ERROR_FE);
+    Mock_HAL_UART_InjectError(&huart1, HAL_UART_ERROR_NE | HAL_UART_ERROR_PE);
+    Mock_HAL_UART_InjectError(&huart1, HAL_UART_ERROR_DMA);
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.overrunErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framingErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.noiseErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.parityErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.dmaErrors);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.rxRestarts);
+}
+
+// Le timeout inter-caractères abandonne la ligne partielle
+void test_esp_link_intercharacter_timeout_resets_line(void) {
+    OrchestratorEvent evt;
+
+    Mock_HAL_SetTick(100);
+    feed_str("NFC_UID:1234");
+    Mock_HAL_SetTick(100 + UART_TIMEOUT_MS + 1);
+    feed_str("NFC_ERR:X\r\n");
+
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_CANCEL, evt.type);
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.lineResets);
+}
+
+// Les événements d'une autre UART sont ignorés
+void test_esp_link_ignores_other_uart(void) {
+    HAL_UARTEx_RxEventCallback(&huart2, 10);
+    huart2.ErrorCode = HAL_UART_ERROR_ORE;
+    HAL_UART_ErrorCallback(&huart2);
+    huart2.ErrorCode = HAL_UART_ERROR_NONE;
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.rxEvents);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.overrunErrors);
+}
+
+// L'ISR ne fait que copier et notifier: aucun dispatch hors contexte tâche
+void test_esp_link_isr_only_queues_bytes_and_notifies(void) {
+    OrchestratorEvent evt;
+
+    isr_feed_str("NFC_UID:12345678\r\n");
+
+    TEST_ASSERT_FALSE(pop_event(&evt));
+    TEST_ASSERT_EQUAL_UINT16(18, RingBuffer_Count(&rxRing1));
+    TEST_ASSERT_EQUAL_UINT32(1, Mock_FreeRTOS_GetPendingNotifications());
+
+    EspComm_ProcessRx();
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, evt.type);
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Count(&rxRing1));
+}
+
+// Plusieurs réveils accumulés sont traités en un seul passage
+void test_esp_link_multiple_events_single_task_pass(void) {
+    OrchestratorEvent evt;
+
+    isr_feed_str("NFC_UID:1\r\n");
+    isr_feed_str("NFC_ERR:2\r\n");
+    isr_feed_str("NFC_UID:3\r\n");
+    TEST_ASSERT_EQUAL_UINT32(3, ulTaskNotifyTake(pdTRUE, 0));
+
+    EspComm_ProcessRx();
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, evt.type);
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_CANCEL, evt.type);
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, evt.type);
+}
+
+// Une erreur n'abandonne que la ligne en cours, pas les lignes déjà reçues
+void test_esp_link_error_resync_keeps_earlier_lines(void) {
+    OrchestratorEvent evt;
+
+    isr_feed_str("NFC_UID:1\r\nNFC_ERR:PART");
+    Mock_HAL_UART_InjectError(&huart1, HAL_UART_ERROR_FE);
+    isr_feed_str("IAL\r\nNFC_ERR:OK\r\n");
+    EspComm_ProcessRx();
+
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, evt.type);
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_CANCEL, evt.type);
+    TEST_ASSERT_FALSE(pop_event(&evt));
+    TEST_ASSERT_FALSE(rxResyncPending);
+}
+
+// Ring plein (tâche bloquée): les octets en excès sont comptés, pas écrasés
+void test_esp_link_ring_full_counts_dropped_bytes(void) {
+    uint8_t burst[ESP_RX_DMA_BUFFER_SIZE / 2];
+    memset(burst, 'A', sizeof(burst));
+
+    for (int i = 0; i < 5; i++) {
+        Mock_HAL_UART_FeedRx(&huart1, burst, sizeof(burst));
+    }
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(5 * sizeof(burst), stats.rxBytes);
+    TEST_ASSERT_EQUAL_UINT32(5 * sizeof(burst) - ESP_RX_RING_SIZE, stats.rxDropped);
+    TEST_ASSERT_EQUAL_UINT16(ESP_RX_RING_SIZE, RingBuffer_Count(&rxRing1));
+}
+
+// Contenu émis jusqu'ici, sous forme de chaîne
+static const char* tx_str(void) {
+    static char out[2049];
+    uint32_t len;
+    const uint8_t* data = Mock_HAL_GetUARTTxData(&len);
+    memcpy(out, data, len);
+    out[len] = '\0';
+    return out;
+}
+
+// Simule la fin successive de tous les transferts DMA TX
+static void complete_all_tx(void) {
+    while (huart1.gState == HAL_UART_STATE_BUSY_TX) {
+        Mock_HAL_UART_CompleteTx(&huart1);
+    }
+}
+
+// La ligne et son CRLF partent en un seul transfert DMA, sans attente
+void test_esp_tx_line_and_crlf_single_dma_transfer(void) {
+    TEST_ASSERT_TRUE(EspComm_SendLine("DELIVERY_COMPLETED"));
+
+    TEST_ASSERT_EQUAL_UINT32(1, Mock_HAL_GetUARTTxStartCount());
+    TEST_ASSERT_EQUAL_STRING("DELIVERY_COMPLETED\r\n", tx_str());
+    TEST_ASSERT_EQUAL(HAL_UART_STATE_BUSY_TX, huart1.gState);
+
+    complete_all_tx();
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.txLines);
+    TEST_ASSERT_EQUAL_UINT32(20, stats.txBytes);
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Count(&txChan1[ESP_CHANNEL_CONTROL].ring));
+}
+
+// Les lignes mises en file pendant un transfert sont enchaînées par TxCplt
+void test_esp_tx_lines_queued_while_busy_are_chained(void) {
+    TEST_ASSERT_TRUE(EspComm_SendLine("VEND_COMPLETED:1"));
+    TEST_ASSERT_TRUE(EspComm_SendLine("VEND_COMPLETED:2"));
+    TEST_ASSERT_TRUE(EspComm_SendLine("DELIVERY_COMPLETED"));
+    TEST_ASSERT_EQUAL_UINT32(1, Mock_HAL_GetUARTTxStartCount());
+
+    // Les deux lignes en attente partent ensemble au TxCplt suivant
+    Mock_HAL_UART_CompleteTx(&huart1);
+    TEST_ASSERT_EQUAL_UINT32(2, Mock_HAL_GetUARTTxStartCount());
+    complete_all_tx();
+
+    TEST_ASSERT_EQUAL_STRING("VEND_COMPLETED:1\r\nVEND_COMPLETED:2\r\nDELIVERY_COMPLETED\r\n", tx_str());
+    TEST_ASSERT_EQUAL(HAL_UART_STATE_READY, huart1.gState);
+}
+
+// Le rebouclage du ring produit deux transferts contigus sans corrompre le flux
+void test_esp_tx_ring_wrap_split_in_two_transfers(void) {
+    char line[101];
+    memset(line, 'X', 100);
+    line[100] = '\0';
+
+    // 10 lignes de 102 octets: 1020 octets, puis une ligne qui reboucle
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(EspComm_SendLine(line));
+        complete_all_tx();
+    }
+    uint32_t startsBefore = Mock_HAL_GetUARTTxStartCount();
+
+    TEST_ASSERT_TRUE(EspComm_SendLine("WRAP_LINE"));
+    complete_all_tx();
+
+    TEST_ASSERT_EQUAL_UINT32(startsBefore + 2, Mock_HAL_GetUARTTxStartCount());
+    uint32_t len;
+    const uint8_t* data = Mock_HAL_GetUARTTxData(&len);
+    TEST_ASSERT_EQUAL_UINT32(10 * 102 + 11, len);
+    TEST_ASSERT_EQUAL_MEMORY("WRAP_LINE\r\n", &data[10 * 102], 11);
+}
+
+// File pleine: contre-pression signalée, ligne entière refusée, compteurs à jour
+void test_esp_tx_backpressure_when_full(void) {
+    char line[101];
+    memset(line, 'Y', 100);
+    line[100] = '\0';
+
+    int accepted = 0;
+    while (EspComm_SendLine(line)) accepted++;
+    TEST_ASSERT_EQUAL_INT(ESP_TX_RING_SIZE / 102, accepted);
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.txDropped);
+    TEST_ASSERT_EQUAL_UINT16(accepted * 102, stats.txHighWater);
+    // Aucune ligne partielle en file
+    TEST_ASSERT_EQUAL_UINT16(accepted * 102, RingBuffer_Count(&txChan1[ESP_CHANNEL_CONTROL].ring));
+
+    // Le DMA libère de la place: l'émission redevient possible
+    complete_all_tx();
+    TEST_ASSERT_TRUE(EspComm_SendLine("OK"));
+}
+
+// Lignes invalides refusées avant toute mise en file
+void test_esp_tx_rejects_invalid_lines(void) {
+    char tooLong[UART_BUFFER_SIZE + 1];
+    memset(tooLong, 'Z', UART_BUFFER_SIZE);
+    tooLong[UART_BUFFER_SIZE] = '\0';
+
+    TEST_ASSERT_FALSE(EspComm_SendLine(NULL));
+    TEST_ASSERT_FALSE(EspComm_SendLine(""));
+    TEST_ASSERT_FALSE(EspComm_SendLine("BAD\x01CHAR"));
+    TEST_ASSERT_FALSE(EspComm_SendLine(tooLong));
+    TEST_ASSERT_EQUAL_UINT32(0, Mock_HAL_GetUARTTxStartCount());
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Count(&txChan1[ESP_CHANNEL_CONTROL].ring));
+}
+
+// Une erreur DMA TX abandonne le bloc en cours et relance la file
+void test_esp_tx_dma_error_recovers(void) {
+    TEST_ASSERT_TRUE(EspComm_SendLine("FIRST"));
+    TEST_ASSERT_TRUE(EspComm_SendLine("SECOND"));
+
+    Mock_HAL_UART_InjectTxDmaError(&huart1);
+    complete_all_tx();
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.txErrors);
+    TEST_ASSERT_EQUAL_STRING("FIRST\r\nSECOND\r\n", tx_str());
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Count(&txChan1[ESP_CHANNEL_CONTROL].ring));
+}
+
+// Une erreur DMA TX ne touche pas à la réception: la ligne en cours de
+// réception est conservée, aucun redémarrage RX compté
+void test_esp_tx_dma_error_keeps_rx_line(void) {
+    OrchestratorEvent evt;
+
+    feed_str("NFC_ERR:TIME");
+    TEST_ASSERT_TRUE(EspComm_SendLine("FIRST"));
+    Mock_HAL_UART_InjectTxDmaError(&huart1);
+    EspComm_ProcessRx();
+    feed_str("OUT\r\n");
+
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_CANCEL, evt.type);
+    TEST_ASSERT_FALSE(pop_event(&evt));
+    TEST_ASSERT_TRUE(Mock_HAL_IsUARTRxActive());
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.txErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.dmaErrors);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.rxRestarts);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.lineResets);
+}
+
+// Ligne longue de télémétrie découpée: le contrôle passe après le morceau en cours
+void test_esp_tx_control_preempts_chunked_telemetry(void) {
+    char bulk[151];
+    memset(bulk, 'T', 150);
+    bulk[150] = '\0';
+    channelsEnabled1 = true;
+
+    TEST_ASSERT_TRUE(EspComm_SendLineOn(ESP_CHANNEL_TELEMETRY, bulk));
+    TEST_ASSERT_TRUE(EspComm_SendLine("VEND_COMPLETED:1"));
+    complete_all_tx();
+
+    // 150 = 64 + 64 + 22, un transfert DMA par morceau
+    char expected[256];
+    snprintf(expected, sizeof(expected), "%%1+:%.64s\r\nVEND_COMPLETED:1\r\n%%1+:%.64s\r\n%%1.:%.22s\r\n",
+             bulk, bulk, bulk);
+    TEST_ASSERT_EQUAL_STRING(expected, tx_str());
+    TEST_ASSERT_EQUAL_UINT32(4, Mock_HAL_GetUARTTxStartCount());
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.txLines);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.txChunks);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.txPreemptions);
+}
+
+// ESP sans canaux: lignes entières, priorité appliquée entre deux messages
+void test_esp_tx_priority_at_message_boundary_without_channels(void) {
+    char bulk[201];
+    memset(bulk, 'S', 200);
+    bulk[200] = '\0';
+
+    TEST_ASSERT_FALSE(EspComm_SendLine(bulk));
+    TEST_ASSERT_TRUE(EspComm_SendLineOn(ESP_CHANNEL_TELEMETRY, bulk));
+    TEST_ASSERT_TRUE(EspComm_SendLineOn(ESP_CHANNEL_DIAG, "DIAG:1"));
+    TEST_ASSERT_TRUE(EspComm_SendLineOn(ESP_CHANNEL_TELEMETRY, "TELEM:2"));
+    TEST_ASSERT_TRUE(EspComm_SendLine("VEND_COMPLETED:2"));
+    complete_all_tx();
+
+    char expected[256];
+    snprintf(expected, sizeof(expected), "%s\r\nVEND_COMPLETED:2\r\nTELEM:2\r\nDIAG:1\r\n", bulk);
+    TEST_ASSERT_EQUAL_STRING(expected, tx_str());
+    for (uint8_t ch = 0; ch < ESP_CHANNEL_COUNT; ch++) {
+        TEST_ASSERT_EQUAL_UINT8(0, txChan1[ch].count);
+    }
+}
+
+// Trame binaire encodée côté ESP puis reçue par DMA
+static void feed_command_frame(const EspCommand* cmd) {
+    uint8_t frame[ESP_FRAME_MAX_ENCODED];
+    size_t n = EspFrame_EncodeCommand(cmd, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(n > 0);
+    Mock_HAL_UART_FeedRx(&huart1, frame, (uint16_t)n);
+    if (ulTaskNotifyTake(pdTRUE, 0) > 0) {
+        EspComm_ProcessRx();
+    }
+}
+
+// Mode binaire: ORDER_START + VEND en trames, ACK renvoyé en trame
+void test_esp_link_binary_frames_dispatched(void) {
+    OrchestratorEvent evt;
+    EspComm_SetLinkMode(ESP_LINK_MODE_BINARY);
+
+    EspCommand start = { .type = ESP_MSG_ORDER_START, .valid = true };
+    strcpy(start.order_id, "ORD42");
+    feed_command_frame(&start);
+
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_START, evt.type);
+    TEST_ASSERT_EQUAL_STRING("ORD42", event_order_id(&evt));
+
+    // Réponse ORDER_ACK: une trame complète, décodable par l'ESP
+    uint32_t len;
+    const uint8_t* tx = Mock_HAL_GetUARTTxData(&len);
+    TEST_ASSERT_TRUE(len > 1);
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_DELIMITER, tx[len - 1]);
+    uint8_t work[ESP_FRAME_MAX_RAW];
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(tx, len - 1, work, sizeof(work), &type, &payload, &payloadLen));
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_ORDER_ACK, type);
+
+    EspCommand vend = { .type = ESP_MSG_VEND_COMMAND, .valid = true, .slot_number = 2, .quantity = 1 };
+    strcpy(vend.product_id, "CHIPS");
+    feed_command_frame(&vend);
+
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_VEND_ITEM, evt.type);
+    TEST_ASSERT_EQUAL_UINT8(2, evt.data.vend.slot_number);
+    TEST_ASSERT_EQUAL_STRING("CHIPS", StrIntern_Get(&testProducts, evt.data.vend.product));
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.rxFrames);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.crcErrors);
+}
+
+// Trame corrompue: rejetée et comptée, la suivante passe
+void test_esp_link_binary_corrupted_frame_counted(void) {
+    OrchestratorEvent evt;
+    EspComm_SetLinkMode(ESP_LINK_MODE_BINARY);
+
+    EspCommand cmd = { .type = ESP_MSG_NFC_UID, .valid = true };
+    uint8_t frame[ESP_FRAME_MAX_ENCODED];
+    size_t n = EspFrame_EncodeCommand(&cmd, frame, sizeof(frame));
+    frame[1] ^= 0x40;
+    Mock_HAL_UART_FeedRx(&huart1, frame, (uint16_t)n);
+    if (ulTaskNotifyTake(pdTRUE, 0) > 0) {
+        EspComm_ProcessRx();
+    }
+    TEST_ASSERT_FALSE(pop_event(&evt));
+
+    feed_command_frame(&cmd);
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, evt.type);
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.crcErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxFrames);
+}
+
+// Réponses typées: chaînes historiques en texte, lignes brutes refusées en binaire
+void test_esp_link_response_follows_link_mode(void) {
+    EspResponse rsp = { .type = ESP_RSP_VEND_COMPLETED, .slot = 3 };
+    TEST_ASSERT_TRUE(EspComm_SendResponse(&rsp));
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("VEND_COMPLETED:3\r\n", tx_str());
+
+    EspComm_SetLinkMode(ESP_LINK_MODE_BINARY);
+    TEST_ASSERT_FALSE(EspComm_SendLine("STATE:PAYING"));
+    TEST_ASSERT_TRUE(EspComm_SendResponse(&rsp));
+    complete_all_tx();
+
+    uint32_t len;
+    const uint8_t* tx = Mock_HAL_GetUARTTxData(&len);
+    const uint32_t textLen = (uint32_t)strlen("VEND_COMPLETED:3\r\n");
+    uint8_t work[ESP_FRAME_MAX_RAW];
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(tx + textLen, len - textLen - 1, work, sizeof(work),
+                                                    &type, &payload, &payloadLen));
+    EspResponse out;
+    TEST_ASSERT_TRUE(EspFrame_ToResponse(type, payload, payloadLen, &out));
+    TEST_ASSERT_EQUAL(ESP_RSP_VEND_COMPLETED, out.type);
+    TEST_ASSERT_EQUAL_UINT8(3, out.slot);
+}
+
+// Négociation complète à travers le service: BAUD puis réinit de USART1
+void test_esp_link_handshake_upgrades_uart(void) {
+    Mock_HAL_SetTick(0);
+    EspComm_StartHandshake(0);
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("HELLO:1:15:921600\r\n", tx_str());
+
+    feed_str("HELLO_ACK:1:3:921600\r\n");
+    // BAUD parti à l'ancien débit avant la réinitialisation
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_UINT32(921600, huart1.Init.BaudRate);
+    TEST_ASSERT_EQUAL_UINT32(1, Mock_HAL_GetUARTInitCount());
+    TEST_ASSERT_TRUE(Mock_HAL_IsUARTRxActive());
+
+    EspComm_PollLink(0);
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("HELLO:1:15:921600\r\nBAUD:921600\r\nSYNC:" ESP_HS_SYNC_PATTERN "\r\n", tx_str());
+
+    feed_str("SYNC_ACK:" ESP_HS_SYNC_PATTERN "\r\n");
+    TEST_ASSERT_EQUAL(ESP_LINK_MODE_BINARY, EspComm_GetLinkMode());
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(921600, stats.baudRate);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.handshakes);
+    TEST_ASSERT_EQUAL_UINT8(ESP_CAP_BINARY_FRAMES | ESP_CAP_BAUD_UPGRADE, stats.linkCaps);
+}
+
+// Rafale d'erreurs au débit rapide: retour à 115200, texte, nouvelle négociation
+void test_esp_link_loss_renegotiates(void) {
+    Mock_HAL_SetTick(0);
+    EspComm_StartHandshake(0);
+    feed_str("HELLO_ACK:1:3:921600\r\n");
+    EspComm_PollLink(0);
+    feed_str("SYNC_ACK:" ESP_HS_SYNC_PATTERN "\r\n");
+    complete_all_tx();
+    TEST_ASSERT_EQUAL(ESP_LINK_MODE_BINARY, EspComm_GetLinkMode());
+
+    for (int i = 0; i < ESP_LINK_LOSS_ERRORS; i++) {
+        Mock_HAL_UART_InjectError(&huart1, HAL_UART_ERROR_FE);
+    }
+    EspComm_PollLink(100);
+
+    TEST_ASSERT_EQUAL(ESP_LINK_MODE_TEXT, EspComm_GetLinkMode());
+    TEST_ASSERT_EQUAL_UINT32(115200, huart1.Init.BaudRate);
+    TEST_ASSERT_EQUAL(ESP_HS_HELLO_SENT, linkHs1.state);
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.linkLosses);
+}
+
+// VEND numérotés en rafale, un perdu: NAK unique, livraison dans l'ordre après retransmission
+void test_esp_link_sequenced_vend_pipeline(void) {
+    OrchestratorEvent evt;
+    seqEnabled1 = true;
+
+    feed_str("#0:ORDER_START:ORD7\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_START, evt.type);
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("#0:ORDER_ACK\r\n#ACK:0\r\n", tx_str());
+
+    // #1 perdu: #2 et #3 gardés, un seul NAK pour le trou
+    feed_str("#2:VEND 2 1 B\r\n#3:VEND 3 1 C\r\n");
+    TEST_ASSERT_FALSE(pop_event(&evt));
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("#0:ORDER_ACK\r\n#ACK:0\r\n#NAK:1\r\n", tx_str());
+
+    feed_str("#1:VEND 1 1 A\r\n");
+    for (uint8_t slot = 1; slot <= 3; slot++) {
+        TEST_ASSERT_TRUE(pop_event(&evt));
+        TEST_ASSERT_EQUAL(ORCH_EVT_VEND_ITEM, evt.type);
+        TEST_ASSERT_EQUAL_UINT8(slot, evt.data.vend.slot_number);
+    }
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("#0:ORDER_ACK\r\n#ACK:0\r\n#NAK:1\r\n#ACK:3\r\n", tx_str());
+
+    // Doublon (notre acquit perdu): ré-acquitté, pas relivré
+    feed_str("#3:VEND 3 1 C\r\n");
+    TEST_ASSERT_FALSE(pop_event(&evt));
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.seqGaps);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.seqDuplicates);
+}
+
+// Réponses numérotées: libérées par l'acquit, renvoyées sur NAK et au timeout
+void test_esp_link_sequenced_response_retransmit(void) {
+    seqEnabled1 = true;
+    Mock_HAL_SetTick(0);
+
+    EspResponse rsp = { .type = ESP_RSP_VEND_COMPLETED, .slot = 1 };
+    TEST_ASSERT_TRUE(EspComm_SendResponse(&rsp));
+    rsp.slot = 2;
+    TEST_ASSERT_TRUE(EspComm_SendResponse(&rsp));
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("#0:VEND_COMPLETED:1\r\n#1:VEND_COMPLETED:2\r\n", tx_str());
+
+    feed_str("#ACK:0\r\n#NAK:1\r\n");
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("#0:VEND_COMPLETED:1\r\n#1:VEND_COMPLETED:2\r\n#1:VEND_COMPLETED:2\r\n", tx_str());
+    TEST_ASSERT_EQUAL_UINT8(1, EspSeq_TxInFlight(&seqTx1));
+
+    EspComm_PollLink(ESP_SEQ_RTO_MS);
+    complete_all_tx();
+    uint32_t len;
+    Mock_HAL_GetUARTTxData(&len);
+    // #0 puis trois fois #1 (envoi, NAK, timeout)
+    TEST_ASSERT_EQUAL_UINT32(4 * strlen("#1:VEND_COMPLETED:2\r\n"), len);
+
+    feed_str("#ACK:1\r\n");
+    TEST_ASSERT_EQUAL_UINT8(0, EspSeq_TxInFlight(&seqTx1));
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.seqRetransmits);
+}
+
+// Mode binaire: enveloppe ESP_FRAME_SEQ et acquit en trame
+void test_esp_link_sequenced_binary_frame(void) {
+    OrchestratorEvent evt;
+    seqEnabled1 = true;
+    EspComm_SetLinkMode(ESP_LINK_MODE_BINARY);
+
+    EspCommand cmd = { .type = ESP_MSG_NFC_UID, .valid = true };
+    uint8_t frame[ESP_FRAME_MAX_ENCODED];
+    size_t n = EspFrame_EncodeCommandSeq(&cmd, 0, frame, sizeof(frame));
+    Mock_HAL_UART_FeedRx(&huart1, frame, (uint16_t)n);
+    if (ulTaskNotifyTake(pdTRUE, 0) > 0) {
+        EspComm_ProcessRx();
+    }
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, evt.type);
+
+    uint32_t len;
+    const uint8_t* out = Mock_HAL_GetUARTTxData(&len);
+    uint8_t work[ESP_FRAME_MAX_RAW];
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(out, len - 1, work, sizeof(work), &type, &payload, &payloadLen));
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_SEQ_ACK, type);
+    TEST_ASSERT_EQUAL(1, payloadLen);
+    TEST_ASSERT_EQUAL_UINT8(0, payload[0]);
+}
+
+// Commande groupée: un seul événement, descripteur réservé jusqu'à sa libération
+void test_esp_link_order_batch_single_event(void) {
+    OrchestratorEvent evt;
+
+    feed_str("ORDER:Q42;1,2,COLA;3,1,CHIPS;4,1,WATER\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_BATCH, evt.type);
+    const EspOrder* order = evt.data.batch.order;
+    TEST_ASSERT_FALSE(pop_event(&evt));
+    TEST_ASSERT_EQUAL_STRING("Q42", order->order_id);
+    TEST_ASSERT_EQUAL_UINT8(3, order->item_count);
+    TEST_ASSERT_EQUAL_STRING("WATER", order->items[2].product_id);
+
+    // Descripteur encore utilisé: commande suivante refusée
+    feed_str("ORDER:Q43;1,1,COLA\r\n");
+    TEST_ASSERT_FALSE(pop_event(&evt));
+
+    EspComm_ReleaseOrder(order);
+    feed_str("ORDER:Q44;9,1,COLA\r\n");
+    TEST_ASSERT_FALSE(pop_event(&evt));
+    feed_str("ORDER:Q45;2,1,COLA\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL_STRING("Q45", evt.data.batch.order->order_id);
+
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("ORDER_ACK\r\nORDER_NAK:ORDER_BUSY\r\n"
+                             "ORDER_NAK:INVALID_ORDER_FORMAT\r\nORDER_ACK\r\n", tx_str());
+}
+
+// ORDER numérotée renvoyée (notre acquit perdu): ré-acquittée sans réserver
+// le descripteur, la commande suivante est acceptée
+void test_esp_link_sequenced_order_duplicate_keeps_descriptor(void) {
+    OrchestratorEvent evt;
+    seqEnabled1 = true;
+
+    feed_str("#0:ORDER:Q50;1,1,COLA\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_BATCH, evt.type);
+    EspComm_ReleaseOrder(evt.data.batch.order);     // Livraison terminée
+
+    // #ACK:0 perdu côté ESP: même commande renvoyée
+    feed_str("#0:ORDER:Q50;1,1,COLA\r\n");
+    TEST_ASSERT_FALSE(pop_event(&evt));
+
+    feed_str("#1:ORDER:Q51;2,1,CHIPS\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_BATCH, evt.type);
+    TEST_ASSERT_EQUAL_STRING("Q51", evt.data.batch.order->order_id);
+
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("#0:ORDER_ACK\r\n#ACK:0\r\n#ACK:0\r\n"
+                             "#1:ORDER_ACK\r\n#ACK:1\r\n", tx_str());
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.seqDuplicates);
+}
+
+// ORDER en avance d'un trou ou hors fenêtre: ni gardée ni réservée; livrée
+// quand l'ESP la renvoie dans l'ordre
+void test_esp_link_sequenced_order_ahead_not_held(void) {
+    OrchestratorEvent evt;
+    seqEnabled1 = true;
+
+    feed_str("#1:ORDER:Q60;1,1,COLA\r\n");
+    feed_str("#100:ORDER:Q61;1,1,COLA\r\n");
+    TEST_ASSERT_FALSE(pop_event(&evt));
+
+    feed_str("#0:NFC_ERR:TIMEOUT\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_CANCEL, evt.type);
+    TEST_ASSERT_FALSE(pop_event(&evt));     // #1 non gardée
+
+    feed_str("#1:ORDER:Q60;1,1,COLA\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_BATCH, evt.type);
+    TEST_ASSERT_EQUAL_STRING("Q60", evt.data.batch.order->order_id);
+
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("#NAK:0\r\n#NAK:0\r\n#ACK:0\r\n"
+                             "#0:ORDER_ACK\r\n#ACK:1\r\n", tx_str());
+}
+
+// Commande groupée en trame binaire
+void test_esp_link_order_batch_binary(void) {
+    OrchestratorEvent evt;
+    EspComm_SetLinkMode(ESP_LINK_MODE_BINARY);
+
+    EspOrder in = { .order_id = "B7", .item_count = 2,
+                    .items = { { 2, 3, "TEA" }, { 1, 1, "COLA" } } };
+    uint8_t frame[ESP_FRAME_MAX_ENCODED];
+    size_t n = EspFrame_EncodeOrder(&in, frame, sizeof(frame));
+    Mock_HAL_UART_FeedRx(&huart1, frame, (uint16_t)n);
+    if (ulTaskNotifyTake(pdTRUE, 0) > 0) {
+        EspComm_ProcessRx();
+    }
+
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_BATCH, evt.type);
+    TEST_ASSERT_EQUAL_UINT8(2, evt.data.batch.order->item_count);
+    TEST_ASSERT_EQUAL_UINT8(3, evt.data.batch.order->items[0].quantity);
+}
+
+// Plus grande commande groupée: 8 articles, identifiants de 31 caractères
+static void make_max_order(EspOrder* order) {
+    memset(order, 0, sizeof(*order));
+    order->item_count = ESP_PROTO_ORDER_MAX_ITEMS;
+    memset(order->order_id, 'O', ESP_PROTO_ID_MAX_LEN);
+    for (uint8_t i = 0; i < ESP_PROTO_ORDER_MAX_ITEMS; i++) {
+        order->items[i].slot_number = (uint8_t)(1 + i % ESP_PROTO_SLOT_MAX);
+        order->items[i].quantity = ESP_PROTO_QTY_MAX;
+        memset(order->items[i].product_id, 'a' + i, ESP_PROTO_ID_MAX_LEN);
+    }
+}
+
+static void assert_max_order(const EspOrder* order) {
+    EspOrder expected;
+    make_max_order(&expected);
+    TEST_ASSERT_EQUAL_STRING(expected.order_id, order->order_id);
+    TEST_ASSERT_EQUAL_UINT8(ESP_PROTO_ORDER_MAX_ITEMS, order->item_count);
+    for (uint8_t i = 0; i < ESP_PROTO_ORDER_MAX_ITEMS; i++) {
+        TEST_ASSERT_EQUAL_UINT8(expected.items[i].slot_number, order->items[i].slot_number);
+        TEST_ASSERT_EQUAL_UINT8(ESP_PROTO_QTY_MAX, order->items[i].quantity);
+        TEST_ASSERT_EQUAL_STRING(expected.items[i].product_id, order->items[i].product_id);
+    }
+}
+
+// Ligne ORDER numérotée de taille maximale: reçue entière, sans remise à zéro
+void test_esp_link_order_batch_max_text(void) {
+    OrchestratorEvent evt;
+    EspOrder order;
+    make_max_order(&order);
+    seqEnabled1 = true;
+
+    char line[ESP_RX_LINE_MAX + 3];
+    int len = snprintf(line, sizeof(line), "#255:ORDER:%s", order.order_id);
+    for (uint8_t i = 0; i < order.item_count; i++) {
+        len += snprintf(line + len, sizeof(line) - (size_t)len, ";%u,%u,%s", order.items[i].slot_number,
+                        order.items[i].quantity, order.items[i].product_id);
+    }
+    TEST_ASSERT_EQUAL_INT(ESP_RX_TEXT_LINE_MAX, len);
+    strcat(line, "\r\n");
+
+    seqRx1.expected = 255;
+    feed_str(line);
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_BATCH, evt.type);
+    assert_max_order(evt.data.batch.order);
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.lineResets);
+}
+
+// Trame ORDER numérotée de taille maximale en mode binaire
+void test_esp_link_order_batch_max_binary(void) {
+    OrchestratorEvent evt;
+    EspOrder order;
+    make_max_order(&order);
+    seqEnabled1 = true;
+    EspComm_SetLinkMode(ESP_LINK_MODE_BINARY);
+
+    uint8_t frame[ESP_FRAME_MAX_RX_ENCODED];
+    size_t n = EspFrame_EncodeOrderSeq(&order, 0, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(n > 0);
+    Mock_HAL_UART_FeedRx(&huart1, frame, (uint16_t)n);
+    if (ulTaskNotifyTake(pdTRUE, 0) > 0) {
+        EspComm_ProcessRx();
+    }
+
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_ORDER_BATCH, evt.type);
+    assert_max_order(evt.data.batch.order);
+
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.frameErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxFrames);
+}
+
+// Diagnostic à la demande: une ligne par canal moteur, sur le canal DIAG
+void test_esp_link_diag_calibration_dump(void) {
+    OrchestratorEvent evt;
+
+    feed_str("DIAG:CAL\r\n");
+    TEST_ASSERT_FALSE(pop_event(&evt));
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("CAL:0:600:20:0:0/0\r\nCAL:1:700:20:0:0/0\r\n", tx_str());
+}
+
+// Lien en binaire: requête en trame, une trame CAL par canal sur DIAG
+void test_esp_link_diag_calibration_dump_binary(void) {
+    EspComm_SetLinkMode(ESP_LINK_MODE_BINARY);
+    EspCommand diag = { .type = ESP_MSG_DIAG_CALIB, .valid = true };
+    feed_command_frame(&diag);
+    complete_all_tx();
+
+    uint32_t len;
+    const uint8_t* tx = Mock_HAL_GetUARTTxData(&len);
+    uint8_t work[ESP_FRAME_MAX_RAW];
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    uint32_t start = 0;
+    uint8_t frames = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        if (tx[i] != ESP_FRAME_DELIMITER) continue;
+        TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(&tx[start], i - start, work, sizeof(work),
+                                                        &type, &payload, &payloadLen));
+        TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_CAL, type);
+        TEST_ASSERT_EQUAL_UINT32(11, payloadLen);
+        TEST_ASSERT_EQUAL_UINT8(frames, payload[0]);
+        TEST_ASSERT_EQUAL_UINT16(600 + 100 * frames, EspFrame_GetU16(&payload[1]));
+        TEST_ASSERT_EQUAL_UINT16(20, EspFrame_GetU16(&payload[3]));
+        TEST_ASSERT_EQUAL_UINT16(0, EspFrame_GetU16(&payload[9]));
+        frames++;
+        start = i + 1;
+    }
+    TEST_ASSERT_EQUAL_UINT8(2, frames);
+    TEST_ASSERT_EQUAL_UINT32(len, start);
+}
+
+// Mise à jour du catalogue: entrées silencieuses, une réponse à la fin;
+// une ligne mal formée abandonne la mise à jour
+void test_esp_link_catalog_update(void) {
+    catalogOpen = false;
+    catalogCommits = 0;
+
+    feed_str("CATALOG_BEGIN:4\r\nCATALOG_ITEM:7,5,255,150,Eau\r\n");
+    feed_str("CATALOG_ITEM:305,6,2,90,Cafe creme\r\nCATALOG_END:2\r\n");
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_UINT8(1, catalogCommits);
+    TEST_ASSERT_EQUAL_STRING("CATALOG_ACK\r\n", tx_str());
+
+    feed_str("CATALOG_BEGIN:5\r\nCATALOG_ITEM:7,5\r\nCATALOG_END:0\r\n");
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_UINT8(1, catalogCommits);
+    TEST_ASSERT_FALSE(catalogOpen);
+    TEST_ASSERT_EQUAL_STRING("CATALOG_ACK\r\nCATALOG_NAK:FORMAT\r\nCATALOG_NAK:FORMAT\r\n", tx_str());
+}
+
+// Lien négocié en binaire: même mise à jour en trames, réponse en trame
+void test_esp_link_catalog_update_binary(void) {
+    catalogOpen = false;
+    catalogCommits = 0;
+    EspComm_SetLinkMode(ESP_LINK_MODE_BINARY);
+
+    EspCommand begin = { .type = ESP_MSG_CATALOG_BEGIN, .valid = true, .catalog_version = 4 };
+    EspCommand item = { .type = ESP_MSG_CATALOG_ITEM, .valid = true,
+                        .product = { .code = 7, .digits = 1, .channel = 5,
+                                     .sensorId = ESP_PROTO_CATALOG_SENSOR_NONE, .priceCents = 150,
+                                     .label = "Eau" } };
+    EspCommand end = { .type = ESP_MSG_CATALOG_END, .valid = true, .catalog_count = 2 };
+    feed_command_frame(&begin);
+    feed_command_frame(&item);
+    item.product = (ProductEntry){ .code = 305, .digits = 3, .channel = 6, .sensorId = 2,
+                                   .priceCents = 290, .label = "Cafe creme" };
+    feed_command_frame(&item);
+    feed_command_frame(&end);
+
+    TEST_ASSERT_EQUAL_UINT8(1, catalogCommits);
+    TEST_ASSERT_EQUAL_UINT16(305, catalogLastItem.code);
+    TEST_ASSERT_EQUAL_UINT8(3, catalogLastItem.digits);
+    TEST_ASSERT_EQUAL_UINT16(290, catalogLastItem.priceCents);
+    TEST_ASSERT_EQUAL_STRING("Cafe creme", catalogLastItem.label);
+
+    uint32_t len;
+    const uint8_t* tx = Mock_HAL_GetUARTTxData(&len);
+    TEST_ASSERT_TRUE(len > 1);
+    uint8_t work[ESP_FRAME_MAX_RAW];
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(tx, len - 1, work, sizeof(work), &type, &payload, &payloadLen));
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_CATALOG_ACK, type);
+}
+
+// Réception arrêtée pendant la sauvegarde: octets perdus, ligne en cours
+// abandonnée, réception réarmée ensuite sans perte du lien comptée
+void test_esp_link_catalog_save_pauses_rx(void) {
+    OrchestratorEvent evt;
+    catalogOpen = false;
+    catalogCommits = 0;
+    catalogSaveArrivals = "12345678\r\n";
+
+    feed_str("CATALOG_BEGIN:6\r\nCATALOG_ITEM:7,5,255,150,Eau\r\n");
+    feed_str("CATALOG_END:1\r\nNFC_UID:");
+    catalogSaveArrivals = NULL;
+    TEST_ASSERT_EQUAL_UINT8(1, catalogCommits);
+    TEST_ASSERT_EQUAL_UINT32(10, Mock_HAL_GetUARTRxLostCount());
+    TEST_ASSERT_TRUE(Mock_HAL_IsUARTRxActive());
+
+    // Fin de la ligne coupée: rejetée seule, la suivante passe
+    feed_str("AABBCCDD\r\nNFC_UID:12345678\r\n");
+    TEST_ASSERT_TRUE(pop_event(&evt));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, evt.type);
+    TEST_ASSERT_FALSE(pop_event(&evt));
+
+    complete_all_tx();
+    TEST_ASSERT_EQUAL_STRING("CATALOG_ACK\r\n", tx_str());
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.linkLosses);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_esp_link_line_delivered_on_idle);
+    RUN_TEST(test_esp_link_line_split_across_bursts);
+    RUN_TEST(test_esp_link_wraps_around_dma_buffer);
+    RUN_TEST(test_esp_link_long_burst_drained_by_half_and_full_transfer);
+    RUN_TEST(test_esp_link_overrun_restarts_reception);
+    RUN_TEST(test_esp_link_error_counters);
+    RUN_TEST(test_esp_link_intercharacter_timeout_resets_line);
+    RUN_TEST(test_esp_link_ignores_other_uart);
+    RUN_TEST(test_esp_link_isr_only_queues_bytes_and_notifies);
+    RUN_TEST(test_esp_link_multiple_events_single_task_pass);
+    RUN_TEST(test_esp_link_error_resync_keeps_earlier_lines);
+    RUN_TEST(test_esp_link_ring_full_counts_dropped_bytes);
+    RUN_TEST(test_esp_tx_line_and_crlf_single_dma_transfer);
+    RUN_TEST(test_esp_tx_lines_queued_while_busy_are_chained);
+    RUN_TEST(test_esp_tx_ring_wrap_split_in_two_transfers);
+    RUN_TEST(test_esp_tx_backpressure_when_full);
+    RUN_TEST(test_esp_tx_rejects_invalid_lines);
+    RUN_TEST(test_esp_tx_dma_error_recovers);
+    RUN_TEST(test_esp_tx_dma_error_keeps_rx_line);
+    RUN_TEST(test_esp_tx_control_preempts_chunked_telemetry);
+    RUN_TEST(test_esp_tx_priority_at_message_boundary_without_channels);
+    RUN_TEST(test_esp_link_binary_frames_dispatched);
+    RUN_TEST(test_esp_link_binary_corrupted_frame_counted);
+    RUN_TEST(test_esp_link_response_follows_link_mode);
+    RUN_TEST(test_esp_link_handshake_upgrades_uart);
+    RUN_TEST(test_esp_link_loss_renegotiates);
+    RUN_TEST(test_esp_link_sequenced_vend_pipeline);
+    RUN_TEST(test_esp_link_sequenced_response_retransmit);
+    RUN_TEST(test_esp_link_sequenced_binary_frame);
+    RUN_TEST(test_esp_link_order_batch_single_event);
+    RUN_TEST(test_esp_link_sequenced_order_duplicate_keeps_descriptor);
+    RUN_TEST(test_esp_link_sequenced_order_ahead_not_held);
+    RUN_TEST(test_esp_link_order_batch_binary);
+    RUN_TEST(test_esp_link_order_batch_max_text);
+    RUN_TEST(test_esp_link_order_batch_max_binary);
+    RUN_TEST(test_esp_link_diag_calibration_dump);
+    RUN_TEST(test_esp_link_diag_calibration_dump_binary);
+    RUN_TEST(test_esp_link_catalog_update);
+    RUN_TEST(test_esp_link_catalog_update_binary);
+    RUN_TEST(test_esp_link_catalog_save_pauses_rx);
+
+    return UNITY_END();
+}
@@ -0,0 +1,324 @@
+// Rejeu de transcriptions enregistrées à travers le vrai esp_communication_service.c:
+// DMA circulaire + IDLE (mock HAL), callback ISR, ring, tâche ESP, décodeur.
+// Affiche lignes/s, cycles/octet, pire temps ISR et compteurs de pertes.
+#define _POSIX_C_SOURCE 199309L
+
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Le callback du service est renommé pour être chronométré par l'enveloppe
+// HAL_UARTEx_RxEventCallback ci-dessous (appelée par le mock comme par le HAL)
+#define HAL_UARTEx_RxEventCallback EspComm_RxEventCallback_Real
+#include "../../../Core/Src/Services/esp_communication_service.c"
+#undef HAL_UARTEx_RxEventCallback
+
+#include "esp_replay_transcripts.h"
+
+// L'orchestrateur n'est pas lié: ses événements sont capturés dans une queue mock
+extern osMessageQueueId_t orchestratorEventQueueHandle;
+
+bool Orchestrator_PostEvent(const OrchestratorEvent* evt) {
+    return osMessageQueuePut(orchestratorEventQueueHandle, evt, 0, 0) == osOK;
+}
+
+// Seul le nombre d'événements compte ici: charges utiles non conservées
+bool Orchestrator_PostOrderStart(const char* order_id) {
+    (void)order_id;
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_START };
+    return Orchestrator_PostEvent(&evt);
+}
+
+bool Orchestrator_PostVendItem(uint8_t slot_number, uint8_t quantity, const char* product_id) {
+    (void)product_id;
+    OrchestratorEvent evt = { .type = ORCH_EVT_VEND_ITEM };
+    evt.data.vend.slot_number = slot_number;
+    evt.data.vend.quantity = quantity;
+    return Orchestrator_PostEvent(&evt);
+}
+
+bool MotorService_GetCalibration(uint8_t channel, MotorCalibRecord* out) {
+    (void)channel;
+    (void)out;
+    return false;
+}
+
+uint8_t CatalogService_Begin(uint16_t version) {
+    (void)version;
+    return ESP_CODE_NONE;
+}
+
+uint8_t CatalogService_AddItem(const ProductEntry* entry) {
+    (void)entry;
+    return ESP_CODE_NONE;
+}
+
+uint8_t CatalogService_Commit(uint8_t count) {
+    (void)count;
+    return ESP_CODE_NONE;
+}
+
+void CatalogService_Abort(void) {
+}
+
+#define REPLAY_ROUNDS           20
+#define REPLAY_CHAR_US          87U     // 10 bits à 115200 bauds
+#define REPLAY_TASK_LATENCY_US  1000U   // La tâche ESP ne reprend la main qu'au tick suivant
+#define REPLAY_QUEUE_DEPTH      64
+#define REPLAY_BURST_MAX        1024
+
+typedef struct {
+    uint64_t bytes;
+    uint64_t lines;
+    uint64_t events;
+    uint64_t ns;
+    uint64_t cycles;
+    uint64_t isrCalls;
+    uint64_t isrWorstCycles;
+    uint64_t isrWorstNs;
+    uint32_t rxDropped;
+    uint32_t lineResets;
+} ReplayResult;
+
+static ReplayResult* isrProbe;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;   // Pas de compteur de cycles portable: seul le temps est affiché
+#endif
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+    uint64_t t0 = now_ns();
+    uint64_t c0 = now_cycles();
+    EspComm_RxEventCallback_Real(huart, Size);
+    uint64_t c1 = now_cycles();
+    uint64_t t1 = now_ns();
+
+    if (!isrProbe) return;
+    isrProbe->isrCalls++;
+    if (c1 - c0 > isrProbe->isrWorstCycles) isrProbe->isrWorstCycles = c1 - c0;
+    if (t1 - t0 > isrProbe->isrWorstNs) isrProbe->isrWorstNs = t1 - t0;
+}
+
+static void reset_esp_link_state(void) {
+    rxDmaReadPos1 = 0;
+    lineLen1 = 0;
+    invalidCharCount = 0;
+    lastRxTimestamp = 0;
+    orderInProgress = false;
+    memset(lineBuf1, 0, sizeof(lineBuf1));
+    memset((void*)&linkStats1, 0, sizeof(linkStats1));
+    rxResyncPending = false;
+    RingBuffer_Init(&rxRing1, rxRingStorage1, sizeof(rxRingStorage1));
+    espTaskHandleLocal = xTaskGetCurrentTaskHandle();
+    for (uint8_t ch = 0; ch < ESP_CHANNEL_COUNT; ch++) {
+        txChan1[ch].ring.head = txChan1[ch].ring.tail = 0;
+        txChan1[ch].head = txChan1[ch].count = 0;
+    }
+    txInFlight1 = 0;
+    txInFlightCh1 = 0;
+    txResumeCh1 = -1;
+    channelsEnabled1 = false;
+    linkMode1 = ESP_LINK_MODE_TEXT;
+    rxAssemblyMode1 = ESP_LINK_MODE_TEXT;
+    EspHandshake_Init(&linkHs1);
+    linkLossWindowStart = 0;
+    linkLossErrorBase = 0;
+    seqEnabled1 = false;
+    EspSeq_RxReset(&seqRx1);
+    EspSeq_TxReset(&seqTx1);
+    stagedOrderBusy1 = false;
+}
+
+// Passage de la tâche ESP: traitement du ring, fin des DMA d'émission,
+// consommation des événements par l'orchestrateur
+static void run_task(uint64_t tUs, ReplayResult* res) {
+    OrchestratorEvent evt;
+
+    Mock_HAL_SetTick((uint32_t)(tUs / 1000U));
+    if (ulTaskNotifyTake(pdTRUE, 0) > 0) {
+        EspComm_ProcessRx();
+    }
+    while (huart1.gState == HAL_UART_STATE_BUSY_TX) {
+        Mock_HAL_UART_CompleteTx(&huart1);
+    }
+    while (osMessageQueueGet(orchestratorEventQueueHandle, &evt, NULL, 0) == osOK) {
+        if (evt.type == ORCH_EVT_ORDER_BATCH) EspComm_ReleaseOrder(evt.data.batch.order);
+        res->events++;
+    }
+}
+
+// Rejoue une transcription: les enregistrements séparés de moins d'un temps
+// caractère forment une seule rafale DMA terminée par un IDLE
+static void replay_records(const EspReplayRecord* recs, size_t count, uint64_t* tUs,
+                           ReplayResult* res) {
+    uint8_t burst[REPLAY_BURST_MAX];
+    uint16_t burstLen = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const EspReplayRecord* r = &recs[i];
+        if (r->gap_us >= REPLAY_CHAR_US && burstLen > 0) {
+            Mock_HAL_UART_FeedRx(&huart1, burst, burstLen);
+            burstLen = 0;
+        }
+        if (r->gap_us >= REPLAY_TASK_LATENCY_US) {
+            run_task(*tUs + REPLAY_TASK_LATENCY_US, res);
+        }
+        *tUs += r->gap_us;
+
+        for (uint16_t k = 0; k < r->len; k++) {
+            if (burstLen == sizeof(burst)) {
+                Mock_HAL_UART_FeedRx(&huart1, burst, burstLen);
+                burstLen = 0;
+            }
+            burst[burstLen++] = (uint8_t)r->data[k];
+            if (r->data[k] == '\n') res->lines++;
+        }
+        res->bytes += r->len;
+        *tUs += (uint64_t)r->len * REPLAY_CHAR_US;
+    }
+    if (burstLen > 0) Mock_HAL_UART_FeedRx(&huart1, burst, burstLen);
+    run_task(*tUs + REPLAY_TASK_LATENCY_US, res);
+}
+
+static void replay_begin(ReplayResult* res) {
+    Mock_HAL_Reset();
+    Mock_FreeRTOS_Reset();
+    reset_esp_link_state();
+    orchestratorEventQueueHandle = osMessageQueueNew(REPLAY_QUEUE_DEPTH, sizeof(OrchestratorEvent), NULL);
+    TEST_ASSERT_EQUAL(HAL_OK, EspComm_StartRx());
+    memset(res, 0, sizeof(*res));
+    isrProbe = res;
+}
+
+static void replay_end(ReplayResult* res) {
+    EspLinkStats stats;
+    EspComm_GetLinkStats(&stats);
+    res->rxDropped = stats.rxDropped;
+    res->lineResets = stats.lineResets;
+    isrProbe = NULL;
+}
+
+static void replay_transcript(const EspReplayTranscript* t, uint32_t rounds, ReplayResult* res) {
+    uint64_t tUs = 1000000U;
+
+    replay_begin(res);
+    for (uint32_t r = 0; r < rounds; r++) {
+        lastRxTimestamp = 0;
+        orderInProgress = false;
+        uint64_t t0 = now_ns();
+        uint64_t c0 = now_cycles();
+        replay_records(t->records, t->count, &tUs, res);
+        res->cycles += now_cycles() - c0;
+        res->ns += now_ns() - t0;
+    }
+    replay_end(res);
+}
+
+static void print_result(const char* name, const ReplayResult* res) {
+    double sec = (double)res->ns / 1e9;
+    printf("[REPLAY] %-8s %6llu octets %5llu lignes  %10.0f lignes/s  %7.1f cycles/octet"
+           "  ISR pire %6llu cycles (%5llu ns) sur %llu  perdus %u  resets %u\n",
+           name,
+           (unsigned long long)res->bytes, (unsigned long long)res->lines,
+           sec > 0.0 ? (double)res->lines / sec : 0.0,
+           res->bytes ? (double)res->cycles / (double)res->bytes : 0.0,
+           (unsigned long long)res->isrWorstCycles, (unsigned long long)res->isrWorstNs,
+           (unsigned long long)res->isrCalls, res->rxDropped, res->lineResets);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// Session, console lente, redémarrage: tous les événements attendus sont livrés
+void test_esp_replay_transcripts(void) {
+    for (size_t i = 0; i < ESP_REPLAY_COUNT(esp_replay_transcripts); i++) {
+        const EspReplayTranscript* t = &esp_replay_transcripts[i];
+        ReplayResult res;
+
+        replay_transcript(t, REPLAY_ROUNDS, &res);
+        print_result(t->name, &res);
+
+        TEST_ASSERT_EQUAL_UINT64_MESSAGE((uint64_t)t->expectedEvents * REPLAY_ROUNDS,
+                                         res.events, t->name);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, res.rxDropped, t->name);
+        TEST_ASSERT_TRUE(res.isrCalls > 0);
+    }
+}
+
+// La console lente provoque un IDLE par octet, sans perte ni reset
+void test_esp_replay_slow_console_one_isr_per_byte(void) {
+    ReplayResult res;
+
+    replay_transcript(&esp_replay_transcripts[1], 1, &res);
+    TEST_ASSERT_EQUAL_UINT64(res.bytes, res.isrCalls);
+    TEST_ASSERT_EQUAL_UINT32(0, res.lineResets);
+}
+
+// Bannière ROM (31 octets invalides: un reset tous les 10); la ligne de log
+// tient dans le buffer de réception (dimensionné pour la plus longue ORDER)
+// et est ignorée comme commande inconnue
+void test_esp_replay_reboot_counts_resets(void) {
+    ReplayResult res;
+
+    replay_transcript(&esp_replay_transcripts[2], 1, &res);
+    TEST_ASSERT_EQUAL_UINT32(3, res.lineResets);
+    TEST_ASSERT_EQUAL_UINT64(4, res.events);
+}
+
+// Tâche ESP privée de CPU pendant une rafale continue: le ring déborde, les
+// pertes sont comptées, et le lien se resynchronise sur la ligne suivante
+void test_esp_replay_starved_task_drops_and_recovers(void) {
+    static char flood[ESP_RX_RING_SIZE * 3];
+    size_t n = 0;
+    while (n + 18 <= sizeof(flood)) {
+        memcpy(&flood[n], "NFC_UID:AABBCCDD\r\n", 18);
+        n += 18;
+    }
+    const EspReplayRecord recs[] = {
+        { 0, flood, (uint16_t)n },
+        ESP_REPLAY_REC(5000, "NFC_UID:11223344\r\n"),
+    };
+    ReplayResult res;
+    uint64_t tUs = 0;
+
+    replay_begin(&res);
+    uint64_t t0 = now_ns();
+    uint64_t c0 = now_cycles();
+    replay_records(recs, ESP_REPLAY_COUNT(recs), &tUs, &res);
+    res.cycles = now_cycles() - c0;
+    res.ns = now_ns() - t0;
+    replay_end(&res);
+    print_result("famine", &res);
+
+    TEST_ASSERT_TRUE(res.rxDropped > 0);
+    TEST_ASSERT_EQUAL_UINT32(n + 18, linkStats1.rxBytes);
+    TEST_ASSERT_TRUE(res.events >= 1);
+    TEST_ASSERT_TRUE(res.events < res.lines);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_esp_replay_transcripts);
+    RUN_TEST(test_esp_replay_slow_console_one_isr_per_byte);
+    RUN_TEST(test_esp_replay_reboot_counts_resets);
+    RUN_TEST(test_esp_replay_starved_task_drops_and_recovers);
+
+    return UNITY_END();
+}
@@ -0,0 +1,332 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_frame.h"
+
+static uint8_t frame[ESP_FRAME_MAX_RX_ENCODED];
+static uint8_t work[ESP_FRAME_MAX_RX_RAW];
+
+void setUp(void) {
+    memset(frame, 0xAA, sizeof(frame));
+    memset(work, 0xAA, sizeof(work));
+}
+
+void tearDown(void) {
+}
+
+// Valeur de contrôle CRC-16/CCITT-FALSE
+void test_esp_frame_crc16_check_value(void) {
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, EspFrame_Crc16((const uint8_t*)"123456789", 9));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, EspFrame_Crc16(NULL, 0));
+}
+
+// COBS: aucun zéro dans la sortie, aller-retour exact (zéros, blocs de 254+ octets)
+void test_esp_frame_cobs_round_trip(void) {
+    uint8_t in[300];
+    uint8_t enc[310];
+    uint8_t dec[300];
+
+    const uint8_t zeros[] = { 0x00, 0x11, 0x00, 0x00, 0x22 };
+    size_t n = EspFrame_CobsEncode(zeros, sizeof(zeros), enc, sizeof(enc));
+    TEST_ASSERT_EQUAL(sizeof(zeros) + 1, n);
+    TEST_ASSERT_NULL(memchr(enc, 0x00, n));
+    TEST_ASSERT_EQUAL(sizeof(zeros), EspFrame_CobsDecode(enc, n, dec, sizeof(dec)));
+    TEST_ASSERT_EQUAL_MEMORY(zeros, dec, sizeof(zeros));
+
+    for (size_t i = 0; i < sizeof(in); i++) in[i] = (uint8_t)(i % 255U) + 1U;
+    n = EspFrame_CobsEncode(in, sizeof(in), enc, sizeof(enc));
+    TEST_ASSERT_EQUAL(sizeof(in) + 2, n);
+    TEST_ASSERT_NULL(memchr(enc, 0x00, n));
+    TEST_ASSERT_EQUAL(sizeof(in), EspFrame_CobsDecode(enc, n, dec, sizeof(dec)));
+    TEST_ASSERT_EQUAL_MEMORY(in, dec, sizeof(in));
+
+    // Place insuffisante et code pointant hors de la trame
+    TEST_ASSERT_EQUAL(0, EspFrame_CobsEncode(in, sizeof(in), enc, 10));
+    const uint8_t bad[] = { 0x05, 0x11, 0x22 };
+    TEST_ASSERT_EQUAL(0, EspFrame_CobsDecode(bad, sizeof(bad), dec, sizeof(dec)));
+}
+
+// Trame complète: délimiteur final unique, décodage du type et du payload
+void test_esp_frame_encode_decode(void) {
+    const uint8_t payload[] = { 0x02, 0x00, 'A', 'B' };
+    size_t n = EspFrame_Encode(ESP_FRAME_VEND, payload, sizeof(payload), frame, sizeof(frame));
+    TEST_ASSERT_TRUE(n > 0);
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_DELIMITER, frame[n - 1]);
+    TEST_ASSERT_NULL(memchr(frame, ESP_FRAME_DELIMITER, n - 1));
+
+    uint8_t type = 0;
+    const uint8_t* out = NULL;
+    size_t outLen = 0;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(frame, n - 1, work, sizeof(work), &type, &out, &outLen));
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_VEND, type);
+    TEST_ASSERT_EQUAL(sizeof(payload), outLen);
+    TEST_ASSERT_EQUAL_MEMORY(payload, out, sizeof(payload));
+
+    // Payload trop long: refusé à l'encodage
+    uint8_t big[ESP_FRAME_MAX_PAYLOAD + 1] = {0};
+    TEST_ASSERT_EQUAL(0, EspFrame_Encode(ESP_FRAME_NFC_UID, big, sizeof(big), frame, sizeof(frame)));
+}
+
+// Corruption d'un octet quelconque ou troncature: jamais acceptée
+void test_esp_frame_detects_corruption(void) {
+    const uint8_t payload[] = { 'O', 'R', 'D', '1' };
+    size_t n = EspFrame_Encode(ESP_FRAME_ORDER_START, payload, sizeof(payload), frame, sizeof(frame));
+    uint8_t type;
+    const uint8_t* out;
+    size_t outLen;
+
+    for (size_t i = 0; i < n - 1; i++) {
+        uint8_t copy[ESP_FRAME_MAX_ENCODED];
+        memcpy(copy, frame, n);
+        copy[i] ^= 0x40;
+        if (copy[i] == 0x00) continue;  // Un zéro serait un délimiteur, pas une corruption
+        TEST_ASSERT_NOT_EQUAL(ESP_FRAME_OK,
+            EspFrame_Decode(copy, n - 1, work, sizeof(work), &type, &out, &outLen));
+    }
+
+    // Trame tronquée, trame trop courte pour type + CRC
+    TEST_ASSERT_NOT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(frame, n - 2, work, sizeof(work), &type, &out, &outLen));
+    const uint8_t tiny[] = { 0x03, 0x05, 0x06 };
+    TEST_ASSERT_EQUAL(ESP_FRAME_ERR_LENGTH, EspFrame_Decode(tiny, sizeof(tiny), work, sizeof(work), &type, &out, &outLen));
+}
+
+// Commandes ESP -> STM: aller-retour et validation des champs
+void test_esp_frame_command_round_trip(void) {
+    EspCommand in = { .type = ESP_MSG_VEND_COMMAND, .valid = true, .slot_number = 3, .quantity = 2 };
+    strcpy(in.product_id, "COLA");
+    size_t n = EspFrame_EncodeCommand(&in, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(n > 0);
+
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(frame, n - 1, work, sizeof(work), &type, &payload, &payloadLen));
+
+    EspCommand out;
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(type, payload, payloadLen, &out));
+    TEST_ASSERT_EQUAL(ESP_MSG_VEND_COMMAND, out.type);
+    TEST_ASSERT_TRUE(out.valid);
+    TEST_ASSERT_EQUAL_UINT8(3, out.slot_number);
+    TEST_ASSERT_EQUAL_UINT8(2, out.quantity);
+    TEST_ASSERT_EQUAL_STRING("COLA", out.product_id);
+
+    // Slot hors bornes: commande reconnue mais invalide, comme en texte
+    const uint8_t badSlot[] = { 9, 1, 'X' };
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(ESP_FRAME_VEND, badSlot, sizeof(badSlot), &out));
+    TEST_ASSERT_FALSE(out.valid);
+
+    // Type inconnu
+    TEST_ASSERT_FALSE(EspFrame_ToCommand(0x7F, NULL, 0, &out));
+}
+
+// Réponses STM -> ESP: aller-retour des champs typés
+void test_esp_frame_response_round_trip(void) {
+    EspResponse in = { .type = ESP_RSP_VEND_FAILED, .slot = 4, .code = ESP_CODE_INVALID_CHANNEL };
+    size_t n = EspFrame_EncodeResponse(&in, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(n > 0);
+
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(frame, n - 1, work, sizeof(work), &type, &payload, &payloadLen));
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_VEND_FAILED, type);
+
+    EspResponse out;
+    TEST_ASSERT_TRUE(EspFrame_ToResponse(type, payload, payloadLen, &out));
+    TEST_ASSERT_EQUAL(ESP_RSP_VEND_FAILED, out.type);
+    TEST_ASSERT_EQUAL_UINT8(4, out.slot);
+    TEST_ASSERT_EQUAL(ESP_CODE_INVALID_CHANNEL, out.code);
+}
+
+// Commande groupée binaire: aller-retour et bornes vérifiées
+void test_esp_frame_order_round_trip(void) {
+    EspOrder in = { .order_id = "Q42", .item_count = 2,
+                    .items = { { 1, 2, "COLA" }, { 4, 1, "CHIPS" } } };
+    size_t n = EspFrame_EncodeOrder(&in, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(n > 0);
+
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(frame, n - 1, work, sizeof(work), &type, &payload, &payloadLen));
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_ORDER, type);
+
+    EspCommand cmd;
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(type, payload, payloadLen, &cmd));
+    TEST_ASSERT_EQUAL(ESP_MSG_ORDER_BATCH, cmd.type);
+
+    EspOrder out;
+    TEST_ASSERT_TRUE(EspFrame_ToOrder(payload, payloadLen, &out));
+    TEST_ASSERT_EQUAL_STRING("Q42", out.order_id);
+    TEST_ASSERT_EQUAL_UINT8(2, out.item_count);
+    TEST_ASSERT_EQUAL_UINT8(4, out.items[1].slot_number);
+    TEST_ASSERT_EQUAL_STRING("CHIPS", out.items[1].product_id);
+
+    // Article tronqué ou hors bornes
+    TEST_ASSERT_FALSE(EspFrame_ToOrder(payload, payloadLen - 1, &out));
+    const uint8_t badQty[] = { 1, 'Q', 1, 0, 1, 'A' };
+    TEST_ASSERT_FALSE(EspFrame_ToOrder(badQty, sizeof(badQty), &out));
+    const uint8_t noItem[] = { 1, 'Q' };
+    TEST_ASSERT_FALSE(EspFrame_ToOrder(noItem, sizeof(noItem), &out));
+}
+
+// Mise à jour du catalogue en trames: aller-retour et bornes vérifiées
+void test_esp_frame_catalog_round_trip(void) {
+    EspCommand in = { .type = ESP_MSG_CATALOG_ITEM, .valid = true,
+                      .product = { .code = 42, .digits = 3, .channel = 9, .sensorId = 1,
+                                   .priceCents = 1250, .label = "Jus pomme" } };
+    size_t n = EspFrame_EncodeCommandSeq(&in, 3, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(n > 0);
+
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(frame, n - 1, work, sizeof(work), &type, &payload, &payloadLen));
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_SEQ, type);
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_CATALOG_ITEM, payload[1]);
+
+    EspCommand out;
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(payload[1], payload + 2, payloadLen - 2, &out));
+    TEST_ASSERT_EQUAL(ESP_MSG_CATALOG_ITEM, out.type);
+    TEST_ASSERT_TRUE(out.valid);
+    TEST_ASSERT_EQUAL_UINT16(42, out.product.code);
+    TEST_ASSERT_EQUAL_UINT8(3, out.product.digits);
+    TEST_ASSERT_EQUAL_UINT8(9, out.product.channel);
+    TEST_ASSERT_EQUAL_UINT8(1, out.product.sensorId);
+    TEST_ASSERT_EQUAL_UINT16(1250, out.product.priceCents);
+    TEST_ASSERT_EQUAL_STRING("Jus pomme", out.product.label);
+
+    // Libellé absent, code trop long, caractère de contrôle
+    const uint8_t noLabel[] = { 7, 0, 1, 5, 255, 150, 0 };
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(ESP_FRAME_CATALOG_ITEM, noLabel, sizeof(noLabel), &out));
+    TEST_ASSERT_FALSE(out.valid);
+    const uint8_t longCode[] = { 7, 0, 4, 5, 255, 150, 0, 'E' };
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(ESP_FRAME_CATALOG_ITEM, longCode, sizeof(longCode), &out));
+    TEST_ASSERT_FALSE(out.valid);
+    const uint8_t ctrl[] = { 7, 0, 1, 5, 255, 150, 0, 'E', '\n' };
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(ESP_FRAME_CATALOG_ITEM, ctrl, sizeof(ctrl), &out));
+    TEST_ASSERT_FALSE(out.valid);
+    const uint8_t sensorNone[] = { 7, 0, 1, 5, 255, 150, 0, 'E' };
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(ESP_FRAME_CATALOG_ITEM, sensorNone, sizeof(sensorNone), &out));
+    TEST_ASSERT_TRUE(out.valid);
+    TEST_ASSERT_EQUAL_UINT8(PRODUCT_SENSOR_NONE, out.product.sensorId);
+
+    // Version u16, nombre d'entrées 1..PRODUCT_CATALOG_MAX
+    const uint8_t version[] = { 0x34, 0x12 };
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(ESP_FRAME_CATALOG_BEGIN, version, sizeof(version), &out));
+    TEST_ASSERT_TRUE(out.valid);
+    TEST_ASSERT_EQUAL_UINT16(0x1234, out.catalog_version);
+    const uint8_t noCount[] = { 0 };
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(ESP_FRAME_CATALOG_END, noCount, sizeof(noCount), &out));
+    TEST_ASSERT_FALSE(out.valid);
+    const uint8_t count[] = { PRODUCT_CATALOG_MAX };
+    TEST_ASSERT_TRUE(EspFrame_ToCommand(ESP_FRAME_CATALOG_END, count, sizeof(count), &out));
+    TEST_ASSERT_TRUE(out.valid);
+    TEST_ASSERT_EQUAL_UINT8(PRODUCT_CATALOG_MAX, out.catalog_count);
+}
+
+// Plus grande commande groupée (numérotée): tient dans les bornes de réception
+void test_esp_frame_order_max_size(void) {
+    EspOrder in = { .item_count = ESP_PROTO_ORDER_MAX_ITEMS };
+    memset(in.order_id, 'O', ESP_PROTO_ID_MAX_LEN);
+    for (uint8_t i = 0; i < ESP_PROTO_ORDER_MAX_ITEMS; i++) {
+        in.items[i].slot_number = ESP_PROTO_SLOT_MAX;
+        in.items[i].quantity = ESP_PROTO_QTY_MAX;
+        memset(in.items[i].product_id, 'a' + i, ESP_PROTO_ID_MAX_LEN);
+    }
+    size_t n = EspFrame_EncodeOrderSeq(&in, 255, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(n > 0 && n <= ESP_FRAME_MAX_RX_ENCODED);
+
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(frame, n - 1, work, sizeof(work), &type, &payload, &payloadLen));
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_SEQ, type);
+    TEST_ASSERT_EQUAL_UINT32(ESP_FRAME_MAX_RX_PAYLOAD, payloadLen);
+    TEST_ASSERT_EQUAL_HEX8(255, payload[0]);
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_ORDER, payload[1]);
+
+    EspOrder out;
+    TEST_ASSERT_TRUE(EspFrame_ToOrder(payload + 2, payloadLen - 2, &out));
+    TEST_ASSERT_EQUAL_UINT8(ESP_PROTO_ORDER_MAX_ITEMS, out.item_count);
+    TEST_ASSERT_EQUAL_STRING(in.order_id, out.order_id);
+    TEST_ASSERT_EQUAL_STRING(in.items[7].product_id, out.items[7].product_id);
+
+    // Un octet de plus que la borne de réception est refusé
+    uint8_t raw[ESP_FRAME_MAX_RX_RAW + 1] = {0};
+    raw[0] = ESP_FRAME_ORDER;
+    uint16_t crc = EspFrame_Crc16(raw, sizeof(raw) - 2);
+    raw[sizeof(raw) - 2] = (uint8_t)crc;
+    raw[sizeof(raw) - 1] = (uint8_t)(crc >> 8);
+    uint8_t big[ESP_FRAME_MAX_RX_ENCODED + 1];
+    n = EspFrame_CobsEncode(raw, sizeof(raw), big, sizeof(big));
+    TEST_ASSERT_TRUE(n > 0);
+    uint8_t bigWork[ESP_FRAME_MAX_RX_RAW + 1];
+    TEST_ASSERT_EQUAL(ESP_FRAME_ERR_LENGTH,
+                      EspFrame_Decode(big, n, bigWork, sizeof(bigWork), &type, &payload, &payloadLen));
+}
+
+// Format texte des réponses identique aux anciennes chaînes
+void test_esp_protocol_format_response_legacy_strings(void) {
+    char line[64];
+    EspResponse rsp = { .type = ESP_RSP_VEND_COMPLETED, .slot = 2 };
+    EspProtocol_FormatResponse(&rsp, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("VEND_COMPLETED:2", line);
+
+    rsp = (EspResponse){ .type = ESP_RSP_VEND_FAILED, .slot = 5, .code = ESP_CODE_INVALID_CHANNEL };
+    EspProtocol_FormatResponse(&rsp, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("VEND_FAILED:5:INVALID_CHANNEL", line);
+
+    // Échec après distribution partielle: compte des unités tombées
+    rsp = (EspResponse){ .type = ESP_RSP_VEND_FAILED, .slot = 5, .code = ESP_CODE_NO_DROP,
+                         .delivered = 3, .quantity = 10 };
+    EspProtocol_FormatResponse(&rsp, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("VEND_FAILED:5:NO_DROP:3/10", line);
+
+    rsp = (EspResponse){ .type = ESP_RSP_ORDER_NAK, .code = ESP_CODE_NO_ACTIVE_ORDER };
+    EspProtocol_FormatResponse(&rsp, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("ORDER_NAK:NO_ACTIVE_ORDER", line);
+
+    rsp = (EspResponse){ .type = ESP_RSP_DELIVERY_FAILED, .code = ESP_CODE_ORDER_CANCELLED };
+    EspProtocol_FormatResponse(&rsp, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("DELIVERY_FAILED:ORDER_CANCELLED", line);
+
+    rsp = (EspResponse){ .type = ESP_RSP_STATE, .code = ESP_CODE_STATE_PAYING };
+    EspProtocol_FormatResponse(&rsp, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("STATE:PAYING", line);
+
+    rsp = (EspResponse){ .type = ESP_RSP_CATALOG_NAK, .code = ESP_CODE_CATALOG_BUSY };
+    EspProtocol_FormatResponse(&rsp, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("CATALOG_NAK:BUSY", line);
+
+    // Même refus en binaire
+    size_t n = EspFrame_EncodeResponse(&rsp, frame, sizeof(frame));
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLen;
+    EspResponse out;
+    TEST_ASSERT_EQUAL(ESP_FRAME_OK, EspFrame_Decode(frame, n - 1, work, sizeof(work), &type, &payload, &payloadLen));
+    TEST_ASSERT_EQUAL_HEX8(ESP_FRAME_CATALOG_NAK, type);
+    TEST_ASSERT_TRUE(EspFrame_ToResponse(type, payload, payloadLen, &out));
+    TEST_ASSERT_EQUAL(ESP_RSP_CATALOG_NAK, out.type);
+    TEST_ASSERT_EQUAL(ESP_CODE_CATALOG_BUSY, out.code);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_esp_frame_crc16_check_value);
+    RUN_TEST(test_esp_frame_cobs_round_trip);
+    RUN_TEST(test_esp_frame_encode_decode);
+    RUN_TEST(test_esp_frame_detects_corruption);
+    RUN_TEST(test_esp_frame_command_round_trip);
+    RUN_TEST(test_esp_frame_response_round_trip);
+    RUN_TEST(test_esp_frame_order_round_trip);
+    RUN_TEST(test_esp_frame_order_max_size);
+    RUN_TEST(test_esp_frame_catalog_round_trip);
+    RUN_TEST(test_esp_protocol_format_response_legacy_strings);
+
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_link_handshake.h"
+
+static EspHandshake hs;
+static EspHsAction act;
+
+void setUp(void) {
+    EspHandshake_Init(&hs);
+    memset(&act, 0xAA, sizeof(act));
+}
+
+void tearDown(void) {
+}
+
+// HELLO émis à 115200 en mode de base
+void test_esp_hs_start_sends_hello(void) {
+    EspHandshake_Start(&hs, 1000, &act);
+
+    TEST_ASSERT_EQUAL_STRING("HELLO:1:15:921600", act.line);
+    TEST_ASSERT_TRUE(act.linkDown);
+    TEST_ASSERT_EQUAL_UINT32(0, act.baud);
+    TEST_ASSERT_FALSE(act.linkUp);
+    TEST_ASSERT_TRUE(EspHandshake_IsBusy(&hs));
+    TEST_ASSERT_EQUAL_UINT32(ESP_HS_HELLO_TIMEOUT_MS, EspHandshake_TimeToDeadline(&hs, 1000));
+}
+
+// ESP sans négociation: retransmissions puis mode historique
+void test_esp_hs_legacy_peer_after_retries(void) {
+    uint32_t now = 0;
+    EspHandshake_Start(&hs, now, &act);
+
+    for (uint32_t i = 1; i < ESP_HS_HELLO_RETRIES; i++) {
+        now += ESP_HS_HELLO_TIMEOUT_MS;
+        EspHandshake_Poll(&hs, now, &act);
+        TEST_ASSERT_EQUAL_STRING("HELLO:1:15:921600", act.line);
+    }
+    now += ESP_HS_HELLO_TIMEOUT_MS - 1;
+    EspHandshake_Poll(&hs, now, &act);
+    TEST_ASSERT_EQUAL_STRING("", act.line);
+
+    EspHandshake_Poll(&hs, now + 1, &act);
+    TEST_ASSERT_TRUE(act.linkUp);
+    TEST_ASSERT_EQUAL(ESP_HS_LEGACY, hs.state);
+    TEST_ASSERT_EQUAL_UINT8(0, hs.caps);
+    TEST_ASSERT_EQUAL_UINT32(ESP_HS_DEFAULT_BAUD, hs.baud);
+    TEST_ASSERT_FALSE(EspHandshake_IsBusy(&hs));
+
+    // Lignes applicatives non consommées par la négociation
+    TEST_ASSERT_FALSE(EspHandshake_OnLine(&hs, "NFC_UID:12", now, &act));
+}
+
+// Montée à 921600 vérifiée par SYNC / SYNC_ACK
+void test_esp_hs_baud_upgrade_verified(void) {
+    EspHandshake_Start(&hs, 0, &act);
+
+    TEST_ASSERT_TRUE(EspHandshake_OnLine(&hs, "HELLO_ACK:1:3:921600", 10, &act));
+    TEST_ASSERT_EQUAL_STRING("BAUD:921600", act.line);
+    TEST_ASSERT_EQUAL_UINT32(921600, act.baud);
+    TEST_ASSERT_FALSE(act.linkUp);
+
+    EspHandshake_Poll(&hs, 10, &act);
+    TEST_ASSERT_EQUAL_STRING("SYNC:" ESP_HS_SYNC_PATTERN, act.line);
+    TEST_ASSERT_EQUAL_UINT32(0, act.baud);
+
+    TEST_ASSERT_TRUE(EspHandshake_OnLine(&hs, "SYNC_ACK:" ESP_HS_SYNC_PATTERN, 20, &act));
+    TEST_ASSERT_TRUE(act.linkUp);
+    TEST_ASSERT_EQUAL(ESP_HS_READY, hs.state);
+    TEST_ASSERT_EQUAL_UINT32(921600, hs.baud);
+    TEST_ASSERT_EQUAL_UINT8(ESP_CAP_BINARY_FRAMES | ESP_CAP_BAUD_UPGRADE, hs.caps);
+}
+
+// Échec à 921600: retour à 115200, essai à 460800, puis 115200 conservé
+void test_esp_hs_sync_failure_falls_back(void) {
+    uint32_t now = 0;
+    EspHandshake_Start(&hs, now, &act);
+    EspHandshake_OnLine(&hs, "HELLO_ACK:1:2:921600", now, &act);
+    EspHandshake_Poll(&hs, now, &act);
+
+    now += ESP_HS_SYNC_TIMEOUT_MS;
+    EspHandshake_Poll(&hs, now, &act);
+    TEST_ASSERT_EQUAL_UINT32(ESP_HS_DEFAULT_BAUD, act.baud);
+    TEST_ASSERT_EQUAL_STRING("", act.line);
+    TEST_ASSERT_EQUAL_UINT32(1, hs.fallbacks);
+
+    now += ESP_HS_REVERT_DELAY_MS;
+    EspHandshake_Poll(&hs, now, &act);
+    TEST_ASSERT_EQUAL_STRING("BAUD:460800", act.line);
+    TEST_ASSERT_EQUAL_UINT32(460800, act.baud);
+
+    // Motif altéré au nouveau débit: même traitement qu'un timeout
+    EspHandshake_Poll(&hs, now, &act);
+    TEST_ASSERT_TRUE(EspHandshake_OnLine(&hs, "SYNC_ACK:UUUU5A5B", now + 5, &act));
+    TEST_ASSERT_EQUAL_UINT32(ESP_HS_DEFAULT_BAUD, act.baud);
+
+    now += 5 + ESP_HS_REVERT_DELAY_MS;
+    EspHandshake_Poll(&hs, now, &act);
+    TEST_ASSERT_TRUE(act.linkUp);
+    TEST_ASSERT_EQUAL(ESP_HS_READY, hs.state);
+    TEST_ASSERT_EQUAL_UINT32(ESP_HS_DEFAULT_BAUD, hs.baud);
+    TEST_ASSERT_EQUAL_UINT32(2, hs.fallbacks);
+    TEST_ASSERT_EQUAL_UINT8(ESP_CAP_BAUD_UPGRADE, hs.caps);
+}
+
+// Pair limité ou sans changement de débit: capacités appliquées dès HELLO_ACK
+void test_esp_hs_peer_limits(void) {
+    EspHandshake_Start(&hs, 0, &act);
+    EspHandshake_OnLine(&hs, "HELLO_ACK:1:3:460800", 0, &act);
+    TEST_ASSERT_EQUAL_STRING("BAUD:460800", act.line);
+
+    EspHandshake_Start(&hs, 0, &act);
+    TEST_ASSERT_EQUAL_UINT32(ESP_HS_DEFAULT_BAUD, act.baud);
+    EspHandshake_OnLine(&hs, "HELLO_ACK:1:1:921600", 0, &act);
+    TEST_ASSERT_TRUE(act.linkUp);
+    TEST_ASSERT_EQUAL_STRING("", act.line);
+    TEST_ASSERT_EQUAL_UINT8(ESP_CAP_BINARY_FRAMES, hs.caps);
+    TEST_ASSERT_EQUAL_UINT32(ESP_HS_DEFAULT_BAUD, hs.baud);
+}
+
+// HELLO_ACK mal formé ignoré; HELLO de l'ESP redémarre la négociation
+void test_esp_hs_malformed_and_restart(void) {
+    EspHandshake_Start(&hs, 0, &act);
+    TEST_ASSERT_TRUE(EspHandshake_OnLine(&hs, "HELLO_ACK:1:x:921600", 0, &act));
+    TEST_ASSERT_FALSE(act.linkUp);
+    TEST_ASSERT_TRUE(EspHandshake_OnLine(&hs, "HELLO_ACK:0:3:921600", 0, &act));
+    TEST_ASSERT_EQUAL(ESP_HS_HELLO_SENT, hs.state);
+
+    EspHandshake_OnLine(&hs, "HELLO_ACK:1:3:921600", 0, &act);
+    EspHandshake_Poll(&hs, 0, &act);
+    EspHandshake_OnLine(&hs, "SYNC_ACK:" ESP_HS_SYNC_PATTERN, 0, &act);
+    TEST_ASSERT_EQUAL(ESP_HS_READY, hs.state);
+
+    TEST_ASSERT_TRUE(EspHandshake_OnLine(&hs, "HELLO", 50, &act));
+    TEST_ASSERT_TRUE(act.linkDown);
+    TEST_ASSERT_EQUAL_UINT32(ESP_HS_DEFAULT_BAUD, act.baud);
+    TEST_ASSERT_EQUAL_STRING("HELLO:1:15:921600", act.line);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_esp_hs_start_sends_hello);
+    RUN_TEST(test_esp_hs_legacy_peer_after_retries);
+    RUN_TEST(test_esp_hs_baud_upgrade_verified);
+    RUN_TEST(test_esp_hs_sync_failure_falls_back);
+    RUN_TEST(test_esp_hs_peer_limits);
+    RUN_TEST(test_esp_hs_malformed_and_restart);
+
+    return UNITY_END();
+}
@@ -0,0 +1,233 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_protocol.h"
+
+static EspCommand cmd;
+
+void setUp(void) {
+    memset(&cmd, 0xAA, sizeof(cmd));
+}
+
+void tearDown(void) {
+}
+
+// Préfixes et lignes exactes reconnus comme dans l'ancienne chaîne strncmp/strcmp
+void test_esp_protocol_classify_keywords(void) {
+    TEST_ASSERT_EQUAL(ESP_MSG_NFC_UID, EspProtocol_Classify("NFC_UID:1A2B3C4D"));
+    TEST_ASSERT_EQUAL(ESP_MSG_NFC_UID, EspProtocol_Classify("NFC_UID:"));
+    TEST_ASSERT_EQUAL(ESP_MSG_NFC_ERR, EspProtocol_Classify("NFC_ERR:TIMEOUT"));
+    TEST_ASSERT_EQUAL(ESP_MSG_NAK_PAYING_NO_NET, EspProtocol_Classify("NAK:STATE:PAYING:NO_NET"));
+    TEST_ASSERT_EQUAL(ESP_MSG_NAK_PAYING_NO_NET, EspProtocol_Classify("NAK:STATE:PAYING:NO_NET:EXTRA"));
+    TEST_ASSERT_EQUAL(ESP_MSG_NAK_PAYMENT_DENIED, EspProtocol_Classify("NAK:PAYMENT:DENIED"));
+    TEST_ASSERT_EQUAL(ESP_MSG_ORDER_START, EspProtocol_Classify("ORDER_START:42"));
+    TEST_ASSERT_EQUAL(ESP_MSG_VEND_COMMAND, EspProtocol_Classify("VEND 1 1 A"));
+    TEST_ASSERT_EQUAL(ESP_MSG_ORDER_END, EspProtocol_Classify("ORDER_END"));
+    TEST_ASSERT_EQUAL(ESP_MSG_ORDER_FAILED, EspProtocol_Classify("ORDER_FAILED"));
+    TEST_ASSERT_EQUAL(ESP_MSG_QR_TOKEN_ERROR, EspProtocol_Classify("QR_TOKEN_ERROR"));
+    TEST_ASSERT_EQUAL(ESP_MSG_QR_TOKEN_INVALID, EspProtocol_Classify("QR_TOKEN_INVALID"));
+    TEST_ASSERT_EQUAL(ESP_MSG_QR_TOKEN_BUSY, EspProtocol_Classify("QR_TOKEN_BUSY"));
+    TEST_ASSERT_EQUAL(ESP_MSG_QR_TOKEN_NO_NETWORK, EspProtocol_Classify("QR_TOKEN_NO_NETWORK"));
+    TEST_ASSERT_EQUAL(ESP_MSG_DIAG_CALIB, EspProtocol_Classify("DIAG:CAL"));
+}
+
+// Messages exacts: aucun suffixe toléré; préfixes partiels et casse rejetés
+void test_esp_protocol_classify_rejects_near_misses(void) {
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify(NULL));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify(""));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("NFC_UID"));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("nfc_uid:12"));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify(" NFC_UID:12"));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("NAK:STATE"));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("NAK:PAYMENT:DENIED:X"));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("ORDER_END "));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("ORDER_ENDX"));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("QR_TOKEN"));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("VEND"));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("VENDX 1 1 A"));
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("DIAG:CAL:1"));
+}
+
+// VEND: arguments extraits dans la commande typée
+void test_esp_protocol_decode_vend(void) {
+    TEST_ASSERT_EQUAL(ESP_MSG_VEND_COMMAND, EspProtocol_Decode("VEND 3 10 PROD_ABC", &cmd));
+    TEST_ASSERT_TRUE(cmd.valid);
+    TEST_ASSERT_EQUAL_UINT8(3, cmd.slot_number);
+    TEST_ASSERT_EQUAL_UINT8(10, cmd.quantity);
+    TEST_ASSERT_EQUAL_STRING("PROD_ABC", cmd.product_id);
+
+    // Blancs multiples et texte après l'identifiant tolérés (comme sscanf)
+    TEST_ASSERT_EQUAL(ESP_MSG_VEND_COMMAND, EspProtocol_Decode("VEND  1   2  P1 trailing", &cmd));
+    TEST_ASSERT_TRUE(cmd.valid);
+    TEST_ASSERT_EQUAL_UINT8(1, cmd.slot_number);
+    TEST_ASSERT_EQUAL_UINT8(2, cmd.quantity);
+    TEST_ASSERT_EQUAL_STRING("P1", cmd.product_id);
+}
+
+// VEND: bornes et format invalides -> reconnu mais non valide
+void test_esp_protocol_decode_vend_invalid(void) {
+    const char* invalid[] = {
+        "VEND 0 1 P", "VEND 5 1 P", "VEND 1 0 P", "VEND 1 11 P",
+        "VEND -1 1 P", "VEND 1 1", "VEND 1 1 ", "VEND A 1 P", "VEND 1 B P",
+        "VEND 99999999999 1 P", "VEND ",
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        TEST_ASSERT_EQUAL(ESP_MSG_VEND_COMMAND, EspProtocol_Decode(invalid[i], &cmd));
+        TEST_ASSERT_FALSE_MESSAGE(cmd.valid, invalid[i]);
+    }
+}
+
+// Identifiants tronqués à ESP_PROTO_ID_MAX_LEN caractères
+void test_esp_protocol_decode_truncates_ids(void) {
+    char line[96];
+    char id[48];
+    memset(id, 'X', 40);
+    id[40] = '\0';
+
+    snprintf(line, sizeof(line), "VEND 1 1 %s", id);
+    EspProtocol_Decode(line, &cmd);
+    TEST_ASSERT_TRUE(cmd.valid);
+    TEST_ASSERT_EQUAL_size_t(ESP_PROTO_ID_MAX_LEN, strlen(cmd.product_id));
+
+    snprintf(line, sizeof(line), "ORDER_START:%s", id);
+    EspProtocol_Decode(line, &cmd);
+    TEST_ASSERT_TRUE(cmd.valid);
+    TEST_ASSERT_EQUAL_size_t(ESP_PROTO_ID_MAX_LEN, strlen(cmd.order_id));
+}
+
+// ORDER_START: identifiant requis
+void test_esp_protocol_decode_order_start(void) {
+    TEST_ASSERT_EQUAL(ESP_MSG_ORDER_START, EspProtocol_Decode("ORDER_START:ORD-2024-001", &cmd));
+    TEST_ASSERT_TRUE(cmd.valid);
+    TEST_ASSERT_EQUAL_STRING("ORD-2024-001", cmd.order_id);
+
+    TEST_ASSERT_EQUAL(ESP_MSG_ORDER_START, EspProtocol_Decode("ORDER_START: 77 rest", &cmd));
+    TEST_ASSERT_TRUE(cmd.valid);
+    TEST_ASSERT_EQUAL_STRING("77", cmd.order_id);
+
+    TEST_ASSERT_EQUAL(ESP_MSG_ORDER_START, EspProtocol_Decode("ORDER_START:", &cmd));
+    TEST_ASSERT_FALSE(cmd.valid);
+}
+
+// Messages sans argument: valides; inconnus: non valides et champs remis à zéro
+void test_esp_protocol_decode_plain_and_unknown(void) {
+    TEST_ASSERT_EQUAL(ESP_MSG_NFC_UID, EspProtocol_Decode("NFC_UID:01", &cmd));
+    TEST_ASSERT_TRUE(cmd.valid);
+
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Decode("HELLO", &cmd));
+    TEST_ASSERT_FALSE(cmd.valid);
+    TEST_ASSERT_EQUAL_UINT8(0, cmd.slot_number);
+    TEST_ASSERT_EQUAL_STRING("", cmd.product_id);
+    TEST_ASSERT_EQUAL_STRING("", cmd.order_id);
+
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Decode(NULL, &cmd));
+    TEST_ASSERT_EQUAL(ESP_MSG_NFC_ERR, EspProtocol_Decode("NFC_ERR:X", NULL));
+}
+
+// Commande groupée: identifiant + articles bornés en un seul descripteur
+void test_esp_protocol_decode_order_batch(void) {
+    EspOrder order;
+    memset(&order, 0xAA, sizeof(order));
+
+    TEST_ASSERT_EQUAL(ESP_MSG_ORDER_BATCH, EspProtocol_Decode("ORDER:Q42;1,2,COLA;4,1,CHIPS", &cmd));
+    TEST_ASSERT_FALSE(cmd.valid);
+
+    TEST_ASSERT_TRUE(EspProtocol_DecodeOrder("ORDER:Q42;1,2,COLA;4,1,CHIPS", &order));
+    TEST_ASSERT_EQUAL_STRING("Q42", order.order_id);
+    TEST_ASSERT_EQUAL_UINT8(2, order.item_count);
+    TEST_ASSERT_EQUAL_UINT8(1, order.items[0].slot_number);
+    TEST_ASSERT_EQUAL_UINT8(2, order.items[0].quantity);
+    TEST_ASSERT_EQUAL_STRING("COLA", order.items[0].product_id);
+    TEST_ASSERT_EQUAL_UINT8(4, order.items[1].slot_number);
+    TEST_ASSERT_EQUAL_STRING("CHIPS", order.items[1].product_id);
+
+    // ORDER_START reste distinct de la commande groupée
+    TEST_ASSERT_EQUAL(ESP_MSG_ORDER_START, EspProtocol_Classify("ORDER_START:42"));
+}
+
+void test_esp_protocol_decode_order_batch_invalid(void) {
+    EspOrder order;
+
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER:Q42", &order));            // Aucun article
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER:Q42;", &order));
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER:;1,1,A", &order));         // Id vide
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER:Q42;5,1,A", &order));      // Slot hors bornes
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER:Q42;1,11,A", &order));     // Quantité hors bornes
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER:Q42;1,1,", &order));       // Produit vide
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER:Q42;1,1,A B", &order));    // Blanc
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER:Q42;1 ,1,A", &order));
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER_START:Q42", &order));
+    TEST_ASSERT_FALSE(EspProtocol_DecodeOrder("ORDER:Q42;1,1,A;1,1,B;1,1,C;1,1,D;1,1,E;1,1,F;1,1,G;1,1,H;1,1,I", &order));
+    TEST_ASSERT_TRUE(EspProtocol_DecodeOrder("ORDER:Q42;1,1,A;1,1,B;1,1,C;1,1,D;1,1,E;1,1,F;1,1,G;1,1,H", &order));
+    TEST_ASSERT_EQUAL_UINT8(ESP_PROTO_ORDER_MAX_ITEMS, order.item_count);
+}
+
+// Mise à jour du catalogue: version, entrées (code à zéros initiaux
+// significatifs, libellé avec blancs), nombre final
+void test_esp_protocol_decode_catalog(void) {
+    EspCommand cmd;
+
+    TEST_ASSERT_EQUAL(ESP_MSG_CATALOG_BEGIN, EspProtocol_Decode("CATALOG_BEGIN:42", &cmd));
+    TEST_ASSERT_TRUE(cmd.valid);
+    TEST_ASSERT_EQUAL_UINT16(42, cmd.catalog_version);
+
+    TEST_ASSERT_EQUAL(ESP_MSG_CATALOG_ITEM, EspProtocol_Decode("CATALOG_ITEM:05,3,2,250,Cafe creme", &cmd));
+    TEST_ASSERT_TRUE(cmd.valid);
+    TEST_ASSERT_EQUAL_UINT16(5, cmd.product.code);
+    TEST_ASSERT_EQUAL_UINT8(2, cmd.product.digits);
+    TEST_ASSERT_EQUAL_UINT8(3, cmd.product.channel);
+    TEST_ASSERT_EQUAL_UINT8(2, cmd.product.sensorId);
+    TEST_ASSERT_EQUAL_UINT16(250, cmd.product.priceCents);
+    TEST_ASSERT_EQUAL_STRING("Cafe creme", cmd.product.label);
+
+    TEST_ASSERT_TRUE(EspProtocol_Decode("CATALOG_ITEM:7,0,255,0,Eau", &cmd) && cmd.valid);
+    TEST_ASSERT_EQUAL_UINT8(PRODUCT_SENSOR_NONE, cmd.product.sensorId);
+
+    TEST_ASSERT_EQUAL(ESP_MSG_CATALOG_END, EspProtocol_Decode("CATALOG_END:12", &cmd));
+    TEST_ASSERT_TRUE(cmd.valid);
+    TEST_ASSERT_EQUAL_UINT8(12, cmd.catalog_count);
+}
+
+void test_esp_protocol_decode_catalog_invalid(void) {
+    EspCommand cmd;
+    static const char* const bad[] = {
+        "CATALOG_BEGIN:",
+        "CATALOG_BEGIN:70000",
+        "CATALOG_BEGIN:3x",
+        "CATALOG_ITEM:1234,1,0,100,Trop long code",
+        "CATALOG_ITEM:,1,0,100,Sans code",
+        "CATALOG_ITEM:12,1,0,100,",
+        "CATALOG_ITEM:12,1,0,100,Libelle trop long",
+        "CATALOG_ITEM:12,256,0,100,Canal",
+        "CATALOG_ITEM:12,1,0,70000,Prix",
+        "CATALOG_ITEM:12,1,0,-5,Prix",
+        "CATALOG_ITEM:12,1,0",
+        "CATALOG_END:0",
+        "CATALOG_END:33",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        TEST_ASSERT_NOT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Decode(bad[i], &cmd));
+        TEST_ASSERT_FALSE_MESSAGE(cmd.valid, bad[i]);
+    }
+    TEST_ASSERT_EQUAL(ESP_MSG_UNKNOWN, EspProtocol_Classify("CATALOG_END"));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_esp_protocol_classify_keywords);
+    RUN_TEST(test_esp_protocol_classify_rejects_near_misses);
+    RUN_TEST(test_esp_protocol_decode_vend);
+    RUN_TEST(test_esp_protocol_decode_vend_invalid);
+    RUN_TEST(test_esp_protocol_decode_truncates_ids);
+    RUN_TEST(test_esp_protocol_decode_order_start);
+    RUN_TEST(test_esp_protocol_decode_plain_and_unknown);
+    RUN_TEST(test_esp_protocol_decode_order_batch);
+    RUN_TEST(test_esp_protocol_decode_order_batch_invalid);
+    RUN_TEST(test_esp_protocol_decode_catalog);
+    RUN_TEST(test_esp_protocol_decode_catalog_invalid);
+
+    return UNITY_END();
+}
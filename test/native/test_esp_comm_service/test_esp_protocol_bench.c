@@ -0,0 +1,179 @@
+// Microbenchmark du décodeur ESP: ancienne chaîne strncmp + sscanf contre
+// EspProtocol_Decode (un seul parcours). Affiche cycles et ns par ligne.
+#define _POSIX_C_SOURCE 199309L
+
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_protocol.h"
+
+#define BENCH_ROUNDS 20000
+
+// Trafic représentatif d'une session de vente
+static const char* const corpus[] = {
+    "NFC_UID:1A2B3C4D",
+    "ORDER_START:ORD-2024-000123",
+    "VEND 1 2 PROD_COCA_33CL",
+    "VEND 3 1 PROD_EAU_50CL",
+    "VEND 4 10 PROD_CHIPS",
+    "ORDER_END",
+    "NFC_ERR:TIMEOUT",
+    "NAK:STATE:PAYING:NO_NET",
+    "NAK:PAYMENT:DENIED",
+    "QR_TOKEN_NO_NETWORK",
+    "QR_TOKEN_INVALID",
+    "ORDER_FAILED",
+    "VEND 9 1 PROD_BAD_SLOT",
+    "STATUS:UNKNOWN_FROM_ESP",
+};
+#define CORPUS_SIZE (sizeof(corpus) / sizeof(corpus[0]))
+
+// Copie de l'ancienne implémentation (classification + re-scan sscanf)
+static EspMessageType EspComm_ClassifyMessage_Legacy(const char* line) {
+    if (!line) return ESP_MSG_UNKNOWN;
+    if (strncmp(line, "NFC_UID:", 8) == 0) return ESP_MSG_NFC_UID;
+    if (strncmp(line, "NFC_ERR:", 8) == 0) return ESP_MSG_NFC_ERR;
+    if (strncmp(line, "NAK:STATE:PAYING:NO_NET", 23) == 0) return ESP_MSG_NAK_PAYING_NO_NET;
+    if (strncmp(line, "NAK:PAYMENT:DENIED", 19) == 0) return ESP_MSG_NAK_PAYMENT_DENIED;
+    if (strncmp(line, "ORDER_START:", 12) == 0) return ESP_MSG_ORDER_START;
+    if (strncmp(line, "VEND ", 5) == 0) return ESP_MSG_VEND_COMMAND;
+    if (strcmp(line, "ORDER_END") == 0) return ESP_MSG_ORDER_END;
+    if (strcmp(line, "QR_TOKEN_ERROR") == 0) return ESP_MSG_QR_TOKEN_ERROR;
+    if (strcmp(line, "QR_TOKEN_INVALID") == 0) return ESP_MSG_QR_TOKEN_INVALID;
+    if (strcmp(line, "QR_TOKEN_BUSY") == 0) return ESP_MSG_QR_TOKEN_BUSY;
+    if (strcmp(line, "QR_TOKEN_NO_NETWORK") == 0) return ESP_MSG_QR_TOKEN_NO_NETWORK;
+    if (strcmp(line, "ORDER_FAILED") == 0) return ESP_MSG_ORDER_FAILED;
+    return ESP_MSG_UNKNOWN;
+}
+
+static EspMessageType decode_legacy(const char* line, EspCommand* cmd) {
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->type = EspComm_ClassifyMessage_Legacy(line);
+    if (cmd->type == ESP_MSG_VEND_COMMAND) {
+        int slot, qty;
+        char product[32];
+        if (sscanf(line, "VEND %d %d %31s", &slot, &qty, product) == 3 &&
+            slot >= 1 && slot <= 4 && qty >= 1 && qty <= 10) {
+            cmd->slot_number = (uint8_t)slot;
+            cmd->quantity = (uint8_t)qty;
+            strncpy(cmd->product_id, product, sizeof(cmd->product_id) - 1);
+            cmd->valid = true;
+        }
+    } else if (cmd->type == ESP_MSG_ORDER_START) {
+        cmd->valid = (sscanf(line, "ORDER_START:%31s", cmd->order_id) == 1);
+    } else if (cmd->type != ESP_MSG_UNKNOWN) {
+        cmd->valid = true;
+    }
+    return cmd->type;
+}
+
+typedef EspMessageType (*DecodeFn)(const char*, EspCommand*);
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;   // Pas de compteur de cycles portable: seul le temps est affiché
+#endif
+}
+
+typedef struct {
+    double ns_per_line;
+    double cycles_per_line;
+} BenchResult;
+
+static volatile uint32_t bench_sink;
+
+static BenchResult run_bench(DecodeFn fn) {
+    EspCommand cmd;
+    uint32_t acc = 0;
+
+    // Chauffe des caches
+    for (size_t i = 0; i < CORPUS_SIZE; i++) acc += fn(corpus[i], &cmd);
+
+    uint64_t t0 = now_ns();
+    uint64_t c0 = now_cycles();
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+        for (size_t i = 0; i < CORPUS_SIZE; i++) {
+            acc += (uint32_t)fn(corpus[i], &cmd) + cmd.slot_number;
+        }
+    }
+    uint64_t c1 = now_cycles();
+    uint64_t t1 = now_ns();
+    bench_sink = acc;
+
+    double lines = (double)BENCH_ROUNDS * (double)CORPUS_SIZE;
+    BenchResult res = {
+        .ns_per_line = (double)(t1 - t0) / lines,
+        .cycles_per_line = (double)(c1 - c0) / lines,
+    };
+    return res;
+}
+
+// Meilleur de plusieurs passes pour limiter le bruit de l'hôte
+static BenchResult best_of(DecodeFn fn, int passes) {
+    BenchResult best = run_bench(fn);
+    for (int p = 1; p < passes; p++) {
+        BenchResult r = run_bench(fn);
+        if (r.ns_per_line < best.ns_per_line) best = r;
+    }
+    return best;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// Les deux décodeurs produisent exactement le même résultat sur le corpus
+void test_esp_protocol_matches_legacy_decoder(void) {
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        EspCommand a, b;
+        decode_legacy(corpus[i], &a);
+        EspProtocol_Decode(corpus[i], &b);
+        TEST_ASSERT_EQUAL_MESSAGE(a.type, b.type, corpus[i]);
+        TEST_ASSERT_EQUAL_MESSAGE(a.valid, b.valid, corpus[i]);
+        if (a.valid) {
+            TEST_ASSERT_EQUAL_UINT8(a.slot_number, b.slot_number);
+            TEST_ASSERT_EQUAL_UINT8(a.quantity, b.quantity);
+            TEST_ASSERT_EQUAL_STRING(a.product_id, b.product_id);
+            TEST_ASSERT_EQUAL_STRING(a.order_id, b.order_id);
+        }
+    }
+}
+
+// Coût par ligne: le décodeur à table doit battre strncmp + sscanf
+void test_esp_protocol_bench_cycles_per_line(void) {
+    BenchResult legacy = best_of(decode_legacy, 3);
+    BenchResult table = best_of(EspProtocol_Decode, 3);
+
+    printf("[BENCH] legacy strncmp+sscanf : %8.1f ns/ligne  %8.1f cycles/ligne\n",
+           legacy.ns_per_line, legacy.cycles_per_line);
+    printf("[BENCH] EspProtocol_Decode    : %8.1f ns/ligne  %8.1f cycles/ligne\n",
+           table.ns_per_line, table.cycles_per_line);
+    if (table.ns_per_line > 0.0) {
+        printf("[BENCH] gain x%.1f\n", legacy.ns_per_line / table.ns_per_line);
+    }
+
+    TEST_ASSERT_TRUE(table.ns_per_line < legacy.ns_per_line);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_esp_protocol_matches_legacy_decoder);
+    RUN_TEST(test_esp_protocol_bench_cycles_per_line);
+
+    return UNITY_END();
+}
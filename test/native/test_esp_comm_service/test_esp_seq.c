@@ -0,0 +1,143 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_seq.h"
+
+static EspSeqRx rx;
+static EspSeqTx tx;
+
+static EspCommand vend(uint8_t slot) {
+    EspCommand cmd = { .type = ESP_MSG_VEND_COMMAND, .valid = true, .slot_number = slot, .quantity = 1 };
+    return cmd;
+}
+
+void setUp(void) {
+    EspSeq_RxReset(&rx);
+    EspSeq_TxReset(&tx);
+}
+
+void tearDown(void) {
+}
+
+void test_esp_seq_parse_line(void) {
+    uint8_t seq = 0;
+    const char* body = NULL;
+
+    TEST_ASSERT_EQUAL(ESP_SEQ_LINE_NONE, EspSeq_ParseLine("VEND 1 1 A", &seq, &body));
+    TEST_ASSERT_EQUAL(ESP_SEQ_LINE_DATA, EspSeq_ParseLine("#12:VEND 1 1 A", &seq, &body));
+    TEST_ASSERT_EQUAL_UINT8(12, seq);
+    TEST_ASSERT_EQUAL_STRING("VEND 1 1 A", body);
+    TEST_ASSERT_EQUAL(ESP_SEQ_LINE_ACK, EspSeq_ParseLine("#ACK:255", &seq, NULL));
+    TEST_ASSERT_EQUAL_UINT8(255, seq);
+    TEST_ASSERT_EQUAL(ESP_SEQ_LINE_NAK, EspSeq_ParseLine("#NAK:0", &seq, NULL));
+    TEST_ASSERT_EQUAL_UINT8(0, seq);
+
+    TEST_ASSERT_EQUAL(ESP_SEQ_LINE_INVALID, EspSeq_ParseLine("#256:X", &seq, &body));
+    TEST_ASSERT_EQUAL(ESP_SEQ_LINE_INVALID, EspSeq_ParseLine("#12:", &seq, &body));
+    TEST_ASSERT_EQUAL(ESP_SEQ_LINE_INVALID, EspSeq_ParseLine("#ACK:1x", &seq, NULL));
+    TEST_ASSERT_EQUAL(ESP_SEQ_LINE_INVALID, EspSeq_ParseLine("#X:1", &seq, NULL));
+}
+
+// Réception hors ordre: gardée puis livrée dans l'ordre quand le trou est comblé
+void test_esp_seq_rx_reorders(void) {
+    EspCommand c1 = vend(1), c2 = vend(2), c3 = vend(3), out;
+
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_DELIVER, EspSeq_RxAccept(&rx, 0, &c1));
+    TEST_ASSERT_FALSE(EspSeq_RxNext(&rx, &out));
+    TEST_ASSERT_EQUAL_UINT8(0, EspSeq_RxAckValue(&rx));
+
+    // Consultation sans effet: 3 n'est pas gardé par RxCheck
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_BUFFERED, EspSeq_RxCheck(&rx, 3));
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_BUFFERED, EspSeq_RxCheck(&rx, 3));
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_DUPLICATE, EspSeq_RxCheck(&rx, 0));
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_DELIVER, EspSeq_RxCheck(&rx, 1));
+
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_BUFFERED, EspSeq_RxAccept(&rx, 3, &c3));
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_BUFFERED, EspSeq_RxAccept(&rx, 2, &c2));
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_DUPLICATE, EspSeq_RxAccept(&rx, 3, &c3));
+
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_DELIVER, EspSeq_RxAccept(&rx, 1, &c1));
+    TEST_ASSERT_TRUE(EspSeq_RxNext(&rx, &out));
+    TEST_ASSERT_EQUAL_UINT8(2, out.slot_number);
+    TEST_ASSERT_TRUE(EspSeq_RxNext(&rx, &out));
+    TEST_ASSERT_EQUAL_UINT8(3, out.slot_number);
+    TEST_ASSERT_FALSE(EspSeq_RxNext(&rx, &out));
+    TEST_ASSERT_EQUAL_UINT8(3, EspSeq_RxAckValue(&rx));
+}
+
+// Doublons récents ré-acquittés, numéros lointains rejetés, passage 255 -> 0
+void test_esp_seq_rx_window_and_wrap(void) {
+    EspCommand c = vend(1), out;
+
+    rx.expected = 254;
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_DELIVER, EspSeq_RxAccept(&rx, 254, &c));
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_BUFFERED, EspSeq_RxAccept(&rx, 0, &c));
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_DELIVER, EspSeq_RxAccept(&rx, 255, &c));
+    TEST_ASSERT_TRUE(EspSeq_RxNext(&rx, &out));
+    TEST_ASSERT_EQUAL_UINT8(1, rx.expected);
+
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_DUPLICATE, EspSeq_RxAccept(&rx, 254, &c));
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_REJECTED, EspSeq_RxAccept(&rx, 1 + ESP_SEQ_WINDOW, &c));
+    TEST_ASSERT_EQUAL(ESP_SEQ_RX_REJECTED, EspSeq_RxAccept(&rx, 100, &c));
+}
+
+// Émission: fenêtre bornée, acquit cumulatif, retransmission sur NAK
+void test_esp_seq_tx_window_and_ack(void) {
+    EspResponse rsp = { .type = ESP_RSP_VEND_COMPLETED };
+    uint8_t seq;
+
+    for (uint8_t i = 0; i < ESP_SEQ_WINDOW; i++) {
+        rsp.slot = i;
+        TEST_ASSERT_TRUE(EspSeq_TxPush(&tx, &rsp, 0, &seq));
+        TEST_ASSERT_EQUAL_UINT8(i, seq);
+    }
+    TEST_ASSERT_FALSE(EspSeq_TxPush(&tx, &rsp, 0, &seq));
+
+    const EspResponse* held = EspSeq_TxGet(&tx, 5, 10);
+    TEST_ASSERT_NOT_NULL(held);
+    TEST_ASSERT_EQUAL_UINT8(5, held->slot);
+
+    TEST_ASSERT_EQUAL_UINT8(3, EspSeq_TxAck(&tx, 2));
+    TEST_ASSERT_EQUAL_UINT8(ESP_SEQ_WINDOW - 3, EspSeq_TxInFlight(&tx));
+    TEST_ASSERT_EQUAL_UINT8(0, EspSeq_TxAck(&tx, 1));          // Acquit ancien
+    TEST_ASSERT_EQUAL_UINT8(0, EspSeq_TxAck(&tx, 200));        // Jamais émis
+    TEST_ASSERT_NULL(EspSeq_TxGet(&tx, 1, 10));
+    TEST_ASSERT_TRUE(EspSeq_TxPush(&tx, &rsp, 0, &seq));
+    TEST_ASSERT_EQUAL_UINT8(ESP_SEQ_WINDOW, seq);
+}
+
+// Timeout: retransmission de la plus ancienne, abandon après le maximum d'essais
+void test_esp_seq_tx_retransmit_then_drop(void) {
+    EspResponse rsp = { .type = ESP_RSP_DELIVERY_COMPLETED }, out;
+    uint8_t seq;
+    bool dropped;
+
+    EspSeq_TxPush(&tx, &rsp, 0, &seq);
+    TEST_ASSERT_FALSE(EspSeq_TxPollRetransmit(&tx, ESP_SEQ_RTO_MS - 1, &seq, &out, &dropped));
+
+    uint32_t now = 0;
+    for (uint8_t i = 0; i < ESP_SEQ_MAX_RETRIES; i++) {
+        now += ESP_SEQ_RTO_MS;
+        TEST_ASSERT_TRUE(EspSeq_TxPollRetransmit(&tx, now, &seq, &out, &dropped));
+        TEST_ASSERT_FALSE(dropped);
+        TEST_ASSERT_EQUAL(ESP_RSP_DELIVERY_COMPLETED, out.type);
+    }
+    now += ESP_SEQ_RTO_MS;
+    TEST_ASSERT_TRUE(EspSeq_TxPollRetransmit(&tx, now, &seq, &out, &dropped));
+    TEST_ASSERT_TRUE(dropped);
+    TEST_ASSERT_EQUAL_UINT8(0, EspSeq_TxInFlight(&tx));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_esp_seq_parse_line);
+    RUN_TEST(test_esp_seq_rx_reorders);
+    RUN_TEST(test_esp_seq_rx_window_and_wrap);
+    RUN_TEST(test_esp_seq_tx_window_and_ack);
+    RUN_TEST(test_esp_seq_tx_retransmit_then_drop);
+
+    return UNITY_END();
+}
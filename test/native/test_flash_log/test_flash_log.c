@@ -0,0 +1,154 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "flash_log.h"
+
+#define TEST_ZONE_SIZE  256U
+#define TEST_MAGIC      0x54534554UL
+
+typedef struct {
+    uint8_t a[10];      // 10 octets: payload complété à 12
+} TestPayload;
+
+// Flash simulée: programmation ne fait que passer des bits à 0, effacement à 0xFF
+static uint8_t zone[TEST_ZONE_SIZE];
+static uint32_t programmedWords;
+static uint32_t failAfterWords;     // Coupure simulée: 0 = jamais
+
+static bool zone_program(uint32_t offset, const uint32_t* words, uint32_t count, void* ctx) {
+    (void)ctx;
+    TEST_ASSERT_EQUAL_UINT32(0, offset % 4U);
+    for (uint32_t i = 0; i < count; i++) {
+        if (failAfterWords != 0 && programmedWords >= failAfterWords) return false;
+        uint8_t bytes[4];
+        memcpy(bytes, &words[i], 4);
+        for (uint8_t b = 0; b < 4; b++) zone[offset + 4U * i + b] &= bytes[b];
+        programmedWords++;
+    }
+    return true;
+}
+
+static bool zone_erase(void* ctx) {
+    (void)ctx;
+    memset(zone, 0xFF, sizeof(zone));
+    return true;
+}
+
+static FlashLogConfig config(void) {
+    FlashLogConfig cfg = { .base = zone, .size = TEST_ZONE_SIZE, .magic = TEST_MAGIC,
+                           .payloadSize = sizeof(TestPayload),
+                           .program = zone_program, .erase = zone_erase };
+    return cfg;
+}
+
+static TestPayload payload(uint8_t v) {
+    TestPayload p;
+    memset(&p, v, sizeof(p));
+    return p;
+}
+
+void setUp(void) {
+    memset(zone, 0xFF, sizeof(zone));
+    programmedWords = 0;
+    failAfterWords = 0;
+}
+
+void tearDown(void) {
+}
+
+// Zone vierge: rien à relire; chaque ajout va dans l'emplacement suivant et
+// survit à un redémarrage (nouveau parcours)
+void test_flash_log_append_and_reload(void) {
+    FlashLog log;
+    FlashLogConfig cfg = config();
+    TestPayload out;
+
+    FlashLog_Init(&log, &cfg);
+    TEST_ASSERT_EQUAL_UINT32(20, log.slotSize);
+    TEST_ASSERT_FALSE(FlashLog_Read(&log, &out));
+
+    for (uint8_t v = 1; v <= 3; v++) {
+        TestPayload in = payload(v);
+        TEST_ASSERT_TRUE(FlashLog_Append(&log, &in));
+    }
+    TEST_ASSERT_EQUAL_UINT32(60, log.next);
+
+    FlashLog reloaded;
+    FlashLog_Init(&reloaded, &cfg);
+    TEST_ASSERT_EQUAL_UINT32(40, reloaded.latest);
+    TEST_ASSERT_EQUAL_UINT32(60, reloaded.next);
+    TEST_ASSERT_TRUE(FlashLog_Read(&reloaded, &out));
+    TEST_ASSERT_EQUAL_UINT8(3, out.a[9]);
+}
+
+// Écriture interrompue: emplacement ignoré au parcours, jamais reprogrammé,
+// l'enregistrement précédent fait foi
+void test_flash_log_torn_write_skipped(void) {
+    FlashLog log;
+    FlashLogConfig cfg = config();
+    TestPayload in = payload(7), out;
+
+    FlashLog_Init(&log, &cfg);
+    TEST_ASSERT_TRUE(FlashLog_Append(&log, &in));
+    failAfterWords = programmedWords + 2;
+    in = payload(8);
+    TEST_ASSERT_FALSE(FlashLog_Append(&log, &in));
+    TEST_ASSERT_EQUAL_UINT32(1, log.errors);
+
+    FlashLog_Init(&log, &cfg);
+    TEST_ASSERT_TRUE(FlashLog_Read(&log, &out));
+    TEST_ASSERT_EQUAL_UINT8(7, out.a[0]);
+    TEST_ASSERT_EQUAL_UINT32(40, log.next);
+
+    failAfterWords = 0;
+    in = payload(9);
+    TEST_ASSERT_TRUE(FlashLog_Append(&log, &in));
+    TEST_ASSERT_EQUAL_UINT32(40, log.latest);
+}
+
+// Zone pleine: un seul effacement, puis reprise au début
+void test_flash_log_erases_when_full(void) {
+    FlashLog log;
+    FlashLogConfig cfg = config();
+    TestPayload in, out;
+    uint32_t slots = TEST_ZONE_SIZE / 20U;
+
+    FlashLog_Init(&log, &cfg);
+    for (uint32_t i = 0; i <= slots; i++) {
+        in = payload((uint8_t)(i + 1));
+        TEST_ASSERT_TRUE(FlashLog_Append(&log, &in));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, log.erases);
+    TEST_ASSERT_EQUAL_UINT32(0, log.latest);
+
+    FlashLog_Init(&log, &cfg);
+    TEST_ASSERT_TRUE(FlashLog_Read(&log, &out));
+    TEST_ASSERT_EQUAL_UINT8(slots + 1, out.a[0]);
+}
+
+// Autre format (magic différent): l'existant est ignoré
+void test_flash_log_magic_mismatch(void) {
+    FlashLog log;
+    FlashLogConfig cfg = config();
+    TestPayload in = payload(1), out;
+
+    FlashLog_Init(&log, &cfg);
+    TEST_ASSERT_TRUE(FlashLog_Append(&log, &in));
+    cfg.magic = TEST_MAGIC + 1U;
+    FlashLog_Init(&log, &cfg);
+    TEST_ASSERT_FALSE(FlashLog_Read(&log, &out));
+    TEST_ASSERT_EQUAL_UINT32(20, log.next);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_flash_log_append_and_reload);
+    RUN_TEST(test_flash_log_torn_write_skipped);
+    RUN_TEST(test_flash_log_erases_when_full);
+    RUN_TEST(test_flash_log_magic_mismatch);
+
+    return UNITY_END();
+}
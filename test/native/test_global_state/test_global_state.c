@@ -13,8 +13,8 @@ extern osMutexId_t keypadChoiceMutex;
 
 // Variables globales (définies dans global.c)
 extern volatile MachineState machine_interaction;
-extern volatile char keypad_choice[3];
-extern volatile uint8_t client_order;
+extern volatile char keypad_choice[KEYPAD_CHOICE_SIZE];
+extern volatile uint16_t client_order;
 
 // ============================================================================
 // TESTS SETUP ET TEARDOWN
@@ -96,7 +96,7 @@ void test_keypad_choice_get_set(void) {
     GlobalState_SetKeypadChoice("12345");  // Plus long que le buffer
     result = GlobalState_GetKeypadChoice(buffer, sizeof(buffer));
     TEST_ASSERT_TRUE(result);
-    TEST_ASSERT_EQUAL_STRING("12", buffer);  // Tronqué à la taille du buffer interne
+    TEST_ASSERT_EQUAL_STRING("123", buffer);  // Tronqué à la taille du buffer interne
 }
 
 void test_keypad_choice_parameter_validation(void) {
@@ -138,7 +138,7 @@ void test_keypad_choice_without_mutex(void) {
 
 void test_client_order_get_set(void) {
     // Test lecture ordre initial
-    uint8_t order = GlobalState_GetClientOrder();
+    uint16_t order = GlobalState_GetClientOrder();
     TEST_ASSERT_EQUAL_UINT8(0, order);
     
     // Test écriture et lecture
@@ -146,10 +146,10 @@ void test_client_order_get_set(void) {
     order = GlobalState_GetClientOrder();
     TEST_ASSERT_EQUAL_UINT8(12, order);
     
-    // Test valeurs limites
-    GlobalState_SetClientOrder(255);
+    // Test valeurs limites (codes jusqu'à 3 chiffres)
+    GlobalState_SetClientOrder(999);
     order = GlobalState_GetClientOrder();
-    TEST_ASSERT_EQUAL_UINT8(255, order);
+    TEST_ASSERT_EQUAL_UINT16(999, order);
     
     GlobalState_SetClientOrder(0);
     order = GlobalState_GetClientOrder();
@@ -161,7 +161,7 @@ void test_client_order_without_mutex(void) {
     globalStateMutex = NULL;
     
     GlobalState_SetClientOrder(42);
-    uint8_t order = GlobalState_GetClientOrder();
+    uint16_t order = GlobalState_GetClientOrder();
     TEST_ASSERT_EQUAL_UINT8(42, order);
 }
 
@@ -0,0 +1,113 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gpio_port.h"
+
+#define MUX_MASK  (GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3)
+
+void setUp(void) {
+    Mock_HAL_Reset();
+}
+
+void tearDown(void) {
+}
+
+void test_gpio_port_bsrr_word(void) {
+    TEST_ASSERT_EQUAL_HEX32(0x000A0005UL, GpioPort_Bsrr(MUX_MASK, 0x0005));
+    // Broches hors masque jamais touchées
+    TEST_ASSERT_EQUAL_HEX32(0x00010000UL, GpioPort_Bsrr(GPIO_PIN_0, 0xFFFE));
+    TEST_ASSERT_EQUAL_HEX32(0, GpioPort_Bsrr(0, 0xFFFF));
+}
+
+// Canal 7 -> 8 du multiplexeur: les 4 bits changent, une seule écriture,
+// aucune adresse intermédiaire
+void test_gpio_port_mux_switch_glitch_free(void) {
+    uint16_t seen[8];
+    HAL_GPIO_WritePin(GPIOC, GPIO_PIN_7, GPIO_PIN_SET);
+    GpioPort_Write(GPIOC, MUX_MASK, 7);
+    Mock_HAL_ClearGpioTrace();
+
+    GpioPort_Write(GPIOC, MUX_MASK, 8);
+
+    TEST_ASSERT_EQUAL_UINT32(1, Mock_HAL_GetGpioPortWriteCount());
+    TEST_ASSERT_EQUAL_UINT8(2, Mock_HAL_GetGpioTransitions(GPIOC, MUX_MASK, seen, 8));
+    TEST_ASSERT_EQUAL_HEX16(7, seen[0]);
+    TEST_ASSERT_EQUAL_HEX16(8, seen[1]);
+    TEST_ASSERT_EQUAL_HEX16(GPIO_PIN_7 | 8, Mock_HAL_GetGpioOutput(GPIOC));
+}
+
+// Référence: broche par broche, le mock voit passer les adresses parasites
+void test_gpio_port_pin_writes_glitch(void) {
+    uint16_t seen[8];
+    GpioPort_Write(GPIOC, MUX_MASK, 7);
+    Mock_HAL_ClearGpioTrace();
+
+    for (uint8_t i = 0; i < 4; i++) {
+        HAL_GPIO_WritePin(GPIOC, (uint16_t)(1U << i), ((8 >> i) & 1) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    }
+
+    uint8_t n = Mock_HAL_GetGpioTransitions(GPIOC, MUX_MASK, seen, 8);
+    TEST_ASSERT_EQUAL_UINT8(5, n);
+    TEST_ASSERT_EQUAL_HEX16(6, seen[1]);
+    TEST_ASSERT_EQUAL_HEX16(8, seen[n - 1]);
+}
+
+// Lot: fusion par port (dernière valeur gagnante), une écriture par port,
+// ports écrits dans l'ordre d'apparition
+void test_gpio_port_batch_one_write_per_port(void) {
+    GpioPortBatch b;
+    GpioPortBatch_Init(&b);
+    TEST_ASSERT_TRUE(GpioPortBatch_Put(&b, GPIOA, GPIO_PIN_8 | GPIO_PIN_9, GPIO_PIN_8 | GPIO_PIN_9));
+    TEST_ASSERT_TRUE(GpioPortBatch_Put(&b, GPIOC, GPIO_PIN_7, GPIO_PIN_7));
+    TEST_ASSERT_TRUE(GpioPortBatch_Put(&b, GPIOB, GPIO_PIN_6, 0));
+    TEST_ASSERT_TRUE(GpioPortBatch_Put(&b, GPIOA, GPIO_PIN_9, 0));
+    TEST_ASSERT_EQUAL_UINT8(3, b.count);
+    TEST_ASSERT_EQUAL_PTR(GPIOB, b.ops[2].port);
+
+    HAL_GPIO_WritePin(GPIOB, GPIO_PIN_6 | GPIO_PIN_2, GPIO_PIN_SET);
+    Mock_HAL_ClearGpioTrace();
+    GpioPortBatch_Apply(&b);
+
+    TEST_ASSERT_EQUAL_UINT32(3, Mock_HAL_GetGpioPortWriteCount());
+    TEST_ASSERT_EQUAL_HEX16(GPIO_PIN_8, Mock_HAL_GetGpioOutput(GPIOA));
+    TEST_ASSERT_EQUAL_HEX16(GPIO_PIN_2, Mock_HAL_GetGpioOutput(GPIOB));
+    TEST_ASSERT_EQUAL_HEX16(GPIO_PIN_7, Mock_HAL_GetGpioOutput(GPIOC));
+}
+
+void test_gpio_port_batch_full(void) {
+    static GPIO_TypeDef extra[2];
+    GpioPortBatch b;
+    GpioPortBatch_Init(&b);
+    TEST_ASSERT_TRUE(GpioPortBatch_Put(&b, GPIOA, GPIO_PIN_0, 0));
+    TEST_ASSERT_TRUE(GpioPortBatch_Put(&b, GPIOB, GPIO_PIN_0, 0));
+    TEST_ASSERT_TRUE(GpioPortBatch_Put(&b, GPIOC, GPIO_PIN_0, 0));
+    TEST_ASSERT_TRUE(GpioPortBatch_Put(&b, &extra[0], GPIO_PIN_0, 0));
+    TEST_ASSERT_FALSE(GpioPortBatch_Put(&b, &extra[1], GPIO_PIN_0, 0));
+    // Port déjà présent: fusion toujours possible
+    TEST_ASSERT_TRUE(GpioPortBatch_Put(&b, GPIOB, GPIO_PIN_1, GPIO_PIN_1));
+}
+
+// Lecture: un accès IDR pour toutes les broches du port
+void test_gpio_port_read_idr(void) {
+    Mock_HAL_SetGpioPin(GPIOB, GPIO_PIN_4, GPIO_PIN_SET);
+    Mock_HAL_SetGpioPin(GPIOB, GPIO_PIN_5, GPIO_PIN_SET);
+    Mock_HAL_ClearGpioTrace();
+
+    uint16_t idr = GpioPort_ReadIdr(GPIOB);
+    TEST_ASSERT_EQUAL_HEX16(GPIO_PIN_4 | GPIO_PIN_5, idr & (GPIO_PIN_4 | GPIO_PIN_5));
+    TEST_ASSERT_EQUAL_UINT32(1, Mock_HAL_GetGpioPortReadCount());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_gpio_port_bsrr_word);
+    RUN_TEST(test_gpio_port_mux_switch_glitch_free);
+    RUN_TEST(test_gpio_port_pin_writes_glitch);
+    RUN_TEST(test_gpio_port_batch_one_write_per_port);
+    RUN_TEST(test_gpio_port_batch_full);
+    RUN_TEST(test_gpio_port_read_idr);
+
+    return UNITY_END();
+}
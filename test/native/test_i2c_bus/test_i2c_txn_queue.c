@@ -0,0 +1,150 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "i2c_txn_queue.h"
+
+static I2cTxnQueue q;
+static uint8_t rxBuf[4];
+
+static I2cTxn write_txn(uint16_t addr8, uint8_t tag) {
+    I2cTxn t = { .addr8 = addr8, .op = I2C_TXN_WRITE, .txLen = 1 };
+    t.tx[0] = tag;
+    return t;
+}
+
+static uint8_t pop_tag(void) {
+    I2cTxn t;
+    TEST_ASSERT_TRUE(I2cTxnQueue_Pop(&q, &t));
+    return t.tx[0];
+}
+
+void setUp(void) {
+    I2cTxnQueue_Init(&q);
+}
+
+void tearDown(void) {
+}
+
+// FIFO dans une priorité, octets copiés à la mise en file
+void test_i2c_txn_queue_fifo(void) {
+    I2cTxn t = write_txn(0x4E, 1);
+    TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_NORMAL));
+    t.tx[0] = 2;
+    TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_NORMAL));
+    t.tx[0] = 99;       // Tampon de l'émetteur réutilisé
+    TEST_ASSERT_EQUAL_UINT8(2, I2cTxnQueue_Count(&q));
+
+    TEST_ASSERT_EQUAL_UINT8(1, pop_tag());
+    TEST_ASSERT_EQUAL_UINT8(2, pop_tag());
+    TEST_ASSERT_FALSE(I2cTxnQueue_Pop(&q, &t));
+}
+
+// Haute priorité devant, sans dépasser I2C_TXN_HIGH_STREAK d'affilée
+// quand une normale attend
+void test_i2c_txn_queue_priority_no_starvation(void) {
+    for (uint8_t i = 0; i < 2; i++) {
+        I2cTxn t = write_txn(0x4E, (uint8_t)(100 + i));
+        TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_NORMAL));
+    }
+    for (uint8_t i = 0; i < I2C_TXN_QUEUE_DEPTH; i++) {
+        I2cTxn t = write_txn(0x52, i);
+        TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_HIGH));
+    }
+
+    for (uint8_t i = 0; i < I2C_TXN_HIGH_STREAK; i++) TEST_ASSERT_EQUAL_UINT8(i, pop_tag());
+    TEST_ASSERT_EQUAL_UINT8(100, pop_tag());
+    for (uint8_t i = 0; i < I2C_TXN_HIGH_STREAK; i++) {
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)(I2C_TXN_HIGH_STREAK + i), pop_tag());
+    }
+    TEST_ASSERT_EQUAL_UINT8(101, pop_tag());
+    TEST_ASSERT_EQUAL_UINT8(0, I2cTxnQueue_Count(&q));
+}
+
+// Hautes seules: pas de limite, la série ne compte que l'attente d'une normale
+void test_i2c_txn_queue_streak_only_when_waiting(void) {
+    for (uint8_t i = 0; i < 6; i++) {
+        I2cTxn t = write_txn(0x52, i);
+        TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_HIGH));
+    }
+    for (uint8_t i = 0; i < 5; i++) TEST_ASSERT_EQUAL_UINT8(i, pop_tag());
+
+    // Une normale arrive: elle attend encore I2C_TXN_HIGH_STREAK hautes au plus
+    I2cTxn n = write_txn(0x4E, 100);
+    TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &n, I2C_PRIO_NORMAL));
+    for (uint8_t i = 0; i < 3; i++) {
+        I2cTxn t = write_txn(0x52, (uint8_t)(10 + i));
+        TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_HIGH));
+    }
+    TEST_ASSERT_EQUAL_UINT8(5, pop_tag());
+    TEST_ASSERT_EQUAL_UINT8(10, pop_tag());
+    TEST_ASSERT_EQUAL_UINT8(11, pop_tag());
+    TEST_ASSERT_EQUAL_UINT8(12, pop_tag());
+    TEST_ASSERT_EQUAL_UINT8(100, pop_tag());
+}
+
+// File pleine par priorité, transactions invalides refusées
+void test_i2c_txn_queue_rejects(void) {
+    I2cTxn t = write_txn(0x4E, 0);
+    for (uint8_t i = 0; i < I2C_TXN_QUEUE_DEPTH; i++) {
+        TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_NORMAL));
+    }
+    TEST_ASSERT_FALSE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_NORMAL));
+    TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_HIGH));
+    TEST_ASSERT_EQUAL_UINT8(I2C_TXN_QUEUE_DEPTH + 1, q.highWater);
+    TEST_ASSERT_FALSE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_COUNT));
+
+    setUp();
+    I2cTxn empty = { .addr8 = 0x52, .op = I2C_TXN_WRITE, .txLen = 0 };
+    TEST_ASSERT_FALSE(I2cTxnQueue_Push(&q, &empty, I2C_PRIO_HIGH));
+    I2cTxn tooLong = { .addr8 = 0x52, .op = I2C_TXN_WRITE, .txLen = I2C_TXN_TX_MAX + 1 };
+    TEST_ASSERT_FALSE(I2cTxnQueue_Push(&q, &tooLong, I2C_PRIO_HIGH));
+    I2cTxn noBuf = { .addr8 = 0x52, .op = I2C_TXN_WRITE_READ, .txLen = 2, .rxLen = 1 };
+    TEST_ASSERT_FALSE(I2cTxnQueue_Push(&q, &noBuf, I2C_PRIO_HIGH));
+    I2cTxn badOp = { .addr8 = 0x52, .op = 7, .txLen = 1 };
+    TEST_ASSERT_FALSE(I2cTxnQueue_Push(&q, &badOp, I2C_PRIO_HIGH));
+    I2cTxn badMemAddr = { .addr8 = 0x52, .op = I2C_TXN_MEM_READ, .memAddrSize = 3, .rx = rxBuf, .rxLen = 1 };
+    TEST_ASSERT_FALSE(I2cTxnQueue_Push(&q, &badMemAddr, I2C_PRIO_HIGH));
+    I2cTxn memNoData = { .addr8 = 0x52, .op = I2C_TXN_MEM_WRITE, .memAddrSize = 2, .txLen = 0 };
+    TEST_ASSERT_FALSE(I2cTxnQueue_Push(&q, &memNoData, I2C_PRIO_HIGH));
+    TEST_ASSERT_EQUAL_UINT32(6, q.rejected);
+
+    I2cTxn memRead = { .addr8 = 0x52, .op = I2C_TXN_MEM_READ, .memAddrSize = 2, .memAddr = 0x04D,
+                       .rx = rxBuf, .rxLen = sizeof(rxBuf) };
+    TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &memRead, I2C_PRIO_HIGH));
+    I2cTxn memOut;
+    TEST_ASSERT_TRUE(I2cTxnQueue_Pop(&q, &memOut));
+    TEST_ASSERT_EQUAL_HEX16(0x04D, memOut.memAddr);
+
+    I2cTxn read = { .addr8 = 0x52, .op = I2C_TXN_WRITE_READ, .txLen = 2, .rx = rxBuf, .rxLen = 1 };
+    TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &read, I2C_PRIO_HIGH));
+    I2cTxn out;
+    TEST_ASSERT_TRUE(I2cTxnQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL_PTR(rxBuf, out.rx);
+}
+
+// Rebouclage de l'anneau
+void test_i2c_txn_queue_wraps(void) {
+    for (uint8_t round = 0; round < 3; round++) {
+        for (uint8_t i = 0; i < I2C_TXN_QUEUE_DEPTH - 1; i++) {
+            I2cTxn t = write_txn(0x4E, (uint8_t)(round * 10 + i));
+            TEST_ASSERT_TRUE(I2cTxnQueue_Push(&q, &t, I2C_PRIO_NORMAL));
+        }
+        for (uint8_t i = 0; i < I2C_TXN_QUEUE_DEPTH - 1; i++) {
+            TEST_ASSERT_EQUAL_UINT8((uint8_t)(round * 10 + i), pop_tag());
+        }
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_i2c_txn_queue_fifo);
+    RUN_TEST(test_i2c_txn_queue_priority_no_starvation);
+    RUN_TEST(test_i2c_txn_queue_streak_only_when_waiting);
+    RUN_TEST(test_i2c_txn_queue_rejects);
+    RUN_TEST(test_i2c_txn_queue_wraps);
+
+    return UNITY_END();
+}
@@ -0,0 +1,92 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "motor_calib.h"
+
+static MotorCalibRecord rec;
+
+static bool observe(uint8_t requested, uint8_t delivered, uint32_t unitMs, uint32_t deadlineMs) {
+    MotorCalibSample s = { .requested = requested, .delivered = delivered,
+                           .sumMs = unitMs * delivered, .deadlineMs = deadlineMs };
+    return MotorCalib_Observe(&rec, &s);
+}
+
+void setUp(void) {
+    MotorCalib_Default(&rec, 2000, 20);
+}
+
+void tearDown(void) {
+}
+
+// Canal rapide: la durée descend par pas bornés vers moyenne + marge
+void test_motor_calib_fast_channel_converges_down(void) {
+    TEST_ASSERT_TRUE(observe(2, 2, 400, 2000));
+    TEST_ASSERT_EQUAL_UINT16(400, rec.avgDispenseMs);
+    TEST_ASSERT_EQUAL_UINT16(1750, rec.onTimeMs);      // -1/8 au plus
+
+    for (uint8_t i = 0; i < 20; i++) observe(1, 1, 400, rec.onTimeMs);
+    TEST_ASSERT_EQUAL_UINT16(600, rec.onTimeMs);
+    TEST_ASSERT_FALSE(observe(1, 1, 400, rec.onTimeMs));
+    TEST_ASSERT_EQUAL_UINT8(100, MotorCalib_SuccessPct(&rec));
+}
+
+// Canal lent: unité manquée, hausse immédiate; le délai censuré tire la moyenne
+void test_motor_calib_missed_unit_raises(void) {
+    MotorCalib_Default(&rec, 600, 20);
+    rec.avgDispenseMs = 400;
+
+    TEST_ASSERT_TRUE(observe(3, 1, 500, 600));
+    TEST_ASSERT_EQUAL_UINT16(750, rec.onTimeMs);       // max(437 * 1,5, 600 + 1/4)
+    TEST_ASSERT_EQUAL_UINT16(437, rec.avgDispenseMs);
+    TEST_ASSERT_EQUAL_UINT16(3, rec.attempts);
+    TEST_ASSERT_EQUAL_UINT16(1, rec.successes);
+    TEST_ASSERT_EQUAL_UINT8(33, MotorCalib_SuccessPct(&rec));
+    TEST_ASSERT_EQUAL_UINT16(1, rec.adjustments);
+}
+
+// Bornes de la durée, taux sur fenêtre glissante
+void test_motor_calib_bounds_and_window(void) {
+    for (uint8_t i = 0; i < 40; i++) observe(1, 0, 0, rec.onTimeMs);
+    TEST_ASSERT_EQUAL_UINT16(MOTOR_CALIB_MAX_ON_MS, rec.onTimeMs);
+
+    for (uint16_t i = 0; i < 1000; i++) observe(1, 1, 10, rec.onTimeMs);
+    TEST_ASSERT_EQUAL_UINT16(MOTOR_CALIB_MIN_ON_MS, rec.onTimeMs);
+    TEST_ASSERT_TRUE(rec.attempts <= MOTOR_CALIB_RATE_WINDOW);
+    TEST_ASSERT_TRUE(rec.attempts - rec.successes <= 1);
+}
+
+// Enregistrement relu incohérent ramené dans ses bornes
+void test_motor_calib_sanitize(void) {
+    TEST_ASSERT_TRUE(MotorCalib_Sanitize(&rec));
+    rec.onTimeMs = 0xFFFF;
+    rec.successes = 9;
+    rec.attempts = 4;
+    TEST_ASSERT_FALSE(MotorCalib_Sanitize(&rec));
+    TEST_ASSERT_EQUAL_UINT16(MOTOR_CALIB_MAX_ON_MS, rec.onTimeMs);
+    TEST_ASSERT_EQUAL_UINT16(4, rec.successes);
+}
+
+void test_motor_calib_format(void) {
+    char line[40];
+    rec.avgDispenseMs = 410;
+    rec.successes = 57;
+    rec.attempts = 60;
+    TEST_ASSERT_EQUAL(23, MotorCalib_Format(3, &rec, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("CAL:3:2000:20:410:57/60", line);
+    TEST_ASSERT_EQUAL(0, MotorCalib_Format(3, &rec, line, 10));
+    TEST_ASSERT_EQUAL_STRING("", line);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_motor_calib_fast_channel_converges_down);
+    RUN_TEST(test_motor_calib_missed_unit_raises);
+    RUN_TEST(test_motor_calib_bounds_and_window);
+    RUN_TEST(test_motor_calib_sanitize);
+    RUN_TEST(test_motor_calib_format);
+
+    return UNITY_END();
+}
@@ -0,0 +1,139 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "motor_drop.h"
+
+#define TEST_BLANK_MS  20U
+#define TEST_MAX_MS    2000U
+#define TEST_GAP_MS    60U
+
+static MotorDropWatch w;
+static MotorDropStats stats;
+
+static MotorDropSpec spec(uint8_t target) {
+    MotorDropSpec s = { .blankMs = TEST_BLANK_MS, .nominalMs = 700, .maxMs = TEST_MAX_MS,
+                        .minGapMs = TEST_GAP_MS, .target = target };
+    return s;
+}
+
+void setUp(void) {
+    memset(&w, 0, sizeof(w));
+    memset(&stats, 0, sizeof(stats));
+}
+
+void tearDown(void) {
+}
+
+// Une unité: première détection retenue, délai depuis l'armement, rebond ignoré
+void test_motor_drop_detected(void) {
+    MotorDropSpec s = spec(1);
+    MotorDrop_Start(&w, &s, 1000);
+    TEST_ASSERT_EQUAL(MOTOR_DROP_WAITING, w.state);
+
+    TEST_ASSERT_TRUE(MotorDrop_Detect(&w, 1420));
+    TEST_ASSERT_FALSE(MotorDrop_Detect(&w, 1430));
+    TEST_ASSERT_EQUAL_UINT32(400, w.detectMs);
+    TEST_ASSERT_EQUAL_UINT8(1, w.count);
+    TEST_ASSERT_EQUAL(MOTOR_DROP_DETECTED, MotorDrop_Finish(&w));
+}
+
+// Masquage pendant l'attente du multiplexeur, échéance à maxMs après l'armement
+void test_motor_drop_window(void) {
+    MotorDropSpec s = spec(1);
+    MotorDrop_Start(&w, &s, 1000);
+    TEST_ASSERT_EQUAL_UINT32(1020 + TEST_MAX_MS, MotorDrop_DeadlineMs(&w));
+    TEST_ASSERT_FALSE(MotorDrop_Detect(&w, 1019));
+    TEST_ASSERT_FALSE(MotorDrop_Detect(&w, 1020 + TEST_MAX_MS + 1));
+    TEST_ASSERT_EQUAL(MOTOR_DROP_WAITING, w.state);
+    TEST_ASSERT_TRUE(MotorDrop_Detect(&w, 1020 + TEST_MAX_MS));
+}
+
+// Marche continue: chaque unité relance l'échéance, arrêt exact à la cible,
+// produit vu deux fois à moins de minGapMs compté une seule fois
+void test_motor_drop_counts_units(void) {
+    MotorDropSpec s = spec(3);
+    MotorDrop_Start(&w, &s, 0);
+
+    TEST_ASSERT_TRUE(MotorDrop_Detect(&w, 500));
+    TEST_ASSERT_FALSE(MotorDrop_Detect(&w, 500 + TEST_GAP_MS - 1));
+    TEST_ASSERT_EQUAL_UINT32(500 + TEST_MAX_MS, MotorDrop_DeadlineMs(&w));
+    TEST_ASSERT_TRUE(MotorDrop_Detect(&w, 1300));
+    TEST_ASSERT_EQUAL(MOTOR_DROP_WAITING, w.state);
+    TEST_ASSERT_TRUE(MotorDrop_Detect(&w, 3200));
+    TEST_ASSERT_EQUAL(MOTOR_DROP_DETECTED, w.state);
+    TEST_ASSERT_EQUAL_UINT8(3, w.count);
+
+    // Cible atteinte: plus rien n'est compté
+    TEST_ASSERT_FALSE(MotorDrop_Detect(&w, 3400));
+    TEST_ASSERT_EQUAL_UINT8(3, w.count);
+    TEST_ASSERT_EQUAL_UINT32(1900, w.longestMs);
+    TEST_ASSERT_EQUAL_UINT8(2, w.extended);
+}
+
+// Colonne vidée en cours de route: TIMEOUT avec le compte partiel
+void test_motor_drop_partial_timeout(void) {
+    MotorDropSpec s = spec(5);
+    MotorDrop_Start(&w, &s, 0);
+    TEST_ASSERT_TRUE(MotorDrop_Detect(&w, 400));
+    TEST_ASSERT_TRUE(MotorDrop_Detect(&w, 900));
+    TEST_ASSERT_FALSE(MotorDrop_Detect(&w, 900 + TEST_MAX_MS + 1));
+
+    TEST_ASSERT_EQUAL(MOTOR_DROP_TIMEOUT, MotorDrop_Finish(&w));
+    TEST_ASSERT_EQUAL_UINT8(2, w.count);
+    TEST_ASSERT_FALSE(MotorDrop_Detect(&w, 1000));
+
+    // Hors job: aucune détection
+    MotorDropWatch idle;
+    memset(&idle, 0, sizeof(idle));
+    TEST_ASSERT_FALSE(MotorDrop_Detect(&idle, 100));
+}
+
+// Fenêtre à cheval sur le rebouclage du tick
+void test_motor_drop_tick_wraparound(void) {
+    MotorDropSpec s = spec(2);
+    MotorDrop_Start(&w, &s, 0xFFFFFF00UL);
+    TEST_ASSERT_FALSE(MotorDrop_Detect(&w, 0xFFFFFF10UL));
+    TEST_ASSERT_TRUE(MotorDrop_Detect(&w, 0x00000100UL));
+    TEST_ASSERT_EQUAL_UINT32(0x100 + 0x100 - TEST_BLANK_MS, w.detectMs);
+    TEST_ASSERT_EQUAL_UINT32(0x100 + TEST_MAX_MS, MotorDrop_DeadlineMs(&w));
+    TEST_ASSERT_TRUE(MotorDrop_Detect(&w, 0x00000300UL));
+    TEST_ASSERT_EQUAL(MOTOR_DROP_DETECTED, w.state);
+}
+
+// Bilan: unités comptées, jobs incomplets, moyenne par unité
+void test_motor_drop_stats(void) {
+    MotorDropSpec s = spec(3);
+    s.blankMs = 0;
+    MotorDrop_Start(&w, &s, 0);
+    MotorDrop_Detect(&w, 300);
+    MotorDrop_Detect(&w, 800);
+    MotorDrop_Detect(&w, 1700);
+    MotorDrop_Finish(&w);
+    MotorDrop_Record(&stats, &w);
+
+    MotorDrop_Start(&w, &s, 5000);
+    MotorDrop_Detect(&w, 5600);
+    MotorDrop_Finish(&w);
+    MotorDrop_Record(&stats, &w);
+
+    TEST_ASSERT_EQUAL_UINT32(4, stats.detected);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.extended);
+    TEST_ASSERT_EQUAL_UINT32(900, stats.maxDetectMs);
+    TEST_ASSERT_EQUAL_UINT32(575, MotorDrop_AverageMs(&stats));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_motor_drop_detected);
+    RUN_TEST(test_motor_drop_window);
+    RUN_TEST(test_motor_drop_counts_units);
+    RUN_TEST(test_motor_drop_partial_timeout);
+    RUN_TEST(test_motor_drop_tick_wraparound);
+    RUN_TEST(test_motor_drop_stats);
+
+    return UNITY_END();
+}
@@ -0,0 +1,98 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "motor_job_queue.h"
+
+static MotorJobQueue q;
+static uint8_t doneCount;
+static MotorJobId lastDoneId;
+static MotorJobStatus lastStatus;
+
+static uint8_t lastDelivered;
+
+static void on_done(MotorJobId id, uint8_t channel, MotorJobStatus status, uint8_t delivered, void* ctx) {
+    (void)channel;
+    (void)ctx;
+    doneCount++;
+    lastDoneId = id;
+    lastStatus = status;
+    lastDelivered = delivered;
+}
+
+void setUp(void) {
+    MotorJobQueue_Init(&q);
+    doneCount = 0;
+    lastDoneId = MOTOR_JOB_ID_NONE;
+}
+
+void tearDown(void) {
+}
+
+// Ids en séquence, jobs servis dans l'ordre de soumission avec leur contexte
+void test_motor_jobs_fifo_with_ids(void) {
+    static int ctxA, ctxB;
+    MotorJob job;
+
+    MotorJobId a = MotorJobQueue_Push(&q, 1, 2, 700, on_done, &ctxA);
+    MotorJobId b = MotorJobQueue_Push(&q, 3, 1, 450, NULL, &ctxB);
+    TEST_ASSERT_EQUAL_UINT16(1, a);
+    TEST_ASSERT_EQUAL_UINT16(2, b);
+    TEST_ASSERT_EQUAL_UINT8(2, MotorJobQueue_Count(&q));
+
+    TEST_ASSERT_TRUE(MotorJobQueue_Pop(&q, &job));
+    TEST_ASSERT_EQUAL_UINT16(a, job.id);
+    TEST_ASSERT_EQUAL_UINT8(1, job.channel);
+    TEST_ASSERT_EQUAL_UINT8(2, job.quantity);
+    TEST_ASSERT_EQUAL_UINT16(700, job.onTimeMs);
+    TEST_ASSERT_EQUAL_PTR(&ctxA, job.ctx);
+    job.done(job.id, job.channel, MOTOR_JOB_DONE, job.quantity, job.ctx);
+    TEST_ASSERT_EQUAL_UINT16(a, lastDoneId);
+    TEST_ASSERT_EQUAL(MOTOR_JOB_DONE, lastStatus);
+    TEST_ASSERT_EQUAL_UINT8(2, lastDelivered);
+
+    TEST_ASSERT_TRUE(MotorJobQueue_Pop(&q, &job));
+    TEST_ASSERT_EQUAL_UINT16(b, job.id);
+    TEST_ASSERT_NULL(job.done);
+    TEST_ASSERT_FALSE(MotorJobQueue_Pop(&q, &job));
+}
+
+// File pleine: refus compté, place rendue au premier retrait
+void test_motor_jobs_bounded(void) {
+    MotorJob job;
+    for (uint8_t i = 0; i < MOTOR_JOB_QUEUE_DEPTH; i++) {
+        TEST_ASSERT_NOT_EQUAL(MOTOR_JOB_ID_NONE, MotorJobQueue_Push(&q, i, 1, 100, on_done, NULL));
+    }
+    TEST_ASSERT_EQUAL_UINT16(MOTOR_JOB_ID_NONE, MotorJobQueue_Push(&q, 0, 1, 100, on_done, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, q.rejected);
+    TEST_ASSERT_EQUAL_UINT8(MOTOR_JOB_QUEUE_DEPTH, q.highWater);
+
+    TEST_ASSERT_TRUE(MotorJobQueue_Pop(&q, &job));
+    TEST_ASSERT_EQUAL_UINT8(0, job.channel);
+    TEST_ASSERT_EQUAL_UINT16(MOTOR_JOB_QUEUE_DEPTH + 1, MotorJobQueue_Push(&q, 9, 1, 100, on_done, NULL));
+}
+
+// Rebouclage des ids: 0 jamais attribué, ordre relatif préservé
+void test_motor_jobs_id_wraparound(void) {
+    static MotorJobQueue zq;    // Zéro: file vide valide sans Init
+    zq.lastId = 0xFFFEU;
+
+    MotorJobId a = MotorJobQueue_Push(&zq, 1, 1, 100, NULL, NULL);
+    MotorJobId b = MotorJobQueue_Push(&zq, 1, 1, 100, NULL, NULL);
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, a);
+    TEST_ASSERT_EQUAL_HEX16(0x0001, b);
+    TEST_ASSERT_TRUE(MotorJobQueue_IdBefore(a, b));
+    TEST_ASSERT_FALSE(MotorJobQueue_IdBefore(b, a));
+    TEST_ASSERT_FALSE(MotorJobQueue_IdBefore(b, b));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_motor_jobs_fifo_with_ids);
+    RUN_TEST(test_motor_jobs_bounded);
+    RUN_TEST(test_motor_jobs_id_wraparound);
+
+    return UNITY_END();
+}
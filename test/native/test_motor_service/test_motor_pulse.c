@@ -0,0 +1,157 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "motor_pulse.h"
+
+#define TEST_TIMER_HZ  84000000U    // TIM3: APB1 42 MHz x2
+#define TEST_TPU       (TEST_TIMER_HZ / 1000000U)
+
+// Timer simulé période par période: PWM mode 2, ARR/CCR préchargés,
+// arrêt one-pulse à la mise à jour qui suit l'armement d'OPM
+typedef struct {
+    uint64_t now;               // Ticks d'horloge timer
+    uint64_t firstHigh;         // Front montant
+    uint64_t lastHigh;          // Front descendant final
+    uint64_t highTicks;
+    uint32_t updates;           // Interruptions de mise à jour
+    uint32_t periods;
+    bool restHigh;              // Niveau de la sortie compteur arrêté
+    uint16_t maxRampCcr;
+    bool dutyMonotonic;
+} SimResult;
+
+static SimResult simulate(const MotorPulseSpec* spec) {
+    MotorPulse p;
+    MotorPulseRegs active, preload, regs;
+    SimResult r;
+    bool opm = false;
+    memset(&r, 0, sizeof(r));
+    r.dutyMonotonic = true;
+    uint32_t lastHighCounts = 0;
+
+    TEST_ASSERT_TRUE(MotorPulse_Start(&p, spec, TEST_TIMER_HZ, &active));
+    preload = active;
+    MotorPulseStep step = MotorPulse_Next(&p, &regs);
+    TEST_ASSERT_NOT_EQUAL(MOTOR_PULSE_DONE, step);
+    preload = regs;
+    opm = (step == MOTOR_PULSE_LAST);
+
+    for (;;) {
+        uint32_t scale = (uint32_t)active.psc + 1U;
+        uint32_t counts = (uint32_t)active.arr + 1U;
+        uint32_t high = (active.ccr <= active.arr) ? counts - active.ccr : 0;
+        if (high > 0) {
+            uint64_t rise = r.now + (uint64_t)active.ccr * scale;
+            if (r.highTicks == 0) r.firstHigh = rise;
+            r.lastHigh = r.now + (uint64_t)counts * scale;
+            r.highTicks += (uint64_t)high * scale;
+        }
+        // Rampe: rapport cyclique jamais décroissant d'une période à l'autre
+        if (p.rampPeriods > 0 && active.psc == 0 && high < counts) {
+            if (high < lastHighCounts) r.dutyMonotonic = false;
+            lastHighCounts = high;
+        }
+        r.now += (uint64_t)counts * scale;
+        r.periods++;
+
+        // Mise à jour: chargement des registres préchargés, arrêt si OPM
+        active = preload;
+        r.updates++;
+        if (opm) {
+            r.restHigh = (active.ccr == 0);
+            TEST_ASSERT_EQUAL(MOTOR_PULSE_DONE, MotorPulse_Next(&p, &regs));
+            return r;
+        }
+        step = MotorPulse_Next(&p, &regs);
+        TEST_ASSERT_NOT_EQUAL(MOTOR_PULSE_DONE, step);
+        preload = regs;
+        opm = (step == MOTOR_PULSE_LAST);
+        TEST_ASSERT_TRUE(r.periods < 100000U);
+    }
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// Démarrage franc: une seule période, une seule interruption, fronts à la
+// résolution du prescaler près (700 ms tiennent dans 16 bits à ~11 us/tick)
+void test_motor_pulse_single_shot(void) {
+    MotorPulseSpec spec = { .settleUs = 20000, .onUs = 700000, .softStartUs = 0 };
+    SimResult r = simulate(&spec);
+
+    TEST_ASSERT_EQUAL_UINT32(1, r.periods);
+    TEST_ASSERT_EQUAL_UINT32(1, r.updates);
+    TEST_ASSERT_FALSE(r.restHigh);
+    TEST_ASSERT_UINT64_WITHIN(12 * TEST_TPU, 20000ULL * TEST_TPU, r.firstHigh);
+    TEST_ASSERT_UINT64_WITHIN(12 * TEST_TPU, 700000ULL * TEST_TPU, r.highTicks);
+    TEST_ASSERT_EQUAL_UINT64(r.now, r.lastHigh);
+}
+
+// Impulsion courte: résolution d'un tick d'horloge (pas de prescaler)
+void test_motor_pulse_short_is_cycle_exact(void) {
+    MotorPulseSpec spec = { .settleUs = 50, .onUs = 500, .softStartUs = 0 };
+    SimResult r = simulate(&spec);
+
+    TEST_ASSERT_EQUAL_UINT64(50ULL * TEST_TPU, r.firstHigh);
+    TEST_ASSERT_EQUAL_UINT64(500ULL * TEST_TPU, r.highTicks);
+}
+
+// Rampe: attente basse, porteuse à rapport cyclique croissant, maintien,
+// arrêt matériel à l'instant prévu avec sortie au repos
+void test_motor_pulse_soft_start_ramp(void) {
+    MotorPulseSpec spec = { .settleUs = 500, .onUs = 100000, .softStartUs = 20000 };
+    SimResult r = simulate(&spec);
+    uint32_t ramp = 20000 / MOTOR_PULSE_CARRIER_US;
+
+    TEST_ASSERT_EQUAL_UINT32(ramp + 2U, r.periods);
+    TEST_ASSERT_TRUE(r.dutyMonotonic);
+    TEST_ASSERT_FALSE(r.restHigh);
+    TEST_ASSERT_UINT64_WITHIN(2 * TEST_TPU, (500ULL + 100000ULL) * TEST_TPU, r.now);
+    TEST_ASSERT_EQUAL_UINT64(r.now, r.lastHigh);
+    // Rampe linéaire: la moitié de son énergie, maintien plein
+    uint64_t expected = (80000ULL + 10000ULL) * TEST_TPU;
+    TEST_ASSERT_UINT64_WITHIN(200ULL * TEST_TPU, expected, r.highTicks);
+}
+
+// Rampe bornée à la moitié de l'impulsion
+void test_motor_pulse_ramp_clamped(void) {
+    MotorPulse p;
+    MotorPulseRegs first;
+    MotorPulseSpec spec = { .settleUs = 100, .onUs = 10000, .softStartUs = 50000 };
+
+    TEST_ASSERT_TRUE(MotorPulse_Start(&p, &spec, TEST_TIMER_HZ, &first));
+    TEST_ASSERT_EQUAL_UINT32(5000, p.rampUs);
+    TEST_ASSERT_EQUAL_UINT32(5000, p.holdUs);
+    TEST_ASSERT_EQUAL_UINT32(10100, MotorPulse_TotalUs(&p));
+    TEST_ASSERT_TRUE(first.ccr > first.arr);
+}
+
+void test_motor_pulse_rejects_invalid(void) {
+    MotorPulse p;
+    MotorPulseRegs first;
+    MotorPulseSpec none = { .settleUs = 10, .onUs = 0 };
+    MotorPulseSpec huge = { .settleUs = 0, .onUs = 60000000U };
+    MotorPulseSpec ok = { .settleUs = 10, .onUs = 1000 };
+
+    TEST_ASSERT_FALSE(MotorPulse_Start(&p, &none, TEST_TIMER_HZ, &first));
+    TEST_ASSERT_FALSE(MotorPulse_Start(&p, &huge, TEST_TIMER_HZ, &first));
+    TEST_ASSERT_FALSE(MotorPulse_Start(&p, &ok, 84500000U, &first));
+    TEST_ASSERT_TRUE(MotorPulse_Start(&p, &ok, TEST_TIMER_HZ, &first));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_motor_pulse_single_shot);
+    RUN_TEST(test_motor_pulse_short_is_cycle_exact);
+    RUN_TEST(test_motor_pulse_soft_start_ramp);
+    RUN_TEST(test_motor_pulse_ramp_clamped);
+    RUN_TEST(test_motor_pulse_rejects_invalid);
+
+    return UNITY_END();
+}
@@ -0,0 +1,135 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "orch_event_queue.h"
+
+static OrchEventQueue q;
+
+static OrchestratorEvent stock(uint8_t sensor, uint8_t mm) {
+    OrchestratorEvent evt = { .type = ORCH_EVT_STOCK_LOW };
+    evt.data.stock.sensorId = sensor;
+    evt.data.stock.mm = mm;
+    return evt;
+}
+
+static OrchestratorEvent key(char k) {
+    OrchestratorEvent evt = { .type = ORCH_EVT_KEYPAD, .data.key = k };
+    return evt;
+}
+
+void setUp(void) {
+    OrchEventQueue_Init(&q);
+}
+
+void tearDown(void) {
+}
+
+// Contrôle servi avant la télémétrie, FIFO dans chaque niveau
+void test_orch_queue_priority_order(void) {
+    OrchestratorEvent s1 = stock(1, 90), s2 = stock(2, 95), k1 = key('1'), k2 = key('2'), out;
+    OrchestratorEvent pay = { .type = ORCH_EVT_PAYMENT_OK };
+
+    TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&q, &s1));
+    TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&q, &k1));
+    TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&q, &s2));
+    TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&q, &k2));
+    TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&q, &pay));
+    TEST_ASSERT_EQUAL_UINT8(5, OrchEventQueue_Count(&q));
+
+    TEST_ASSERT_TRUE(OrchEventQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL_CHAR('1', out.data.key);
+    TEST_ASSERT_TRUE(OrchEventQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL_CHAR('2', out.data.key);
+    TEST_ASSERT_TRUE(OrchEventQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, out.type);
+    TEST_ASSERT_TRUE(OrchEventQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL_UINT8(1, out.data.stock.sensorId);
+    TEST_ASSERT_TRUE(OrchEventQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL_UINT8(2, out.data.stock.sensorId);
+    TEST_ASSERT_FALSE(OrchEventQueue_Pop(&q, &out));
+}
+
+// STOCK_LOW d'un même capteur fusionné sur place, dernière mesure conservée
+void test_orch_queue_coalesces_per_sensor(void) {
+    OrchestratorEvent out;
+
+    for (uint8_t i = 0; i < 20; i++) {
+        OrchestratorEvent s = stock((uint8_t)(i % 2), (uint8_t)(100 + i));
+        OrchEventQueue_Push(&q, &s);
+    }
+    TEST_ASSERT_EQUAL_UINT8(2, OrchEventQueue_Count(&q));
+    TEST_ASSERT_EQUAL_UINT32(20, q.stats[ORCH_EVT_STOCK_LOW].posted);
+    TEST_ASSERT_EQUAL_UINT32(18, q.stats[ORCH_EVT_STOCK_LOW].coalesced);
+    TEST_ASSERT_EQUAL_UINT32(0, q.stats[ORCH_EVT_STOCK_LOW].dropped);
+
+    TEST_ASSERT_TRUE(OrchEventQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL_UINT8(0, out.data.stock.sensorId);
+    TEST_ASSERT_EQUAL_UINT8(118, out.data.stock.mm);
+    TEST_ASSERT_TRUE(OrchEventQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL_UINT8(119, out.data.stock.mm);
+}
+
+// Rafale de télémétrie sur tous les capteurs: le niveau télémétrie sature,
+// un paiement posté ensuite passe toujours
+void test_orch_queue_payment_never_lost_behind_telemetry(void) {
+    OrchestratorEvent pay = { .type = ORCH_EVT_PAYMENT_OK }, out;
+
+    for (uint8_t round = 0; round < 10; round++) {
+        for (uint8_t sensor = 0; sensor < 5; sensor++) {
+            OrchestratorEvent s = stock(sensor, 120);
+            OrchEventQueue_Push(&q, &s);
+        }
+    }
+    TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&q, &pay));
+    TEST_ASSERT_TRUE(q.stats[ORCH_EVT_STOCK_LOW].dropped > 0);
+    TEST_ASSERT_EQUAL_UINT8(ORCH_QUEUE_TELEMETRY_DEPTH, q.stats[ORCH_EVT_STOCK_LOW].highWater);
+
+    TEST_ASSERT_TRUE(OrchEventQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL(ORCH_EVT_PAYMENT_OK, out.type);
+    TEST_ASSERT_EQUAL_UINT32(0, q.stats[ORCH_EVT_PAYMENT_OK].dropped);
+}
+
+// Niveau contrôle plein: perte comptée par type, high-water par type et par niveau
+void test_orch_queue_control_full_counts_drops(void) {
+    OrchestratorEvent k = key('5'), out;
+    OrchestratorEvent fail = { .type = ORCH_EVT_ORDER_FAILED };
+
+    for (uint8_t i = 0; i < ORCH_QUEUE_CONTROL_DEPTH; i++) {
+        TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&q, &k));
+    }
+    TEST_ASSERT_EQUAL(ORCH_PUSH_DROPPED, OrchEventQueue_Push(&q, &fail));
+    TEST_ASSERT_EQUAL_UINT32(1, q.stats[ORCH_EVT_ORDER_FAILED].dropped);
+    TEST_ASSERT_EQUAL_UINT8(ORCH_QUEUE_CONTROL_DEPTH, q.stats[ORCH_EVT_KEYPAD].highWater);
+    TEST_ASSERT_EQUAL_UINT8(ORCH_QUEUE_CONTROL_DEPTH, q.levels[ORCH_PRIO_CONTROL].highWater);
+
+    TEST_ASSERT_TRUE(OrchEventQueue_Pop(&q, &out));
+    TEST_ASSERT_EQUAL_UINT8(ORCH_QUEUE_CONTROL_DEPTH - 1, q.stats[ORCH_EVT_KEYPAD].queued);
+    TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&q, &fail));
+}
+
+// Une file statique à zéro est utilisable sans Init; les timers se fusionnent par id
+void test_orch_queue_zeroed_and_timer_coalescing(void) {
+    static OrchEventQueue zq;
+    OrchestratorEvent t0 = { .type = ORCH_EVT_TIMER, .data.code = 0 };
+    OrchestratorEvent t1 = { .type = ORCH_EVT_TIMER, .data.code = 1 }, out;
+
+    TEST_ASSERT_FALSE(OrchEventQueue_Pop(&zq, &out));
+    TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&zq, &t0));
+    TEST_ASSERT_EQUAL(ORCH_PUSH_COALESCED, OrchEventQueue_Push(&zq, &t0));
+    TEST_ASSERT_EQUAL(ORCH_PUSH_QUEUED, OrchEventQueue_Push(&zq, &t1));
+    TEST_ASSERT_EQUAL_UINT8(2, OrchEventQueue_Count(&zq));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_orch_queue_priority_order);
+    RUN_TEST(test_orch_queue_coalesces_per_sensor);
+    RUN_TEST(test_orch_queue_payment_never_lost_behind_telemetry);
+    RUN_TEST(test_orch_queue_control_full_counts_drops);
+    RUN_TEST(test_orch_queue_zeroed_and_timer_coalescing);
+
+    return UNITY_END();
+}
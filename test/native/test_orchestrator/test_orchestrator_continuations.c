@@ -0,0 +1,585 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+// L'orchestrateur réel est compilé contre les mocks FreeRTOS: table de transitions,
+// actions d'entrée/sortie, jobs moteur soumis d'avance, messages sur timers
+#include "../../../Core/Src/orchestrator.c"
+
+#define TEST_MAX_RESPONSES 16
+
+static EspResponse responses[TEST_MAX_RESPONSES];
+static uint8_t responseCount;
+static MotorJobQueue motorJobs;     // File du service moteur simulé
+static uint8_t deliveries[TEST_MAX_RESPONSES];
+static uint8_t deliveryCount;       // Jobs soumis
+static uint8_t releasedOrders;
+static LcdMessage lastLcd;
+
+// ---------- Stubs des services ----------
+void LCD_SendMessage(const LcdMessage* msg) {
+    lastLcd = *msg;
+}
+
+// Catalogue simulé: codes 11..14 -> canaux 1..4, plus "7" et "305" pour la
+// saisie de longueur variable
+static ProductCatalog catalog;
+
+static void catalog_add(const char* code, uint8_t channel, const char* label) {
+    ProductEntry* e = &catalog.image.entries[catalog.image.count++];
+    memset(e, 0, sizeof(*e));
+    e->digits = (uint8_t)strlen(code);
+    e->code = (uint16_t)atoi(code);
+    e->channel = channel;
+    e->sensorId = PRODUCT_SENSOR_NONE;
+    strcpy(e->label, label);
+}
+
+static void catalog_reset(void) {
+    memset(&catalog, 0, sizeof(catalog));
+    catalog_add("11", 1, "Produit 11");
+    catalog_add("12", 2, "Produit 12");
+    catalog_add("13", 3, "Produit 13");
+    catalog_add("14", 4, "Produit 14");
+    catalog_add("7", 5, "Eau");
+    catalog_add("305", 6, "Cafe");
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_OK, ProductCatalog_Build(&catalog, 16));
+}
+
+ProductMatch CatalogService_Match(const char* digits, ProductEntry* entry) {
+    const ProductEntry* found = NULL;
+    ProductMatch m = ProductCatalog_Match(&catalog, digits, &found);
+    if (m == PRODUCT_MATCH_FOUND && entry != NULL) *entry = *found;
+    return m;
+}
+
+MotorJobId MotorService_Submit(uint8_t channel, uint8_t quantity, uint16_t onTimeMs,
+                               MotorJobCallback done, void* ctx) {
+    MotorJobId id = MotorJobQueue_Push(&motorJobs, channel, quantity, onTimeMs, done, ctx);
+    if (id != MOTOR_JOB_ID_NONE) {
+        if (deliveryCount < TEST_MAX_RESPONSES) deliveries[deliveryCount] = channel;
+        deliveryCount++;
+    }
+    return id;
+}
+
+uint8_t MotorService_CancelAll(void) {
+    MotorJob job;
+    uint8_t n = 0;
+    while (MotorJobQueue_Pop(&motorJobs, &job)) {
+        if (job.done != NULL) job.done(job.id, job.channel, MOTOR_JOB_CANCELLED, 0, job.ctx);
+        n++;
+    }
+    return n;
+}
+
+bool EspComm_SendResponse(const EspResponse* rsp) {
+    if (responseCount < TEST_MAX_RESPONSES) responses[responseCount] = *rsp;
+    responseCount++;
+    return true;
+}
+
+void EspComm_ReleaseOrder(const EspOrder* order) {
+    (void)order;
+    releasedOrders++;
+}
+
+// ---------- Outils ----------
+static void post(OrchestratorEvent evt) {
+    TEST_ASSERT_TRUE(Orchestrator_PostEvent(&evt));
+}
+
+static void post_key(char key) {
+    OrchestratorEvent evt = { .type = ORCH_EVT_KEYPAD, .data.key = key };
+    post(evt);
+}
+
+// Passage de la boucle de la tâche: tous les événements en attente
+static void pump(void) {
+    OrchestratorEvent evt;
+    while (orchestrator_next_event(&evt)) {
+        orchestrator_dispatch(&evt);
+        orchestrator_release_payload(&evt);
+    }
+}
+
+// La tâche moteur prend le job suivant; son résultat est rendu par motor_finish
+static MotorJob motor_take(void) {
+    MotorJob job;
+    TEST_ASSERT_TRUE(MotorJobQueue_Pop(&motorJobs, &job));
+    return job;
+}
+
+static void motor_finish_partial(const MotorJob* job, MotorJobStatus status, uint8_t delivered) {
+    job->done(job->id, job->channel, status, delivered, job->ctx);
+    pump();
+}
+
+// Job complet: toute la quantité tombée, rien en cas d'échec
+static void motor_finish(const MotorJob* job, MotorJobStatus status) {
+    motor_finish_partial(job, status, (status == MOTOR_JOB_DONE) ? job->quantity : 0);
+}
+
+static void motor_run_next(MotorJobStatus status) {
+    MotorJob job = motor_take();
+    motor_finish(&job, status);
+}
+
+// Le temps avance par pas d'un tick; la tâche traite les échéances au fil de l'eau
+static void advance_ms(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        Mock_FreeRTOS_AdvanceTimers(1);
+        pump();
+    }
+}
+
+static uint8_t count_responses(EspResponseType type) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < responseCount && i < TEST_MAX_RESPONSES; i++) {
+        if (responses[i].type == type) n++;
+    }
+    return n;
+}
+
+static EspOrder make_order(void) {
+    EspOrder order;
+    memset(&order, 0, sizeof(order));
+    strcpy(order.order_id, "ORD-1");
+    order.item_count = 2;
+    order.items[0].slot_number = 1;
+    order.items[0].quantity = 2;
+    strcpy(order.items[0].product_id, "PROD_A");
+    order.items[1].slot_number = 3;
+    order.items[1].quantity = 1;
+    strcpy(order.items[1].product_id, "PROD_B");
+    return order;
+}
+
+void setUp(void) {
+    Mock_HAL_Reset();
+    Mock_FreeRTOS_Reset();
+    catalog_reset();
+    OrchEventQueue_Init(&orchQueue);
+    orchestrator_timers_init();
+
+    machine_interaction = IDLE;
+    memset((void*)keypad_choice, 0, sizeof(keypad_choice));
+    client_order = 0;
+    deliveryOrderInProgress = false;
+    pendingDeliveryItems = 0;
+    completedDeliveryItems = 0;
+    vendHead = vendCount = vendSubmitIdx = 0;
+    orderCompletePending = false;
+    sessionFirstJob = MOTOR_JOB_ID_NONE;
+    parkedMask = 0;
+    MotorJobQueue_Init(&motorJobs);
+    pendingFlashSet = false;
+    memset(&orchStats, 0, sizeof(orchStats));
+
+    responseCount = 0;
+    deliveryCount = 0;
+    releasedOrders = 0;
+    memset(&lastLcd, 0, sizeof(lastLcd));
+}
+
+void tearDown(void) {
+}
+
+// Commande groupée: un job moteur par article, de toute sa quantité, soumis
+// d'un coup; VEND_COMPLETED au retour de chaque job, puis DELIVERY_COMPLETED;
+// l'orchestrateur n'attend jamais
+void test_orch_batch_pipelines_motor_jobs(void) {
+    EspOrder order = make_order();
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_BATCH, .data.batch.order = &order };
+
+    post(evt);
+    pump();
+    TEST_ASSERT_EQUAL_UINT8(1, releasedOrders);
+    TEST_ASSERT_EQUAL_UINT8(2, deliveryCount);
+    TEST_ASSERT_EQUAL_UINT8(1, deliveries[0]);
+    TEST_ASSERT_EQUAL_UINT8(3, deliveries[1]);
+    TEST_ASSERT_EQUAL_UINT8(2, MotorJobQueue_Count(&motorJobs));
+    TEST_ASSERT_EQUAL_UINT8(0, responseCount);
+    TEST_ASSERT_EQUAL(DELIVERING, machine_interaction);
+
+    MotorJob first = motor_take();
+    TEST_ASSERT_EQUAL_UINT8(2, first.quantity);
+    motor_finish(&first, MOTOR_JOB_DONE);
+    TEST_ASSERT_EQUAL_UINT8(1, count_responses(ESP_RSP_VEND_COMPLETED));
+    TEST_ASSERT_EQUAL_UINT8(1, responses[0].slot);
+
+    motor_run_next(MOTOR_JOB_DONE);
+    TEST_ASSERT_EQUAL_UINT8(2, count_responses(ESP_RSP_VEND_COMPLETED));
+    TEST_ASSERT_EQUAL_UINT8(3, responses[1].slot);
+    TEST_ASSERT_EQUAL_UINT8(1, count_responses(ESP_RSP_DELIVERY_COMPLETED));
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+    TEST_ASSERT_FALSE(deliveryOrderInProgress);
+
+    TEST_ASSERT_EQUAL_UINT32(0, Mock_FreeRTOS_GetDelayCallCount());
+}
+
+// File d'événements pleine à la fin des jobs: la tâche moteur n'attend pas,
+// les résultats sont mis de côté puis traités après la file
+void test_orch_motor_results_parked_when_queue_full(void) {
+    EspOrder order = make_order();
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_BATCH, .data.batch.order = &order };
+    post(evt);
+    pump();
+    TEST_ASSERT_EQUAL(DELIVERING, machine_interaction);
+
+    for (uint8_t i = 0; i < ORCH_QUEUE_CONTROL_DEPTH; i++) {
+        post_key('1');
+    }
+    MotorJob first = motor_take();
+    MotorJob second = motor_take();
+    first.done(first.id, first.channel, MOTOR_JOB_DONE, first.quantity, first.ctx);
+    second.done(second.id, second.channel, MOTOR_JOB_DONE, second.quantity, second.ctx);
+    TEST_ASSERT_EQUAL_UINT32(0, Mock_FreeRTOS_GetDelayCallCount());
+    TEST_ASSERT_EQUAL_UINT8(ORCH_QUEUE_CONTROL_DEPTH, OrchEventQueue_Count(&orchQueue));
+    TEST_ASSERT_EQUAL_UINT8(0, responseCount);
+
+    pump();
+    TEST_ASSERT_EQUAL_UINT8(2, count_responses(ESP_RSP_VEND_COMPLETED));
+    TEST_ASSERT_EQUAL_UINT8(1, count_responses(ESP_RSP_DELIVERY_COMPLETED));
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT16(0, parkedMask);
+}
+
+// File moteur presque pleine: l'article suivant est soumis à la première fin
+// de job; un article arrêté en cours de route échoue avec son compte partiel
+void test_orch_motor_queue_refilled_and_partial_reported(void) {
+    EspOrder order;
+    memset(&order, 0, sizeof(order));
+    strcpy(order.order_id, "ORD-BIG");
+    order.item_count = 3;
+    for (uint8_t i = 0; i < 3; i++) {
+        order.items[i].slot_number = (uint8_t)(i + 1);
+        order.items[i].quantity = 4;
+    }
+    // Jobs d'essai déjà en file: deux places seulement
+    for (uint8_t i = 0; i < MOTOR_JOB_QUEUE_DEPTH - 2U; i++) {
+        TEST_ASSERT_NOT_EQUAL(MOTOR_JOB_ID_NONE, MotorJobQueue_Push(&motorJobs, 4, 1, 100, NULL, NULL));
+    }
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_BATCH, .data.batch.order = &order };
+
+    post(evt);
+    pump();
+    TEST_ASSERT_EQUAL_UINT8(2, deliveryCount);
+    for (uint8_t i = 0; i < MOTOR_JOB_QUEUE_DEPTH - 2U; i++) {
+        MotorJob test = motor_take();
+        TEST_ASSERT_NULL(test.done);
+    }
+
+    motor_run_next(MOTOR_JOB_DONE);
+    TEST_ASSERT_EQUAL_UINT8(3, deliveryCount);
+    TEST_ASSERT_EQUAL_UINT8(3, deliveries[2]);
+
+    // Article 2: une seule unité tombée sur quatre
+    MotorJob second = motor_take();
+    motor_finish_partial(&second, MOTOR_JOB_NO_DROP, 1);
+    motor_run_next(MOTOR_JOB_DONE);
+
+    TEST_ASSERT_EQUAL_UINT8(2, count_responses(ESP_RSP_VEND_COMPLETED));
+    TEST_ASSERT_EQUAL_UINT8(1, count_responses(ESP_RSP_VEND_FAILED));
+    TEST_ASSERT_EQUAL_UINT8(2, responses[1].slot);
+    TEST_ASSERT_EQUAL_UINT8(ESP_CODE_NO_DROP, responses[1].code);
+    TEST_ASSERT_EQUAL_UINT8(1, responses[1].delivered);
+    TEST_ASSERT_EQUAL_UINT8(4, responses[1].quantity);
+    TEST_ASSERT_EQUAL_UINT8(1, count_responses(ESP_RSP_DELIVERY_COMPLETED));
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+}
+
+// Moteur arrêté sans chute détectée: l'article échoue avec NO_DROP, jamais
+// VEND_COMPLETED; échec moteur sans aucune unité: MOTOR_FAILED, 0/n
+void test_orch_no_drop_reported(void) {
+    EspOrder order = make_order();
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_BATCH, .data.batch.order = &order };
+
+    post(evt);
+    pump();
+    motor_run_next(MOTOR_JOB_FAILED);
+    motor_run_next(MOTOR_JOB_NO_DROP);
+
+    TEST_ASSERT_EQUAL_UINT8(0, count_responses(ESP_RSP_VEND_COMPLETED));
+    TEST_ASSERT_EQUAL_UINT8(2, count_responses(ESP_RSP_VEND_FAILED));
+    TEST_ASSERT_EQUAL_UINT8(1, responses[0].slot);
+    TEST_ASSERT_EQUAL_UINT8(ESP_CODE_MOTOR_FAILED, responses[0].code);
+    TEST_ASSERT_EQUAL_UINT8(0, responses[0].delivered);
+    TEST_ASSERT_EQUAL_UINT8(2, responses[0].quantity);
+    TEST_ASSERT_EQUAL_UINT8(3, responses[1].slot);
+    TEST_ASSERT_EQUAL_UINT8(ESP_CODE_NO_DROP, responses[1].code);
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+}
+
+// Les événements clavier restent traités pendant une distribution
+void test_orch_events_handled_during_vend(void) {
+    EspOrder order = make_order();
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_BATCH, .data.batch.order = &order };
+
+    post(evt);
+    pump();
+    MotorJob running = motor_take();
+
+    OrchestratorEvent stock = { .type = ORCH_EVT_STOCK_LOW, .data.stock = { 2, 40 } };
+    post(stock);
+    post_key('5');
+    pump();
+    TEST_ASSERT_EQUAL_UINT8(0, OrchEventQueue_Count(&orchQueue));
+    TEST_ASSERT_EQUAL(DELIVERING, machine_interaction);
+    TEST_ASSERT_EQUAL_STRING("", (const char*)keypad_choice);
+
+    // Annulation au milieu: jobs en attente retirés de la file moteur
+    OrchestratorEvent fail = { .type = ORCH_EVT_ORDER_FAILED };
+    post(fail);
+    pump();
+    TEST_ASSERT_EQUAL_UINT8(0, MotorJobQueue_Count(&motorJobs));
+    TEST_ASSERT_EQUAL_UINT8(1, count_responses(ESP_RSP_DELIVERY_FAILED));
+
+    // Achat local lancé aussitôt: la fin tardive du job annulé ne le clôt pas
+    post_key('1');
+    post_key('3');
+    pump();
+    OrchestratorEvent ok = { .type = ORCH_EVT_PAYMENT_OK };
+    post(ok);
+    pump();
+    TEST_ASSERT_EQUAL(DELIVERING, machine_interaction);
+    motor_finish(&running, MOTOR_JOB_DONE);
+    TEST_ASSERT_EQUAL(DELIVERING, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT8(0, count_responses(ESP_RSP_VEND_COMPLETED));
+
+    motor_run_next(MOTOR_JOB_DONE);
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+}
+
+// Produit invalide: retour immédiat à l'accueil, message effacé après 3 s
+// sauf si une nouvelle saisie a commencé entre-temps
+void test_orch_invalid_product_message_timer(void) {
+    post_key('9');
+    post_key('9');
+    pump();
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+    TEST_ASSERT_EQUAL_STRING("Produit non ", lastLcd.line1);
+
+    advance_ms(ORCH_MESSAGE_MS - 1);
+    TEST_ASSERT_EQUAL_STRING("Produit non ", lastLcd.line1);
+    advance_ms(1);
+    TEST_ASSERT_EQUAL_STRING("Choisissez une", lastLcd.line1);
+
+    post_key('9');
+    post_key('9');
+    pump();
+    advance_ms(1000);
+    post_key('1');
+    pump();
+    LcdMessage typing = lastLcd;
+    advance_ms(ORCH_MESSAGE_MS);
+    TEST_ASSERT_EQUAL(ORDERING, machine_interaction);
+    TEST_ASSERT_EQUAL_STRING(typing.line1, lastLcd.line1);
+    TEST_ASSERT_EQUAL_UINT32(0, Mock_FreeRTOS_GetDelayCallCount());
+}
+
+// Parcours local complet: une transition par étape, horodatée, avec les
+// actions d'entrée (ESP informé en entrant dans PAYING)
+void test_orch_fsm_local_purchase_timestamps(void) {
+    OrchestratorStats st;
+
+    Mock_FreeRTOS_SetTick(100);
+    post_key('1');
+    pump();
+    TEST_ASSERT_EQUAL(ORDERING, machine_interaction);
+    TEST_ASSERT_EQUAL_STRING("1", lastLcd.line2);
+
+    Mock_FreeRTOS_SetTick(350);
+    post_key('2');
+    pump();
+    TEST_ASSERT_EQUAL(PAYING, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT8(12, client_order);
+    TEST_ASSERT_EQUAL_STRING("", (const char*)keypad_choice);
+    TEST_ASSERT_EQUAL_UINT8(1, count_responses(ESP_RSP_STATE));
+
+    Mock_FreeRTOS_SetTick(2350);
+    OrchestratorEvent ok = { .type = ORCH_EVT_PAYMENT_OK };
+    post(ok);
+    pump();
+    TEST_ASSERT_EQUAL(DELIVERING, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT8(1, deliveryCount);
+    TEST_ASSERT_EQUAL_UINT8(2, deliveries[0]);
+
+    Mock_FreeRTOS_SetTick(3050);
+    motor_run_next(MOTOR_JOB_DONE);
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT8(0, client_order);
+
+    Orchestrator_GetStats(&st);
+    TEST_ASSERT_EQUAL_UINT32(4, st.transitions);
+    TEST_ASSERT_EQUAL_UINT32(3050, st.stateSinceTick);
+    TEST_ASSERT_EQUAL_UINT32(700, st.lastDwellMs);
+    TEST_ASSERT_EQUAL_UINT32(250, st.dwellMs[ORDERING]);
+    TEST_ASSERT_EQUAL_UINT32(2000, st.dwellMs[PAYING]);
+    TEST_ASSERT_EQUAL_UINT32(700, st.dwellMs[DELIVERING]);
+}
+
+// Codes de longueur variable: conclus au dernier chiffre, sans validation;
+// le code est relu dans le catalogue au moment de distribuer
+void test_orch_variable_length_codes(void) {
+    OrchestratorEvent cancel = { .type = ORCH_EVT_PAYMENT_CANCEL };
+    OrchestratorEvent ok = { .type = ORCH_EVT_PAYMENT_OK };
+
+    post_key('7');
+    pump();
+    TEST_ASSERT_EQUAL(PAYING, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT16(7, client_order);
+    TEST_ASSERT_EQUAL_STRING("7 Eau", lastLcd.line2);
+    post(cancel);
+    pump();
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+
+    post_key('3');
+    post_key('0');
+    pump();
+    TEST_ASSERT_EQUAL(ORDERING, machine_interaction);
+    TEST_ASSERT_EQUAL_STRING("30", lastLcd.line2);
+    post_key('5');
+    pump();
+    TEST_ASSERT_EQUAL(PAYING, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT16(305, client_order);
+    TEST_ASSERT_EQUAL_STRING("305 Cafe", lastLcd.line2);
+
+    // Catalogue remplacé pendant le paiement: produit retiré, rien ne tourne
+    catalog.image.count = 4;
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_OK, ProductCatalog_Build(&catalog, 16));
+    post(ok);
+    pump();
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+    TEST_ASSERT_EQUAL_STRING("Produit retire", lastLcd.line1);
+    TEST_ASSERT_EQUAL_UINT8(0, deliveryCount);
+
+    // Début de code inconnu: refus dès le chiffre fautif
+    post_key('3');
+    pump();
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+    TEST_ASSERT_EQUAL_STRING("Produit non ", lastLcd.line1);
+}
+
+// Cases vides de la table: événement ignoré et compté, état inchangé
+void test_orch_fsm_ignored_events(void) {
+    OrchestratorStats st;
+    OrchestratorEvent ok = { .type = ORCH_EVT_PAYMENT_OK };
+    OrchestratorEvent done = { .type = ORCH_EVT_DELIVERY_DONE };
+    OrchestratorEvent vend = { .type = ORCH_EVT_VEND_ITEM };
+
+    post(ok);
+    post(done);
+    post(vend);
+    post_key('#');
+    pump();
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT8(0, deliveryCount);
+
+    Orchestrator_GetStats(&st);
+    TEST_ASSERT_EQUAL_UINT32(3, st.ignoredEvents);
+    TEST_ASSERT_EQUAL_UINT32(0, st.transitions);
+}
+
+// Rester dans l'état courant ne rejoue ni sortie ni entrée: jobs moteur et
+// choix clavier conservés, aucune transition comptée
+void test_orch_fsm_self_transition_is_noop(void) {
+    OrchestratorStats st;
+    EspOrder order = make_order();
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_BATCH, .data.batch.order = &order };
+    post(evt);
+    pump();
+    Orchestrator_GetStats(&st);
+    uint32_t transitions = st.transitions;
+
+    orchestrator_commit_state(DELIVERING);
+    TEST_ASSERT_EQUAL_UINT8(2, MotorJobQueue_Count(&motorJobs));
+    TEST_ASSERT_TRUE(deliveryOrderInProgress);
+
+    machine_interaction = ORDERING;
+    strcpy((char*)keypad_choice, "1");
+    orchestrator_commit_state(ORDERING);
+    TEST_ASSERT_EQUAL_STRING("1", (const char*)keypad_choice);
+
+    Orchestrator_GetStats(&st);
+    TEST_ASSERT_EQUAL_UINT32(transitions, st.transitions);
+}
+
+// Le moteur signale chaque article d'une commande QR: l'état reste DELIVERING
+// jusqu'à la fin de la file, et une seconde commande est refusée
+void test_orch_fsm_delivery_done_during_qr_order(void) {
+    EspOrder order = make_order();
+    EspOrder other = make_order();
+    OrchestratorEvent evt = { .type = ORCH_EVT_ORDER_BATCH, .data.batch.order = &order };
+    OrchestratorEvent busy = { .type = ORCH_EVT_ORDER_BATCH, .data.batch.order = &other };
+
+    post(evt);
+    pump();
+    motor_run_next(MOTOR_JOB_DONE);
+    post(busy);
+    pump();
+    TEST_ASSERT_EQUAL(DELIVERING, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT8(2, releasedOrders);
+    TEST_ASSERT_EQUAL_UINT8(0, count_responses(ESP_RSP_DELIVERY_FAILED));
+    TEST_ASSERT_EQUAL_UINT8(1, count_responses(ESP_RSP_ORDER_NAK));
+    TEST_ASSERT_EQUAL_UINT8(ESP_CODE_ORDER_BUSY, responses[responseCount - 1].code);
+    TEST_ASSERT_EQUAL_UINT8(2, deliveryCount);
+
+    motor_run_next(MOTOR_JOB_DONE);
+    TEST_ASSERT_EQUAL(IDLE, machine_interaction);
+    TEST_ASSERT_EQUAL_UINT8(1, count_responses(ESP_RSP_DELIVERY_COMPLETED));
+}
+
+// Commande ligne à ligne: l'identifiant de commande passe par un bloc du pool,
+// rendu après traitement; les identifiants produit répétés sont internés une fois
+void test_orch_payloads_pooled_and_interned(void) {
+    TEST_ASSERT_TRUE(sizeof(OrchestratorEvent) <= 2 * sizeof(void*));
+
+    TEST_ASSERT_TRUE(Orchestrator_PostOrderStart("ORD-77"));
+    TEST_ASSERT_EQUAL_UINT8(1, orderIdPool.inUse);
+    pump();
+    TEST_ASSERT_EQUAL_UINT8(0, orderIdPool.inUse);
+    TEST_ASSERT_EQUAL_STRING("ORD-77", currentDeliveryOrderId);
+
+    uint8_t before = productIds.count;
+    TEST_ASSERT_TRUE(Orchestrator_PostVendItem(2, 1, "PROD_SHARED"));
+    TEST_ASSERT_TRUE(Orchestrator_PostVendItem(4, 1, "PROD_SHARED"));
+    TEST_ASSERT_EQUAL_UINT8(before + 1, productIds.count);
+    pump();
+    TEST_ASSERT_EQUAL_UINT8(2, pendingDeliveryItems);
+
+    // ORDER_START refusé (commande en cours): le bloc est rendu quand même
+    TEST_ASSERT_TRUE(Orchestrator_PostOrderStart("ORD-78"));
+    pump();
+    TEST_ASSERT_EQUAL_UINT8(0, orderIdPool.inUse);
+    TEST_ASSERT_EQUAL_STRING("ORD-77", currentDeliveryOrderId);
+
+    // Pool épuisé: refus signalé au producteur, aucune fuite
+    for (uint8_t i = 0; i < ORCH_ORDER_ID_BLOCKS; i++) {
+        TEST_ASSERT_TRUE(Orchestrator_PostOrderStart("X"));
+    }
+    TEST_ASSERT_FALSE(Orchestrator_PostOrderStart("Y"));
+    pump();
+    TEST_ASSERT_EQUAL_UINT8(0, orderIdPool.inUse);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_orch_batch_pipelines_motor_jobs);
+    RUN_TEST(test_orch_motor_results_parked_when_queue_full);
+    RUN_TEST(test_orch_motor_queue_refilled_and_partial_reported);
+    RUN_TEST(test_orch_no_drop_reported);
+    RUN_TEST(test_orch_events_handled_during_vend);
+    RUN_TEST(test_orch_invalid_product_message_timer);
+    RUN_TEST(test_orch_fsm_local_purchase_timestamps);
+    RUN_TEST(test_orch_variable_length_codes);
+    RUN_TEST(test_orch_fsm_ignored_events);
+    RUN_TEST(test_orch_fsm_self_transition_is_noop);
+    RUN_TEST(test_orch_fsm_delivery_done_during_qr_order);
+    RUN_TEST(test_orch_payloads_pooled_and_interned);
+
+    return UNITY_END();
+}
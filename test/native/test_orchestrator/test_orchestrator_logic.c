@@ -12,21 +12,10 @@ void LCD_SendMessage(const LcdMessage* msg) {
     // Mock - ne fait rien
 }
 
-void EspComm_SendLine(const char* line) {
+bool EspComm_SendLine(const char* line) {
     // Mock - ne fait rien
-}
-
-uint8_t MotorService_OrderToChannel(uint8_t orderCode) {
-    // Implémentation de test
-    switch (orderCode) {
-        case 11: return 0;
-        case 12: return 1;
-        case 13: return 2;
-        case 21: return 3;
-        case 22: return 4;
-        case 23: return 6;
-        default: return 0xFF;
-    }
+    (void)line;
+    return true;
 }
 
 void MotorService_StartDelivery(uint8_t channel) {
@@ -35,8 +24,16 @@ void MotorService_StartDelivery(uint8_t channel) {
 
 // Variables globales mockées (définies dans mock_global.c)
 extern volatile MachineState machine_interaction;
-extern volatile char keypad_choice[3];
-extern volatile uint8_t client_order;
+extern volatile char keypad_choice[KEYPAD_CHOICE_SIZE];
+extern volatile uint16_t client_order;
+
+// Catalogue intégré au firmware, tel que chargé sans catalogue en flash
+#define TEST_MOTOR_CHANNELS 16U
+static ProductCatalog catalog;
+
+static ProductMatch match_code(const char* digits, const ProductEntry** entry) {
+    return ProductCatalog_Match(&catalog, digits, entry);
+}
 
 // ============================================================================
 // TESTS SETUP ET TEARDOWN
@@ -50,6 +47,9 @@ void setUp(void) {
     machine_interaction = IDLE;
     memset((void*)keypad_choice, 0, sizeof(keypad_choice));
     client_order = 0;
+
+    ProductCatalog_Default(&catalog.image);
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_OK, ProductCatalog_Build(&catalog, TEST_MOTOR_CHANNELS));
 }
 
 void tearDown(void) {
@@ -94,19 +94,27 @@ void test_machine_state_transitions(void) {
 }
 
 void test_order_code_validation(void) {
-    // Codes valides
-    TEST_ASSERT_EQUAL_UINT8(0, MotorService_OrderToChannel(11));
-    TEST_ASSERT_EQUAL_UINT8(1, MotorService_OrderToChannel(12));
-    TEST_ASSERT_EQUAL_UINT8(2, MotorService_OrderToChannel(13));
-    TEST_ASSERT_EQUAL_UINT8(3, MotorService_OrderToChannel(21));
-    TEST_ASSERT_EQUAL_UINT8(4, MotorService_OrderToChannel(22));
-    TEST_ASSERT_EQUAL_UINT8(6, MotorService_OrderToChannel(23));
-    
+    const ProductEntry* entry = NULL;
+
+    // Codes du catalogue intégré
+    static const struct { const char* code; uint8_t channel; } known[] = {
+        { "11", 1 }, { "12", 2 }, { "13", 3 }, { "21", 4 }, { "22", 1 }, { "23", 2 },
+    };
+    for (size_t i = 0; i < sizeof(known) / sizeof(known[0]); i++) {
+        TEST_ASSERT_EQUAL_MESSAGE(PRODUCT_MATCH_FOUND, match_code(known[i].code, &entry), known[i].code);
+        TEST_ASSERT_EQUAL_UINT8(known[i].channel, entry->channel);
+    }
+
+    // Début de code: saisie à poursuivre
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_PREFIX, match_code("1", &entry));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_PREFIX, match_code("2", &entry));
+
     // Codes invalides
-    TEST_ASSERT_EQUAL_UINT8(0xFF, MotorService_OrderToChannel(10));
-    TEST_ASSERT_EQUAL_UINT8(0xFF, MotorService_OrderToChannel(14));
-    TEST_ASSERT_EQUAL_UINT8(0xFF, MotorService_OrderToChannel(31));
-    TEST_ASSERT_EQUAL_UINT8(0xFF, MotorService_OrderToChannel(99));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, match_code("10", &entry));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, match_code("14", &entry));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, match_code("31", &entry));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, match_code("99", &entry));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, match_code("3", &entry));
 }
 
 // ============================================================================
@@ -133,63 +141,32 @@ void test_keypad_input_validation(void) {
 }
 
 void test_order_processing_flow(void) {
-    // Simulation du flux complet de commande
-    
-    // 1. État initial
-    machine_interaction = IDLE;
-    TEST_ASSERT_STATE_EQUAL(IDLE, machine_interaction);
-    
-    // 2. Saisie premier chiffre
+    const ProductEntry* entry = NULL;
+
+    // Premier chiffre: début de code, la saisie continue
     keypad_choice[0] = '1';
     keypad_choice[1] = '\0';
-    machine_interaction = ORDERING;
-    TEST_ASSERT_STATE_EQUAL(ORDERING, machine_interaction);
-    TEST_ASSERT_EQUAL_STRING("1", (char*)keypad_choice);
-    
-    // 3. Saisie second chiffre (code complet)
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_PREFIX, match_code((const char*)keypad_choice, &entry));
+
+    // Second chiffre: code complet, produit et canal connus
     keypad_choice[1] = '2';
     keypad_choice[2] = '\0';
-    uint8_t orderCode = (keypad_choice[0] - '0') * 10 + (keypad_choice[1] - '0');
-    TEST_ASSERT_EQUAL_UINT8(12, orderCode);
-    
-    // 4. Validation du code
-    uint8_t channel = MotorService_OrderToChannel(orderCode);
-    TEST_ASSERT_NOT_EQUAL(0xFF, channel);
-    
-    // 5. Transition vers paiement
-    client_order = orderCode;
-    machine_interaction = PAYING;
-    TEST_ASSERT_STATE_EQUAL(PAYING, machine_interaction);
-    TEST_ASSERT_EQUAL_UINT8(12, client_order);
-    
-    // 6. Reset du choix keypad
-    memset((void*)keypad_choice, 0, sizeof(keypad_choice));
-    TEST_ASSERT_EQUAL_STRING("", (char*)keypad_choice);
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, match_code((const char*)keypad_choice, &entry));
+    TEST_ASSERT_EQUAL_UINT16(12, entry->code);
+    TEST_ASSERT_EQUAL_UINT8(2, entry->digits);
+    TEST_ASSERT_EQUAL_UINT8(2, entry->channel);
+    TEST_ASSERT_EQUAL_STRING("Produit 12", entry->label);
 }
 
 void test_error_handling(void) {
-    // Test gestion code produit invalide
-    machine_interaction = ORDERING;
-    keypad_choice[0] = '9';
-    keypad_choice[1] = '9';
-    keypad_choice[2] = '\0';
-    
-    uint8_t orderCode = (keypad_choice[0] - '0') * 10 + (keypad_choice[1] - '0');
-    uint8_t channel = MotorService_OrderToChannel(orderCode);
-    
-    TEST_ASSERT_EQUAL_UINT8(99, orderCode);
-    TEST_ASSERT_EQUAL_UINT8(0xFF, channel);  // Code invalide
-    
-    // Le système devrait revenir à IDLE
-    if (channel == 0xFF) {
-        client_order = 0;
-        machine_interaction = IDLE;
-        memset((void*)keypad_choice, 0, sizeof(keypad_choice));
-    }
-    
-    TEST_ASSERT_STATE_EQUAL(IDLE, machine_interaction);
-    TEST_ASSERT_EQUAL_UINT8(0, client_order);
-    TEST_ASSERT_EQUAL_STRING("", (char*)keypad_choice);
+    const ProductEntry* entry = NULL;
+
+    // Premier chiffre sans code correspondant: refus immédiat
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, match_code("9", &entry));
+    // Code plus long que tout code du catalogue
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, match_code("111", &entry));
+    // Saisie vide: rien à chercher
+    TEST_ASSERT_NOT_EQUAL(PRODUCT_MATCH_FOUND, match_code("", &entry));
 }
 
 // ============================================================================
@@ -197,8 +174,8 @@ void test_error_handling(void) {
 // ============================================================================
 
 void test_keypad_buffer_limits(void) {
-    // Test limite de buffer keypad (3 caractères)
-    TEST_ASSERT_EQUAL_INT(3, sizeof(keypad_choice));
+    // Test limite de buffer keypad (code de 3 chiffres + '\0')
+    TEST_ASSERT_EQUAL_INT(4, sizeof(keypad_choice));
     
     // Simuler saisie normale (2 chiffres)
     keypad_choice[0] = '1';
@@ -0,0 +1,157 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "product_catalog.h"
+
+#define TEST_CHANNELS  16U
+
+static ProductCatalog cat;
+
+static void add(const char* code, uint8_t channel, const char* label) {
+    ProductEntry* e = &cat.image.entries[cat.image.count++];
+    memset(e, 0, sizeof(*e));
+    e->digits = (uint8_t)strlen(code);
+    for (const char* p = code; *p; p++) e->code = (uint16_t)(e->code * 10U + (uint16_t)(*p - '0'));
+    e->channel = channel;
+    e->sensorId = PRODUCT_SENSOR_NONE;
+    strncpy(e->label, label, PRODUCT_LABEL_LEN - 1);
+}
+
+void setUp(void) {
+    memset(&cat, 0, sizeof(cat));
+}
+
+void tearDown(void) {}
+
+// Format persistant figé: toute modification impose un nouveau CATALOG_MAGIC
+void test_product_catalog_layout(void) {
+    TEST_ASSERT_EQUAL_UINT32(20, sizeof(ProductEntry));
+    TEST_ASSERT_EQUAL_UINT32(8 + 20 * PRODUCT_CATALOG_MAX, sizeof(ProductCatalogImage));
+}
+
+// Catalogue intégré: mêmes codes et canaux que l'ancienne table figée
+void test_product_catalog_default(void) {
+    const ProductEntry* e = NULL;
+    ProductCatalog_Default(&cat.image);
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_OK, ProductCatalog_Build(&cat, TEST_CHANNELS));
+
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, ProductCatalog_Match(&cat, "11", &e));
+    TEST_ASSERT_EQUAL_UINT8(1, e->channel);
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, ProductCatalog_Match(&cat, "21", &e));
+    TEST_ASSERT_EQUAL_UINT8(4, e->channel);
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, ProductCatalog_Match(&cat, "23", &e));
+    TEST_ASSERT_EQUAL_UINT8(2, e->channel);
+    TEST_ASSERT_EQUAL_STRING("Produit 23", e->label);
+
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_PREFIX, ProductCatalog_Match(&cat, "1", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_PREFIX, ProductCatalog_Match(&cat, "2", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "3", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "14", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "111", NULL));
+}
+
+// Longueurs mélangées; "05" et "5" sont deux codes différents
+void test_product_catalog_variable_length(void) {
+    const ProductEntry* e = NULL;
+    add("7", 0, "Eau");
+    add("05", 1, "Jus");
+    add("305", 2, "Cafe");
+    add("31", 3, "The");
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_OK, ProductCatalog_Build(&cat, TEST_CHANNELS));
+
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, ProductCatalog_Match(&cat, "7", &e));
+    TEST_ASSERT_EQUAL_STRING("Eau", e->label);
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_PREFIX, ProductCatalog_Match(&cat, "0", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, ProductCatalog_Match(&cat, "05", &e));
+    TEST_ASSERT_EQUAL_UINT8(1, e->channel);
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "5", NULL));
+
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_PREFIX, ProductCatalog_Match(&cat, "3", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_PREFIX, ProductCatalog_Match(&cat, "30", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, ProductCatalog_Match(&cat, "305", &e));
+    TEST_ASSERT_EQUAL_STRING("Cafe", e->label);
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, ProductCatalog_Match(&cat, "31", &e));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "306", NULL));
+
+    // Saisie invalide
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "3054", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "3a", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, NULL, NULL));
+}
+
+// Catalogue plein: chaque entrée reste joignable
+void test_product_catalog_full(void) {
+    char code[4];
+    for (uint8_t i = 0; i < PRODUCT_CATALOG_MAX; i++) {
+        snprintf(code, sizeof(code), "%u", 100U + i * 7U);
+        add(code, (uint8_t)(i % TEST_CHANNELS), code);
+    }
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_OK, ProductCatalog_Build(&cat, TEST_CHANNELS));
+    for (uint8_t i = 0; i < PRODUCT_CATALOG_MAX; i++) {
+        const ProductEntry* e = NULL;
+        snprintf(code, sizeof(code), "%u", 100U + i * 7U);
+        TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, ProductCatalog_Match(&cat, code, &e));
+        TEST_ASSERT_EQUAL_STRING(code, e->label);
+    }
+    cat.image.count = PRODUCT_CATALOG_MAX + 1U;
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_ERR_COUNT, ProductCatalog_Build(&cat, TEST_CHANNELS));
+}
+
+// Refus: quel que soit l'ordre des entrées, et l'index ne répond plus rien
+void test_product_catalog_rejects(void) {
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_ERR_COUNT, ProductCatalog_Build(&cat, TEST_CHANNELS));
+
+    add("12", 1, "A");
+    add("1", 2, "B");
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_ERR_PREFIX, ProductCatalog_Build(&cat, TEST_CHANNELS));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "12", NULL));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_NONE, ProductCatalog_Match(&cat, "1", NULL));
+
+    setUp();
+    add("1", 2, "B");
+    add("123", 1, "A");
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_ERR_PREFIX, ProductCatalog_Build(&cat, TEST_CHANNELS));
+
+    setUp();
+    add("42", 1, "A");
+    add("42", 2, "B");
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_ERR_DUPLICATE, ProductCatalog_Build(&cat, TEST_CHANNELS));
+
+    setUp();
+    add("42", TEST_CHANNELS, "A");
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_ERR_CHANNEL, ProductCatalog_Build(&cat, TEST_CHANNELS));
+
+    setUp();
+    add("42", 1, "A");
+    cat.image.entries[0].digits = 1;
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_ERR_CODE, ProductCatalog_Build(&cat, TEST_CHANNELS));
+    cat.image.entries[0].digits = 4;
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_ERR_CODE, ProductCatalog_Build(&cat, TEST_CHANNELS));
+}
+
+// Libellé reçu sans terminaison: tronqué à la construction
+void test_product_catalog_label_terminated(void) {
+    const ProductEntry* e = NULL;
+    add("9", 0, "");
+    memset(cat.image.entries[0].label, 'X', PRODUCT_LABEL_LEN);
+    TEST_ASSERT_EQUAL(PRODUCT_CATALOG_OK, ProductCatalog_Build(&cat, TEST_CHANNELS));
+    TEST_ASSERT_EQUAL(PRODUCT_MATCH_FOUND, ProductCatalog_Match(&cat, "9", &e));
+    TEST_ASSERT_EQUAL_UINT32(PRODUCT_LABEL_LEN - 1, strlen(e->label));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_product_catalog_layout);
+    RUN_TEST(test_product_catalog_default);
+    RUN_TEST(test_product_catalog_variable_length);
+    RUN_TEST(test_product_catalog_full);
+    RUN_TEST(test_product_catalog_rejects);
+    RUN_TEST(test_product_catalog_label_terminated);
+
+    return UNITY_END();
+}
@@ -0,0 +1,120 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ring_buffer.h"
+
+#define TEST_RING_SIZE 16
+
+static uint8_t storage[TEST_RING_SIZE];
+static RingBuffer rb;
+
+void setUp(void) {
+    memset(storage, 0, sizeof(storage));
+    TEST_ASSERT_TRUE(RingBuffer_Init(&rb, storage, sizeof(storage)));
+}
+
+void tearDown(void) {
+}
+
+// Taille non puissance de 2 refusée
+void test_ring_buffer_init_rejects_invalid_size(void) {
+    RingBuffer other;
+    uint8_t buf[12];
+    TEST_ASSERT_FALSE(RingBuffer_Init(&other, buf, sizeof(buf)));
+    TEST_ASSERT_FALSE(RingBuffer_Init(&other, buf, 0));
+    TEST_ASSERT_FALSE(RingBuffer_Init(&other, NULL, 8));
+    TEST_ASSERT_TRUE(RingBuffer_Init(&other, buf, 8));
+}
+
+// Écriture puis lecture dans l'ordre FIFO
+void test_ring_buffer_write_read_fifo(void) {
+    uint8_t out[8] = {0};
+
+    TEST_ASSERT_EQUAL_UINT16(5, RingBuffer_Write(&rb, (const uint8_t*)"HELLO", 5));
+    TEST_ASSERT_EQUAL_UINT16(5, RingBuffer_Count(&rb));
+    TEST_ASSERT_EQUAL_UINT16(TEST_RING_SIZE - 5, RingBuffer_Free(&rb));
+
+    TEST_ASSERT_EQUAL_UINT16(3, RingBuffer_Read(&rb, out, 3));
+    TEST_ASSERT_EQUAL_MEMORY("HEL", out, 3);
+    TEST_ASSERT_EQUAL_UINT16(2, RingBuffer_Read(&rb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY("LO", out, 2);
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Read(&rb, out, sizeof(out)));
+}
+
+// Écriture tronquée quand le buffer est plein (pas d'écrasement)
+void test_ring_buffer_write_truncates_when_full(void) {
+    uint8_t data[20];
+    uint8_t out[20];
+    for (int i = 0; i < 20; i++) data[i] = (uint8_t)i;
+
+    TEST_ASSERT_EQUAL_UINT16(TEST_RING_SIZE, RingBuffer_Write(&rb, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Write(&rb, data, 1));
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Free(&rb));
+
+    TEST_ASSERT_EQUAL_UINT16(TEST_RING_SIZE, RingBuffer_Read(&rb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY(data, out, TEST_RING_SIZE);
+}
+
+// Copies correctes à travers le rebouclage
+void test_ring_buffer_wraps_around(void) {
+    uint8_t out[TEST_RING_SIZE];
+
+    // Décaler les indices près de la fin du stockage
+    RingBuffer_Write(&rb, (const uint8_t*)"0123456789AB", 12);
+    RingBuffer_Read(&rb, out, 12);
+
+    TEST_ASSERT_EQUAL_UINT16(10, RingBuffer_Write(&rb, (const uint8_t*)"abcdefghij", 10));
+    TEST_ASSERT_EQUAL_UINT16(10, RingBuffer_Read(&rb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY("abcdefghij", out, 10);
+}
+
+// Les indices libres débordent sur 16 bits sans fausser le comptage
+void test_ring_buffer_index_overflow(void) {
+    uint8_t out[4];
+    rb.head = 0xFFFE;
+    rb.tail = 0xFFFE;
+
+    TEST_ASSERT_EQUAL_UINT16(4, RingBuffer_Write(&rb, (const uint8_t*)"WXYZ", 4));
+    TEST_ASSERT_EQUAL_UINT16(4, RingBuffer_Count(&rb));
+    TEST_ASSERT_EQUAL_UINT16(2, RingBuffer_Head(&rb));
+    TEST_ASSERT_EQUAL_UINT16(4, RingBuffer_Read(&rb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY("WXYZ", out, 4);
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Count(&rb));
+}
+
+// Lecture sans copie: bloc contigu jusqu'à la fin du stockage, puis libération
+void test_ring_buffer_peek_contiguous_and_skip(void) {
+    uint8_t out[TEST_RING_SIZE];
+    const uint8_t* data = NULL;
+
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_PeekContiguous(&rb, &data));
+
+    RingBuffer_Write(&rb, (const uint8_t*)"0123456789AB", 12);
+    RingBuffer_Read(&rb, out, 12);
+    RingBuffer_Write(&rb, (const uint8_t*)"abcdefgh", 8);
+
+    // 4 octets avant la fin du stockage, 4 après rebouclage
+    TEST_ASSERT_EQUAL_UINT16(4, RingBuffer_PeekContiguous(&rb, &data));
+    TEST_ASSERT_EQUAL_MEMORY("abcd", data, 4);
+    RingBuffer_Skip(&rb, 4);
+
+    TEST_ASSERT_EQUAL_UINT16(4, RingBuffer_PeekContiguous(&rb, &data));
+    TEST_ASSERT_EQUAL_MEMORY("efgh", data, 4);
+    RingBuffer_Skip(&rb, 10);
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Count(&rb));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_ring_buffer_init_rejects_invalid_size);
+    RUN_TEST(test_ring_buffer_write_read_fifo);
+    RUN_TEST(test_ring_buffer_write_truncates_when_full);
+    RUN_TEST(test_ring_buffer_wraps_around);
+    RUN_TEST(test_ring_buffer_index_overflow);
+    RUN_TEST(test_ring_buffer_peek_contiguous_and_skip);
+
+    return UNITY_END();
+}
@@ -0,0 +1,119 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "tof_scan.h"
+
+#define TEST_TIMEOUT_MS  80U
+
+static TofScan scan;
+
+void setUp(void) {
+    TofScan_Init(&scan, 5, TEST_TIMEOUT_MS);
+}
+
+void tearDown(void) {
+}
+
+// Résultats dans le désordre: le cycle se clôt au dernier, durée = le plus lent
+void test_tof_scan_out_of_order(void) {
+    TofScan_Begin(&scan, 1000);
+    TEST_ASSERT_EQUAL_HEX8(0x1F, scan.pending);
+    TEST_ASSERT_FALSE(TofScan_Complete(&scan));
+
+    TEST_ASSERT_TRUE(TofScan_Ready(&scan, 3, 120, 1030));
+    TEST_ASSERT_TRUE(TofScan_Ready(&scan, 0, 90, 1032));
+    TEST_ASSERT_TRUE(TofScan_Ready(&scan, 4, 200, 1034));
+    TEST_ASSERT_TRUE(TofScan_Ready(&scan, 1, 60, 1040));
+    TEST_ASSERT_FALSE(TofScan_Complete(&scan));
+    TEST_ASSERT_TRUE(TofScan_Ready(&scan, 2, 75, 1046));
+
+    TEST_ASSERT_TRUE(TofScan_Complete(&scan));
+    TEST_ASSERT_EQUAL_HEX8(0x1F, scan.done);
+    TEST_ASSERT_EQUAL_HEX8(0, scan.failed);
+    TEST_ASSERT_EQUAL_UINT8(120, scan.mm[3]);
+    TEST_ASSERT_EQUAL_UINT8(75, scan.mm[2]);
+    TEST_ASSERT_EQUAL_UINT32(46, scan.cycleMs);
+}
+
+// Second résultat du même capteur ou capteur inconnu: ignorés
+void test_tof_scan_ignores_unexpected(void) {
+    TofScan_Begin(&scan, 0);
+    TEST_ASSERT_TRUE(TofScan_Ready(&scan, 1, 50, 10));
+    TEST_ASSERT_FALSE(TofScan_Ready(&scan, 1, 99, 12));
+    TEST_ASSERT_EQUAL_UINT8(50, scan.mm[1]);
+    TEST_ASSERT_FALSE(TofScan_Ready(&scan, 5, 10, 12));
+    TEST_ASSERT_FALSE(TofScan_Ready(&scan, TOF_SCAN_MAX, 10, 12));
+}
+
+// Erreur et échéance: le cycle se clôt quand même, sans attendre les muets
+void test_tof_scan_fail_and_expire(void) {
+    TofScan_Begin(&scan, 500);
+    TofScan_Fail(&scan, 2);
+    TofScan_Ready(&scan, 0, 40, 520);
+    TofScan_Ready(&scan, 1, 41, 521);
+
+    TEST_ASSERT_EQUAL_UINT32(580, TofScan_DeadlineMs(&scan));
+    TEST_ASSERT_EQUAL_HEX8(0, TofScan_Expire(&scan, 579));
+    TEST_ASSERT_FALSE(TofScan_Complete(&scan));
+    TEST_ASSERT_EQUAL_HEX8(0x18, TofScan_Expire(&scan, 580));
+    TEST_ASSERT_TRUE(TofScan_Complete(&scan));
+    TEST_ASSERT_EQUAL_HEX8(0x1C, scan.failed);
+    TEST_ASSERT_EQUAL_HEX8(0x03, scan.done);
+
+    // Résultat tardif: hors cycle
+    TEST_ASSERT_FALSE(TofScan_Ready(&scan, 3, 10, 590));
+
+    // Cycle suivant: tout le monde de nouveau attendu
+    TofScan_Begin(&scan, 700);
+    TEST_ASSERT_EQUAL_HEX8(0x1F, scan.pending);
+    TEST_ASSERT_EQUAL_HEX8(0, scan.failed);
+}
+
+// Capteur hors service: jamais attendu
+void test_tof_scan_disabled_sensor(void) {
+    TofScan_SetEnabled(&scan, 1, false);
+    TofScan_SetEnabled(&scan, 9, false);
+    TofScan_Begin(&scan, 0);
+    TEST_ASSERT_EQUAL_HEX8(0x1D, scan.pending);
+    TEST_ASSERT_FALSE(TofScan_Ready(&scan, 1, 10, 5));
+
+    // Retiré en cours de cycle
+    TofScan_SetEnabled(&scan, 4, false);
+    TEST_ASSERT_EQUAL_HEX8(0x0D, scan.pending);
+
+    // Tous hors service: cycle vide, clos d'emblée
+    for (uint8_t i = 0; i < 5; i++) TofScan_SetEnabled(&scan, i, false);
+    TofScan_Begin(&scan, 10);
+    TEST_ASSERT_TRUE(TofScan_Complete(&scan));
+    TEST_ASSERT_EQUAL_HEX8(0, TofScan_Expire(&scan, 1000));
+}
+
+// Échéance calculée à travers le rebouclage du tick
+void test_tof_scan_tick_wrap(void) {
+    TofScan_Begin(&scan, 0xFFFFFFF0UL);
+    TEST_ASSERT_EQUAL_HEX8(0, TofScan_Expire(&scan, 0x00000010UL));
+    TEST_ASSERT_EQUAL_HEX8(0x1F, TofScan_Expire(&scan, 0x00000040UL));
+    TEST_ASSERT_EQUAL_UINT32(0x50, scan.cycleMs);
+}
+
+// Plus de capteurs que de bits: borné
+void test_tof_scan_count_bounded(void) {
+    TofScan_Init(&scan, 12, TEST_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL_UINT8(TOF_SCAN_MAX, scan.count);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, scan.enabled);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_tof_scan_out_of_order);
+    RUN_TEST(test_tof_scan_ignores_unexpected);
+    RUN_TEST(test_tof_scan_fail_and_expire);
+    RUN_TEST(test_tof_scan_disabled_sensor);
+    RUN_TEST(test_tof_scan_tick_wrap);
+    RUN_TEST(test_tof_scan_count_bounded);
+
+    return UNITY_END();
+}
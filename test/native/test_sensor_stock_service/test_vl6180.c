@@ -0,0 +1,162 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "mock_hal.h"
+#include "vl6180.h"
+
+#define TOF_ADDR8  (0x2A << 1)
+
+// Transport bloquant sur le HAL (mock): une transaction par appel
+static bool hal_write(uint16_t addr8, uint16_t reg, const uint8_t* data, uint8_t len, void* ctx) {
+    return HAL_I2C_Mem_Write((I2C_HandleTypeDef*)ctx, addr8, reg, I2C_MEMADD_SIZE_16BIT,
+                             (uint8_t*)data, len, 10) == HAL_OK;
+}
+
+static bool hal_read(uint16_t addr8, uint16_t reg, uint8_t* data, uint8_t len, void* ctx) {
+    return HAL_I2C_Mem_Read((I2C_HandleTypeDef*)ctx, addr8, reg, I2C_MEMADD_SIZE_16BIT,
+                            data, len, 10) == HAL_OK;
+}
+
+static const Vl6180Bus bus = { .write = hal_write, .read = hal_read, .ctx = &hi2c1 };
+
+// Ancien accès (copie locale): adresse de registre émise seule, puis lecture
+// ou écriture séparée
+static void legacy_write_reg(uint16_t reg, uint8_t value) {
+    uint8_t tx[3] = { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF), value };
+    HAL_I2C_Master_Transmit(&hi2c1, TOF_ADDR8, tx, sizeof(tx), 10);
+}
+
+static void legacy_read_reg(uint16_t reg, uint8_t* value) {
+    uint8_t addr[2] = { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF) };
+    HAL_I2C_Master_Transmit(&hi2c1, TOF_ADDR8, addr, sizeof(addr), 10);
+    HAL_I2C_Master_Receive(&hi2c1, TOF_ADDR8, value, 1, 10);
+}
+
+// Bloc résultat 0x04D..0x062 tel que rendu par le capteur
+static void set_result_block(uint8_t rangeStatus, uint8_t irqStatus, uint8_t mm) {
+    uint8_t block[VL6180_RESULT_BLOCK_LEN];
+    memset(block, 0xEE, sizeof(block));
+    block[0] = rangeStatus;
+    block[VL6180_RESULT_INTERRUPT_STATUS_GPIO - VL6180_RESULT_RANGE_STATUS] = irqStatus;
+    block[VL6180_RESULT_RANGE_VAL - VL6180_RESULT_RANGE_STATUS] = mm;
+    Mock_HAL_SetI2CResponse(HAL_OK, block, sizeof(block));
+}
+
+void setUp(void) {
+    Mock_HAL_Reset();
+}
+
+void tearDown(void) {
+}
+
+// Un échantillon en mesure unique: lancement + relevé, deux transactions au
+// lieu de quatre
+void test_vl6180_sample_halves_transactions(void) {
+    uint8_t mm = 0;
+    legacy_write_reg(VL6180_SYSRANGE_START, 0x01);
+    legacy_read_reg(VL6180_RESULT_RANGE_VAL, &mm);
+    legacy_write_reg(VL6180_SYSTEM_INTERRUPT_CLEAR, 0x07);
+    uint32_t legacy = Mock_HAL_GetI2CCallCount();
+
+    Mock_HAL_Reset();
+    set_result_block(0x01, 0x04, 87);
+    TEST_ASSERT_TRUE(Vl6180_Start(&bus, TOF_ADDR8));
+    TEST_ASSERT_TRUE(Vl6180_ReadSample(&bus, TOF_ADDR8, &mm));
+    uint32_t burst = Mock_HAL_GetI2CCallCount();
+
+    TEST_ASSERT_EQUAL_UINT32(4, legacy);
+    TEST_ASSERT_EQUAL_UINT32(2, burst);
+    TEST_ASSERT_TRUE(2U * burst <= legacy);
+    TEST_ASSERT_EQUAL_UINT8(87, mm);
+}
+
+// Acquittement et lancement en une écriture à partir de INTERRUPT_CLEAR
+void test_vl6180_start_single_write(void) {
+    const uint8_t expected[] = { 0x07, 0x00, 0x00, 0x01 };
+    TEST_ASSERT_TRUE(Vl6180_Start(&bus, TOF_ADDR8));
+    TEST_ASSERT_EQUAL_UINT32(1, Mock_HAL_GetI2CCallCount());
+    TEST_ASSERT_EQUAL_HEX16(VL6180_SYSTEM_INTERRUPT_CLEAR, Mock_HAL_GetI2CLastMemAddress());
+    TEST_ASSERT_EQUAL_HEX16(I2C_MEMADD_SIZE_16BIT, Mock_HAL_GetI2CLastMemAddSize());
+    TEST_ASSERT_EQUAL_UINT16(sizeof(expected), Mock_HAL_GetI2CLastSize());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, Mock_HAL_GetI2CLastTx(), sizeof(expected));
+}
+
+// Statut et distance lus d'une traite
+void test_vl6180_read_sample_burst(void) {
+    uint8_t mm = 0;
+    set_result_block(0x01, 0x04, 142);
+    TEST_ASSERT_TRUE(Vl6180_ReadSample(&bus, TOF_ADDR8, &mm));
+    TEST_ASSERT_EQUAL_UINT32(1, Mock_HAL_GetI2CCallCount());
+    TEST_ASSERT_EQUAL_HEX16(VL6180_RESULT_RANGE_STATUS, Mock_HAL_GetI2CLastMemAddress());
+    TEST_ASSERT_EQUAL_UINT16(VL6180_RESULT_BLOCK_LEN, Mock_HAL_GetI2CLastSize());
+    TEST_ASSERT_EQUAL_UINT8(142, mm);
+}
+
+// Codes d'erreur de mesure: sans cible -> distance maximale (stock vide),
+// cible collée -> 0, défaut du capteur ou échantillon absent -> échec
+void test_vl6180_read_sample_status(void) {
+    uint8_t mm = 42;
+    set_result_block(0xB1, 0x04, 17);       // 11: rapport signal/bruit
+    TEST_ASSERT_TRUE(Vl6180_ReadSample(&bus, TOF_ADDR8, &mm));
+    TEST_ASSERT_EQUAL_UINT8(VL6180_RANGE_MM_MAX, mm);
+
+    set_result_block(0xF1, 0x04, 17);       // 15: dépassement
+    TEST_ASSERT_TRUE(Vl6180_ReadSample(&bus, TOF_ADDR8, &mm));
+    TEST_ASSERT_EQUAL_UINT8(VL6180_RANGE_MM_MAX, mm);
+
+    set_result_block(0xE1, 0x04, 17);       // 14: dépassement par le bas
+    TEST_ASSERT_TRUE(Vl6180_ReadSample(&bus, TOF_ADDR8, &mm));
+    TEST_ASSERT_EQUAL_UINT8(0, mm);
+
+    mm = 42;
+    set_result_block(0x31, 0x04, 17);       // 3: chien de garde VCSEL
+    TEST_ASSERT_FALSE(Vl6180_ReadSample(&bus, TOF_ADDR8, &mm));
+    set_result_block(0x01, 0x00, 17);       // Pas de nouvel échantillon
+    TEST_ASSERT_FALSE(Vl6180_ReadSample(&bus, TOF_ADDR8, &mm));
+    TEST_ASSERT_EQUAL_UINT8(42, mm);
+
+    Mock_HAL_SetI2CResponse(HAL_ERROR, NULL, 0);
+    TEST_ASSERT_FALSE(Vl6180_ReadSample(&bus, TOF_ADDR8, &mm));
+    TEST_ASSERT_FALSE(Vl6180_Start(&bus, TOF_ADDR8));
+}
+
+// Configuration de l'interruption en une écriture (0x014..0x016)
+void test_vl6180_init(void) {
+    const uint8_t irq[] = { 0x04, 0x07, 0x00 };
+    TEST_ASSERT_TRUE(Vl6180_Init(&bus, TOF_ADDR8, 0));
+    TEST_ASSERT_EQUAL_UINT32(3, Mock_HAL_GetI2CCallCount());
+    TEST_ASSERT_EQUAL_HEX16(VL6180_SYSTEM_INTERRUPT_CONFIG_GPIO, Mock_HAL_GetI2CLastMemAddress());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(irq, Mock_HAL_GetI2CLastTx(), sizeof(irq));
+
+    // Mesure continue: période puis démarrage
+    Mock_HAL_Reset();
+    TEST_ASSERT_TRUE(Vl6180_Init(&bus, TOF_ADDR8, 200));
+    TEST_ASSERT_EQUAL_UINT32(5, Mock_HAL_GetI2CCallCount());
+    TEST_ASSERT_EQUAL_HEX16(VL6180_SYSRANGE_START, Mock_HAL_GetI2CLastMemAddress());
+    TEST_ASSERT_EQUAL_HEX8(0x03, Mock_HAL_GetI2CLastTx()[0]);
+
+    // Capteur absent: arrêt à la première transaction
+    Mock_HAL_Reset();
+    Mock_HAL_SetI2CResponse(HAL_ERROR, NULL, 0);
+    TEST_ASSERT_FALSE(Vl6180_Init(&bus, TOF_ADDR8, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, Mock_HAL_GetI2CCallCount());
+}
+
+void test_vl6180_set_address(void) {
+    TEST_ASSERT_TRUE(Vl6180_SetAddress(&bus, (0x29 << 1), 0x2A));
+    TEST_ASSERT_EQUAL_HEX16(VL6180_I2C_SLAVE_DEVICE_ADDRESS, Mock_HAL_GetI2CLastMemAddress());
+    TEST_ASSERT_EQUAL_HEX8(0x2A, Mock_HAL_GetI2CLastTx()[0]);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_vl6180_sample_halves_transactions);
+    RUN_TEST(test_vl6180_start_single_write);
+    RUN_TEST(test_vl6180_read_sample_burst);
+    RUN_TEST(test_vl6180_read_sample_status);
+    RUN_TEST(test_vl6180_init);
+    RUN_TEST(test_vl6180_set_address);
+    return UNITY_END();
+}
@@ -0,0 +1,75 @@
+#include "unity.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "str_intern.h"
+
+#define TEST_ENTRY_LEN  12
+#define TEST_ENTRIES    4
+
+static char storage[TEST_ENTRIES][TEST_ENTRY_LEN];
+static StrIntern table;
+
+void setUp(void) {
+    TEST_ASSERT_TRUE(StrIntern_Init(&table, &storage[0][0], TEST_ENTRY_LEN, TEST_ENTRIES));
+}
+
+void tearDown(void) {
+}
+
+// Même chaîne, même id; la copie est faite une seule fois
+void test_str_intern_same_string_same_id(void) {
+    char buf[16];
+    strcpy(buf, "PROD_COCA");
+
+    uint8_t a = StrIntern_Intern(&table, buf);
+    uint8_t b = StrIntern_Intern(&table, "PROD_EAU");
+    strcpy(buf, "PROD_COCA");
+    TEST_ASSERT_EQUAL_UINT8(a, StrIntern_Intern(&table, buf));
+    TEST_ASSERT_NOT_EQUAL(a, b);
+    TEST_ASSERT_EQUAL_UINT8(2, table.count);
+
+    buf[0] = 'X';   // L'entrée ne dépend pas du tampon de l'appelant
+    TEST_ASSERT_EQUAL_STRING("PROD_COCA", StrIntern_Get(&table, a));
+    TEST_ASSERT_EQUAL_STRING("PROD_EAU", StrIntern_Get(&table, b));
+}
+
+// Table pleine ou chaîne trop longue: refus compté, entrées existantes toujours servies
+void test_str_intern_rejects_when_full_or_too_long(void) {
+    TEST_ASSERT_EQUAL_UINT8(STR_INTERN_NONE, StrIntern_Intern(&table, "ABCDEFGHIJKL"));
+    TEST_ASSERT_NOT_EQUAL(STR_INTERN_NONE, StrIntern_Intern(&table, "ABCDEFGHIJK"));
+
+    StrIntern_Intern(&table, "B");
+    StrIntern_Intern(&table, "C");
+    StrIntern_Intern(&table, "D");
+    TEST_ASSERT_EQUAL_UINT8(STR_INTERN_NONE, StrIntern_Intern(&table, "E"));
+    TEST_ASSERT_EQUAL_UINT8(3, StrIntern_Intern(&table, "D"));
+    TEST_ASSERT_EQUAL_UINT32(2, table.rejected);
+}
+
+// Empreintes identiques: la comparaison complète départage
+void test_str_intern_hash_collision(void) {
+    // "AB" et "BD": (0x41<<1)^0x42 = 0xC0 = (0x42<<1)^0x44
+    uint8_t a = StrIntern_Intern(&table, "AB");
+    uint8_t c = StrIntern_Intern(&table, "BD");
+    TEST_ASSERT_EQUAL_UINT8(table.hash[a], table.hash[c]);
+    TEST_ASSERT_NOT_EQUAL(a, c);
+    TEST_ASSERT_EQUAL_STRING("BD", StrIntern_Get(&table, c));
+}
+
+void test_str_intern_unknown_id(void) {
+    TEST_ASSERT_EQUAL_STRING("", StrIntern_Get(&table, 0));
+    TEST_ASSERT_EQUAL_STRING("", StrIntern_Get(&table, STR_INTERN_NONE));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_str_intern_same_string_same_id);
+    RUN_TEST(test_str_intern_rejects_when_full_or_too_long);
+    RUN_TEST(test_str_intern_hash_collision);
+    RUN_TEST(test_str_intern_unknown_id);
+
+    return UNITY_END();
+}